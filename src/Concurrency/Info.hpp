@@ -19,7 +19,7 @@
 
 #include <omp.h>
 #ifdef QMC_EXP_THREADING
-#include <thread>
+#include "Concurrency/ThreadPool.hpp"
 #endif
 
 namespace qmcplusplus
@@ -56,11 +56,17 @@ inline unsigned int getWorkerId<Executor::OPENMP>()
 
 
 #ifdef QMC_EXP_THREADING
+/// the size of the pool follows the process affinity mask, e.g. set by taskset or the MPI launcher
 template<>
 inline unsigned int maxCapacity<Executor::STD_THREADS>()
 {
-  // Does taskset fix what this reports?  i.e. deal with binding to socket properly
-  return std::thread::hardware_concurrency();
+  return ThreadPool::getGlobal().size();
+}
+
+template<>
+inline unsigned int getWorkerId<Executor::STD_THREADS>()
+{
+  return ThreadPool::getWorkerId();
 }
 #endif
 
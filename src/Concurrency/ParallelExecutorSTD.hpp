@@ -17,49 +17,43 @@
 #ifndef QMCPLUSPLUS_PARALLELEXECUTOR_STDTHREADS_HPP
 #define QMCPLUSPLUS_PARALLELEXECUTOR_STDTHREADS_HPP
 
-#include <vector>
-#include <functional>
-#include <utility>
-#include <thread>
+#include <atomic>
+#include <stdexcept>
 
 #include "Concurrency/ParallelExecutor.hpp"
+#include "Concurrency/ThreadPool.hpp"
+#include "Platforms/Host/OutputManager.h"
 
 namespace qmcplusplus
 {
-/**  TaskWrapper code from
-  *  https://stackoverflow.com/questions/48268322/wrap-stdthread-call-function
-  *
-  *  Required to forward an arbitrary var args function
-  */
-template<typename F>
-struct TaskWrapper
-{
-  F f;
-
-  template<typename... T>
-  void operator()(T&&... args)
-  {
-    f(std::forward<T>(args)...);
-  }
-};
-
-/** implements parallel tasks executed by STD threads. One task one thread mapping.
+/** implements parallel tasks executed by the persistent threads of ThreadPool::getGlobal().
+ *
+ *  The tasks are distributed over the pool and idle threads steal the remaining tasks of the busy ones,
+ *  so running more tasks, e.g. crowds, than threads balances uneven tasks.
+ *  Unlike the OpenMP specialization, nested use from inside a task is supported.
  */
 template<>
 template<typename F, typename... Args>
 void ParallelExecutor<Executor::STD_THREADS>::operator()(int num_tasks, F&& f, Args&&... args)
 {
-  std::vector<std::thread> threads(num_tasks_);
-
-  for (int task_id = 0; task_id < num_tasks; ++task_id)
-  {
-    threads[task_id] = std::thread(TaskWrapper<F>{std::forward<F>(f)}, task_id, std::forward<Args>(args)...);
-  }
-
-  for (int task_id = 0; task_id < num_tasks; ++task_id)
-  {
-    threads[task_id].join();
-  }
+  std::atomic<int> throw_count(0);
+  ThreadPool::getGlobal().run(num_tasks, [&](int task_id) {
+    try
+    {
+      f(task_id, args...);
+    }
+    catch (const std::runtime_error& re)
+    {
+      app_warning() << re.what();
+      ++throw_count;
+    }
+    catch (...)
+    {
+      ++throw_count;
+    }
+  });
+  if (throw_count > 0)
+    throw std::runtime_error("Unexpected exception thrown in threaded section");
 }
 
 } // namespace qmcplusplus
@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source
+// License.  See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file
+ *  @brief persistent work stealing thread pool backing ParallelExecutor<Executor::STD_THREADS>
+ */
+#ifndef QMCPLUSPLUS_THREADPOOL_HPP
+#define QMCPLUSPLUS_THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace qmcplusplus
+{
+/** pool of persistent worker threads
+ *
+ *  The workers are created once and optionally pinned to the cores of the process affinity mask,
+ *  so repeated parallel sections, e.g. one per MC step, do not pay thread creation
+ *  and keep the data of a task in the same cache.
+ *
+ *  Each worker and the calling thread own a queue. run() splits the tasks in contiguous chunks over the queues.
+ *  A thread takes tasks from the front of its own queue and, when it runs dry, steals from the back of the others,
+ *  so the threads done with their share take over the remaining tasks of the slower ones.
+ *  The calling thread works on the tasks as well until all of them are completed.
+ *  Nested run() calls from inside a task are allowed, the waiting thread keeps executing queued tasks
+ *  and sleeps on the condition variable of the idle workers when none is left.
+ */
+class ThreadPool
+{
+public:
+  using TaskType = std::function<void(int)>;
+
+  /** constructor
+   * @param num_workers number of threads created in addition to the calling thread
+   * @param pin_workers if true, worker i is pinned to the i+1-th core of the process affinity mask
+   */
+  ThreadPool(int num_workers, bool pin_workers) : stop_(false), pending_jobs_(0)
+  {
+    queues_.reserve(num_workers + 1);
+    for (int iq = 0; iq <= num_workers; iq++)
+      queues_.push_back(std::make_unique<WorkQueue>());
+
+    const std::vector<int> cpus(getAvailableCPUs());
+    workers_.reserve(num_workers);
+    for (int iw = 0; iw < num_workers; iw++)
+    {
+      workers_.push_back(std::thread(&ThreadPool::workerLoop, this, iw + 1));
+      if (pin_workers && cpus.size() > 1)
+        pinThread(workers_.back(), cpus[(iw + 1) % cpus.size()]);
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto& worker : workers_)
+      worker.join();
+  }
+
+  /// number of threads executing tasks, including the calling thread
+  int size() const { return workers_.size() + 1; }
+
+  /** the pool used by ParallelExecutor<Executor::STD_THREADS>
+   *
+   *  One thread per core of the process affinity mask, the calling thread included.
+   *  The workers are pinned.
+   */
+  static ThreadPool& getGlobal()
+  {
+    static ThreadPool global_pool(std::max(static_cast<int>(getAvailableCPUs().size()) - 1, 0), true);
+    return global_pool;
+  }
+
+  /// index of the calling thread, 1 to size()-1 on the workers and 0 on any other thread
+  static int getWorkerId() { return workerIdRef(); }
+
+  /** run task(task_id) for task_id in [0, num_tasks) and return when all of them are done
+   *
+   *  Exceptions must be handled inside the task.
+   *  Any exception escaping a task is caught and reported by throwing std::runtime_error after all the tasks are done.
+   */
+  void run(int num_tasks, const TaskType& task)
+  {
+    if (num_tasks <= 0)
+      return;
+
+    Batch batch(task, num_tasks);
+    const int num_queues = queues_.size();
+    const int my_queue   = getWorkerId();
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      pending_jobs_ += num_tasks;
+    }
+    for (int iq = 0; iq < num_queues; iq++)
+    {
+      const int first = static_cast<long>(num_tasks) * iq / num_queues;
+      const int last  = static_cast<long>(num_tasks) * (iq + 1) / num_queues;
+      if (first == last)
+        continue;
+      WorkQueue& queue = *queues_[(my_queue + iq) % num_queues];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      for (int task_id = first; task_id < last; task_id++)
+        queue.jobs.push_back(Job{&batch, task_id});
+    }
+    sleep_cv_.notify_all();
+
+    // help until the batch is completed, possibly executing tasks of other batches
+    while (batch.remaining.load(std::memory_order_acquire) > 0)
+    {
+      Job job;
+      if (popJob(my_queue, job))
+        execute(job);
+      else
+      {
+        // sleep until jobs are queued or the last task of the batch is done
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this, &batch] {
+          return batch.remaining.load(std::memory_order_acquire) == 0 || pending_jobs_.load() > 0;
+        });
+      }
+    }
+
+    if (batch.throw_count > 0)
+      throw std::runtime_error("Unexpected exception thrown in threaded section");
+  }
+
+private:
+  /// the tasks of a run() call
+  struct Batch
+  {
+    const TaskType& task;
+    std::atomic<int> remaining;
+    std::atomic<int> throw_count;
+    Batch(const TaskType& task_in, int num_tasks) : task(task_in), remaining(num_tasks), throw_count(0) {}
+  };
+
+  struct Job
+  {
+    Batch* batch;
+    int task_id;
+  };
+
+  struct WorkQueue
+  {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  /// one queue per thread, queues_[0] belongs to the threads outside the pool
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::vector<std::thread> workers_;
+  /// guard the sleep of idle workers
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  bool stop_;
+  /// number of jobs in all the queues
+  std::atomic<int> pending_jobs_;
+
+  static int& workerIdRef()
+  {
+    static thread_local int worker_id = 0;
+    return worker_id;
+  }
+
+  void workerLoop(int worker_id)
+  {
+    workerIdRef() = worker_id;
+    while (true)
+    {
+      Job job;
+      if (popJob(worker_id, job))
+      {
+        execute(job);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      sleep_cv_.wait(lock, [this] { return stop_ || pending_jobs_.load() > 0; });
+      if (stop_)
+        return;
+    }
+  }
+
+  /// take a job from the front of the own queue, otherwise steal one from the back of another queue
+  bool popJob(int my_queue, Job& job)
+  {
+    const int num_queues = queues_.size();
+    for (int iq = 0; iq < num_queues; iq++)
+    {
+      WorkQueue& queue = *queues_[(my_queue + iq) % num_queues];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.jobs.empty())
+        continue;
+      if (iq == 0)
+      {
+        job = queue.jobs.front();
+        queue.jobs.pop_front();
+      }
+      else
+      {
+        job = queue.jobs.back();
+        queue.jobs.pop_back();
+      }
+      pending_jobs_--;
+      return true;
+    }
+    return false;
+  }
+
+  void execute(const Job& job)
+  {
+    try
+    {
+      job.batch->task(job.task_id);
+    }
+    catch (...)
+    {
+      job.batch->throw_count++;
+    }
+    // the batch may be destroyed by its waiting thread as soon as remaining reaches zero
+    if (job.batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      sleep_cv_.notify_all();
+    }
+  }
+
+  /// the cores the process is allowed to run on
+  static std::vector<int> getAvailableCPUs()
+  {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        if (CPU_ISSET(cpu, &mask))
+          cpus.push_back(cpu);
+#endif
+    if (cpus.empty())
+      for (unsigned cpu = 0; cpu < std::max(std::thread::hardware_concurrency(), 1u); cpu++)
+        cpus.push_back(cpu);
+    return cpus;
+  }
+
+  static void pinThread(std::thread& thread, int cpu)
+  {
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(mask), &mask);
+#endif
+  }
+};
+
+} // namespace qmcplusplus
+
+#endif
@@ -12,10 +12,14 @@
 #include <atomic>
 #include <thread>
 #include <functional>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
 
 #include "catch.hpp"
 
 #include "Concurrency/ParallelExecutor.hpp"
+#include "Concurrency/ThreadPool.hpp"
 
 namespace qmcplusplus
 {
@@ -55,4 +59,41 @@ TEST_CASE("ParallelExecutor<STD> nested case", "[concurrency]")
   REQUIRE(count == 64);
 }
 
+TEST_CASE("ParallelExecutor<STD> exception case", "[concurrency]")
+{
+  ParallelExecutor<Executor::STD_THREADS> test_block;
+  std::atomic<int> count(0);
+  REQUIRE_THROWS(test_block(
+      8,
+      [](int task_id, std::atomic<int>& my_count) {
+        ++my_count;
+        if (task_id == 3)
+          throw std::runtime_error("task 3 failed");
+      },
+      std::ref(count)));
+  // the other tasks still run
+  REQUIRE(count == 8);
+}
+
+TEST_CASE("ThreadPool uneven tasks", "[concurrency]")
+{
+  ThreadPool pool(3, false);
+  REQUIRE(pool.size() == 4);
+  const int num_tasks = 37;
+  std::vector<std::atomic<int>> executed(num_tasks);
+  for (int repeat = 0; repeat < 3; repeat++)
+  {
+    for (auto& e : executed)
+      e = 0;
+    // the first tasks are much slower than the others
+    pool.run(num_tasks, [&executed](int task_id) {
+      if (task_id < 4)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      ++executed[task_id];
+    });
+    for (auto& e : executed)
+      REQUIRE(e == 1);
+  }
+}
+
 } // namespace qmcplusplus
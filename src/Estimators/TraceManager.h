@@ -35,6 +35,7 @@
 #include <map>
 #include <set>
 #include <algorithm>
+#include <thread>
 
 namespace qmcplusplus
 {
@@ -1092,9 +1093,13 @@ struct TraceBuffer
   std::string top;
   hsize_t dims[2];
   hsize_t hdf_file_pointer;
+  ///creation properties of the traces dataset: chunk shape and filters
+  hid_t dataset_properties;
+  ///columns per chunk of the traces dataset
+  static const int chunk_columns = 256;
 
 
-  TraceBuffer() : samples(0), complex_samples(0), verbose(false)
+  TraceBuffer() : samples(0), complex_samples(0), verbose(false), dataset_properties(H5P_DEFAULT)
   {
     type        = "?";
     has_complex = false;
@@ -1277,20 +1282,65 @@ struct TraceBuffer
   }
 
 
-  inline void write_hdf(hdf_archive& f) { write_hdf(f, hdf_file_pointer); }
+  /** set the chunk shape and the compression of the traces dataset
+   * @param chunk_rows number of rows (walker samples) per chunk
+   * @param compression deflate level, 0 for no compression
+   *
+   * A chunk spans at most chunk_columns columns, so the columns of a single quantity are read
+   * without decompressing the rest of the row.
+   * The byte shuffle filter precedes deflate to group the bytes of the same significance.
+   */
+  inline void set_hdf_layout(int chunk_rows, int compression)
+  {
+    close_hdf_layout();
+    const int row_size = buffer.size(1);
+    if (row_size == 0)
+      return;
+    hsize_t chunk_dims[2] = {static_cast<hsize_t>(std::max(chunk_rows, 1)),
+                             static_cast<hsize_t>(std::min(row_size, chunk_columns))};
+    dataset_properties    = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(dataset_properties, 2, chunk_dims);
+    if (compression > 0)
+    {
+      if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+      {
+        H5Pset_shuffle(dataset_properties);
+        H5Pset_deflate(dataset_properties, compression);
+      }
+      else
+        app_warning() << "TraceBuffer<" << type << ">::set_hdf_layout the HDF5 library has no deflate filter, "
+                      << "traces are written uncompressed" << std::endl;
+    }
+  }
+
+
+  inline void close_hdf_layout()
+  {
+    if (dataset_properties != H5P_DEFAULT)
+      H5Pclose(dataset_properties);
+    dataset_properties = H5P_DEFAULT;
+  }
+
+
+  inline void write_hdf(hdf_archive& f) { write_hdf(f, buffer); }
 
 
-  inline void write_hdf(hdf_archive& f, hsize_t& file_pointer)
+  /** append rows to the traces dataset
+   * @param f trace file
+   * @param rows buffer of a clone, with the same row size as this
+   */
+  inline void write_hdf(hdf_archive& f, const Array<T, 2>& rows)
   {
     if (verbose)
-      app_log() << "TraceBuffer<" << type << ">::write_hdf() " << file_pointer << " " << buffer.size(0) << " "
-                << buffer.size(1) << std::endl;
-    dims[0] = buffer.size(0);
-    dims[1] = buffer.size(1);
+      app_log() << "TraceBuffer<" << type << ">::write_hdf() " << hdf_file_pointer << " " << rows.size(0) << " "
+                << rows.size(1) << std::endl;
+    dims[0] = rows.size(0);
+    dims[1] = rows.size(1);
     if (dims[0] > 0)
     {
       f.push(top);
-      h5d_append(f.top(), "traces", file_pointer, buffer.dim(), dims, buffer.data());
+      h5d_append(f.top(), "traces", hdf_file_pointer, rows.dim(), dims, rows.data(), 1, H5P_DEFAULT,
+                 dataset_properties);
       f.pop();
     }
     f.flush();
@@ -1449,6 +1499,16 @@ public:
   std::string file_root;
   Communicate* communicator;
   hdf_archive* hdf_file;
+  ///deflate level of the trace datasets, 0 for no compression
+  int compression;
+  ///number of rows per chunk of the trace datasets
+  int chunk_rows;
+  ///if true, the buffers are written by a background thread while the next block runs
+  bool async_write;
+  std::thread writer_thread;
+  ///copies of the clone buffers held until writer_thread is done
+  std::vector<Array<TraceInt, 2>> int_pending;
+  std::vector<Array<TraceReal, 2>> real_pending;
 
   TraceManager(Communicate* comm = 0) : verbose(false), hdf_file(0)
   {
@@ -1456,6 +1516,9 @@ public:
     master_copy    = true;
     communicator   = comm;
     throttle       = 1;
+    compression    = 0;
+    chunk_rows     = 128;
+    async_write    = false;
     format         = "hdf";
     default_domain = "scalars";
     request.set_scalar_domain(default_domain);
@@ -1467,6 +1530,9 @@ public:
   }
 
 
+  ~TraceManager() { wait_for_writer(); }
+
+
   inline TraceManager* makeClone()
   {
     if (verbose)
@@ -1540,6 +1606,7 @@ public:
       std::string scalar_defaults = "yes";
       std::string array_defaults  = "yes";
       std::string verbose_write   = "no";
+      std::string async           = "no";
       OhmmsAttributeSet attrib;
       attrib.add(writing, "write");
       attrib.add(scalar, "scalar");
@@ -1549,6 +1616,9 @@ public:
       attrib.add(format, "format");
       attrib.add(throttle, "throttle");
       attrib.add(verbose_write, "verbose");
+      attrib.add(compression, "compress");
+      attrib.add(chunk_rows, "chunk");
+      attrib.add(async, "async");
       attrib.add(array, "particle");                   //legacy
       attrib.add(array_defaults, "particle_defaults"); //legacy
       attrib.put(cur);
@@ -1558,6 +1628,7 @@ public:
       bool use_scalar_defaults = scalar_defaults == "yes";
       bool use_array_defaults  = array_defaults == "yes";
       verbose                  = verbose_write == "yes";
+      async_write              = async == "yes";
       tolower(format);
       if (format == "hdf")
       {
@@ -1567,6 +1638,18 @@ public:
       {
         APP_ABORT("TraceManager::put " + format + " is not a valid file format for traces\n  valid options is: hdf");
       }
+      if (compression < 0 || compression > 9)
+        APP_ABORT("TraceManager::put compress must be a deflate level between 0 and 9");
+      if (chunk_rows < 1)
+        APP_ABORT("TraceManager::put chunk must be a positive number of rows");
+#if !defined(H5_HAVE_THREADSAFE)
+      if (async_write)
+      {
+        app_warning() << "TraceManager::put async writes require a thread-safe HDF5 library, "
+                      << "traces are written at the end of each block" << std::endl;
+        async_write = false;
+      }
+#endif
 
       //read scalar and array elements
       //  each requests that certain traces be computed
@@ -2038,6 +2121,9 @@ public:
     app_log() << pad2 << "writing_traces          = " << writing_traces << std::endl;
     app_log() << pad2 << "format                  = " << format << std::endl;
     app_log() << pad2 << "hdf format              = " << hdf_format << std::endl;
+    app_log() << pad2 << "compression             = " << compression << std::endl;
+    app_log() << pad2 << "chunk_rows              = " << chunk_rows << std::endl;
+    app_log() << pad2 << "async_write             = " << async_write << std::endl;
     app_log() << pad2 << "default_domain          = " << default_domain << std::endl;
     int_buffer.write_summary(pad2);
     real_buffer.write_summary(pad2);
@@ -2092,6 +2178,15 @@ public:
     //tm.write_summary();
     tm.int_buffer.register_hdf_data(*hdf_file);
     tm.real_buffer.register_hdf_data(*hdf_file);
+    // the master copy appends the rows of all the clones
+    int_buffer.top               = tm.int_buffer.top;
+    real_buffer.top              = tm.real_buffer.top;
+    int_buffer.hdf_file_pointer  = 0;
+    real_buffer.hdf_file_pointer = 0;
+    int_buffer.buffer.resize(0, tm.int_buffer.buffer.size(1));
+    real_buffer.buffer.resize(0, tm.real_buffer.buffer.size(1));
+    int_buffer.set_hdf_layout(chunk_rows, compression);
+    real_buffer.set_hdf_layout(chunk_rows, compression);
   }
 
 
@@ -2099,15 +2194,51 @@ public:
   {
     if (verbose)
       app_log() << "TraceManager::write_buffers_hdf " << master_copy << std::endl;
-    for (int ip = 0; ip < clones.size(); ++ip)
+    if (async_write)
     {
-      TraceManager& tm = *clones[ip];
-      tm.int_buffer.write_hdf(*hdf_file, int_buffer.hdf_file_pointer);
-      tm.real_buffer.write_hdf(*hdf_file, real_buffer.hdf_file_pointer);
+      // the clones refill their buffers in the next block, write copies
+      wait_for_writer();
+      int_pending.resize(clones.size());
+      real_pending.resize(clones.size());
+      for (int ip = 0; ip < clones.size(); ++ip)
+      {
+        int_pending[ip]  = clones[ip]->int_buffer.buffer;
+        real_pending[ip] = clones[ip]->real_buffer.buffer;
+      }
+      writer_thread = std::thread([this] {
+        for (int ip = 0; ip < int_pending.size(); ++ip)
+        {
+          int_buffer.write_hdf(*hdf_file, int_pending[ip]);
+          real_buffer.write_hdf(*hdf_file, real_pending[ip]);
+        }
+      });
     }
+    else
+      for (int ip = 0; ip < clones.size(); ++ip)
+      {
+        TraceManager& tm = *clones[ip];
+        int_buffer.write_hdf(*hdf_file, tm.int_buffer.buffer);
+        real_buffer.write_hdf(*hdf_file, tm.real_buffer.buffer);
+      }
   }
 
-  inline void close_hdf_file() { delete hdf_file; }
+
+  inline void wait_for_writer()
+  {
+    if (writer_thread.joinable())
+      writer_thread.join();
+  }
+
+
+  inline void close_hdf_file()
+  {
+    wait_for_writer();
+    int_pending.clear();
+    real_pending.clear();
+    int_buffer.close_hdf_layout();
+    real_buffer.close_hdf_layout();
+    delete hdf_file;
+  }
 };
 
 
@@ -169,4 +169,54 @@ TEST_CASE("TraceManager check_trace_build", "[estimators]")
   ac4 = tm.checkout_complex<4>(name4, P, 11, 12, 13);
 }
 
+TEST_CASE("TraceBuffer chunked compressed hdf", "[estimators]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  TraceBuffer<TraceReal> tbr;
+  tbr.set_type("real");
+  tbr.buffer.resize(3, 5);
+  for (int i = 0; i < tbr.buffer.size(); i++)
+    tbr.buffer(i) = 0.5 * i;
+  tbr.hdf_file_pointer = 0;
+  tbr.set_hdf_layout(2, 6);
+  {
+    hdf_archive f(c, false);
+    REQUIRE(f.create("trace_buffer_test.h5"));
+    // two blocks
+    tbr.write_hdf(f);
+    tbr.write_hdf(f);
+  }
+  tbr.close_hdf_layout();
+  REQUIRE(tbr.hdf_file_pointer == 6);
+
+  hdf_archive f(c, false);
+  REQUIRE(f.open("trace_buffer_test.h5", H5F_ACC_RDONLY));
+  f.push("real_data", false);
+  hid_t dset = H5Dopen(f.top(), "traces");
+  REQUIRE(dset >= 0);
+
+  hid_t space = H5Dget_space(dset);
+  hsize_t dims[2];
+  H5Sget_simple_extent_dims(space, dims, NULL);
+  REQUIRE(dims[0] == 6);
+  REQUIRE(dims[1] == 5);
+  H5Sclose(space);
+
+  hid_t plist = H5Dget_create_plist(dset);
+  hsize_t chunk_dims[2];
+  REQUIRE(H5Pget_chunk(plist, 2, chunk_dims) == 2);
+  REQUIRE(chunk_dims[0] == 2);
+  REQUIRE(chunk_dims[1] == 5);
+  // shuffle and deflate, the layout is left unfiltered if the library has no deflate
+  REQUIRE(H5Pget_nfilters(plist) == (H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0 ? 2 : 0));
+  H5Pclose(plist);
+
+  std::vector<TraceReal> traces(30);
+  H5Dread(dset, get_h5_datatype(traces[0]), H5S_ALL, H5S_ALL, H5P_DEFAULT, traces.data());
+  H5Dclose(dset);
+  for (int i = 0; i < 30; i++)
+    REQUIRE(traces[i] == Approx(0.5 * (i % 15)));
+}
+
 } // namespace qmcplusplus
@@ -116,6 +116,14 @@ void Communicate::initializeAsNodeComm(const Communicate& parent)
   d_ncontexts = comm.size();
 }
 
+void Communicate::initializeAsSplitComm(const Communicate& parent, int color)
+{
+  comm        = parent.comm.split(color, parent.rank());
+  myMPI       = &comm;
+  d_mycontext = comm.rank();
+  d_ncontexts = comm.size();
+}
+
 void Communicate::finalize()
 {
   static bool has_finalized = false;
@@ -137,6 +145,8 @@ void Communicate::initialize(int argc, char** argv) { std::string when = "qmc."
 
 void Communicate::initializeAsNodeComm(const Communicate& parent) {}
 
+void Communicate::initializeAsSplitComm(const Communicate& parent, int color) {}
+
 void Communicate::finalize() {}
 
 void Communicate::abort() const { std::abort(); }
@@ -97,6 +97,8 @@ public:
 #endif
   /// initialize this as a node/shared-memory communicator
   void initializeAsNodeComm(const Communicate& parent);
+  /// initialize this as the communicator of the ranks in parent with the same color
+  void initializeAsSplitComm(const Communicate& parent, int color);
   void finalize();
   void barrier() const;
   void abort() const;
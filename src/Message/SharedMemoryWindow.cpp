@@ -0,0 +1,62 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "SharedMemoryWindow.h"
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include "Platforms/CPU/SIMD/alignment.config.h"
+
+///return the offset in bytes to the first QMC_CLINE aligned address from base
+inline int alignmentOffset(const void* base)
+{
+  return (QMC_CLINE - reinterpret_cast<std::uintptr_t>(base) % QMC_CLINE) % QMC_CLINE;
+}
+
+#ifdef HAVE_MPI
+SharedMemoryWindow::SharedMemoryWindow(const Communicate& node_comm, size_t bytes)
+    : base_(nullptr), bytes_(bytes), is_leader_(node_comm.rank() == 0)
+{
+  // only the leader allocates, padded to be aligned regardless of the address returned by MPI
+  const MPI_Aint local_bytes = is_leader_ ? bytes + QMC_CLINE : 0;
+  void* local_base           = nullptr;
+  if (MPI_Win_allocate_shared(local_bytes, 1, MPI_INFO_NULL, node_comm.getMPI(), &local_base, &win_) != MPI_SUCCESS)
+    throw std::runtime_error("SharedMemoryWindow failed to allocate " + std::to_string(bytes) + " bytes!\n");
+
+  MPI_Aint leader_bytes;
+  int disp_unit;
+  void* leader_base = nullptr;
+  MPI_Win_shared_query(win_, 0, &leader_bytes, &disp_unit, &leader_base);
+  // the block may be mapped at different addresses, the leader decides the offset for all
+  int offset = alignmentOffset(leader_base);
+  MPI_Bcast(&offset, 1, MPI_INT, 0, node_comm.getMPI());
+  base_ = static_cast<char*>(leader_base) + offset;
+  MPI_Win_fence(0, win_);
+}
+
+SharedMemoryWindow::~SharedMemoryWindow() { MPI_Win_free(&win_); }
+
+void SharedMemoryWindow::fence() { MPI_Win_fence(0, win_); }
+#else
+SharedMemoryWindow::SharedMemoryWindow(const Communicate& node_comm, size_t bytes)
+    : base_(nullptr), bytes_(bytes), is_leader_(true)
+{
+  alloc_ = static_cast<char*>(std::malloc(bytes + QMC_CLINE));
+  if (alloc_ == nullptr)
+    throw std::runtime_error("SharedMemoryWindow failed to allocate " + std::to_string(bytes) + " bytes!\n");
+  base_ = alloc_ + alignmentOffset(alloc_);
+}
+
+SharedMemoryWindow::~SharedMemoryWindow() { std::free(alloc_); }
+
+void SharedMemoryWindow::fence() {}
+#endif
@@ -0,0 +1,76 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file SharedMemoryWindow.h
+ * @brief declaration of SharedMemoryWindow
+ */
+#ifndef QMCPLUSPLUS_SHARED_MEMORY_WINDOW_H
+#define QMCPLUSPLUS_SHARED_MEMORY_WINDOW_H
+
+#include <cstddef>
+#include "Message/Communicate.h"
+
+/** memory block shared by all the ranks of a node communicator
+ *
+ * The node leader (rank 0 of the node communicator) allocates the block with MPI_Win_allocate_shared
+ * and the other ranks map the same physical memory. Only the leader is expected to write the block.
+ * fence() must be called by all the ranks of the node between writing and reading.
+ * Without MPI, the block is a plain aligned allocation.
+ */
+class SharedMemoryWindow
+{
+public:
+  /** constructor, collective over node_comm
+   * @param node_comm communicator of the ranks sharing memory, see Communicate::initializeAsNodeComm
+   * @param bytes size of the block in bytes
+   */
+  SharedMemoryWindow(const Communicate& node_comm, size_t bytes);
+
+  ///destructor, collective over the node communicator used at the construction
+  ~SharedMemoryWindow();
+
+  SharedMemoryWindow(const SharedMemoryWindow&) = delete;
+  SharedMemoryWindow& operator=(const SharedMemoryWindow&) = delete;
+
+  ///return the address of the block in this rank, aligned to QMC_CLINE
+  template<typename T>
+  inline T* data() const
+  {
+    return reinterpret_cast<T*>(base_);
+  }
+
+  ///return the size of the block in bytes
+  inline size_t size() const { return bytes_; }
+
+  ///return true if this rank owns the block and is expected to write it
+  inline bool isNodeLeader() const { return is_leader_; }
+
+  ///complete the writes of the node leader and make them visible to all the ranks of the node
+  void fence();
+
+private:
+  ///address of the block in this rank
+  char* base_;
+  ///size of the block in bytes
+  size_t bytes_;
+  ///true if this rank is the node leader
+  bool is_leader_;
+#ifdef HAVE_MPI
+  ///MPI window handle
+  MPI_Win win_;
+#else
+  ///allocation without MPI
+  char* alloc_;
+#endif
+};
+
+#endif
@@ -114,4 +114,15 @@ TEST_CASE("test_communicate_split_four", "[message]")
   }
 }
 
+TEST_CASE("test_communicate_split_color", "[message]")
+{
+  Communicate* c = OHMMS::Controller;
+  Communicate c2;
+  c2.initializeAsSplitComm(*c, c->rank() % 2);
+
+  const int color = c->rank() % 2;
+  REQUIRE(c2.size() == (c->size() + 1 - color) / 2);
+  REQUIRE(c2.rank() == c->rank() / 2);
+}
+
 } // namespace qmcplusplus
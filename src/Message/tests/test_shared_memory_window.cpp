@@ -0,0 +1,46 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+#include <cstdint>
+#include "Message/Communicate.h"
+#include "Message/SharedMemoryWindow.h"
+#include "Platforms/CPU/SIMD/alignment.config.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("SharedMemoryWindow", "[message]")
+{
+  Communicate* c = OHMMS::Controller;
+  Communicate node_comm;
+  node_comm.initializeAsNodeComm(*c);
+
+  const size_t n = 100;
+  SharedMemoryWindow window(node_comm, n * sizeof(double));
+  REQUIRE(window.size() == n * sizeof(double));
+  REQUIRE(window.isNodeLeader() == (node_comm.rank() == 0));
+
+  double* data = window.data<double>();
+  REQUIRE(reinterpret_cast<std::uintptr_t>(data) % QMC_CLINE == 0);
+
+  if (window.isNodeLeader())
+    for (int i = 0; i < n; i++)
+      data[i] = i * 0.5;
+  window.fence();
+
+  // all the ranks on the node see the values written by the leader
+  for (int i = 0; i < n; i++)
+    REQUIRE(data[i] == Approx(i * 0.5));
+  window.fence();
+}
+
+} // namespace qmcplusplus
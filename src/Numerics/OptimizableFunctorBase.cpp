@@ -10,6 +10,7 @@
 //////////////////////////////////////////////////////////////////////////////////////
 
 #include "OptimizableFunctorBase.h"
+#include <algorithm>
 
 void print(OptimizableFunctorBase& func, std::ostream& os)
 {
@@ -25,3 +26,24 @@ void print(OptimizableFunctorBase& func, std::ostream& os)
     r += d;
   }
 }
+
+void OptimizableFunctorBase::evaluateDerivativesSum(int n,
+                                                    const real_type* dist,
+                                                    const real_type* cfac,
+                                                    real_type* dlog,
+                                                    real_type* dh)
+{
+  const int nparam = myVars.size();
+  std::vector<qmcplusplus::TinyVector<real_type, 3>> derivs(nparam);
+  for (int k = 0; k < n; ++k)
+  {
+    std::fill(derivs.begin(), derivs.end(), 0.0);
+    if (!evaluateDerivatives(dist[k], derivs))
+      continue;
+    for (int p = 0; p < nparam; ++p)
+    {
+      dlog[p] -= derivs[p][0];
+      dh[p] += derivs[p][2] + cfac[k] * derivs[p][1];
+    }
+  }
+}
@@ -112,6 +112,17 @@ struct OptimizableFunctorBase
     return false;
   }
 
+  /** accumulate the parameter derivatives of a sum of u(r) and of a kinetic term over a list of distances
+   * @param n number of distances
+   * @param dist distances \f$r_k\f$ below cutoff_radius
+   * @param cfac factors \f$c_k\f$ of the first derivative in the kinetic term
+   * @param dlog dlog[p] -= \f$\sum_k \partial_p u(r_k)\f$
+   * @param dh dh[p] += \f$\sum_k \partial_p u''(r_k) + c_k \partial_p u'(r_k)\f$
+   *
+   * The default implementation calls evaluateDerivatives distance by distance.
+   */
+  virtual void evaluateDerivativesSum(int n, const real_type* dist, const real_type* cfac, real_type* dlog, real_type* dh);
+
   // mmorales: don't know how to solve a template problem for cusp correction,
   //           so for now I do this
   virtual void setGridManager(bool willmanage) {}
@@ -50,6 +50,8 @@ public:
 
   static void make_seeds();
   static void make_children();
+  /// offset of the random seeds of this run, the same on all the ranks
+  static uint_type getOffset() { return Offset; }
 
   xmlNodePtr initialize(xmlXPathContextPtr);
 
@@ -24,6 +24,7 @@
 #include <numeric>
 #include <iostream>
 #include <sstream>
+#include <cstdio>
 #include "Message/Communicate.h"
 #include "mpi/collectives.h"
 #include "hdf/hdf_hyperslab.h"
@@ -57,7 +58,9 @@ HDFWalkerOutput::HDFWalkerOutput(MCWalkerConfiguration& W, const std::string& ar
       max_number_of_backups(4),
       myComm(c),
       currentConfigNumber(0),
-      RootName(aroot)
+      RootName(aroot),
+      background_write_(false),
+      hdf5_thread_safe_(false)
 //       , fw_out(myComm)
 {
   number_of_particles = W.getTotalNum();
@@ -80,6 +83,7 @@ HDFWalkerOutput::HDFWalkerOutput(MCWalkerConfiguration& W, const std::string& ar
 HDFWalkerOutput::~HDFWalkerOutput()
 {
   //     fw_out.close();
+  waitForBackgroundWrite();
   delete_iter(RemoteData.begin(), RemoteData.end());
 }
 
@@ -96,6 +100,9 @@ HDFWalkerOutput::~HDFWalkerOutput()
  */
 bool HDFWalkerOutput::dump(MCWalkerConfiguration& W, int nblock)
 {
+  if (background_write_)
+    return dump_background(W, nblock);
+
   std::string FileName = myComm->getName() + hdf::config_ext;
   //rotate files
   //if(!myComm->rank() && currentConfigNumber)
@@ -121,6 +128,127 @@ bool HDFWalkerOutput::dump(MCWalkerConfiguration& W, int nblock)
   return true;
 }
 
+void HDFWalkerOutput::setBackgroundWrite(bool background)
+{
+  waitForBackgroundWrite();
+  background_write_ = background;
+  if (background_write_)
+  {
+    hbool_t thread_safe = false;
+    H5is_library_threadsafe(&thread_safe);
+    hdf5_thread_safe_ = thread_safe;
+    if (!hdf5_thread_safe_)
+      app_warning() << "HDFWalkerOutput::setBackgroundWrite HDF5 library is not thread-safe. "
+                    << "Checkpoint files are written by the master in the foreground." << std::endl;
+  }
+}
+
+bool HDFWalkerOutput::waitForBackgroundWrite()
+{
+  if (!pending_write_.valid())
+    return true;
+  const bool success = pending_write_.get();
+  if (!success)
+    app_warning() << "HDFWalkerOutput failed to write the checkpoint file of the previous block in the background. "
+                  << "The earlier checkpoint file is kept." << std::endl;
+  return success;
+}
+
+void HDFWalkerOutput::addCompanionFile(const std::string& staged_name, const std::string& final_name)
+{
+  companion_files_.emplace_back(staged_name, final_name);
+}
+
+/** Snapshot the walkers and write them in the background
+ *
+ * The walkers are packed and gathered to the master synchronously.
+ * The gathered buffer is owned by the pending write until the next dump, which waits for it first.
+ * Only the master touches the file so no collective HDF5 operation is involved.
+ */
+bool HDFWalkerOutput::dump_background(MCWalkerConfiguration& W, int nblock)
+{
+  //buffers can be reused only after the previous write is done
+  const bool previous_success = waitForBackgroundWrite();
+
+  const int wb = OHMMS_DIM * number_of_particles;
+  RemoteData[0]->resize(wb * W.getActiveWalkers());
+  W.putConfigurations(RemoteData[0]->begin());
+  block = nblock;
+
+  number_of_walkers = W.WalkerOffsets[myComm->size()];
+  pending_offsets_.assign(W.WalkerOffsets.begin(), W.WalkerOffsets.end());
+  if (myComm->size() > 1)
+  {
+    std::vector<int> displ(myComm->size()), counts(myComm->size());
+    for (int i = 0; i < myComm->size(); ++i)
+    {
+      counts[i] = wb * (W.WalkerOffsets[i + 1] - W.WalkerOffsets[i]);
+      displ[i]  = wb * W.WalkerOffsets[i];
+    }
+    if (!myComm->rank())
+      RemoteData[1]->resize(wb * number_of_walkers);
+    mpi::gatherv(*myComm, *RemoteData[0], *RemoteData[1], counts, displ);
+  }
+
+  const std::string FileName = myComm->getName() + hdf::config_ext;
+  std::vector<std::pair<std::string, std::string>> companions;
+  companions.swap(companion_files_);
+  if (myComm->rank() == 0)
+  {
+    BufferType& walker_data = *RemoteData[(myComm->size() > 1) ? 1 : 0];
+    if (hdf5_thread_safe_)
+      pending_write_ = std::async(std::launch::async, [this, FileName, nblock, &walker_data, companions]() {
+        return write_snapshot(FileName, nblock, walker_data, companions);
+      });
+    else if (!write_snapshot(FileName, nblock, walker_data, companions))
+      app_warning() << "HDFWalkerOutput failed to write the checkpoint file " << FileName
+                    << ". The earlier checkpoint files are kept." << std::endl;
+  }
+
+  currentConfigNumber++;
+  prevFile = FileName;
+  return previous_success;
+}
+
+bool HDFWalkerOutput::write_snapshot(const std::string& fname,
+                                     int nblock,
+                                     BufferType& walker_data,
+                                     const std::vector<std::pair<std::string, std::string>>& companions)
+{
+  const std::string tmp_name = fname + ".tmp";
+  bool success               = true;
+  try
+  {
+    hdf_archive hout;
+    if (!hout.create(tmp_name))
+      return false;
+    HDFVersion cur_version;
+    hout.write(cur_version.version, hdf::version);
+    hout.push(hdf::main_state);
+    hout.write(nblock, "block");
+    hout.write(number_of_walkers, hdf::num_walkers);
+    hout.write(pending_offsets_, "walker_partition");
+    std::array<int, 3> gcounts{number_of_walkers, number_of_particles, OHMMS_DIM};
+    hout.writeSlabReshaped(walker_data, gcounts, hdf::walkers);
+    hout.close();
+  }
+  catch (const std::runtime_error&)
+  {
+    //this may run in a separate thread, the failure is reported by waitForBackgroundWrite
+    std::remove(tmp_name.c_str());
+    success = false;
+  }
+  //replace the previous checkpoint only with a complete file
+  success = success && std::rename(tmp_name.c_str(), fname.c_str()) == 0;
+  //the companions of a failed walker file are dropped to keep the previous checkpoint consistent
+  for (const auto& companion : companions)
+    if (success)
+      success = std::rename(companion.first.c_str(), companion.second.c_str()) == 0;
+    else
+      std::remove(companion.first.c_str());
+  return success;
+}
+
 void HDFWalkerOutput::write_configuration(MCWalkerConfiguration& W, hdf_archive& hout, int nblock)
 {
   const int wb = OHMMS_DIM * number_of_particles;
@@ -19,6 +19,7 @@
 #include "Particle/MCWalkerConfiguration.h"
 // #include "QMCDrivers/ForwardWalking/ForwardWalkingStructure.h"
 #include <utility>
+#include <future>
 #include "hdf/hdf_archive.h"
 
 namespace qmcplusplus
@@ -62,12 +63,45 @@ public:
   bool dump(MCWalkerConfiguration& w, int block);
   //     bool dump(ForwardWalkingHistoryObject& FWO);
 
+  /** enable or disable writing the checkpoint files in the background
+   *
+   * In the background mode, dump gathers a snapshot of the walkers to the master
+   * which writes it in a separate thread while the caller continues.
+   * The file is written under a temporary name and renamed only after it is complete.
+   * Requires a thread-safe HDF5 library, otherwise the write is done in the foreground.
+   */
+  void setBackgroundWrite(bool background);
+
+  /** wait for the completion of the pending background write and report its status
+   * @return false if the pending write failed
+   */
+  bool waitForBackgroundWrite();
+
+  /** add a file of the same block as the next dump, to be renamed once its walker file is complete
+   * @param staged_name name the file was written to
+   * @param final_name name of the checkpoint file
+   *
+   * Only used in the background mode. The master renames the file after the walker file of the next dump is
+   * in place, so the files of a checkpoint never mix blocks. The staged file is removed if the walker file fails.
+   */
+  void addCompanionFile(const std::string& staged_name, const std::string& final_name);
+
 private:
   ///PooledData<T> is used to define the shape of multi-dimensional array
   typedef PooledData<OHMMS_PRECISION> BufferType;
   std::vector<Communicate::request> myRequest;
   std::vector<BufferType*> RemoteData;
   int block;
+  ///if true, write the checkpoint files in the background
+  bool background_write_;
+  ///true if the HDF5 library allows writing from a separate thread
+  bool hdf5_thread_safe_;
+  ///status of the pending background write
+  std::future<bool> pending_write_;
+  ///snapshot of the walker partition for the background write
+  std::vector<int> pending_offsets_;
+  ///staged and final names of the files committed with the next background write
+  std::vector<std::pair<std::string, std::string>> companion_files_;
 
   //     //define some types for the FW collection
   //     typedef std::vector<ForwardWalkingData> FWBufferType;
@@ -75,6 +109,21 @@ private:
   //     std::vector<std::vector<int> > FWCountData;
 
   void write_configuration(MCWalkerConfiguration& W, hdf_archive& hout, int block);
+
+  ///gather the walkers to the master and hand them over to a background write
+  bool dump_background(MCWalkerConfiguration& W, int block);
+
+  /** write the gathered walkers to a file by the master only
+   * @param fname final file name, the data is written to fname.tmp first
+   * @param nblock current block
+   * @param walker_data buffer holding all the walkers
+   * @param companions staged files renamed after the walker file
+   * @return true if the file and its companions are complete
+   */
+  bool write_snapshot(const std::string& fname,
+                      int nblock,
+                      BufferType& walker_data,
+                      const std::vector<std::pair<std::string, std::string>>& companions);
 };
 
 } // namespace qmcplusplus
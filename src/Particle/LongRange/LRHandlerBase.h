@@ -121,6 +121,51 @@ struct LRHandlerBase
     return vk;
   }
 
+  /** expand Fk_symm to all the k-points
+   * @param kshell degeneracies of the vectors
+   * @param fk \f$F_{k}\f$ of the k-points [0, kshell[MaxKshell])
+   */
+  inline void expandFk(const std::vector<int>& kshell, std::vector<mRealType>& fk) const
+  {
+    fk.resize(kshell[MaxKshell]);
+    for (int ks = 0; ks < MaxKshell; ks++)
+      std::fill(fk.begin() + kshell[ks], fk.begin() + kshell[ks + 1], Fk_symm[ks]);
+  }
+
+  /** evaluate \f$\sum_k F_{k} \rho^1_{-{\bf k}} \rho^2_{\bf k}\f$ of a batch of walkers
+   * @param fk \f$F_{k}\f$ of the k-points, see expandFk
+   * @param rk1_r_list real part of \f$\rho^1_{\bf k}\f$ of each walker
+   * @param rk1_i_list imaginary part of \f$\rho^1_{\bf k}\f$ of each walker
+   * @param rk2_r_list real part of \f$\rho^2_{\bf k}\f$ of each walker
+   * @param rk2_i_list imaginary part of \f$\rho^2_{\bf k}\f$ of each walker
+   * @param vk result of each walker
+   *
+   * Unlike evaluate, the sum over each walker is a single loop over k-points.
+   */
+  static void mw_evaluate(const std::vector<mRealType>& fk,
+                          const std::vector<const pRealType*>& rk1_r_list,
+                          const std::vector<const pRealType*>& rk1_i_list,
+                          const std::vector<const pRealType*>& rk2_r_list,
+                          const std::vector<const pRealType*>& rk2_i_list,
+                          std::vector<mRealType>& vk)
+  {
+    const int nk            = fk.size();
+    const mRealType* fk_ptr = fk.data();
+    vk.resize(rk1_r_list.size());
+    for (int iw = 0; iw < rk1_r_list.size(); iw++)
+    {
+      const pRealType* restrict rk1_r = rk1_r_list[iw];
+      const pRealType* restrict rk1_i = rk1_i_list[iw];
+      const pRealType* restrict rk2_r = rk2_r_list[iw];
+      const pRealType* restrict rk2_i = rk2_i_list[iw];
+      mRealType v                     = 0.0;
+#pragma omp simd reduction(+ : v)
+      for (int ki = 0; ki < nk; ki++)
+        v += fk_ptr[ki] * (rk1_r[ki] * rk2_r[ki] + rk1_i[ki] * rk2_i[ki]);
+      vk[iw] = v;
+    }
+  }
+
   /** Evaluate the long-range potential with the open BC for the D-1 direction */
   virtual mRealType evaluate_slab(pRealType z,
                                   const std::vector<int>& kshell,
@@ -44,6 +44,9 @@ void StructFact::UpdateNewCell(ParticleSet& P, RealType kc)
   KLists.UpdateKLists(P.LRBox, kc);
   //resize any array
   resize(P.getSpeciesSet().size(), P.getTotalNum(), KLists.numk);
+#if defined(USE_REAL_STRUCT_FACTOR)
+  setupPhaseTables(P);
+#endif
   //Compute the entire Rhok
   FillRhok(P);
 }
@@ -61,6 +64,8 @@ void StructFact::resize(int ns, int nptcl, int nkpts)
   }
   eikr_r_temp.resize(nkpts);
   eikr_i_temp.resize(nkpts);
+  eikr_r_old.resize(nkpts);
+  eikr_i_old.resize(nkpts);
 #else
   rhok.resize(ns, nkpts);
   eikr.resize(nptcl, nkpts);
@@ -71,68 +76,155 @@ void StructFact::resize(int ns, int nptcl, int nkpts)
 
 void StructFact::UpdateAllPart(ParticleSet& P) { FillRhok(P); }
 
-
-/** evaluate rok per species, eikr  per particle
- */
-void StructFact::FillRhok(ParticleSet& P)
+void StructFact::mw_updateAllPart(const RefVector<StructFact>& sk_list, const RefVector<ParticleSet>& p_list)
 {
-  int npart = P.getTotalNum();
 #if defined(USE_REAL_STRUCT_FACTOR)
-  rhok_r = 0.0;
-  rhok_i = 0.0;
-  //algorithmA
+  const int nw = sk_list.size();
+  const int nk = sk_list[0].get().KLists.numk;
+#pragma omp parallel
+  {
+#pragma omp for
+    for (int iw = 0; iw < nw; iw++)
+      sk_list[iw].get().computeAllPhases(p_list[iw]);
+
+#pragma omp for
+    for (int first = 0; first < nk; first += KBlockSize)
+      for (int iw = 0; iw < nw; iw++)
+        sk_list[iw].get().accumulateRhok(p_list[iw], first, std::min(first + KBlockSize, nk));
+  }
+#else
+#pragma omp parallel for
+  for (int iw = 0; iw < sk_list.size(); iw++)
+    sk_list[iw].get().UpdateAllPart(p_list[iw]);
+#endif
+}
+
+#if defined(USE_REAL_STRUCT_FACTOR)
+void StructFact::setupPhaseTables(ParticleSet& P)
+{
   const int nk = KLists.numk;
-  if (StorePerParticle)
+  int nphases  = 0;
+  for (int d = 0; d < DIM; d++)
   {
-    // save per particle and species value
-    for (int i = 0; i < npart; ++i)
+    PosType unit_k;
+    unit_k[d]       = 1;
+    kbasis[d]       = P.LRBox.k_cart(unit_k);
+    phase_origin[d] = nphases + KLists.mmax[d];
+    nphases += 2 * KLists.mmax[d] + 1;
+  }
+
+  kindex.resize(DIM, nk);
+  for (int ki = 0; ki < nk; ki++)
+    for (int d = 0; d < DIM; d++)
     {
-      const auto& pos           = P.R[i];
-      auto* restrict eikr_r_ptr = eikr_r[i];
-      auto* restrict eikr_i_ptr = eikr_i[i];
-      auto* restrict rhok_r_ptr = rhok_r[P.GroupID[i]];
-      auto* restrict rhok_i_ptr = rhok_i[P.GroupID[i]];
-#pragma omp simd
-      for (int ki = 0; ki < nk; ki++)
-      {
-        qmcplusplus::sincos(dot(KLists.kpts_cart[ki], pos), &eikr_i_ptr[ki], &eikr_r_ptr[ki]);
-        rhok_r_ptr[ki] += eikr_r_ptr[ki];
-        rhok_i_ptr[ki] += eikr_i_ptr[ki];
-      }
+      assert(std::abs(KLists.kpts[ki][d]) <= KLists.mmax[d]);
+      kindex[d][ki] = phase_origin[d] + KLists.kpts[ki][d];
+    }
+
+  phase_r.resize(P.getTotalNum(), nphases);
+  phase_i.resize(P.getTotalNum(), nphases);
+  phase_r_temp.resize(nphases);
+  phase_i_temp.resize(nphases);
+}
+
+void StructFact::computePhases(const PosType& pos, RealType* restrict pr, RealType* restrict pi) const
+{
+  for (int d = 0; d < DIM; d++)
+  {
+    // the recurrence is carried out in full precision to keep the error of large |m| small
+    FullPrecRealType theta = 0;
+    for (int j = 0; j < DIM; j++)
+      theta += static_cast<FullPrecRealType>(kbasis[d][j]) * pos[j];
+    FullPrecRealType s1, c1;
+    qmcplusplus::sincos(theta, &s1, &c1);
+
+    RealType* restrict pr_d = pr + phase_origin[d];
+    RealType* restrict pi_d = pi + phase_origin[d];
+    FullPrecRealType c(1), s(0);
+    pr_d[0] = c;
+    pi_d[0] = s;
+    for (int m = 1; m <= KLists.mmax[d]; m++)
+    {
+      const FullPrecRealType c_next = c * c1 - s * s1;
+      s                             = s * c1 + c * s1;
+      c                             = c_next;
+      pr_d[m]                       = c;
+      pi_d[m]                       = s;
+      pr_d[-m]                      = c;
+      pi_d[-m]                      = -s;
     }
   }
-  else
+}
+
+void StructFact::computeEikr(const RealType* restrict pr,
+                             const RealType* restrict pi,
+                             int first,
+                             int last,
+                             RealType* restrict eikr_r_ptr,
+                             RealType* restrict eikr_i_ptr) const
+{
+  const int* restrict kindex0 = kindex[0];
+#pragma omp simd
+  for (int ki = first; ki < last; ki++)
   {
-    // save per species value
-    for (int i = 0; i < npart; ++i)
+    RealType re = pr[kindex0[ki]];
+    RealType im = pi[kindex0[ki]];
+    for (int d = 1; d < DIM; d++)
     {
-      const auto& pos           = P.R[i];
-      auto* restrict rhok_r_ptr = rhok_r[P.GroupID[i]];
-      auto* restrict rhok_i_ptr = rhok_i[P.GroupID[i]];
-#ifdef __INTEL_COMPILER
+      const int j         = kindex[d][ki];
+      const RealType re_d = re * pr[j] - im * pi[j];
+      im                  = re * pi[j] + im * pr[j];
+      re                  = re_d;
+    }
+    eikr_r_ptr[ki] = re;
+    eikr_i_ptr[ki] = im;
+  }
+}
+
+void StructFact::computeAllPhases(ParticleSet& P)
+{
+  for (int i = 0; i < P.getTotalNum(); ++i)
+    computePhases(P.R[i], phase_r[i], phase_i[i]);
+}
+
+void StructFact::accumulateRhok(ParticleSet& P, int first, int last)
+{
+  for (int ig = 0; ig < rhok_r.rows(); ig++)
+  {
+    std::fill(rhok_r[ig] + first, rhok_r[ig] + last, RealType(0));
+    std::fill(rhok_i[ig] + first, rhok_i[ig] + last, RealType(0));
+  }
+
+  for (int i = 0; i < P.getTotalNum(); ++i)
+  {
+    // blocks of eikr_r_temp and eikr_i_temp are disjoint between threads
+    RealType* restrict eikr_r_ptr = StorePerParticle ? eikr_r[i] : eikr_r_temp.data();
+    RealType* restrict eikr_i_ptr = StorePerParticle ? eikr_i[i] : eikr_i_temp.data();
+    RealType* restrict rhok_r_ptr = rhok_r[P.GroupID[i]];
+    RealType* restrict rhok_i_ptr = rhok_i[P.GroupID[i]];
+    computeEikr(phase_r[i], phase_i[i], first, last, eikr_r_ptr, eikr_i_ptr);
 #pragma omp simd
-      for (int ki = 0; ki < nk; ki++)
-      {
-        RealType s, c;
-        qmcplusplus::sincos(dot(KLists.kpts_cart[ki], pos), &s, &c);
-        rhok_r_ptr[ki] += c;
-        rhok_i_ptr[ki] += s;
-      }
-#else
-      for (int ki = 0; ki < nk; ki++)
-        phiV[ki] = dot(KLists.kpts_cart[ki], pos);
-      eval_e2iphi(nk, phiV.data(), eikr_r_temp.data(), eikr_i_temp.data());
-      for (int ki = 0; ki < nk; ki++)
-      {
-        rhok_r_ptr[ki] += eikr_r_temp[ki];
-        rhok_i_ptr[ki] += eikr_i_temp[ki];
-      }
-#endif
+    for (int ki = first; ki < last; ki++)
+    {
+      rhok_r_ptr[ki] += eikr_r_ptr[ki];
+      rhok_i_ptr[ki] += eikr_i_ptr[ki];
     }
   }
+}
+#endif
+
+/** evaluate rok per species, eikr  per particle
+ */
+void StructFact::FillRhok(ParticleSet& P)
+{
+#if defined(USE_REAL_STRUCT_FACTOR)
+  const int nk = KLists.numk;
+  computeAllPhases(P);
+  for (int first = 0; first < nk; first += KBlockSize)
+    accumulateRhok(P, first, std::min(first + KBlockSize, nk));
 #else
   rhok = 0.0;
-  for (int i = 0; i < npart; i++)
+  for (int i = 0; i < P.getTotalNum(); i++)
   {
     PosType pos(P.R[i]);
     RealType s, c; //get sin and cos
@@ -152,9 +244,8 @@ void StructFact::FillRhok(ParticleSet& P)
 void StructFact::makeMove(int active, const PosType& pos)
 {
 #if defined(USE_REAL_STRUCT_FACTOR)
-#pragma omp simd
-  for (int ki = 0; ki < KLists.numk; ki++)
-    qmcplusplus::sincos(dot(KLists.kpts_cart[ki], pos), &eikr_i_temp[ki], &eikr_r_temp[ki]);
+  computePhases(pos, phase_r_temp.data(), phase_i_temp.data());
+  computeEikr(phase_r_temp.data(), phase_i_temp.data(), 0, KLists.numk, eikr_r_temp.data(), eikr_i_temp.data());
 #else
   RealType s, c; //get sin and cos
   for (int ki = 0; ki < KLists.numk; ++ki)
@@ -187,14 +278,14 @@ void StructFact::acceptMove(int active, int gid, const PosType& rold)
     RealType* restrict rhok_ptr_r(rhok_r[gid]);
     RealType* restrict rhok_ptr_i(rhok_i[gid]);
 
+    computePhases(rold, phase_r_temp.data(), phase_i_temp.data());
+    computeEikr(phase_r_temp.data(), phase_i_temp.data(), 0, KLists.numk, eikr_r_old.data(), eikr_i_old.data());
 // add the new value and subtract the old value
 #pragma omp simd
     for (int ki = 0; ki < KLists.numk; ++ki)
     {
-      RealType s, c;
-      qmcplusplus::sincos(dot(KLists.kpts_cart[ki], rold), &s, &c);
-      rhok_ptr_r[ki] += eikr_r_temp[ki] - c;
-      rhok_ptr_i[ki] += eikr_i_temp[ki] - s;
+      rhok_ptr_r[ki] += eikr_r_temp[ki] - eikr_r_old[ki];
+      rhok_ptr_i[ki] += eikr_i_temp[ki] - eikr_i_old[ki];
     }
   }
 #else
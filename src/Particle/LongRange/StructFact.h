@@ -19,6 +19,7 @@
 #include "Utilities/PooledData.h"
 #include "LongRange/KContainer.h"
 #include "OhmmsPETE/OhmmsVector.h"
+#include "type_traits/template_types.hpp"
 
 namespace qmcplusplus
 {
@@ -29,6 +30,11 @@ namespace qmcplusplus
  *   Rhok[alpha][k] \f$ \equiv \rho_{k}^{\alpha} = \sum_{i} e^{i{\bf k}\cdot{\bf r_i}}\f$
  * Structure factor per particle
  *   eikr[i][k]
+ *
+ * With USE_REAL_STRUCT_FACTOR, \f$e^{i{\bf k}\cdot{\bf r}}\f$ is not computed by a sincos per k-point.
+ * Each k-point is an integer combination of the reciprocal cell vectors, \f${\bf k}=\sum_d m_d{\bf b}_d\f$,
+ * and the factors \f$e^{im\theta_d}\f$, \f$\theta_d={\bf b}_d\cdot{\bf r}\f$, of each direction
+ * are tabulated by recurrence. Then \f$e^{i{\bf k}\cdot{\bf r}}\f$ is the product of DIM table entries.
  */
 class StructFact : public QMCTraits
 {
@@ -81,6 +87,15 @@ public:
    */
   void UpdateAllPart(ParticleSet& P);
 
+  /** Update Rhok of a batch of walkers if all particles moved
+   * @param sk_list the list of StructFact in a walker batch
+   * @param p_list the list of ParticleSet in a walker batch
+   *
+   * The k-points are split into blocks and each block is updated for all the walkers,
+   * so that the threads share the walkers and a block of Rhok stays in cache over the particle loop.
+   */
+  static void mw_updateAllPart(const RefVector<StructFact>& sk_list, const RefVector<ParticleSet>& p_list);
+
   /** evaluate eikr_temp for eikr for the proposed move
    * @param active index of the moved particle
    * @param pos proposed position
@@ -162,6 +177,38 @@ public:
   void turnOnStorePerParticle(ParticleSet& P);
 
 private:
+#if defined(USE_REAL_STRUCT_FACTOR)
+  ///number of k-points per block in FillRhok and mw_updateAllPart
+  static constexpr int KBlockSize = 256;
+  ///k_cart of the unit translations of the reciprocal cell
+  TinyVector<PosType, DIM> kbasis;
+  ///position of m=0 of each direction in a row of the phase tables
+  TinyVector<int, DIM> phase_origin;
+  ///index of the phase factor of each k-point in a row of the phase tables, kindex[d][k]
+  Matrix<int> kindex;
+  ///exp(i m theta_d) of all the particles, phase_r[i][phase_origin[d]+m]
+  Matrix<RealType> phase_r, phase_i;
+  ///phase tables of a single position
+  Vector<RealType> phase_r_temp, phase_i_temp;
+  ///eikr of the old position used by acceptMove
+  Vector<RealType> eikr_r_old, eikr_i_old;
+
+  ///build the tables mapping k-points to phase factors
+  void setupPhaseTables(ParticleSet& P);
+  ///compute exp(i m theta_d) of pos for all the directions
+  void computePhases(const PosType& pos, RealType* restrict pr, RealType* restrict pi) const;
+  ///compute eikr of the k-points [first, last) from the phase tables of a position
+  void computeEikr(const RealType* restrict pr,
+                   const RealType* restrict pi,
+                   int first,
+                   int last,
+                   RealType* restrict eikr_r_ptr,
+                   RealType* restrict eikr_i_ptr) const;
+  ///compute phase_r and phase_i of all the particles
+  void computeAllPhases(ParticleSet& P);
+  ///compute rhok and eikr of the k-points [first, last) from phase_r and phase_i
+  void accumulateRhok(ParticleSet& P, int first, int last);
+#endif
   ///Compute all rhok elements from the start
   void FillRhok(ParticleSet& P);
   /** resize the internal data
@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "Configuration.h"
+#include "Lattice/CrystalLattice.h"
+#include "Particle/ParticleSet.h"
+#include "LongRange/StructFact.h"
+
+namespace qmcplusplus
+{
+using RealType = QMCTraits::RealType;
+using PosType  = QMCTraits::PosType;
+
+/// rho_k of a species by summing exp(ik.r) directly
+void checkRhok(const ParticleSet& P, const StructFact& SK, int ig)
+{
+  const auto& klists = SK.KLists;
+  for (int ki = 0; ki < klists.numk; ki++)
+  {
+    RealType rhok_r(0), rhok_i(0);
+    for (int i = P.first(ig); i < P.last(ig); i++)
+    {
+      const RealType phase = dot(klists.kpts_cart[ki], P.R[i]);
+      rhok_r += std::cos(phase);
+      rhok_i += std::sin(phase);
+    }
+#if defined(USE_REAL_STRUCT_FACTOR)
+    REQUIRE(SK.rhok_r[ig][ki] == Approx(rhok_r).margin(1e-5));
+    REQUIRE(SK.rhok_i[ig][ki] == Approx(rhok_i).margin(1e-5));
+#else
+    REQUIRE(std::real(SK.rhok[ig][ki]) == Approx(rhok_r).margin(1e-5));
+    REQUIRE(std::imag(SK.rhok[ig][ki]) == Approx(rhok_i).margin(1e-5));
+#endif
+  }
+}
+
+TEST_CASE("StructFact rhok", "[lrhandler]")
+{
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> Lattice;
+  Lattice.BoxBConds = true;
+  Lattice.R         = {3.0, 0.5, 0.0, 0.0, 3.5, 0.3, 0.2, 0.0, 4.0};
+  Lattice.reset();
+
+  ParticleSet elec;
+  elec.setName("e");
+  elec.Lattice = Lattice;
+  elec.LRBox   = Lattice;
+  std::vector<int> agroup(2, 2);
+  elec.create(agroup);
+  elec.R[0] = {0.1, 0.2, 0.3};
+  elec.R[1] = {1.4, -0.7, 2.2};
+  elec.R[2] = {-2.0, 3.1, 0.5};
+  elec.R[3] = {2.6, 1.9, -1.3};
+  SpeciesSet& tspecies = elec.getSpeciesSet();
+  tspecies.addSpecies("u");
+  tspecies.addSpecies("d");
+  elec.resetGroups();
+
+  const RealType kc = 12.0;
+  StructFact SK(elec, kc);
+  REQUIRE(SK.KLists.numk > 300);
+  checkRhok(elec, SK, 0);
+  checkRhok(elec, SK, 1);
+
+  SK.DoUpdate = true;
+  const PosType rold(elec.R[2]);
+  const PosType rnew(-1.2, 2.4, 1.1);
+  SK.makeMove(2, rnew);
+  SK.acceptMove(2, elec.GroupID[2], rold);
+  elec.R[2] = rnew;
+  checkRhok(elec, SK, 0);
+  checkRhok(elec, SK, 1);
+
+  // a walker batch
+  ParticleSet elec_clone(elec);
+  elec_clone.R[0] = {0.7, -1.1, 0.9};
+  elec_clone.R[3] = {-0.4, 0.8, 3.3};
+  StructFact SK_clone(SK);
+  RefVector<StructFact> sk_list{SK, SK_clone};
+  RefVector<ParticleSet> p_list{elec, elec_clone};
+  StructFact::mw_updateAllPart(sk_list, p_list);
+  checkRhok(elec, SK, 0);
+  checkRhok(elec, SK, 1);
+  checkRhok(elec_clone, SK_clone, 0);
+  checkRhok(elec_clone, SK_clone, 1);
+}
+
+} // namespace qmcplusplus
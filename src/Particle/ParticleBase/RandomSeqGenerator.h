@@ -64,6 +64,13 @@ inline void assignGaussRand(T* restrict a, unsigned n, RG& rng)
   }
 }
 
+///bulk generation with the counter-based engine
+template<class T, class U>
+inline void assignGaussRand(T* restrict a, unsigned n, PhiloxRandom<U>& rng)
+{
+  rng.generate_normal(a, n);
+}
+
 /*!\fn template<class T> void assignUniformRand(T* restrict a, unsigned n)
   *\param a the starting pointer
   *\param n the number of type T to be assigned
@@ -416,9 +416,11 @@ void ParticleSet::flex_update(const RefVector<ParticleSet>& p_list, bool skipSK)
 
     if (!skipSK && p_list[0].get().SK)
     {
-#pragma omp parallel for
-      for (int iw = 0; iw < p_list.size(); iw++)
-        p_list[iw].get().SK->UpdateAllPart(p_list[iw]);
+      RefVector<StructFact> sk_list;
+      sk_list.reserve(p_list.size());
+      for (ParticleSet& pset : p_list)
+        sk_list.push_back(*pset.SK);
+      StructFact::mw_updateAllPart(sk_list, p_list);
     }
   }
   else if (p_list.size() == 1)
@@ -32,6 +32,7 @@
 #include "CUDA_legacy/gpu_vector.h"
 #endif
 #include <assert.h>
+#include <cstring>
 #include <deque>
 namespace qmcplusplus
 {
@@ -424,6 +425,27 @@ public:
     return DataSet.byteSize();
   }
 
+  /** byte size of the walker block of DataSet
+   *
+   * The walker data is registered first and occupies the head of both the array and the scalar parts of DataSet.
+   * The data appended later by ParticleSet and TrialWaveFunction is not included.
+   */
+  inline size_t walkerBlockByteSize() const { return block_end + scalar_end * sizeof(FullPrecRealType); }
+
+  /// copy the walker block of DataSet to a contiguous message of walkerBlockByteSize() bytes
+  inline void packWalkerBlock(char* msg)
+  {
+    std::memcpy(msg, DataSet.data(), block_end);
+    std::memcpy(msg + block_end, DataSet.data() + DataSet.scalar_offset(), scalar_end * sizeof(FullPrecRealType));
+  }
+
+  /// copy a message made by packWalkerBlock back to the walker block of DataSet
+  inline void unpackWalkerBlock(const char* msg)
+  {
+    std::memcpy(DataSet.data(), msg, block_end);
+    std::memcpy(DataSet.data() + DataSet.scalar_offset(), msg + block_end, scalar_end * sizeof(FullPrecRealType));
+  }
+
   void registerData()
   {
     // walker data must be placed at the beginning
@@ -21,6 +21,7 @@
 #include "QMCDrivers/WalkerProperties.h"
 
 #include <stdio.h>
+#include <fstream>
 #include <string>
 
 using std::string;
@@ -113,6 +114,62 @@ TEST_CASE("walker HDF read and write", "[particle]")
   }
 }
 
+TEST_CASE("walker HDF background write", "[particle]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  MCWalkerConfiguration W;
+  W.setName("electrons");
+  W.create(1);
+  W.createWalkers(2);
+  for (int iw = 0; iw < 2; iw++)
+    for (int i = 0; i < 3; i++)
+      W[iw]->R[0][i] = 0.1 * (3 * iw + i) + c->rank();
+
+  std::vector<int> walker_offset(c->size() + 1);
+  for (int i = 0; i <= c->size(); i++)
+    walker_offset[i] = 2 * i;
+  W.setWalkerOffsets(walker_offset);
+
+  c->setName("walker_test_background");
+  HDFWalkerOutput hout(W, "walker_test_background", c);
+  hout.setBackgroundWrite(true);
+  // a file of the same block is renamed once the walker file is complete
+  const std::string staged_name("walker_test_background.tmp.companion");
+  const std::string final_name("walker_test_background.companion");
+  if (c->rank() == 0)
+  {
+    remove(final_name.c_str());
+    std::ofstream(staged_name) << "block 0" << std::endl;
+  }
+  hout.addCompanionFile(staged_name, final_name);
+  hout.dump(W, 0);
+  // walkers can change while the snapshot is written
+  W[0]->R[0][0] = -1.0;
+  REQUIRE(hout.waitForBackgroundWrite());
+  if (c->rank() == 0)
+  {
+    CHECK(std::ifstream(final_name).good());
+    CHECK_FALSE(std::ifstream(staged_name).good());
+  }
+
+  c->barrier();
+
+  MCWalkerConfiguration W2;
+  W2.setName("electrons");
+  W2.create(1);
+
+  HDFVersion version(0, 4);
+  HDFWalkerInput_0_4 hinp(W2, c, version);
+  bool okay = hinp.read_hdf5("walker_test_background");
+  REQUIRE(okay);
+
+  REQUIRE(W2.getActiveWalkers() == 2);
+  for (int iw = 0; iw < 2; iw++)
+    for (int i = 0; i < 3; i++)
+      REQUIRE(W2[iw]->R[0][i] == Approx(0.1 * (3 * iw + i) + c->rank()));
+}
+
 TEST_CASE("walker buffer add, update, restore", "[particle]")
 {
   int num_particles = 4;
@@ -110,6 +110,19 @@ void BranchIO<SFNB>::initAttributes()
   iParamName[6] = "brnachinterval";
 }
 
+template<class SFNB>
+std::string BranchIO<SFNB>::getFileName(const std::string& fname)
+{
+#if defined(HAVE_LIBBOOST)
+  return fname + ".qmc.xml";
+#else
+  //append .qmc.h5 if missing
+  if (fname.find("qmc.h5") >= fname.size())
+    return fname + ".qmc.h5";
+  return fname;
+#endif
+}
+
 template<class SFNB>
 bool BranchIO<SFNB>::write(const std::string& fname)
 {
@@ -134,15 +147,10 @@ bool BranchIO<SFNB>::write(const std::string& fname)
   put_histogram("state.variance", ref.VarianceHist, pt);
   put_histogram("state.r2accepted", ref.R2Accepted, pt);
   put_histogram("state.r2proposed", ref.R2Proposed, pt);
-  std::string xname = fname + ".qmc.xml";
-  write_xml(xname, pt);
+  write_xml(getFileName(fname), pt);
 #else
-  //append .qmc.h5 if missing
-  std::string h5name(fname);
-  if (fname.find("qmc.h5") >= fname.size())
-    h5name.append(".qmc.h5");
   hdf_archive dump(myComm);
-  hid_t fid = dump.create(h5name);
+  hid_t fid = dump.create(getFileName(fname));
   dump.push(hdf::main_state);
   dump.push(hdf::qmc_status);
   std::string v_header("tau:taueff:etrial:eref:branchmax:branchcutoff:branchfilter:sigma:acc_energy:acc_samples");
@@ -35,6 +35,8 @@ public:
   BranchIO(SFNB& source, Communicate* c) : ref(source), myComm(c) {}
 
   bool write(const std::string& fname);
+  ///name of the file written by write
+  static std::string getFileName(const std::string& fname);
   bool read(const std::string& fname);
   void bcast_state();
 
@@ -32,4 +32,35 @@ ContextForSteps::ContextForSteps(int num_walkers,
   walker_deltas_.resize(num_walkers * num_particles);
 }
 
+void ContextForSteps::nextWalkerDeltaRs(const RefVector<MCPWalker>& walkers,
+                                        int num_particles,
+                                        uint32_t run_seed,
+                                        uint32_t section_key,
+                                        uint32_t step)
+{
+#if defined(QMC_RNG_PHILOX) && !defined(USE_FAKE_RNG)
+  num_draw_walkers_ = walkers.size();
+  walker_deltas_.resize(num_draw_walkers_ * num_particles);
+  walker_accepts_.resize(num_draw_walkers_ * num_particles);
+  std::vector<PosType> deltas(num_particles);
+  std::vector<RealType> accepts(num_particles);
+  // keyed by the seed of the run, the seed of the context differs between crowds and ranks
+  RandomGenerator_t walker_rng(run_seed);
+  for (int iw = 0; iw < num_draw_walkers_; ++iw)
+  {
+    const uint64_t walker_id = static_cast<uint32_t>(walkers[iw].get().ID);
+    walker_rng.setStream((static_cast<uint64_t>(section_key) << 32) | walker_id, step);
+    makeGaussRandomWithEngine(deltas, walker_rng);
+    walker_rng.generate_uniform(accepts.data(), num_particles);
+    for (int iat = 0; iat < num_particles; ++iat)
+    {
+      walker_deltas_[iat * num_draw_walkers_ + iw]  = deltas[iat];
+      walker_accepts_[iat * num_draw_walkers_ + iw] = accepts[iat];
+    }
+  }
+#else
+  nextDeltaRs(walkers.size() * num_particles);
+#endif
+}
+
 } // namespace qmcplusplus
@@ -55,6 +55,31 @@ public:
     makeGaussRandomWithEngine(walker_deltas_, random_gen_);
   }
 
+  /** generate the deltas and the acceptance draws of a step of the crowd
+   * @param walkers walkers of the crowd
+   * @param num_particles number of particles per walker
+   * @param run_seed seed shared by all the contexts and ranks of the run
+   * @param section_key identifies the driver section
+   * @param step index of the step within the section
+   *
+   * With the counter-based PhiloxRandom (QMC_RNG_PHILOX) every walker draws from its own stream
+   * keyed by (run_seed, section_key, walker ID, step). The generator of the context is not used,
+   * so the moves of a walker do not depend on the crowd or the rank it is assigned to.
+   * Walker IDs must be unique. Other generators draw the deltas from the stream of the context
+   * and nextAcceptDraw falls back to the same stream.
+   */
+  void nextWalkerDeltaRs(const RefVector<MCPWalker>& walkers,
+                         int num_particles,
+                         uint32_t run_seed,
+                         uint32_t section_key,
+                         uint32_t step);
+
+  /// uniform number to accept the move of particle iat of walker iw in the current step
+  RealType nextAcceptDraw(int iat, int iw)
+  {
+    return walker_accepts_.empty() ? random_gen_() : walker_accepts_[iat * num_draw_walkers_ + iw];
+  }
+
   std::vector<PosType>& get_walker_deltas() { return walker_deltas_; }
   auto deltaRsBegin() { return walker_deltas_.begin(); };
 
@@ -63,6 +88,10 @@ public:
 
 protected:
   std::vector<PosType> walker_deltas_;
+  /// acceptance draws from the walker streams, same layout as walker_deltas_
+  std::vector<RealType> walker_accepts_;
+  /// number of walkers of the last nextWalkerDeltaRs
+  int num_draw_walkers_ = 0;
 
   /** indexes of start and stop of each particle group;
    *
@@ -114,6 +114,8 @@ void DMCBatched::advanceWalkers(const StateForThread& sft,
 
   const int num_walkers = crowd.size();
   //This generates an entire steps worth of deltas.
+  // Walkers spawned by branching share IDs (see WalkerControlBase::onRankSpawn),
+  // so DMC cannot use the per walker streams of ContextForSteps::nextWalkerDeltaRs yet.
   step_context.nextDeltaRs(num_walkers * sft.population.get_num_particles());
   auto it_delta_r = step_context.deltaRsBegin();
 
@@ -580,6 +582,7 @@ bool DMCBatched::run()
     }
     endBlock();
   }
+  branch_engine_->flushStatistics();
   return finalize(num_blocks, true);
 }
 
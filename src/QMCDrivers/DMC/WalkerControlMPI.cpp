@@ -13,12 +13,14 @@
 //////////////////////////////////////////////////////////////////////////////////////
 
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 
 #include "WalkerControlMPI.h"
 #include "Utilities/IteratorUtility.h"
 #include "Utilities/FairDivide.h"
+#include "Utilities/Timer.h"
 
 namespace qmcplusplus
 {
@@ -62,9 +64,21 @@ WalkerControlMPI::WalkerControlMPI(Communicate* c) : WalkerControlBase(c)
   SwapMode       = 1;
   Cur_min        = 0;
   Cur_max        = 0;
+  stats_pending_ = false;
+  stats_primed_  = false;
+  pending_iter_  = -1;
+  migration_costs_.fill(0.0);
+  migration_exchanges_ = 0;
+  minimal_migration_   = false;
   setup_timers(myTimers, DMCMPITimerNames, timer_level_medium);
 }
 
+WalkerControlMPI::~WalkerControlMPI()
+{
+  if (stats_pending_)
+    MPI_Wait(&stats_request_, MPI_STATUS_IGNORE);
+}
+
 /** Perform branch and swap walkers as required
  *
  *  It takes 5 steps:
@@ -141,6 +155,11 @@ int WalkerControlMPI::branch(int iter, MCWalkerConfiguration& W, FullPrecRealTyp
  *  In order to reduce the time for allocating walker memory,
  *  this algorithm does not destroy the bad walkers in step 1.
  *  All the dead walkers are reused in step 5 & 6. None are ever GC'd
+ *
+ *  With pipelined branching, step 2 only reduces the future number of walkers per rank
+ *  and the statistics are reduced by reduceStatistics in the background.
+ *  The future counts are reused for the load balancing and the global population
+ *  unless a population limit was applied, so one blocking collective remains instead of four.
  */
 QMCTraits::FullPrecRealType WalkerControlMPI::branch(int iter, MCPopulation& pop)
 {
@@ -160,15 +179,27 @@ QMCTraits::FullPrecRealType WalkerControlMPI::branch(int iter, MCPopulation& pop
   myTimers[DMC_MPI_allreduce]->start();
   // You might think we are just reducing LE and sent walkers but
   // see calcPopulationAdjustments massive side effects.
-  myComm->allreduce(curData);
+  const int stats_iter = reduceStatistics(iter);
+  std::vector<IndexType> num_per_node;
+  if (pipelined_branching_)
+    num_per_node = WalkerControlBase::syncFutureWalkersPerRank(myComm, adjust.num_walkers);
   myTimers[DMC_MPI_allreduce]->stop();
-  measureProperties(iter);
+  // the ensemble properties of the previous step are kept while the pipeline fills
+  if (stats_iter >= 0)
+    measureProperties(stats_iter);
 
   pop.set_ensemble_property(ensemble_property_);
 
-  limitPopulation(adjust);
-
-  auto num_per_node = WalkerControlBase::syncFutureWalkersPerRank(myComm, adjust.num_walkers);
+  if (pipelined_branching_)
+  {
+    if (limitPopulation(adjust, num_per_node))
+      num_per_node = WalkerControlBase::syncFutureWalkersPerRank(myComm, adjust.num_walkers);
+  }
+  else
+  {
+    limitPopulation(adjust);
+    num_per_node = WalkerControlBase::syncFutureWalkersPerRank(myComm, adjust.num_walkers);
+  }
 
   myTimers[DMC_MPI_prebalance]->stop();
   myTimers[DMC_MPI_loadbalance]->start();
@@ -188,7 +219,10 @@ QMCTraits::FullPrecRealType WalkerControlMPI::branch(int iter, MCPopulation& pop
   }
 
   // Update to the current population
-  pop.syncWalkersPerNode(myComm);
+  if (pipelined_branching_)
+    pop.set_num_global_walkers(std::accumulate(num_per_node.begin(), num_per_node.end(), 0));
+  else
+    pop.syncWalkersPerNode(myComm);
 
   for (UPtr<MCPWalker>& walker : pop.get_walkers())
   {
@@ -201,6 +235,47 @@ QMCTraits::FullPrecRealType WalkerControlMPI::branch(int iter, MCPopulation& pop
   return pop.get_num_global_walkers();
 }
 
+int WalkerControlMPI::reduceStatistics(int iter)
+{
+  if (!pipelined_branching_)
+  {
+    myComm->allreduce(curData);
+    return iter;
+  }
+
+  if (!stats_primed_)
+  {
+    // the first step is reduced exactly and nothing is posted
+    myComm->allreduce(curData);
+    pending_stats_.resize(LE_MAX);
+    stats_primed_ = true;
+    return iter;
+  }
+
+  const int reduced_iter = stats_pending_ ? pending_iter_ : -1;
+  if (stats_pending_)
+    MPI_Wait(&stats_request_, MPI_STATUS_IGNORE);
+
+  // post the reduction of this step and hand back the previous one
+  std::swap_ranges(curData.begin(), curData.begin() + LE_MAX, pending_stats_.begin());
+  MPI_Iallreduce(MPI_IN_PLACE, pending_stats_.data(), LE_MAX, mpi::get_mpi_datatype(pending_stats_[0]), MPI_SUM,
+                 myComm->getMPI(), &stats_request_);
+  stats_pending_ = true;
+  pending_iter_  = iter;
+  return reduced_iter;
+}
+
+void WalkerControlMPI::flushStatistics()
+{
+  if (!stats_pending_)
+    return;
+  MPI_Wait(&stats_request_, MPI_STATUS_IGNORE);
+  stats_pending_ = false;
+  stats_primed_  = false;
+  std::copy(pending_stats_.begin(), pending_stats_.end(), curData.begin());
+  measureProperties(pending_iter_);
+}
+
 // determine new walker population on each node
 void WalkerControlMPI::determineNewWalkerPopulation(int cur_pop,
                                                     int num_contexts,
@@ -552,61 +627,76 @@ int WalkerControlMPI::swapWalkersSimple(MCPopulation& pop,
     }
   }
 
+  const bool minimal = useMinimalMigration();
+
   //create send requests
   std::vector<mpi3::request> send_requests;
+  // with minimal migration each message is packed in its own buffer
+  std::vector<std::vector<char>> send_buffers(minimal ? send_message_list.size() : 0);
 
   if (send_message_list.size() > 0)
   {
-    std::for_each(send_message_list.begin(), send_message_list.end(), [&send_requests, this](WalkerMessage& message) {
+    for (int im = 0; im < send_message_list.size(); im++)
+    {
+      WalkerMessage& message = send_message_list[im];
       MCPWalker& this_walker = message.walker_elements.walker;
-      ParticleSet& this_pset      = message.walker_elements.pset;
+      ParticleSet& this_pset = message.walker_elements.pset;
+      this_pset.saveWalker(this_walker);
+      this_walker.updateBuffer();
+      if (minimal)
+      {
+        send_buffers[im].resize(this_walker.walkerBlockByteSize());
+        this_walker.packWalkerBlock(send_buffers[im].data());
+        send_requests.emplace_back(
+            myComm->comm.isend_n(send_buffers[im].data(), send_buffers[im].size(), message.target_rank));
+        continue;
+      }
       // Most of these calls are unecessary,
       // evaluateLog definitely is but is invaluable for checking for the state of the walker before and after transfer
       // \todo narrow these down to a minimum and manage to reason out the state of a valid fat walker.
-      this_pset.saveWalker(this_walker);
-      this_walker.updateBuffer();
       TrialWaveFunction& this_twf = message.walker_elements.twf;
 #ifndef NDEBUG
       this_twf.evaluateLog(this_pset);
 #endif
       this_twf.updateBuffer(this_pset, this_walker.DataSet);
-      send_requests.emplace_back(myComm->comm.isend_n(message.walker_elements.walker.DataSet.data(),
-                                                      message.walker_elements.walker.DataSet.size(),
-                                                      message.target_rank));
-    });
+      send_requests.emplace_back(
+          myComm->comm.isend_n(this_walker.DataSet.data(), this_walker.DataSet.size(), message.target_rank));
+    }
   }
 
   //create recv requests
   std::vector<mpi3::request> recv_requests;
-  if (recv_message_list.size() > 0)
+  std::vector<std::vector<char>> recv_buffers(minimal ? recv_message_list.size() : 0);
+  for (int im = 0; im < recv_message_list.size(); im++)
   {
-    std::for_each(recv_message_list.begin(), recv_message_list.end(), [&recv_requests, this](WalkerMessage& message) {
-      recv_requests.emplace_back(myComm->comm.ireceive_n(message.walker_elements.walker.DataSet.data(),
-                                                         message.walker_elements.walker.DataSet.size(),
-                                                         message.source_rank));
-      size_t dsize = message.walker_elements.walker.DataSet.size();
-    });
+    WalkerMessage& message = recv_message_list[im];
+    MCPWalker& this_walker = message.walker_elements.walker;
+    if (minimal)
+    {
+      recv_buffers[im].resize(this_walker.walkerBlockByteSize());
+      recv_requests.emplace_back(
+          myComm->comm.ireceive_n(recv_buffers[im].data(), recv_buffers[im].size(), message.source_rank));
+    }
+    else
+      recv_requests.emplace_back(
+          myComm->comm.ireceive_n(this_walker.DataSet.data(), this_walker.DataSet.size(), message.source_rank));
   }
 
   if (recv_message_list.size() > 0)
   {
     myTimers[DMC_MPI_recv]->start();
+    Timer recv_clock;
     std::vector<int> recv_completed(recv_message_list.size(), 0);
-    std::vector<int> recv_waited(recv_message_list.size(), 0);
 
     while (std::any_of(recv_completed.begin(), recv_completed.end(), [](int i) { return i == 0; }))
     {
       for (int im = 0; im < recv_requests.size(); ++im)
       {
-        if (!recv_waited[im])
-        {
-          //recv_requests[im].wait();
-          recv_waited[im] = 1;
-        }
-
         if (!recv_completed[im] && recv_requests[im].completed())
         {
           MCPWalker& this_walker = recv_message_list[im].walker_elements.walker;
+          if (minimal)
+            this_walker.unpackWalkerBlock(recv_buffers[im].data());
           // This sequence of calls is our best effort to go from the wire to a working fat walker.
           // \todo narrow these down to a minimum and manage to reason out the state of a valid fat walker.
           this_walker.copyFromBuffer();
@@ -614,20 +704,36 @@ int WalkerControlMPI::swapWalkersSimple(MCPopulation& pop,
           this_walker.set_has_been_on_wire(true);
 #endif
           ParticleSet& this_pset      = recv_message_list[im].walker_elements.pset;
+          TrialWaveFunction& this_twf = recv_message_list[im].walker_elements.twf;
           this_pset.loadWalker(this_walker, true);
           // If this update isn't called then the Jastrow's will not match those in the sent walker.
           // The update call is required to update the internal state of pset used by TWF to do the
           // Jastrow evaluations in evaluateLog.
           this_pset.update();
-          TrialWaveFunction& this_twf = recv_message_list[im].walker_elements.twf;
-          this_twf.copyFromBuffer(this_pset, this_walker.DataSet);          
+          // with minimal migration only the walker block was sent and the wavefunction buffers
+          // are rebuilt from the positions alone
+          if (!minimal)
+            this_twf.copyFromBuffer(this_pset, this_walker.DataSet);
           this_twf.evaluateLog(this_pset);
           this_twf.updateBuffer(this_pset, this_walker.DataSet);
           recv_completed[im] = 1;
         }
       }
     }
+    const double recv_time = recv_clock.elapsed();
     myTimers[DMC_MPI_recv]->stop();
+
+    // the receiving side accounts the cost of the migration for the automatic policy
+    if (minimal)
+    {
+      migration_costs_[MINIMAL_TIME] += recv_time;
+      migration_costs_[MINIMAL_WALKERS] += recv_message_list.size();
+    }
+    else
+    {
+      migration_costs_[FULL_TIME] += recv_time;
+      migration_costs_[FULL_WALKERS] += recv_message_list.size();
+    }
   }
 
   if (send_message_list.size() > 0)
@@ -686,4 +792,43 @@ int WalkerControlMPI::swapWalkersSimple(MCPopulation& pop,
 }
 
 
+/** choose what is sent by the walker exchange of this branch
+ *
+ *  The automatic policy runs MigrationCalibrationExchanges exchanges with full migration and as many
+ *  with minimal migration, then sums the receiving costs over the ranks and keeps the mode with the lower
+ *  cost per received walker. The full cost is dominated by the transfer of the wavefunction buffers and the
+ *  minimal one by their rebuild. All the ranks call it once per branch, so they switch at the same exchange.
+ *  If no walker was received during one of the phases, the calibration starts over.
+ */
+bool WalkerControlMPI::useMinimalMigration()
+{
+  if (walker_migration_ == WalkerMigration::FULL)
+    return false;
+  if (walker_migration_ == WalkerMigration::MINIMAL)
+    return true;
+
+  if (migration_exchanges_ < 2 * MigrationCalibrationExchanges)
+    return migration_exchanges_++ >= MigrationCalibrationExchanges;
+
+  if (migration_exchanges_ == 2 * MigrationCalibrationExchanges)
+  {
+    std::vector<double> costs(migration_costs_.begin(), migration_costs_.end());
+    myComm->allreduce(costs);
+    std::fill(migration_costs_.begin(), migration_costs_.end(), 0.0);
+    if (costs[FULL_WALKERS] == 0 || costs[MINIMAL_WALKERS] == 0)
+    {
+      migration_exchanges_ = 1;
+      return false;
+    }
+    const double full_cost    = costs[FULL_TIME] / costs[FULL_WALKERS];
+    const double minimal_cost = costs[MINIMAL_TIME] / costs[MINIMAL_WALKERS];
+    minimal_migration_        = minimal_cost < full_cost;
+    migration_exchanges_++;
+    app_log() << "  WalkerControlMPI automatic walker migration: receiving a walker takes " << full_cost
+              << " s with full and " << minimal_cost << " s with minimal migration, using "
+              << (minimal_migration_ ? "minimal" : "full") << " migration" << std::endl;
+  }
+  return minimal_migration_;
+}
+
 } // namespace qmcplusplus
@@ -16,9 +16,11 @@
 #ifndef QMCPLUSPLUS_WALKER_CONTROL_MPI_H
 #define QMCPLUSPLUS_WALKER_CONTROL_MPI_H
 
+#include <array>
 #include "QMCDrivers/WalkerControlBase.h"
 #include "QMCDrivers/WalkerElementsRef.h"
 #include "Utilities/TimerManager.h"
+#include "mpi/mpi_datatype.h"
 
 namespace qmcplusplus
 {
@@ -64,6 +66,33 @@ struct WalkerControlMPI : public WalkerControlBase
   // This semi-persistent state is only here because we keep zeroing curData
   // defensively?
   IndexType NumWalkersSent;
+  /// pipelined branching: statistics of the step being reduced
+  std::vector<FullPrecRealType> pending_stats_;
+  /// pipelined branching: request of the reduction of pending_stats_
+  mpi::request stats_request_;
+  /// pipelined branching: true if stats_request_ is in flight
+  bool stats_pending_;
+  /// pipelined branching: true once the first step was reduced
+  bool stats_primed_;
+  /// pipelined branching: step of the statistics in pending_stats_
+  int pending_iter_;
+  /// automatic walker migration: number of exchanges in each calibration phase
+  static constexpr int MigrationCalibrationExchanges = 8;
+  /// automatic walker migration: indexes of migration_costs_
+  enum
+  {
+    FULL_TIME = 0,
+    FULL_WALKERS,
+    MINIMAL_TIME,
+    MINIMAL_WALKERS,
+    MIGRATION_COSTS_MAX
+  };
+  /// automatic walker migration: receiving time and number of walkers received with each mode on this rank
+  std::array<double, MIGRATION_COSTS_MAX> migration_costs_;
+  /// automatic walker migration: number of exchanges since the calibration started
+  int migration_exchanges_;
+  /// automatic walker migration: mode chosen after the calibration
+  bool minimal_migration_;
 
   /** default constructor
    *
@@ -71,6 +100,9 @@ struct WalkerControlMPI : public WalkerControlBase
    */
   WalkerControlMPI(Communicate* comm);
 
+  /** destructor, completes any reduction in flight */
+  ~WalkerControlMPI();
+
   /** creates the distribution plan
    *
    *  populates the minus and plus vectors they contain 1 copy of a partition index 
@@ -99,6 +131,23 @@ struct WalkerControlMPI : public WalkerControlBase
   /** unified driver: perform branch and swap walkers as required */
   FullPrecRealType branch(int iter, MCPopulation& pop);
 
+  /** unified: reduce the statistics curData[0, LE_MAX) over the ranks
+   *
+   * Without pipelined branching, it is a blocking allreduce.
+   * With pipelined branching, the reduction of this step is posted with a non-blocking allreduce
+   * and curData receives the completed reduction of the previous step, so the reduction
+   * overlaps with the crowds advancing the next step. The first call reduces the first step with a
+   * blocking allreduce and posts nothing. The second call only posts its step, so no statistics are
+   * returned by it and every step is measured once. The reduction posted by the last call is measured
+   * by flushStatistics.
+   * @param iter current step
+   * @return the step of the reduced statistics in curData or -1 if there are none
+   */
+  int reduceStatistics(int iter);
+
+  /** unified: measure the statistics of the last step still being reduced by pipelined branching */
+  void flushStatistics() override;
+
   /** legacy: swap implementation
    */
   void swapWalkersSimple(MCWalkerConfiguration& W);
@@ -112,6 +161,13 @@ struct WalkerControlMPI : public WalkerControlBase
    */
   int swapWalkersSimple(MCPopulation& pop, PopulationAdjustment& adjust, std::vector<IndexType>& num_per_node);
 
+  /** unified: true if the walker exchange of this branch sends only the walker block of DataSet
+   *
+   * Only the positions, properties and history of a walker are sent and the receiving rank rebuilds
+   * the wavefunction buffers by evaluateLog and updateBuffer. It must be called by all the ranks once per exchange.
+   */
+  bool useMinimalMigration();
+
   // Testing wrappers
   friend WalkerControlMPITest;
   friend testing::UnifiedDriverWalkerControlMPITest;
@@ -25,6 +25,7 @@
 #include "Message/Communicate.h"
 #include "Message/CommOperators.h"
 #include "OhmmsApp/RandomNumberControl.h"
+#include "QMCDrivers/BranchIO.h"
 #include "hdf/HDFVersion.h"
 #include "Utilities/qmc_common.h"
 #include <limits>
@@ -61,12 +62,13 @@ QMCDriver::QMCDriver(MCWalkerConfiguration& w,
       driver_scope_timer_(timer_manager.createTimer(QMC_driver_type, timer_level_coarse)),
       driver_scope_profiler_(enable_profiling)
 {
-  ResetRandom  = false;
-  AppendRun    = false;
-  DumpConfig   = false;
-  IsQMCDriver  = true;
-  allow_traces = false;
-  MyCounter    = 0;
+  ResetRandom          = false;
+  AppendRun            = false;
+  DumpConfig           = false;
+  BackgroundCheckpoint = false;
+  IsQMCDriver          = true;
+  allow_traces         = false;
+  MyCounter            = 0;
   //<parameter name=" "> value </parameter>
   //accept multiple names for the same value
   //recommend using all lower cases for a new parameter
@@ -234,6 +236,7 @@ void QMCDriver::process(xmlNodePtr cur)
   Estimators->put(H, cur);
   if (wOut == 0)
     wOut = new HDFWalkerOutput(W, RootName, myComm);
+  wOut->setBackgroundWrite(BackgroundCheckpoint);
   branchEngine->start(RootName);
   branchEngine->write(RootName);
   //use new random seeds
@@ -332,9 +335,25 @@ void QMCDriver::recordBlock(int block)
   if (DumpConfig && block % Period4CheckPoint == 0)
   {
     checkpointTimer->start();
-    wOut->dump(W, block);
-    branchEngine->write(RootName, true); //save energy_history
-    RandomNumberControl::write(RootName, myComm);
+    if (BackgroundCheckpoint)
+    {
+      // the branch and random files are staged and renamed with the walker file of this block once it is written.
+      // The staged files of the previous block are renamed before they are written again.
+      wOut->waitForBackgroundWrite();
+      const std::string staged_root = RootName + ".tmp";
+      branchEngine->write(staged_root, true); //save energy_history
+      RandomNumberControl::write(staged_root, myComm);
+      wOut->addCompanionFile(BranchIO<SimpleFixedNodeBranch>::getFileName(staged_root),
+                             BranchIO<SimpleFixedNodeBranch>::getFileName(RootName));
+      wOut->addCompanionFile(staged_root + ".random.h5", RootName + ".random.h5");
+      wOut->dump(W, block);
+    }
+    else
+    {
+      wOut->dump(W, block);
+      branchEngine->write(RootName, true); //save energy_history
+      RandomNumberControl::write(RootName, myComm);
+    }
     checkpointTimer->stop();
   }
 }
@@ -421,6 +440,7 @@ void QMCDriver::setWalkerOffsets()
  *   -- 1 = do not write anything
  *   -- 0 = dump after the completion of a qmc section
  *   -- n = dump after n blocks
+ * - <checkpoint background="yes|no"/> default=no, write the walker configurations in a background thread
  * - kdelay = "0|1|n" default=0
  */
 bool QMCDriver::putQMCInfo(xmlNodePtr cur)
@@ -471,10 +491,13 @@ bool QMCDriver::putQMCInfo(xmlNodePtr cur)
       }
       else if (cname == "checkpoint")
       {
+        std::string background("no");
         OhmmsAttributeSet rAttrib;
         rAttrib.add(Period4CheckPoint, "stride");
         rAttrib.add(Period4CheckPoint, "period");
+        rAttrib.add(background, "background");
         rAttrib.put(tcur);
+        BackgroundCheckpoint = (background == "yes");
         //DumpConfig=(Period4CheckPoint>0);
       }
       else if (cname == "dumpconfig")
@@ -200,6 +200,8 @@ protected:
   bool AppendRun;
   ///flag to turn off dumping configurations
   bool DumpConfig;
+  ///flag to write the checkpoint files in the background
+  bool BackgroundCheckpoint;
   ///true, if it is a real QMC engine
   bool IsQMCDriver;
   /** the number of times this QMCDriver is executed
@@ -299,6 +299,7 @@ void SFNBranch::branch(int iter, MCPopulation& population)
       {
         app_log() << "Switching to DMC with fluctuating populations" << std::endl;
         BranchMode.set(B_POPCONTROL, 1); //use standard DMC
+        WalkerController->flushStatistics();
         WalkerController       = std::move(BackupWalkerController);
         BackupWalkerController = 0;
         vParam[SBVP::ETRIAL]   = vParam[SBVP::EREF];
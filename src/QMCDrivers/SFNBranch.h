@@ -409,6 +409,14 @@ struct SFNBranch : public QMCTraits
    */
   void branch(int iter, MCPopulation& population);
 
+  /** measure the ensemble properties of the last steps still held by the walker controller
+   */
+  void flushStatistics()
+  {
+    if (WalkerController)
+      WalkerController->flushStatistics();
+  }
+
   /** restart averaging
    * @param counter Counter to determine the cummulative average will be reset.
    */
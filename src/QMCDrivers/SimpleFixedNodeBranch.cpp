@@ -749,7 +749,6 @@ bool SimpleFixedNodeBranch::put(xmlNodePtr cur)
 
 void SimpleFixedNodeBranch::write(const std::string& fname, bool overwrite)
 {
-  RootName = fname;
   if (MyEstimator->is_manager())
   {
     //\since 2008-06-24
@@ -451,6 +451,8 @@ struct SimpleFixedNodeBranch : public QMCTraits
   /** write the state
    * @param fname name of the configuration file
    * @param overwrite NOT USED
+   *
+   * RootName set by start is kept, finalize writes to it.
    */
   void write(const std::string& fname, bool overwrite = true);
 
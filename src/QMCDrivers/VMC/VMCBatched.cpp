@@ -15,6 +15,7 @@
 #include "Message/UniformCommunicateError.h"
 #include "Utilities/RunTimeManager.h"
 #include "ParticleBase/RandomSeqGenerator.h"
+#include "OhmmsApp/RandomNumberControl.h"
 #include "Particle/MCSample.h"
 
 namespace qmcplusplus
@@ -81,7 +82,9 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
   for (int sub_step = 0; sub_step < sft.qmcdrv_input.get_sub_steps(); sub_step++)
   {
     //This generates an entire steps worth of deltas.
-    step_context.nextDeltaRs(num_walkers * sft.population.get_num_particles());
+    const int num_sub_steps = sft.qmcdrv_input.get_sub_steps();
+    step_context.nextWalkerDeltaRs(walkers, sft.population.get_num_particles(), sft.run_seed, sft.section_key,
+                                   sft.section_step * num_sub_steps + sub_step);
 
     // up and down electrons are "species" within qmpack
     for (int ig = 0; ig < step_context.get_num_groups(); ++ig) //loop over species
@@ -147,7 +150,7 @@ void VMCBatched::advanceWalkers(const StateForThread& sft,
 
         for (int i_accept = 0; i_accept < num_walkers; ++i_accept)
           if (prob[i_accept] >= std::numeric_limits<RealType>::epsilon() &&
-              step_context.get_random_gen()() < prob[i_accept] * std::exp(log_gb[i_accept] - log_gf[i_accept]))
+              step_context.nextAcceptDraw(iat, i_accept) < prob[i_accept] * std::exp(log_gb[i_accept] - log_gf[i_accept]))
           {
             crowd.incAccept();
             isAccepted.push_back(true);
@@ -279,6 +282,8 @@ bool VMCBatched::run()
   estimator_manager_->start(num_blocks);
 
   StateForThread vmc_state(qmcdriver_input_, vmcdriver_input_, *drift_modifier_, population_);
+  vmc_state.section_key = static_cast<uint32_t>(std::hash<std::string>{}(root_name_));
+  vmc_state.run_seed    = RandomNumberControl::getOffset();
 
   LoopTimer<> vmc_loop;
   RunTimeControl<> runtimeControl(run_time_manager, MaxCPUSecs);
@@ -300,6 +305,7 @@ bool VMCBatched::run()
   for (int step = 0; step < qmcdriver_input_.get_warmup_steps(); ++step)
   {
     ScopedTimer local_timer(&(timers_.run_steps_timer));
+    vmc_state.section_step = step;
     crowd_task(crowds_.size(), runWarmupStep, vmc_state, std::ref(timers_), std::ref(step_contexts_),
                std::ref(crowds_));
   }
@@ -319,6 +325,8 @@ bool VMCBatched::run()
     {
       ScopedTimer local_timer(&(timers_.run_steps_timer));
       vmc_state.step = step;
+      vmc_state.section_step =
+          qmcdriver_input_.get_warmup_steps() + block * qmcdriver_input_.get_max_steps() + step;
       crowd_task(crowds_.size(), runVMCStep, vmc_state, timers_, std::ref(step_contexts_), std::ref(crowds_));
 
       if (collect_samples_)
@@ -54,6 +54,12 @@ public:
     IndexType step;
     int block;
     bool recomputing_blocks;
+    /// steps taken in this section including warmup, keys the walker random streams
+    IndexType section_step = 0;
+    /// identifies this section in the walker random streams
+    uint32_t section_key = 0;
+    /// seed of the run, the same on all the ranks, keys the walker random streams
+    uint32_t run_seed = 0;
 
     StateForThread(QMCDriverInput& qmci, VMCDriverInput& vmci, DriftModifierBase& drift_mod, MCPopulation& pop)
         : qmcdrv_input(qmci), vmcdrv_input(vmci), drift_modifier(drift_mod), population(pop)
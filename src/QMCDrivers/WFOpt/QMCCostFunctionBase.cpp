@@ -53,6 +53,8 @@ QMCCostFunctionBase::QMCCostFunctionBase(MCWalkerConfiguration& w,
       targetExcitedStr("no"),
       targetExcited(false),
       omega_shift(0.0),
+      recordsStorage("memory"),
+      scratchDir("."),
       msg_stream(0),
       m_wfPtr(NULL),
       m_doc_out(NULL),
@@ -339,11 +341,17 @@ bool QMCCostFunctionBase::put(xmlNodePtr q)
   m_param.add(GEVType, "GEVMethod", "string");
   m_param.add(targetExcitedStr, "targetExcited", "string");
   m_param.add(omega_shift, "omega", "double");
+  m_param.add(recordsStorage, "records_storage", "string");
+  m_param.add(scratchDir, "scratch_dir", "string");
   m_param.put(q);
 
   tolower(targetExcitedStr);
   targetExcited = (targetExcitedStr == "yes");
 
+  tolower(recordsStorage);
+  if (recordsStorage != "memory" && recordsStorage != "file")
+    APP_ABORT("QMCCostFunctionBase::put records_storage must be memory or file");
+
   if (includeNonlocalH == "yes")
     includeNonlocalH = "NonLocalECP";
 
@@ -150,6 +150,27 @@ public:
 
   virtual Return_rt fillOverlapHamiltonianMatrices(Matrix<Return_rt>& Left, Matrix<Return_rt>& Right) = 0;
 
+  /** prepare the matrix-free products with the matrices of fillOverlapHamiltonianMatrices
+   * @param left_diag return the diagonal of Left
+   * @param right_diag return the diagonal of Right
+   * @return false if the cost function can only build the full matrices
+   */
+  virtual bool prepareOverlapHamiltonianProducts(std::vector<Return_rt>& left_diag, std::vector<Return_rt>& right_diag)
+  {
+    return false;
+  }
+
+  /** compute Left*x and Right*x from the sample records without building the matrices
+   *
+   * prepareOverlapHamiltonianProducts must be called first. All the vectors have getNumParams()+1 elements.
+   */
+  virtual void applyOverlapHamiltonianMatrices(const std::vector<Return_rt>& x,
+                                               std::vector<Return_rt>& left_x,
+                                               std::vector<Return_rt>& right_x)
+  {
+    APP_ABORT("QMCCostFunctionBase::applyOverlapHamiltonianMatrices is not implemented by this cost function");
+  }
+
 #ifdef HAVE_LMY_ENGINE
   Return_rt LMYEngineCost(const bool needDeriv, cqmc::engine::LMYEngine<Return_t>* EngineObj);
 #endif
@@ -245,6 +266,10 @@ protected:
   bool targetExcited;
   ///the shift to use when targeting an excited state
   double omega_shift;
+  ///storage of the derivative records of the samples, memory or file
+  std::string recordsStorage;
+  ///directory of the scratch files used by recordsStorage = file
+  std::string scratchDir;
 
   ///list of optimizables
   opt_variables_type OptVariables;
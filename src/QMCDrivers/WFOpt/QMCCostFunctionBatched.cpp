@@ -43,7 +43,9 @@ QMCCostFunctionBatched::QMCCostFunctionBatched(MCWalkerConfiguration& w,
       corr_sampling_timer_(
           *timer_manager.createTimer("QMCCostFunctionBatched::correlatedSampling", timer_level_medium)),
       fill_timer_(
-          *timer_manager.createTimer("QMCCostFunctionBatched::fillOverlapHamiltonianMatrices", timer_level_medium))
+          *timer_manager.createTimer("QMCCostFunctionBatched::fillOverlapHamiltonianMatrices", timer_level_medium)),
+      apply_timer_(
+          *timer_manager.createTimer("QMCCostFunctionBatched::applyOverlapHamiltonianMatrices", timer_level_medium))
 
 {
   app_log() << " Using QMCCostFunctionBatched::QMCCostFunctionBatched" << std::endl;
@@ -241,6 +243,36 @@ void compute_batch_parameters(int sample_size, int batch_size, int& num_batches,
   }
 }
 
+/** The records are written by the crowds in sample order and every later pass over them,
+ *  the correlated sampling and the matrix builds, traverses them in the same order.
+ *  With recordsStorage = file they are kept in memory-mapped scratch files, the kernel pages them in and out
+ *  so that the number of samples times the number of parameters is not bounded by the node memory.
+ */
+void QMCCostFunctionBatched::resizeDerivRecords(int num_samples)
+{
+  if (recordsStorage == "file")
+  {
+    const size_t num_records = static_cast<size_t>(num_samples) * NumOptimizables;
+    DerivRecords_.attachReference(deriv_records_file_.resize(scratchDir, num_records), num_samples, NumOptimizables);
+    HDerivRecords_.attachReference(hderiv_records_file_.resize(scratchDir, num_records), num_samples, NumOptimizables);
+    app_log() << "  Derivative records of " << 2 * num_records * sizeof(Return_rt) / (1024 * 1024)
+              << " MB are stored in memory-mapped scratch files in " << scratchDir << std::endl;
+  }
+  else
+  {
+    if (deriv_records_file_.data() != nullptr)
+    {
+      // detach the scratch files before allocating in memory
+      DerivRecords_.free();
+      HDerivRecords_.free();
+      deriv_records_file_.free();
+      hderiv_records_file_.free();
+    }
+    DerivRecords_.resize(num_samples, NumOptimizables);
+    HDerivRecords_.resize(num_samples, NumOptimizables);
+  }
+}
+
 /** evaluate everything before optimization */
 void QMCCostFunctionBatched::checkConfigurations()
 {
@@ -254,19 +286,13 @@ void QMCCostFunctionBatched::checkConfigurations()
   {
     RecordsOnNode_.resize(numSamples, SUM_INDEX_SIZE);
     if (needGrads)
-    {
-      DerivRecords_.resize(numSamples, NumOptimizables);
-      HDerivRecords_.resize(numSamples, NumOptimizables);
-    }
+      resizeDerivRecords(numSamples);
   }
   else if (RecordsOnNode_.size1() != numSamples)
   {
     RecordsOnNode_.resize(numSamples, SUM_INDEX_SIZE);
     if (needGrads)
-    {
-      DerivRecords_.resize(numSamples, NumOptimizables);
-      HDerivRecords_.resize(numSamples, NumOptimizables);
-    }
+      resizeDerivRecords(numSamples);
   }
   OperatorBase* nlpp = (includeNonlocalH == "no") ? 0 : H.getHamiltonian(includeNonlocalH);
   bool compute_nlpp  = useNLPPDeriv && nlpp;
@@ -791,4 +817,157 @@ QMCCostFunctionBatched::Return_rt QMCCostFunctionBatched::fillOverlapHamiltonian
 
   return 1.0;
 }
+
+/** The first row and column and the diagonals of the matrices of fillOverlapHamiltonianMatrices are
+ *  accumulated here at O(Nsamples x Nparams) cost. The parameter blocks are never stored.
+ */
+bool QMCCostFunctionBatched::prepareOverlapHamiltonianProducts(std::vector<Return_rt>& left_diag,
+                                                               std::vector<Return_rt>& right_diag)
+{
+  ScopedTimer tmp_timer(&fill_timer_);
+
+  LinearMethodProducts& lm = lm_products_;
+  if (GEVType == "H2")
+  {
+    lm.b1 = w_beta;
+    lm.b2 = 0;
+  }
+  else
+  {
+    lm.b2 = w_beta;
+    lm.b1 = 0;
+  }
+
+  const int num_params      = getNumParams();
+  curAvg_w                  = SumValue[SUM_E_WGT] / SumValue[SUM_WGT];
+  const Return_rt curAvg2_w = SumValue[SUM_ESQ_WGT] / SumValue[SUM_WGT];
+  lm.H2_avg                 = 1.0 / (curAvg_w * curAvg_w);
+  lm.V_avg                  = curAvg2_w - curAvg_w * curAvg_w;
+  lm.wgtinv                 = 1.0 / SumValue[SUM_WGT];
+  const Return_rt b1        = lm.b1;
+  const Return_rt b2        = lm.b2;
+
+  const int numSamples = samples_.getNumSamples();
+  lm.D_avg.assign(num_params, 0.0);
+  for (int iw = 0; iw < numSamples; iw++)
+  {
+    const Return_rt weight  = RecordsOnNode_[iw][REWEIGHT] * lm.wgtinv;
+    const Return_rt* Dsaved = DerivRecords_[iw];
+    for (int pm = 0; pm < num_params; pm++)
+      lm.D_avg[pm] += Dsaved[pm] * weight;
+  }
+  myComm->allreduce(lm.D_avg);
+
+  lm.left_row0.assign(num_params + 1, 0.0);
+  lm.left_col0.assign(num_params + 1, 0.0);
+  lm.right_row0.assign(num_params + 1, 0.0);
+  left_diag.assign(num_params + 1, 0.0);
+  right_diag.assign(num_params + 1, 0.0);
+  for (int iw = 0; iw < numSamples; iw++)
+  {
+    const Return_rt* restrict saved = RecordsOnNode_[iw];
+    const Return_rt weight          = saved[REWEIGHT] * lm.wgtinv;
+    const Return_rt eloc_new        = saved[ENERGY_NEW];
+    const Return_rt* Dsaved         = DerivRecords_[iw];
+    const Return_rt* HDsaved        = HDerivRecords_[iw];
+    for (int pm = 0; pm < num_params; pm++)
+    {
+      const Return_rt d = Dsaved[pm] - lm.D_avg[pm];
+      const Return_rt h = HDsaved[pm] + d * eloc_new;
+      const Return_rt a = HDsaved[pm] - 2.0 * d * eloc_new;
+      const Return_rt vterm =
+          HDsaved[pm] * (eloc_new - curAvg_w) + d * eloc_new * (eloc_new - 2.0 * curAvg_w);
+      lm.left_row0[pm + 1] += weight * ((1 - b2) * h + b2 * vterm);
+      lm.left_col0[pm + 1] += weight * ((1 - b2) * d * eloc_new + b2 * vterm);
+      lm.right_row0[pm + 1] += weight * b1 * lm.H2_avg * vterm;
+      left_diag[pm + 1] += weight * ((1 - b2) * d * h + b2 * (a * a + lm.V_avg * d * d));
+      right_diag[pm + 1] += weight * (d * d + b1 * lm.H2_avg * a * a);
+    }
+  }
+  myComm->allreduce(lm.left_row0);
+  myComm->allreduce(lm.left_col0);
+  myComm->allreduce(lm.right_row0);
+  myComm->allreduce(left_diag);
+  myComm->allreduce(right_diag);
+
+  lm.left_row0[0] = lm.left_col0[0] = left_diag[0] = (1 - b2) * curAvg_w + b2 * lm.V_avg;
+  lm.right_row0[0] = right_diag[0] = 1.0 + b1 * lm.H2_avg * lm.V_avg;
+  return true;
+}
+
+/** Every sample contributes rank-1 terms to the parameter blocks,
+ *  e.g. w d d^T to Right with d the centered derivatives, so that Right*x is accumulated as w (d.x) d.
+ *  One pass over the local records and one reduction over the ranks per call.
+ */
+void QMCCostFunctionBatched::applyOverlapHamiltonianMatrices(const std::vector<Return_rt>& x,
+                                                             std::vector<Return_rt>& left_x,
+                                                             std::vector<Return_rt>& right_x)
+{
+  ScopedTimer tmp_timer(&apply_timer_);
+
+  const LinearMethodProducts& lm = lm_products_;
+  const int num_params           = getNumParams();
+  const bool need_var            = lm.b1 != 0 || lm.b2 != 0;
+  const Return_rt b1             = lm.b1;
+  const Return_rt b2             = lm.b2;
+
+  // the parameter blocks of Left*x and Right*x, reduced together
+  std::vector<Return_rt> products(2 * num_params, 0.0);
+  Return_rt* restrict lx = products.data();
+  Return_rt* restrict rx = products.data() + num_params;
+  std::vector<Return_rt> d(num_params), a(num_params);
+  const Return_rt* restrict xp = x.data() + 1;
+
+  const int numSamples = samples_.getNumSamples();
+  for (int iw = 0; iw < numSamples; iw++)
+  {
+    const Return_rt* restrict saved   = RecordsOnNode_[iw];
+    const Return_rt weight            = saved[REWEIGHT] * lm.wgtinv;
+    const Return_rt eloc_new          = saved[ENERGY_NEW];
+    const Return_rt* restrict Dsaved  = DerivRecords_[iw];
+    const Return_rt* restrict HDsaved = HDerivRecords_[iw];
+    Return_rt dx(0), hx(0), ax(0);
+    for (int pm = 0; pm < num_params; pm++)
+    {
+      d[pm] = Dsaved[pm] - lm.D_avg[pm];
+      dx += d[pm] * xp[pm];
+      hx += (HDsaved[pm] + d[pm] * eloc_new) * xp[pm];
+    }
+    const Return_rt ld = weight * ((1 - b2) * hx + b2 * lm.V_avg * dx);
+    const Return_rt rd = weight * dx;
+    for (int pm = 0; pm < num_params; pm++)
+    {
+      lx[pm] += ld * d[pm];
+      rx[pm] += rd * d[pm];
+    }
+    if (need_var)
+    {
+      for (int pm = 0; pm < num_params; pm++)
+      {
+        a[pm] = HDsaved[pm] - 2.0 * d[pm] * eloc_new;
+        ax += a[pm] * xp[pm];
+      }
+      const Return_rt la = weight * b2 * ax;
+      const Return_rt ra = weight * b1 * lm.H2_avg * ax;
+      for (int pm = 0; pm < num_params; pm++)
+      {
+        lx[pm] += la * a[pm];
+        rx[pm] += ra * a[pm];
+      }
+    }
+  }
+  myComm->allreduce(products);
+
+  left_x.resize(num_params + 1);
+  right_x.resize(num_params + 1);
+  left_x[0]  = lm.left_row0[0] * x[0];
+  right_x[0] = lm.right_row0[0] * x[0];
+  for (int pm = 0; pm < num_params; pm++)
+  {
+    left_x[0] += lm.left_row0[pm + 1] * xp[pm];
+    right_x[0] += lm.right_row0[pm + 1] * xp[pm];
+    left_x[pm + 1]  = lm.left_col0[pm + 1] * x[0] + products[pm];
+    right_x[pm + 1] = lm.right_row0[pm + 1] * x[0] + products[num_params + pm];
+  }
+}
 } // namespace qmcplusplus
@@ -18,6 +18,7 @@
 #include "QMCDrivers/WFOpt/QMCCostFunctionBase.h"
 #include "QMCDrivers/CloneManager.h"
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
+#include "Utilities/ScratchFileArray.h"
 
 namespace qmcplusplus
 {
@@ -58,6 +59,10 @@ public:
   void resetPsi(bool final_reset = false);
   void GradCost(std::vector<Return_rt>& PGradient, const std::vector<Return_rt>& PM, Return_rt FiniteDiff = 0);
   Return_rt fillOverlapHamiltonianMatrices(Matrix<Return_rt>& Left, Matrix<Return_rt>& Right);
+  bool prepareOverlapHamiltonianProducts(std::vector<Return_rt>& left_diag, std::vector<Return_rt>& right_diag);
+  void applyOverlapHamiltonianMatrices(const std::vector<Return_rt>& x,
+                                       std::vector<Return_rt>& left_x,
+                                       std::vector<Return_rt>& right_x);
 
 protected:
   std::unique_ptr<QMCHamiltonian> H_KE_Node;
@@ -69,6 +74,23 @@ protected:
   */
   Matrix<Return_rt> DerivRecords_;
   Matrix<Return_rt> HDerivRecords_;
+  /// storage of DerivRecords_ and HDerivRecords_ with recordsStorage = file
+  ScratchFileArray<Return_rt> deriv_records_file_;
+  ScratchFileArray<Return_rt> hderiv_records_file_;
+  /// allocate DerivRecords_ and HDerivRecords_ for num_samples samples as selected by recordsStorage
+  void resizeDerivRecords(int num_samples);
+
+  /** state of the matrix-free products, set by prepareOverlapHamiltonianProducts
+   *
+   * Only the first row and column of the matrices are stored, the parameter blocks are
+   * applied on the fly from DerivRecords_ and HDerivRecords_.
+   */
+  struct LinearMethodProducts
+  {
+    Return_rt b1, b2, H2_avg, V_avg, wgtinv;
+    std::vector<Return_rt> D_avg;
+    std::vector<Return_rt> left_row0, left_col0, right_row0;
+  } lm_products_;
 
   Return_rt correlatedSampling(bool needGrad = true);
 
@@ -82,6 +104,7 @@ protected:
   NewTimer& check_config_timer_;
   NewTimer& corr_sampling_timer_;
   NewTimer& fill_timer_;
+  NewTimer& apply_timer_;
 
 
 #ifdef HAVE_LMY_ENGINE
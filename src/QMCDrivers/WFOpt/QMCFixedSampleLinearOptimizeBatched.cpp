@@ -97,6 +97,9 @@ QMCFixedSampleLinearOptimizeBatched::QMCFixedSampleLinearOptimizeBatched(MCWalke
       block_third(false),
       crowd_size_(1),
       opt_num_crowds_(1),
+      eigensolver_("dense"),
+      davidson_tol_(1.0e-6),
+      davidson_max_its_(200),
       MinMethod("OneShiftOnly"),
       previous_optimizer_type_(OptimizerType::NONE),
       current_optimizer_type_(OptimizerType::NONE)
@@ -129,6 +132,9 @@ QMCFixedSampleLinearOptimizeBatched::QMCFixedSampleLinearOptimizeBatched(MCWalke
   m_param.add(target_shift_i, "target_shift_i", "double");
   m_param.add(crowd_size_, "opt_crowd_size", "int");
   m_param.add(opt_num_crowds_, "opt_num_crowds", "int");
+  m_param.add(eigensolver_, "eigensolver", "string");
+  m_param.add(davidson_tol_, "davidson_tol", "double");
+  m_param.add(davidson_max_its_, "davidson_max_its", "int");
 
 
 #ifdef HAVE_LMY_ENGINE
@@ -491,6 +497,10 @@ bool QMCFixedSampleLinearOptimizeBatched::processOptXML(xmlNodePtr opt_xml,
   tolower(block_lmStr);
   block_lm = (block_lmStr == "yes");
 
+  tolower(eigensolver_);
+  if (eigensolver_ != "dense" && eigensolver_ != "davidson")
+    throw std::runtime_error("eigensolver must be dense or davidson in QMCFixedSampleLinearOptimizeBatched::put");
+
   auto iter = OptimizerNames.find(MinMethod);
   if (iter == OptimizerNames.end())
     throw std::runtime_error("Unknown MinMethod!\n");
@@ -1220,49 +1230,62 @@ bool QMCFixedSampleLinearOptimizeBatched::one_shift_run()
             << "Building overlap and Hamiltonian matrices" << std::endl
             << "*****************************************" << std::endl;
 
-  // allocate the matrices we will need
-  Matrix<RealType> ovlMat(N, N);
-  ovlMat = 0.0;
-  Matrix<RealType> hamMat(N, N);
-  hamMat = 0.0;
-  Matrix<RealType> invMat(N, N);
-  invMat = 0.0;
-  Matrix<RealType> prdMat(N, N);
-  prdMat = 0.0;
-
-  // build the overlap and hamiltonian matrices
-  optTarget->fillOverlapHamiltonianMatrices(hamMat, ovlMat);
-  invMat.copy(ovlMat);
-
-  // apply the identity shift
-  for (int i = 1; i < N; i++)
+  RealType lowestEV;
+  if (eigensolver_ == "davidson")
   {
-    hamMat(i, i) += bestShift_i;
-    if (invMat(i, i) == 0)
-      invMat(i, i) = bestShift_i * bestShift_s;
+    // apply the matrices on the fly from the sample records instead of building them
+    lowestEV = getLowestEigenvectorDavidson(*optTarget, bestShift_i, bestShift_s, davidson_tol_, davidson_max_its_,
+                                            parameterDirections);
+
+    // compute the scaling constant to apply to the update
+    Lambda = getNonLinearRescale(parameterDirections);
   }
+  else
+  {
+    // allocate the matrices we will need
+    Matrix<RealType> ovlMat(N, N);
+    ovlMat = 0.0;
+    Matrix<RealType> hamMat(N, N);
+    hamMat = 0.0;
+    Matrix<RealType> invMat(N, N);
+    invMat = 0.0;
+    Matrix<RealType> prdMat(N, N);
+    prdMat = 0.0;
+
+    // build the overlap and hamiltonian matrices
+    optTarget->fillOverlapHamiltonianMatrices(hamMat, ovlMat);
+    invMat.copy(ovlMat);
 
-  // compute the inverse of the overlap matrix
-  invert_matrix(invMat, false);
+    // apply the identity shift
+    for (int i = 1; i < N; i++)
+    {
+      hamMat(i, i) += bestShift_i;
+      if (invMat(i, i) == 0)
+        invMat(i, i) = bestShift_i * bestShift_s;
+    }
+
+    // compute the inverse of the overlap matrix
+    invert_matrix(invMat, false);
 
-  // apply the overlap shift
-  for (int i = 1; i < N; i++)
-    for (int j = 1; j < N; j++)
-      hamMat(i, j) += bestShift_s * ovlMat(i, j);
+    // apply the overlap shift
+    for (int i = 1; i < N; i++)
+      for (int j = 1; j < N; j++)
+        hamMat(i, j) += bestShift_s * ovlMat(i, j);
 
-  // multiply the shifted hamiltonian matrix by the inverse of the overlap matrix
-  qmcplusplus::MatrixOperators::product(invMat, hamMat, prdMat);
+    // multiply the shifted hamiltonian matrix by the inverse of the overlap matrix
+    qmcplusplus::MatrixOperators::product(invMat, hamMat, prdMat);
 
-  // transpose the result (why?)
-  for (int i = 0; i < N; i++)
-    for (int j = i + 1; j < N; j++)
-      std::swap(prdMat(i, j), prdMat(j, i));
+    // transpose the result (why?)
+    for (int i = 0; i < N; i++)
+      for (int j = i + 1; j < N; j++)
+        std::swap(prdMat(i, j), prdMat(j, i));
 
-  // compute the lowest eigenvalue of the product matrix and the corresponding eigenvector
-  const RealType lowestEV = getLowestEigenvector(prdMat, parameterDirections);
+    // compute the lowest eigenvalue of the product matrix and the corresponding eigenvector
+    lowestEV = getLowestEigenvector(prdMat, parameterDirections);
 
-  // compute the scaling constant to apply to the update
-  Lambda = getNonLinearRescale(parameterDirections, ovlMat);
+    // compute the scaling constant to apply to the update
+    Lambda = getNonLinearRescale(parameterDirections, ovlMat);
+  }
 
   // scale the update by the scaling constant
   for (int i = 0; i < numParams; i++)
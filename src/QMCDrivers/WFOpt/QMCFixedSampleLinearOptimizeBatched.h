@@ -186,6 +186,12 @@ private:
   int crowd_size_;
   /// Number of crowds to use to process samples during optimization
   int opt_num_crowds_;
+  /// eigensolver of the one shift update, dense or davidson
+  std::string eigensolver_;
+  /// convergence threshold of the residual norm of the davidson eigensolver
+  RealType davidson_tol_;
+  /// maximal number of iterations of the davidson eigensolver
+  int davidson_max_its_;
   //Variables for alternatives to linear method
 
   //name of the current optimization method, updated by processOptXML before run
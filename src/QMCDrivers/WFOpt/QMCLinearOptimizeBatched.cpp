@@ -565,6 +565,249 @@ QMCLinearOptimizeBatched::RealType QMCLinearOptimizeBatched::getNonLinearRescale
   return rescale;
 }
 
+QMCLinearOptimizeBatched::RealType QMCLinearOptimizeBatched::getNonLinearRescale(std::vector<RealType>& dP)
+{
+  int first(0), last(0);
+  getNonLinearRange(first, last);
+  if (first == last)
+    return 1.0;
+  std::vector<RealType> x(dP.size(), 0.0), left_x, right_x;
+  for (int i = first; i < last; i++)
+    x[i + 1] = dP[i + 1];
+  optTarget->applyOverlapHamiltonianMatrices(x, left_x, right_x);
+  RealType rescale(1.0);
+  RealType xi(0.5);
+  RealType D(0.0);
+  for (int i = first; i < last; i++)
+    D += right_x[i + 1] * dP[i + 1];
+  rescale = (1 - xi) * D / ((1 - xi) + xi * std::sqrt(1 + D));
+  rescale = 1.0 / (1.0 - rescale);
+  return rescale;
+}
+
+/** Davidson iteration for (H + shift_i I + shift_s S) v = lambda S v, the shifts acting on the parameter block only.
+ *
+ * The search space starts from the unit vector of the current wavefunction. At each iteration the problem projected
+ * on the search space is solved by ggev and the eigenvalue is selected as in getLowestEigenvector(A, ev).
+ * The residual preconditioned by the diagonals of the matrices extends the search space.
+ * Memory is O(max_basis x Nparams) and each iteration costs one pass over the samples.
+ */
+QMCLinearOptimizeBatched::RealType QMCLinearOptimizeBatched::getLowestEigenvectorDavidson(QMCCostFunctionBase& cost,
+                                                                                          RealType shift_i,
+                                                                                          RealType shift_s,
+                                                                                          RealType tolerance,
+                                                                                          int max_iterations,
+                                                                                          std::vector<RealType>& ev)
+{
+  const int Nl        = ev.size();
+  const int max_basis = std::min(Nl, 32);
+
+  std::vector<RealType> left_diag, right_diag;
+  if (!cost.prepareOverlapHamiltonianProducts(left_diag, right_diag))
+    APP_ABORT("QMCLinearOptimizeBatched::getLowestEigenvectorDavidson requires a cost function with matrix-free "
+              "products. Use eigensolver=\"dense\".");
+  std::vector<RealType> precond(Nl);
+  precond[0] = left_diag[0];
+  for (int i = 1; i < Nl; i++)
+    precond[i] = left_diag[i] + shift_i + shift_s * right_diag[i];
+  // like invMat in the dense solver, a vanishing overlap diagonal is replaced by shift_i * shift_s
+  std::vector<int> zero_overlap;
+  for (int i = 1; i < Nl; i++)
+    if (right_diag[i] == 0)
+    {
+      zero_overlap.push_back(i);
+      right_diag[i] = shift_i * shift_s;
+    }
+
+  // the search space V, A*V and S*V. V[0] is the current wavefunction
+  std::vector<std::vector<RealType>> V(1, std::vector<RealType>(Nl, 0.0)), AV(1), SV(1);
+  V[0][0] = 1.0;
+  cost.applyOverlapHamiltonianMatrices(V[0], AV[0], SV[0]);
+  const std::vector<RealType> left_e0(AV[0]), right_e0(SV[0]);
+  const RealType zerozero = left_e0[0];
+
+  // the shifts only act on the parameter block, v[0] is handled by the saved products with the first unit vector
+  std::vector<RealType> y, left_y, right_y;
+  auto applyShifted = [&](const std::vector<RealType>& v, std::vector<RealType>& av, std::vector<RealType>& sv) {
+    y    = v;
+    y[0] = 0.0;
+    cost.applyOverlapHamiltonianMatrices(y, left_y, right_y);
+    av.resize(Nl);
+    sv.resize(Nl);
+    for (int i = 0; i < Nl; i++)
+    {
+      av[i] = left_y[i] + v[0] * left_e0[i];
+      sv[i] = right_y[i] + v[0] * right_e0[i];
+    }
+    for (int i = 1; i < Nl; i++)
+      av[i] += shift_i * v[i] + shift_s * right_y[i];
+    for (int i : zero_overlap)
+      sv[i] += shift_i * shift_s * v[i];
+  };
+
+  auto dot = [Nl](const std::vector<RealType>& a, const std::vector<RealType>& b) {
+    RealType res(0);
+    for (int i = 0; i < Nl; i++)
+      res += a[i] * b[i];
+    return res;
+  };
+
+  // orthonormalize t against V twice, false if nothing is left
+  auto orthonormalize = [&](std::vector<RealType>& t) {
+    const RealType norm0 = std::sqrt(dot(t, t));
+    for (int pass = 0; pass < 2; pass++)
+      for (int k = 0; k < V.size(); k++)
+      {
+        const RealType overlap = dot(V[k], t);
+        for (int i = 0; i < Nl; i++)
+          t[i] -= overlap * V[k][i];
+      }
+    const RealType norm = std::sqrt(dot(t, t));
+    if (!(norm > 1e-10 * norm0))
+      return false;
+    for (int i = 0; i < Nl; i++)
+      t[i] /= norm;
+    return true;
+  };
+
+  std::vector<RealType> u(Nl), au(Nl), su(Nl), t(Nl);
+  RealType theta(zerozero), residual(0);
+  int iter = 0;
+  bool converged(false);
+  while (true)
+  {
+    // solve the projected problem, stored column major for LAPACK
+    int nk = V.size();
+    Matrix<RealType> Ak(nk, nk), Sk(nk, nk), eigenT(nk, nk);
+    for (int i = 0; i < nk; i++)
+      for (int j = 0; j < nk; j++)
+      {
+        Ak(j, i) = dot(V[i], AV[j]);
+        Sk(j, i) = dot(V[i], SV[j]);
+      }
+    char jl('N');
+    char jr('V');
+    std::vector<RealType> alphar(nk), alphai(nk), beta(nk);
+    int info;
+    int lwork(-1);
+    std::vector<RealType> work(1);
+    RealType tt(0);
+    int one(1);
+    LAPACK::ggev(&jl, &jr, &nk, Ak.data(), &nk, Sk.data(), &nk, &alphar[0], &alphai[0], &beta[0], &tt, &one,
+                 eigenT.data(), &nk, &work[0], &lwork, &info);
+    lwork = int(work[0]);
+    work.resize(lwork);
+    LAPACK::ggev(&jl, &jr, &nk, Ak.data(), &nk, Sk.data(), &nk, &alphar[0], &alphai[0], &beta[0], &tt, &one,
+                 eigenT.data(), &nk, &work[0], &lwork, &info);
+    if (info != 0)
+    {
+      APP_ABORT("Invalid Matrix Diagonalization Function!");
+    }
+
+    // real eigenvalues below the current energy are preferred like in getLowestEigenvector(A, ev)
+    int best(-1), lowest(-1);
+    RealType best_score(std::numeric_limits<RealType>::max());
+    for (int i = 0; i < nk; i++)
+    {
+      if (alphai[i] != 0 || beta[i] == 0)
+        continue;
+      const RealType evi(alphar[i] / beta[i]);
+      if (!(std::abs(evi) < 1e10))
+        continue;
+      if (lowest < 0 || evi < alphar[lowest] / beta[lowest])
+        lowest = i;
+      if ((evi < zerozero) && (evi > (zerozero - 1e2)) && (evi - zerozero + 2.0) * (evi - zerozero + 2.0) < best_score)
+      {
+        best_score = (evi - zerozero + 2.0) * (evi - zerozero + 2.0);
+        best       = i;
+      }
+    }
+    if (best < 0)
+      best = lowest;
+    if (best < 0)
+      APP_ABORT("QMCLinearOptimizeBatched::getLowestEigenvectorDavidson found no real eigenvalue");
+    theta = alphar[best] / beta[best];
+
+    // Ritz vector and residual
+    std::fill(u.begin(), u.end(), 0.0);
+    std::fill(au.begin(), au.end(), 0.0);
+    std::fill(su.begin(), su.end(), 0.0);
+    for (int k = 0; k < nk; k++)
+    {
+      const RealType c = eigenT(best, k);
+      for (int i = 0; i < Nl; i++)
+      {
+        u[i] += c * V[k][i];
+        au[i] += c * AV[k][i];
+        su[i] += c * SV[k][i];
+      }
+    }
+    const RealType unorm = std::sqrt(dot(u, u));
+    for (int i = 0; i < Nl; i++)
+      t[i] = au[i] - theta * su[i];
+    residual = std::sqrt(dot(t, t)) / unorm;
+    if (residual < tolerance)
+    {
+      converged = true;
+      break;
+    }
+    if (iter == max_iterations)
+      break;
+    iter++;
+
+    // restart from the current wavefunction and the Ritz vector
+    if (nk == max_basis && u[0] != 0)
+    {
+      V.resize(2);
+      AV.resize(2);
+      SV.resize(2);
+      for (int i = 0; i < Nl; i++)
+      {
+        V[1][i]  = u[i] - u[0] * V[0][i];
+        AV[1][i] = au[i] - u[0] * AV[0][i];
+        SV[1][i] = su[i] - u[0] * SV[0][i];
+      }
+      const RealType norm = std::sqrt(dot(V[1], V[1]));
+      if (norm > 0)
+        for (int i = 0; i < Nl; i++)
+        {
+          V[1][i] /= norm;
+          AV[1][i] /= norm;
+          SV[1][i] /= norm;
+        }
+      else
+      {
+        V.resize(1);
+        AV.resize(1);
+        SV.resize(1);
+      }
+    }
+    else if (nk == max_basis)
+      break;
+
+    // preconditioned residual
+    for (int i = 0; i < Nl; i++)
+    {
+      RealType denom = precond[i] - theta * right_diag[i];
+      if (std::abs(denom) < 1e-8)
+        denom = denom < 0 ? -1e-8 : 1e-8;
+      t[i] /= denom;
+    }
+    if (!orthonormalize(t))
+      break;
+    V.push_back(t);
+    AV.emplace_back();
+    SV.emplace_back();
+    applyShifted(V.back(), AV.back(), SV.back());
+  }
+
+  app_log() << "  Davidson eigensolver " << (converged ? "converged" : "did not converge") << " in " << iter
+            << " iterations, eigenvalue = " << theta << " residual = " << residual << std::endl;
+  for (int i = 0; i < Nl; i++)
+    ev[i] = u[i] / u[0];
+  return theta;
+}
+
 void QMCLinearOptimizeBatched::orthoScale(std::vector<RealType>& dP, Matrix<RealType>& S)
 {
   //     int first(0),last(0);
@@ -183,11 +183,32 @@ public:
   //asymmetric generalized EV
   RealType getLowestEigenvector(Matrix<RealType>& A, Matrix<RealType>& B, std::vector<RealType>& ev);
   //asymmetric EV
-  RealType getLowestEigenvector(Matrix<RealType>& A, std::vector<RealType>& ev);
+  static RealType getLowestEigenvector(Matrix<RealType>& A, std::vector<RealType>& ev);
+  /** asymmetric generalized EV of the shifted linear method matrices by a matrix-free Davidson iteration
+   * @param cost cost function applying the matrices
+   * @param shift_i identity shift added to the parameter block of the Hamiltonian matrix
+   * @param shift_s overlap shift, shift_s times the parameter block of the overlap matrix is added to the Hamiltonian
+   * @param tolerance convergence threshold of the residual norm
+   * @param max_iterations maximal number of iterations
+   * @param ev return the eigenvector normalized to ev[0] = 1
+   * @return the eigenvalue
+   *
+   * The matrices are applied by cost.applyOverlapHamiltonianMatrices and never built.
+   * A vanishing diagonal element of the parameter block of the overlap matrix is replaced by shift_i * shift_s
+   * as in the dense solver.
+   */
+  static RealType getLowestEigenvectorDavidson(QMCCostFunctionBase& cost,
+                                               RealType shift_i,
+                                               RealType shift_s,
+                                               RealType tolerance,
+                                               int max_iterations,
+                                               std::vector<RealType>& ev);
   void getNonLinearRange(int& first, int& last);
   void orthoScale(std::vector<RealType>& dP, Matrix<RealType>& S);
   bool nonLinearRescale(std::vector<RealType>& dP, Matrix<RealType>& S);
   RealType getNonLinearRescale(std::vector<RealType>& dP, Matrix<RealType>& S);
+  /// getNonLinearRescale with the overlap matrix applied by optTarget->applyOverlapHamiltonianMatrices
+  RealType getNonLinearRescale(std::vector<RealType>& dP);
   void generateSamples();
 
   QMCDriverInput qmcdriver_input_;
@@ -38,7 +38,10 @@ WalkerControlBase::WalkerControlBase(Communicate* c, bool rn)
       dmcStream(0),
       NumWalkersCreated(0),
       SwapMode(0),
-      write_release_nodes_(rn)
+      write_release_nodes_(rn),
+      use_nonblocking(true),
+      pipelined_branching_(false),
+      walker_migration_(WalkerMigration::FULL)
 {
   method_       = -1; //assign invalid method
   num_contexts_ = myComm->size();
@@ -853,7 +856,13 @@ void WalkerControlBase::limitPopulation(PopulationAdjustment& adjust)
 
   //strong assumption that adjust.num_walkers is correct.
   auto num_per_node = WalkerControlBase::syncFutureWalkersPerRank(this->getCommunicator(), adjust.num_walkers);
+  limitPopulation(adjust, num_per_node);
+}
+
+bool WalkerControlBase::limitPopulation(PopulationAdjustment& adjust, std::vector<IndexType>& num_per_node)
+{
   IndexType current_population = std::accumulate(num_per_node.begin(), num_per_node.end(), 0);
+  bool limited                 = false;
 
   // limit Nmax
   // TODO:  this seems to be the wrong pace to do this.
@@ -863,6 +872,7 @@ void WalkerControlBase::limitPopulation(PopulationAdjustment& adjust)
 
   if (current_max > n_max_)
   {
+    limited = true;
     app_warning() << "Exceeding Max Walkers per MPI rank : " << n_max_ << ". Ceiling is applied" << std::endl;
     int nsub = current_population - n_max_ * num_contexts_;
 
@@ -937,6 +947,7 @@ void WalkerControlBase::limitPopulation(PopulationAdjustment& adjust)
   if (current_population / num_contexts_ < n_min_)
   {
     //strong assumption at least one good walker exists.
+    limited  = true;
     int nadd = n_min_ * num_contexts_ - current_population;
     app_warning() << "The number of walkers " << (current_population / num_contexts_) << " over ranks:" << num_contexts_
                   << " is running lower than Min Walkers per MPI rank : " << n_min_ << ". Floor is applied, adding "
@@ -1017,6 +1028,7 @@ void WalkerControlBase::limitPopulation(PopulationAdjustment& adjust)
                 << "Improve the trial wavefunction or adjust the simulation parameters." << std::endl;
     APP_ABORT("WalkerControlBase::adjustPopulation");
   }
+  return limited;
 }
 
 
@@ -1080,12 +1092,16 @@ bool WalkerControlBase::put(xmlNodePtr cur)
 {
   int nw_target = 0, nw_max = 0;
   std::string nonblocking = "yes";
+  std::string pipelined   = "no";
+  std::string migration   = "full";
   ParameterSet params;
   params.add(target_sigma_, "sigmaBound", "double");
   params.add(MaxCopy, "maxCopy", "int");
   params.add(nw_target, "targetwalkers", "int");
   params.add(nw_max, "max_walkers", "int");
   params.add(nonblocking, "use_nonblocking", "string");
+  params.add(pipelined, "pipelined_branching", "string");
+  params.add(migration, "walker_migration", "string");
 
   bool success = params.put(cur);
 
@@ -1103,6 +1119,22 @@ bool WalkerControlBase::put(xmlNodePtr cur)
     APP_ABORT("WalkerControlBase::put unknown use_nonblocking option " + nonblocking);
   }
 
+  if (pipelined == "yes")
+    pipelined_branching_ = true;
+  else if (pipelined == "no")
+    pipelined_branching_ = false;
+  else
+    APP_ABORT("WalkerControlBase::put unknown pipelined_branching option " + pipelined);
+
+  if (migration == "full")
+    walker_migration_ = WalkerMigration::FULL;
+  else if (migration == "minimal")
+    walker_migration_ = WalkerMigration::MINIMAL;
+  else if (migration == "auto")
+    walker_migration_ = WalkerMigration::AUTO;
+  else
+    APP_ABORT("WalkerControlBase::put unknown walker_migration option " + migration);
+
   setMinMax(nw_target, nw_max);
 
   app_log() << "  WalkerControlBase parameters " << std::endl;
@@ -1112,6 +1144,11 @@ bool WalkerControlBase::put(xmlNodePtr cur)
   app_log() << "    Max Walkers per MPI rank " << n_max_ << std::endl;
   app_log() << "    Min Walkers per MPI rank " << n_min_ << std::endl;
   app_log() << "    Using " << (use_nonblocking ? "non-" : "") << "blocking send/recv" << std::endl;
+  if (pipelined_branching_)
+    app_log() << "    Using pipelined branching, the trial energy lags the population by one step" << std::endl;
+  if (walker_migration_ != WalkerMigration::FULL)
+    app_log() << "    Walker migration " << migration << ", the receiving rank may rebuild the wavefunction buffers"
+              << std::endl;
   return true;
 }
 
@@ -187,6 +187,13 @@ public:
    */
   void limitPopulation(PopulationAdjustment& adjust);
 
+  /** unified: limitPopulation with the future number of walkers per rank already synchronized
+   *
+   *  \param[inout] num_per_node future number of walkers per rank, updated when a limit is applied
+   *  \return true if a limit was applied. Then num_per_node may be inexact and needs to be synchronized again.
+   */
+  bool limitPopulation(PopulationAdjustment& adjust, std::vector<IndexType>& num_per_node);
+
   /** legacy: apply per node limit Nmax and Nmin
    */
   int applyNmaxNmin(int current_population);
@@ -212,6 +219,12 @@ public:
    */
   virtual FullPrecRealType branch(int iter, MCPopulation& pop);
 
+  /** unified: measure the statistics of the steps not measured by branch yet
+   *
+   *  Called once after the last branch of a section, only pipelined branching leaves any.
+   */
+  virtual void flushStatistics() {}
+
   virtual FullPrecRealType getFeedBackParameter(int ngen, FullPrecRealType tau)
   {
     return 1.0 / (static_cast<FullPrecRealType>(ngen) * tau);
@@ -294,6 +307,24 @@ protected:
   bool write_release_nodes_;
   ///Use non-blocking isend/irecv
   bool use_nonblocking;
+  /** unified: overlap the reduction of the ensemble statistics with the next step
+   *
+   *  The ensemble properties and the trial energy then lag the population by one step.
+   */
+  bool pipelined_branching_;
+  /** unified: what is sent when a walker migrates to another rank
+   *
+   *  FULL sends the whole DataSet including the wavefunction buffers.
+   *  MINIMAL sends only the walker block of DataSet, i.e. positions, properties and history,
+   *  and the receiving rank rebuilds the wavefunction buffers.
+   *  AUTO picks one of them from the measured rebuild and transfer costs.
+   */
+  enum class WalkerMigration
+  {
+    FULL,
+    MINIMAL,
+    AUTO
+  } walker_migration_;
 
   ///ensemble properties
   MCDataType<FullPrecRealType> ensemble_property_;
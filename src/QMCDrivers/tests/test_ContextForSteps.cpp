@@ -23,6 +23,46 @@
 
 namespace qmcplusplus
 {
+TEST_CASE("ContextForSteps::nextWalkerDeltaRs", "[drivers]")
+{
+  using MCPWalker = ContextForSteps::MCPWalker;
+  const int num_particles = 3;
+  std::vector<std::pair<int, int>> particle_group_indexes{{0, num_particles}};
+  // the contexts have their own generators, seeded differently as for different crowds or ranks
+  RandomGenerator_t rng_a, rng_b;
+#if defined(QMC_RNG_PHILOX) && !defined(USE_FAKE_RNG)
+  rng_a.seed(17);
+  rng_b.seed(19);
+#endif
+  const uint32_t run_seed = 11;
+  ContextForSteps context_a(2, num_particles, particle_group_indexes, rng_a);
+  ContextForSteps context_b(1, num_particles, particle_group_indexes, rng_b);
+
+  MCPWalker walker1(num_particles), walker2(num_particles);
+  walker1.ID = 1;
+  walker2.ID = 2;
+  RefVector<MCPWalker> crowd_a{walker1, walker2};
+  RefVector<MCPWalker> crowd_b{walker2};
+
+  context_a.nextWalkerDeltaRs(crowd_a, num_particles, run_seed, 7, 4);
+  context_b.nextWalkerDeltaRs(crowd_b, num_particles, run_seed, 7, 4);
+  REQUIRE(context_a.get_walker_deltas().size() == 2 * num_particles);
+  REQUIRE(context_b.get_walker_deltas().size() == num_particles);
 
+#if defined(QMC_RNG_PHILOX) && !defined(USE_FAKE_RNG)
+  // walker2 moves the same whether it is the second walker of a crowd or the only one
+  for (int iat = 0; iat < num_particles; ++iat)
+  {
+    CHECK(context_a.get_walker_deltas()[iat * 2 + 1] == context_b.get_walker_deltas()[iat]);
+    CHECK(context_a.nextAcceptDraw(iat, 1) == context_b.nextAcceptDraw(iat, 0));
+  }
+  // a different step or run seed draws different numbers
+  auto deltas = context_b.get_walker_deltas();
+  context_b.nextWalkerDeltaRs(crowd_b, num_particles, run_seed, 7, 5);
+  CHECK(context_b.get_walker_deltas()[0][0] != deltas[0][0]);
+  context_b.nextWalkerDeltaRs(crowd_b, num_particles, run_seed + 1, 7, 4);
+  CHECK(context_b.get_walker_deltas()[0][0] != deltas[0][0]);
+#endif
+}
 
 } // namespace qmcplusplus
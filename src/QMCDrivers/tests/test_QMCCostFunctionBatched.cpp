@@ -11,6 +11,16 @@
 
 #include "catch.hpp"
 
+#include "Message/Communicate.h"
+#include "Particle/MCWalkerConfiguration.h"
+#include "Particle/MCSample.h"
+#include "Particle/SampleStack.h"
+#include "QMCDrivers/WFOpt/QMCCostFunctionBatched.h"
+#include "QMCDrivers/WFOpt/QMCLinearOptimizeBatched.h"
+#include "Numerics/DeterminantOperators.h"
+#include "Numerics/MatrixOperators.h"
+#include "QMCHamiltonians/QMCHamiltonian.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
 
 namespace qmcplusplus
 {
@@ -37,5 +47,167 @@ TEST_CASE("compuate_batch_parameters", "[drivers]")
   CHECK(final_batch_size == 3);
 }
 
+/// fill the sample records directly, without wavefunction and Hamiltonian
+class CostFunctionRecordsTest : public QMCCostFunctionBatched
+{
+public:
+  using QMCCostFunctionBatched::QMCCostFunctionBatched;
+
+  void setRecords(int num_params, const std::string& gev_type, Return_rt beta, const std::string& storage)
+  {
+    GEVType            = gev_type;
+    w_beta             = beta;
+    recordsStorage     = storage;
+    const int nsamples = samples_.getNumSamples();
+    for (int i = 0; i < num_params; i++)
+      OptVariables.insert("p" + std::to_string(i), 0.0);
+    NumOptimizables = num_params;
+    RecordsOnNode_.resize(nsamples, SUM_INDEX_SIZE);
+    resizeDerivRecords(nsamples);
+    std::fill(SumValue.begin(), SumValue.end(), 0.0);
+    for (int iw = 0; iw < nsamples; iw++)
+    {
+      const Return_rt weight          = 1.0 + 0.1 * std::sin(1.3 * iw);
+      const Return_rt eloc            = -2.0 + 0.5 * std::cos(0.7 * iw);
+      RecordsOnNode_[iw][REWEIGHT]    = weight;
+      RecordsOnNode_[iw][ENERGY_NEW]  = eloc;
+      SumValue[SUM_WGT] += weight;
+      SumValue[SUM_E_WGT] += weight * eloc;
+      SumValue[SUM_ESQ_WGT] += weight * eloc * eloc;
+      for (int pm = 0; pm < num_params; pm++)
+      {
+        DerivRecords_[iw][pm]  = std::sin(0.3 * iw * (pm + 1) + pm);
+        HDerivRecords_[iw][pm] = 0.2 * std::cos(0.5 * iw + 0.9 * pm);
+      }
+    }
+  }
+
+  /// make the samples independent of parameter pm
+  void clearParameter(int pm)
+  {
+    for (int iw = 0; iw < samples_.getNumSamples(); iw++)
+    {
+      DerivRecords_[iw][pm]  = 0.0;
+      HDerivRecords_[iw][pm] = 0.0;
+    }
+  }
+};
+
+void checkOverlapHamiltonianProducts(const std::string& gev_type,
+                                     QMCTraits::RealType beta,
+                                     const std::string& storage = "memory")
+{
+  using Return_rt      = QMCTraits::RealType;
+  const int nsamples   = 13;
+  const int num_params = 4;
+  const int N          = num_params + 1;
+
+  MCWalkerConfiguration w;
+  TrialWaveFunction psi;
+  QMCHamiltonian h;
+  SampleStack samples;
+  samples.setMaxSamples(nsamples);
+  for (int iw = 0; iw < nsamples; iw++)
+    samples.appendSample(MCSample(0));
+
+  CostFunctionRecordsTest cost(w, psi, h, samples, 1, 1, OHMMS::Controller);
+  cost.setRecords(num_params, gev_type, beta, storage);
+
+  Matrix<Return_rt> left(N, N), right(N, N);
+  cost.fillOverlapHamiltonianMatrices(left, right);
+
+  std::vector<Return_rt> left_diag, right_diag;
+  REQUIRE(cost.prepareOverlapHamiltonianProducts(left_diag, right_diag));
+  for (int i = 0; i < N; i++)
+  {
+    CHECK(left_diag[i] == Approx(left(i, i)));
+    CHECK(right_diag[i] == Approx(right(i, i)));
+  }
+
+  std::vector<Return_rt> x(N), left_x, right_x;
+  for (int i = 0; i < N; i++)
+    x[i] = 1.0 - 0.3 * i;
+  cost.applyOverlapHamiltonianMatrices(x, left_x, right_x);
+  for (int i = 0; i < N; i++)
+  {
+    Return_rt left_ref(0), right_ref(0);
+    for (int j = 0; j < N; j++)
+    {
+      left_ref += left(i, j) * x[j];
+      right_ref += right(i, j) * x[j];
+    }
+    CHECK(left_x[i] == Approx(left_ref).margin(1e-10));
+    CHECK(right_x[i] == Approx(right_ref).margin(1e-10));
+  }
+}
+
+TEST_CASE("QMCCostFunctionBatched matrix-free products", "[drivers]")
+{
+  checkOverlapHamiltonianProducts("mixed", 0.0);
+  checkOverlapHamiltonianProducts("mixed", 0.3);
+  checkOverlapHamiltonianProducts("H2", 0.3);
+  // derivative records in memory-mapped scratch files
+  checkOverlapHamiltonianProducts("mixed", 0.3, "file");
+}
+
+/** compare the Davidson eigensolver with the dense one on the matrices of the same records
+ * @param zero_parameter index of a parameter the samples do not depend on, none if negative
+ */
+void checkDavidsonEigenvector(int zero_parameter)
+{
+  using Return_rt      = QMCTraits::RealType;
+  const int nsamples   = 13;
+  const int num_params = 4;
+  const int N          = num_params + 1;
+  const Return_rt shift_i(0.01), shift_s(1.0);
+
+  MCWalkerConfiguration w;
+  TrialWaveFunction psi;
+  QMCHamiltonian h;
+  SampleStack samples;
+  samples.setMaxSamples(nsamples);
+  for (int iw = 0; iw < nsamples; iw++)
+    samples.appendSample(MCSample(0));
+
+  CostFunctionRecordsTest cost(w, psi, h, samples, 1, 1, OHMMS::Controller);
+  cost.setRecords(num_params, "mixed", 0.0, "memory");
+  if (zero_parameter >= 0)
+    cost.clearParameter(zero_parameter);
+
+  // the dense path of QMCFixedSampleLinearOptimizeBatched
+  Matrix<Return_rt> ham(N, N), ovl(N, N), inv(N, N), prd(N, N);
+  cost.fillOverlapHamiltonianMatrices(ham, ovl);
+  if (zero_parameter >= 0)
+    REQUIRE(ovl(zero_parameter + 1, zero_parameter + 1) == 0.0);
+  inv.copy(ovl);
+  for (int i = 1; i < N; i++)
+  {
+    ham(i, i) += shift_i;
+    if (inv(i, i) == 0)
+      inv(i, i) = shift_i * shift_s;
+  }
+  invert_matrix(inv, false);
+  for (int i = 1; i < N; i++)
+    for (int j = 1; j < N; j++)
+      ham(i, j) += shift_s * ovl(i, j);
+  MatrixOperators::product(inv, ham, prd);
+  for (int i = 0; i < N; i++)
+    for (int j = i + 1; j < N; j++)
+      std::swap(prd(i, j), prd(j, i));
+  std::vector<Return_rt> ev_dense(N), ev_davidson(N);
+  const Return_rt lowest_dense = QMCLinearOptimizeBatched::getLowestEigenvector(prd, ev_dense);
+
+  const Return_rt lowest_davidson =
+      QMCLinearOptimizeBatched::getLowestEigenvectorDavidson(cost, shift_i, shift_s, 1e-10, 100, ev_davidson);
+  CHECK(lowest_davidson == Approx(lowest_dense));
+  for (int i = 0; i < N; i++)
+    CHECK(ev_davidson[i] == Approx(ev_dense[i]).margin(1e-8));
+}
+
+TEST_CASE("QMCLinearOptimizeBatched Davidson eigensolver", "[drivers]")
+{
+  checkDavidsonEigenvector(-1);
+  checkDavidsonEigenvector(2);
+}
 
 } // namespace qmcplusplus
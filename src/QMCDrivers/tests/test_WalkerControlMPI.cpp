@@ -9,6 +9,8 @@
 // File created by: Peter Doak, doakpw@ornl.gov, Oak Ridge National Laboratory
 //////////////////////////////////////////////////////////////////////////////////////
 
+#include <array>
+#include <fstream>
 #include <functional>
 
 #include "catch.hpp"
@@ -144,6 +146,174 @@ void UnifiedDriverWalkerControlMPITest::testPopulationDiff(std::vector<int>& ran
   CHECK(pop_->get_num_local_walkers() == rank_counts_after[rank]);
 }
 
+void UnifiedDriverWalkerControlMPITest::testMinimalMigration(std::vector<int>& rank_counts_before,
+                                                             std::vector<int>& rank_counts_after)
+{
+  int rank = dpools_.comm->rank();
+
+  pop_->get_walkers()[0]->Multiplicity = rank_counts_before[rank];
+
+  std::vector<WalkerElementsRef> walker_elements = pop_->get_walker_elements();
+
+  WalkerControlBase::PopulationAdjustment pop_adjust{rank_counts_before[rank],
+                                                     walker_elements,
+                                                     {rank_counts_before[rank] - 1},
+                                                     std::vector<WalkerElementsRef>{}};
+
+  WalkerControlBase::onRankKill(*pop_, pop_adjust);
+  WalkerControlBase::onRankSpawn(*pop_, pop_adjust);
+
+  // tag the walkers with their original rank
+  const double tag = 0.1 * (rank + 1);
+  for (auto we : pop_->get_walker_elements())
+  {
+    we.pset.R[0][0] = tag;
+    we.pset.saveWalker(we.walker);
+  }
+
+  WalkerControlBase::PopulationAdjustment pop_adjust2{rank_counts_before[rank], pop_->get_walker_elements(),
+                                                      std::vector<int>(pop_->get_num_local_walkers(), 0),
+                                                      std::vector<WalkerElementsRef>{}};
+
+  auto num_per_node = WalkerControlBase::syncFutureWalkersPerRank(dpools_.comm, pop_->get_num_local_walkers());
+
+  wc_.walker_migration_ = WalkerControlBase::WalkerMigration::MINIMAL;
+  wc_.swapWalkersSimple(*pop_, pop_adjust2, num_per_node);
+  CHECK(pop_->get_num_local_walkers() == rank_counts_after[rank]);
+
+  // the received walkers carry the positions of their original rank and a consistent wavefunction buffer
+  int num_received = 0;
+  for (auto we : pop_->get_walker_elements())
+    if (we.walker.R[0][0] != Approx(tag))
+    {
+      num_received++;
+      auto log_rebuilt = we.twf.getLogPsi();
+      we.twf.copyFromBuffer(we.pset, we.walker.DataSet);
+      CHECK(we.twf.getLogPsi() == Approx(log_rebuilt));
+      CHECK(we.pset.R[0][0] == Approx(we.walker.R[0][0]));
+    }
+  CHECK(num_received == std::max(rank_counts_after[rank] - rank_counts_before[rank], 0));
+}
+
+void UnifiedDriverWalkerControlMPITest::testMigrationPolicy()
+{
+  const int nexchanges = WalkerControlMPI::MigrationCalibrationExchanges;
+  const int rank       = dpools_.comm->rank();
+
+  wc_.walker_migration_ = WalkerControlBase::WalkerMigration::FULL;
+  CHECK_FALSE(wc_.useMinimalMigration());
+  wc_.walker_migration_ = WalkerControlBase::WalkerMigration::MINIMAL;
+  CHECK(wc_.useMinimalMigration());
+
+  // one calibration phase with each mode, the costs are accounted by the receiving ranks
+  auto calibrate = [this, nexchanges](double full_time, double minimal_time) {
+    for (int i = wc_.migration_exchanges_; i < nexchanges; i++)
+      CHECK_FALSE(wc_.useMinimalMigration());
+    wc_.migration_costs_[WalkerControlMPI::FULL_TIME] += full_time;
+    wc_.migration_costs_[WalkerControlMPI::FULL_WALKERS] += full_time > 0 ? 2 : 0;
+    for (int i = 0; i < nexchanges; i++)
+      CHECK(wc_.useMinimalMigration());
+    wc_.migration_costs_[WalkerControlMPI::MINIMAL_TIME] += minimal_time;
+    wc_.migration_costs_[WalkerControlMPI::MINIMAL_WALKERS] += minimal_time > 0 ? 2 : 0;
+  };
+
+  wc_.walker_migration_ = WalkerControlBase::WalkerMigration::AUTO;
+  // no walker was received with the minimal mode, the calibration starts over with full migration
+  calibrate(1.0, 0.0);
+  CHECK_FALSE(wc_.useMinimalMigration());
+  CHECK(wc_.migration_exchanges_ == 1);
+  // the mode cheaper per received walker over all the ranks is kept, whatever each rank measured
+  calibrate(rank == 0 ? 4.0 : 1.0, 1.5);
+  CHECK(wc_.useMinimalMigration());
+  CHECK(wc_.useMinimalMigration());
+  // start another calibration
+  wc_.migration_exchanges_ = 0;
+  calibrate(1.0, rank == 0 ? 6.0 : 0.5);
+  CHECK_FALSE(wc_.useMinimalMigration());
+  CHECK_FALSE(wc_.useMinimalMigration());
+}
+
+void UnifiedDriverWalkerControlMPITest::testPipelinedStatistics()
+{
+  int rank      = dpools_.comm->rank();
+  auto set_data = [this, rank](double scale) {
+    std::fill(wc_.curData.begin(), wc_.curData.end(), 0.0);
+    wc_.curData[WalkerControlBase::ENERGY_INDEX] = scale * (rank + 1);
+    wc_.curData[WalkerControlBase::WEIGHT_INDEX] = scale;
+  };
+
+  wc_.pipelined_branching_ = true;
+  // the first reduction is exact
+  set_data(1.0);
+  CHECK(wc_.reduceStatistics(0) == 0);
+  CHECK(wc_.curData[WalkerControlBase::ENERGY_INDEX] == Approx(6.0));
+  CHECK(wc_.curData[WalkerControlBase::WEIGHT_INDEX] == Approx(3.0));
+  // the second only posts its step
+  set_data(10.0);
+  CHECK(wc_.reduceStatistics(1) == -1);
+  // then the statistics lag by one step and every step is returned once
+  set_data(100.0);
+  CHECK(wc_.reduceStatistics(2) == 1);
+  CHECK(wc_.curData[WalkerControlBase::ENERGY_INDEX] == Approx(60.0));
+  CHECK(wc_.curData[WalkerControlBase::WEIGHT_INDEX] == Approx(30.0));
+  set_data(1000.0);
+  CHECK(wc_.reduceStatistics(3) == 2);
+  CHECK(wc_.curData[WalkerControlBase::ENERGY_INDEX] == Approx(600.0));
+  // the last step is measured by the flush
+  wc_.flushStatistics();
+  CHECK(wc_.ensemble_property_.Energy == Approx(2.0));
+  CHECK(wc_.ensemble_property_.Weight == Approx(3000.0));
+  CHECK_FALSE(wc_.stats_pending_);
+}
+
+void UnifiedDriverWalkerControlMPITest::testPipelinedBranch()
+{
+  using WP             = WalkerProperties::Indexes;
+  const int rank       = dpools_.comm->rank();
+  const int num_steps  = 4;
+  const std::array<std::string, 2> fnames{"walker_control_blocking.dmc.dat", "walker_control_pipelined.dmc.dat"};
+
+  // the population control requires at least as many walkers per rank as ranks
+  while (pop_->get_num_local_walkers() < dpools_.comm->size())
+    pop_->spawnWalker();
+  makeValidWalkers();
+
+  for (int pipelined = 0; pipelined < 2; pipelined++)
+  {
+    WalkerControlMPI wc(dpools_.comm);
+    wc.pipelined_branching_ = pipelined;
+    if (rank == 0)
+      wc.dmcStream = new std::ofstream(fnames[pipelined]);
+    for (int step = 0; step < num_steps; step++)
+    {
+      for (UPtr<MCPopulation::MCPWalker>& walker : pop_->get_walkers())
+      {
+        walker->Properties(WP::LOCALENERGY) = -1.0 - 0.25 * step - 0.5 * rank;
+        walker->Properties(WP::R2ACCEPTED)  = 0.5;
+        walker->Properties(WP::R2PROPOSED)  = 1.0;
+      }
+      wc.branch(step, *pop_);
+    }
+    wc.flushStatistics();
+  }
+
+  // every step is recorded under its own index with the energies of the blocking reduction
+  if (rank == 0)
+  {
+    std::array<std::vector<std::string>, 2> records;
+    for (int pipelined = 0; pipelined < 2; pipelined++)
+    {
+      std::ifstream fin(fnames[pipelined]);
+      std::string line;
+      while (std::getline(fin, line))
+        if (!line.empty())
+          records[pipelined].push_back(line);
+    }
+    CHECK(records[0].size() == num_steps);
+    CHECK(records[1] == records[0]);
+  }
+}
+
 void UnifiedDriverWalkerControlMPITest::reportWalkersPerRank(Communicate* c, MCPopulation& pop)
 {
 #if !defined(NDEBUG)
@@ -240,4 +410,54 @@ TEST_CASE("MPI WalkerControl population swap walkers", "[drivers][walker_control
 }
 
 
+TEST_CASE("MPI WalkerControl minimal walker migration", "[drivers][walker_control]")
+{
+  auto test_func = []() {
+    outputManager.pause();
+    testing::UnifiedDriverWalkerControlMPITest test;
+    outputManager.resume();
+    std::vector<int> count_before{3, 1, 1};
+    std::vector<int> count_after{1, 2, 2};
+    test.testMinimalMigration(count_before, count_after);
+  };
+  MPIExceptionWrapper mew;
+  mew(test_func);
+}
+
+TEST_CASE("MPI WalkerControl migration policy", "[drivers][walker_control]")
+{
+  auto test_func = []() {
+    outputManager.pause();
+    testing::UnifiedDriverWalkerControlMPITest test;
+    outputManager.resume();
+    test.testMigrationPolicy();
+  };
+  MPIExceptionWrapper mew;
+  mew(test_func);
+}
+
+TEST_CASE("MPI WalkerControl pipelined statistics", "[drivers][walker_control]")
+{
+  auto test_func = []() {
+    outputManager.pause();
+    testing::UnifiedDriverWalkerControlMPITest test;
+    outputManager.resume();
+    test.testPipelinedStatistics();
+  };
+  MPIExceptionWrapper mew;
+  mew(test_func);
+}
+
+TEST_CASE("MPI WalkerControl pipelined branch", "[drivers][walker_control]")
+{
+  auto test_func = []() {
+    outputManager.pause();
+    testing::UnifiedDriverWalkerControlMPITest test;
+    outputManager.resume();
+    test.testPipelinedBranch();
+  };
+  MPIExceptionWrapper mew;
+  mew(test_func);
+}
+
 } // namespace qmcplusplus
@@ -28,6 +28,10 @@ public:
   void testMultiplicity(std::vector<int>& rank_counts_expanded, std::vector<int>& rank_counts_after);
   void testPopulationDiff(std::vector<int>& rank_counts_before, std::vector<int>& rank_counts_after);
   void makeValidWalkers();
+  void testMinimalMigration(std::vector<int>& rank_counts_before, std::vector<int>& rank_counts_after);
+  void testMigrationPolicy();
+  void testPipelinedStatistics();
+  void testPipelinedBranch();
 
 private:
   void reportWalkersPerRank(Communicate* c, MCPopulation& pop);
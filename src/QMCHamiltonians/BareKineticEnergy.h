@@ -218,29 +218,55 @@ struct BareKineticEnergy : public OperatorBase
     }
     else
 #endif
-        if (SameMass)
+      Value = evaluateKinetic(P);
+    return Value;
+  }
+
+  /** evaluate a batch of walkers
+   *
+   * The kinetic energy only needs P.G and P.L, the walkers are evaluated in a single loop.
+   */
+  void mw_evaluate(const RefVector<OperatorBase>& O_list, const RefVector<ParticleSet>& P_list)
+  {
+#if !defined(REMOVE_TRACEMANAGER)
+    if (streaming_particles)
     {
-      //app_log() << "Here" << std::endl;
-      #ifdef QMC_COMPLEX  
-      Value = std::real( CplxDot(P.G, P.G) + CplxSum(P.L) );
-      Value *= -OneOver2M;
-      #else
-      Value = Dot(P.G, P.G) + Sum(P.L);
-      Value *= -OneOver2M;
-      #endif
+      OperatorBase::mw_evaluate(O_list, P_list);
+      return;
+    }
+#endif
+    for (int iw = 0; iw < O_list.size(); iw++)
+    {
+      BareKineticEnergy& O(static_cast<BareKineticEnergy&>(O_list[iw].get()));
+      O.Value = O.evaluateKinetic(P_list[iw]);
+    }
+  }
+
+  ///kinetic energy from the gradients and laplacians of P
+  inline Return_t evaluateKinetic(const ParticleSet& P) const
+  {
+    Return_t kinetic = 0.0;
+    if (SameMass)
+    {
+#ifdef QMC_COMPLEX
+      kinetic = std::real(CplxDot(P.G, P.G) + CplxSum(P.L));
+      kinetic *= -OneOver2M;
+#else
+      kinetic = Dot(P.G, P.G) + Sum(P.L);
+      kinetic *= -OneOver2M;
+#endif
     }
     else
     {
-      Value = 0.0;
       for (int i = 0; i < MinusOver2M.size(); ++i)
       {
         T x = 0.0;
         for (int j = P.first(i); j < P.last(i); ++j)
           x += laplacian(P.G[j], P.L[j]);
-        Value += x * MinusOver2M[i];
+        kinetic += x * MinusOver2M[i];
       }
     }
-    return Value;
+    return kinetic;
   }
 
   /**@brief Function to compute the value, direct ionic gradient terms, and pulay terms for the local kinetic energy.
@@ -172,6 +172,52 @@ CoulombPBCAA::Return_t CoulombPBCAA::evaluate(ParticleSet& P)
   return Value;
 }
 
+void CoulombPBCAA::mw_evaluate(const RefVector<OperatorBase>& O_list, const RefVector<ParticleSet>& P_list)
+{
+  // the value of an inactive AA term is a constant
+  if (!is_active)
+    return;
+#if defined(USE_REAL_STRUCT_FACTOR)
+  const StructFact& leader_sk(*P_list[0].get().SK);
+#if !defined(REMOVE_TRACEMANAGER)
+  if (leader_sk.SuperCellEnum != SUPERCELL_SLAB && !streaming_particles)
+#else
+  if (leader_sk.SuperCellEnum != SUPERCELL_SLAB)
+#endif
+  {
+    const size_t nw = O_list.size();
+    std::vector<mRealType> v_lr(nw, 0.0);
+    std::vector<mRealType> v_pair;
+    std::vector<const RealType*> rk1_r(nw), rk1_i(nw), rk2_r(nw), rk2_i(nw);
+    AA->expandFk(leader_sk.KLists.kshell, Fk_k);
+    for (int spec1 = 0; spec1 < NumSpecies; spec1++)
+      for (int spec2 = spec1; spec2 < NumSpecies; spec2++)
+      {
+        for (size_t iw = 0; iw < nw; iw++)
+        {
+          const StructFact& PtclRhoK(*P_list[iw].get().SK);
+          rk1_r[iw] = PtclRhoK.rhok_r[spec1];
+          rk1_i[iw] = PtclRhoK.rhok_i[spec1];
+          rk2_r[iw] = PtclRhoK.rhok_r[spec2];
+          rk2_i[iw] = PtclRhoK.rhok_i[spec2];
+        }
+        LRHandlerType::mw_evaluate(Fk_k, rk1_r, rk1_i, rk2_r, rk2_i, v_pair);
+        const mRealType z12 = (spec1 == spec2 ? 0.5 : 1.0) * Zspec[spec1] * Zspec[spec2];
+        for (size_t iw = 0; iw < nw; iw++)
+          v_lr[iw] += z12 * v_pair[iw];
+      }
+
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      CoulombPBCAA& O(static_cast<CoulombPBCAA&>(O_list[iw].get()));
+      O.Value = v_lr[iw] + O.evalSR(P_list[iw]) + O.myConst;
+    }
+    return;
+  }
+#endif
+  OperatorBase::mw_evaluate(O_list, P_list);
+}
+
 CoulombPBCAA::Return_t CoulombPBCAA::evaluateWithIonDerivs(ParticleSet& P,
                                                            ParticleSet& ions,
                                                            TrialWaveFunction& psi,
@@ -68,6 +68,8 @@ struct CoulombPBCAA : public OperatorBase, public ForceBase
   Matrix<RealType> SR2;
   Vector<RealType> dSR;
   Vector<ComplexType> del_eikr;
+  ///F_k of each k-point, used by mw_evaluate
+  std::vector<mRealType> Fk_k;
   /// Flag for whether to compute forces or not
   bool ComputeForces;
   //     madelung constant
@@ -90,6 +92,12 @@ struct CoulombPBCAA : public OperatorBase, public ForceBase
 
   Return_t evaluate(ParticleSet& P);
 
+  /** evaluate a batch of walkers
+   *
+   * The long-range part of all the walkers is computed from rho_k with a single k-point loop per walker and species pair.
+   */
+  void mw_evaluate(const RefVector<OperatorBase>& O_list, const RefVector<ParticleSet>& P_list);
+
   Return_t evaluateWithIonDerivs(ParticleSet& P,
                                  ParticleSet& ions,
                                  TrialWaveFunction& psi,
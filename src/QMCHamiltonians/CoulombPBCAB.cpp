@@ -174,6 +174,62 @@ CoulombPBCAB::Return_t CoulombPBCAB::evaluate(ParticleSet& P)
   return Value;
 }
 
+void CoulombPBCAB::mw_evaluate(const RefVector<OperatorBase>& O_list, const RefVector<ParticleSet>& P_list)
+{
+#if defined(USE_REAL_STRUCT_FACTOR)
+  const StructFact& RhoKA(*(PtclA.SK));
+#if !defined(REMOVE_TRACEMANAGER)
+  if (!ComputeForces && RhoKA.SuperCellEnum != SUPERCELL_SLAB && !streaming_particles)
+#else
+  if (!ComputeForces && RhoKA.SuperCellEnum != SUPERCELL_SLAB)
+#endif
+  {
+    const size_t nw = O_list.size();
+    AB->expandFk(RhoKA.KLists.kshell, Fk_k);
+    const int nk = Fk_k.size();
+
+    // sum_i Z_i rho^i_k of the sources
+    rhokA_r.assign(nk, 0.0);
+    rhokA_i.assign(nk, 0.0);
+    for (int i = 0; i < NumSpeciesA; i++)
+    {
+      const RealType z                 = Zspec[i];
+      const RealType* restrict rhok_r = RhoKA.rhok_r[i];
+      const RealType* restrict rhok_i = RhoKA.rhok_i[i];
+      for (int ki = 0; ki < nk; ki++)
+      {
+        rhokA_r[ki] += z * rhok_r[ki];
+        rhokA_i[ki] += z * rhok_i[ki];
+      }
+    }
+
+    std::vector<mRealType> v_lr(nw, 0.0);
+    std::vector<mRealType> v_spec;
+    const std::vector<const RealType*> rk1_r(nw, rhokA_r.data()), rk1_i(nw, rhokA_i.data());
+    std::vector<const RealType*> rk2_r(nw), rk2_i(nw);
+    for (int j = 0; j < NumSpeciesB; j++)
+    {
+      for (size_t iw = 0; iw < nw; iw++)
+      {
+        rk2_r[iw] = P_list[iw].get().SK->rhok_r[j];
+        rk2_i[iw] = P_list[iw].get().SK->rhok_i[j];
+      }
+      LRHandlerType::mw_evaluate(Fk_k, rk1_r, rk1_i, rk2_r, rk2_i, v_spec);
+      for (size_t iw = 0; iw < nw; iw++)
+        v_lr[iw] += Qspec[j] * v_spec[iw];
+    }
+
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      CoulombPBCAB& O(static_cast<CoulombPBCAB&>(O_list[iw].get()));
+      O.Value = v_lr[iw] + O.evalSR(P_list[iw]) + O.myConst;
+    }
+    return;
+  }
+#endif
+  OperatorBase::mw_evaluate(O_list, P_list);
+}
+
 CoulombPBCAB::Return_t CoulombPBCAB::evaluateWithIonDerivs(ParticleSet& P,
                                                            ParticleSet& ions,
                                                            TrialWaveFunction& psi,
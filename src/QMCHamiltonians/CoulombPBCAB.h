@@ -107,6 +107,11 @@ struct CoulombPBCAB : public OperatorBase, public ForceBase
   Vector<RealType> LRpart;
   /*@}*/
 
+  ///F_k of each k-point, used by mw_evaluate
+  std::vector<mRealType> Fk_k;
+  ///charge weighted rho_k of A, used by mw_evaluate
+  std::vector<RealType> rhokA_r, rhokA_i;
+
   //This is set to true if the K_c of structure-factors are different
   bool kcdifferent;
   RealType minkc;
@@ -140,6 +145,13 @@ struct CoulombPBCAB : public OperatorBase, public ForceBase
 
 
   Return_t evaluate(ParticleSet& P);
+
+  /** evaluate a batch of walkers
+   *
+   * The rho_k of the sources, the same for all the walkers, is combined once and the long-range part
+   * of all the walkers is computed with a single k-point loop per walker and target species.
+   */
+  void mw_evaluate(const RefVector<OperatorBase>& O_list, const RefVector<ParticleSet>& P_list);
   Return_t evaluateWithIonDerivs(ParticleSet& P,
                                  ParticleSet& ions,
                                  TrialWaveFunction& psi,
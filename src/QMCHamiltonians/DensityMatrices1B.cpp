@@ -312,7 +312,7 @@ void DensityMatrices1B::initialize()
 
   rsamples.resize(samples);
   sample_weights.resize(samples);
-  psi_ratios.resize(nparticles);
+  psi_ratios.resize(samples, nparticles);
 
   if (evaluator == matrix)
   {
@@ -1159,22 +1159,17 @@ void DensityMatrices1B::generate_sample_basis(Matrix_t& Phi_mb)
 void DensityMatrices1B::generate_sample_ratios(std::vector<Matrix_t*> Psi_nm)
 {
   ScopedTimer t(timers[DM_gen_sample_ratios]);
-  for (int m = 0; m < samples; ++m)
-  {
-    // get N ratios for the current sample point
-    Pq.makeVirtualMoves(rsamples[m]);
-    Psi.evaluateRatiosAlltoOne(Pq, psi_ratios);
+  // get N ratios for all the sample points at once
+  Psi.evaluateRatiosAlltoMany(Pq, rsamples, psi_ratios);
 
-    // collect ratios into per-species matrices
-    int p = 0;
-    for (int s = 0; s < nspecies; ++s)
-    {
-      Matrix_t& P_nm = *Psi_nm[s];
-      for (int n = 0; n < species_size[s]; ++n, ++p)
-      {
-        P_nm(n,m) = qmcplusplus::conj(psi_ratios[p]);
-      }
-    }
+  // collect ratios into per-species matrices
+  int p = 0;
+  for (int s = 0; s < nspecies; ++s)
+  {
+    Matrix_t& P_nm = *Psi_nm[s];
+    for (int n = 0; n < species_size[s]; ++n, ++p)
+      for (int m = 0; m < samples; ++m)
+        P_nm(n, m) = qmcplusplus::conj(psi_ratios(m, p));
   }
 }
 
@@ -141,7 +141,7 @@ bool ECPotentialBuilder::put(xmlNodePtr cur)
       if (nonLocalPot[i])
       {
         nknot_max = std::max(nknot_max, nonLocalPot[i]->getNknot());
-        if (NLPP_algo == "batched")
+        if (NLPP_algo == "batched" || NLPP_algo == "batched_pairs")
           nonLocalPot[i]->initVirtualParticle(targetPtcl);
         apot->addComponent(i, nonLocalPot[i]);
       }
@@ -150,6 +150,11 @@ bool ECPotentialBuilder::put(xmlNodePtr cur)
               << "    Maximum grid on a sphere for NonLocalECPotential: " << nknot_max << std::endl;
     if (NLPP_algo == "batched")
       app_log() << "    Using batched ratio computing in NonLocalECP" << std::endl;
+    if (NLPP_algo == "batched_pairs")
+    {
+      app_log() << "    Using batched ratio computing over all the ion-electron pairs in NonLocalECP" << std::endl;
+      apot->enablePairBatching();
+    }
 
     targetH.addOperator(apot, "NonLocalECP");
   }
@@ -29,7 +29,7 @@ MomentumEstimator::MomentumEstimator(ParticleSet& elns, TrialWaveFunction& psi)
     : M(40), refPsi(psi), Lattice(elns.Lattice), norm_nofK(1), hdf5_out(false)
 {
   UpdateMode.set(COLLECTABLE, 1);
-  psi_ratios.resize(elns.getTotalNum());
+  psi_ratios_all.resize(M, elns.getTotalNum());
   twist = elns.getTwist();
 }
 
@@ -46,37 +46,54 @@ MomentumEstimator::Return_t MomentumEstimator::evaluate(ParticleSet& P)
       newpos[i] = myRNG();
     //make it cartesian
     vPos[s] = Lattice.toCart(newpos);
-    P.makeVirtualMoves(vPos[s]);
-    refPsi.evaluateRatiosAlltoOne(P, psi_ratios);
-    for (int i = 0; i < np; ++i)
-      psi_ratios_all[s][i] = psi_ratios[i];
-
     for (int ik = 0; ik < nk; ++ik)
       kdotp[ik] = -dot(kPoints[ik], vPos[s]);
     eval_e2iphi(nk, kdotp.data(), phases_vPos[s].data(0), phases_vPos[s].data(1));
   }
+  refPsi.evaluateRatiosAlltoMany(P, vPos, psi_ratios_all);
 
-  std::fill_n(nofK.begin(), nk, RealType(0));
+  // nofK[ik] = Re sum_s exp(-i k.vPos[s]) sum_i psi_ratios_all(s,i) exp(i k.R[i])
+  // the sum over the particles is a (samples x particles) x (particles x k-points) GEMM
   for (int i = 0; i < np; ++i)
   {
     for (int ik = 0; ik < nk; ++ik)
       kdotp[ik] = dot(kPoints[ik], P.R[i]);
-    eval_e2iphi(nk, kdotp.data(), phases.data(0), phases.data(1));
-    for (int s = 0; s < M; ++s)
-    {
-      const ComplexType one_ratio(psi_ratios_all[s][i]);
-      const RealType ratio_c                 = one_ratio.real();
-      const RealType ratio_s                 = one_ratio.imag();
-      const RealType* restrict phases_c      = phases.data(0);
-      const RealType* restrict phases_s      = phases.data(1);
-      const RealType* restrict phases_vPos_c = phases_vPos[s].data(0);
-      const RealType* restrict phases_vPos_s = phases_vPos[s].data(1);
-      RealType* restrict nofK_here           = nofK.data();
-#pragma omp simd aligned(nofK_here, phases_c, phases_s, phases_vPos_c, phases_vPos_s)
-      for (int ik = 0; ik < nk; ++ik)
-        nofK_here[ik] += (phases_c[ik] * phases_vPos_c[ik] - phases_s[ik] * phases_vPos_s[ik]) * ratio_c -
-            (phases_s[ik] * phases_vPos_c[ik] + phases_c[ik] * phases_vPos_s[ik]) * ratio_s;
-    }
+#if defined(QMC_COMPLEX)
+    eval_e2iphi(nk, kdotp.data(), phases[i]);
+#else
+    eval_e2iphi(nk, kdotp.data(), phases_c[i], phases_s[i]);
+#endif
+  }
+#if defined(QMC_COMPLEX)
+  BLAS::gemm('N', 'N', nk, M, np, ValueType(1), phases.data(), nk, psi_ratios_all.data(), np, ValueType(0),
+             ratios_phases.data(), nk);
+#else
+  BLAS::gemm('N', 'N', nk, M, np, RealType(1), phases_c.data(), nk, psi_ratios_all.data(), np, RealType(0),
+             ratios_phases_c.data(), nk);
+  BLAS::gemm('N', 'N', nk, M, np, RealType(1), phases_s.data(), nk, psi_ratios_all.data(), np, RealType(0),
+             ratios_phases_s.data(), nk);
+#endif
+
+  std::fill_n(nofK.begin(), nk, RealType(0));
+  for (int s = 0; s < M; ++s)
+  {
+#if defined(QMC_COMPLEX)
+    const ValueType* restrict rp = ratios_phases[s];
+#else
+    const RealType* restrict rp_c = ratios_phases_c[s];
+    const RealType* restrict rp_s = ratios_phases_s[s];
+#endif
+    const RealType* restrict phases_vPos_c = phases_vPos[s].data(0);
+    const RealType* restrict phases_vPos_s = phases_vPos[s].data(1);
+    RealType* restrict nofK_here           = nofK.data();
+#if defined(QMC_COMPLEX)
+    for (int ik = 0; ik < nk; ++ik)
+      nofK_here[ik] += rp[ik].real() * phases_vPos_c[ik] - rp[ik].imag() * phases_vPos_s[ik];
+#else
+#pragma omp simd aligned(nofK_here, phases_vPos_c, phases_vPos_s)
+    for (int ik = 0; ik < nk; ++ik)
+      nofK_here[ik] += rp_c[ik] * phases_vPos_c[ik] - rp_s[ik] * phases_vPos_s[ik];
+#endif
   }
   if (hdf5_out)
   {
@@ -407,14 +424,7 @@ bool MomentumEstimator::putSpecial(xmlNodePtr cur, ParticleSet& elns, bool rootN
     }
     fout.close();
   }
-  nofK.resize(kPoints.size());
-  kdotp.resize(kPoints.size());
-  vPos.resize(M);
-  phases.resize(kPoints.size());
-  phases_vPos.resize(M);
-  for (int im = 0; im < M; im++)
-    phases_vPos[im].resize(kPoints.size());
-  psi_ratios_all.resize(M, psi_ratios.size());
+  resize(kPoints, M);
   norm_nofK = 1.0 / RealType(M);
   return true;
 }
@@ -437,11 +447,20 @@ void MomentumEstimator::resize(const std::vector<PosType>& kin, const int Min)
   kPoints = kin;
   nofK.resize(kin.size());
   kdotp.resize(kPoints.size());
-  phases.resize(kPoints.size());
   //M
   M = Min;
   vPos.resize(M);
-  psi_ratios_all.resize(M, psi_ratios.size());
+  const int np = psi_ratios_all.cols();
+  psi_ratios_all.resize(M, np);
+#if defined(QMC_COMPLEX)
+  phases.resize(np, kPoints.size());
+  ratios_phases.resize(M, kPoints.size());
+#else
+  phases_c.resize(np, kPoints.size());
+  phases_s.resize(np, kPoints.size());
+  ratios_phases_c.resize(M, kPoints.size());
+  ratios_phases_s.resize(M, kPoints.size());
+#endif
   phases_vPos.resize(M);
   for (int im = 0; im < M; im++)
     phases_vPos[im].resize(kPoints.size());
@@ -49,14 +49,21 @@ public:
   RandomGenerator_t myRNG;
   ///sample positions
   std::vector<PosType> vPos;
-  ///wavefunction ratios
-  std::vector<ValueType> psi_ratios;
-  ///wavefunction ratios all samples
+  ///wavefunction ratios all samples, M x number of particles
   Matrix<ValueType> psi_ratios_all;
   ///nofK internal
   Vector<RealType> kdotp;
-  ///phases
-  VectorSoaContainer<RealType, 2> phases;
+#if defined(QMC_COMPLEX)
+  ///phases of the particles, number of particles x number of k-points
+  Matrix<ValueType> phases;
+  ///ratios summed over the particles with the phases, M x number of k-points
+  Matrix<ValueType> ratios_phases;
+#else
+  ///cos and sin of the phases of the particles, number of particles x number of k-points
+  Matrix<RealType> phases_c, phases_s;
+  ///ratios summed over the particles with the cos and sin of the phases, M x number of k-points
+  Matrix<RealType> ratios_phases_c, ratios_phases_s;
+#endif
   ///phases of vPos
   std::vector<VectorSoaContainer<RealType, 2>> phases_vPos;
   ///list of k-points in Cartesian Coordinates
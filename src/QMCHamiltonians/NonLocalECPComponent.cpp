@@ -265,6 +265,84 @@ void NonLocalECPComponent::flex_evaluateOne(const RefVector<NonLocalECPComponent
                                                           joblist[0].get().ion_elec_displ, use_DLA);
 }
 
+void NonLocalECPComponent::calculateProjectors(const RefVector<const NLPPJob<RealType>>& joblist,
+                                               const RefVector<const std::vector<ValueType>>& ratios_list,
+                                               const RefVector<std::vector<RealType>>& knot_pots_list,
+                                               RealType* pairpots)
+{
+  const size_t npairs = joblist.size();
+  const size_t ntot   = npairs * nknot;
+  batch_zz.resize(ntot);
+  batch_lpol_prev.resize(ntot);
+  batch_lpol.resize(ntot);
+  batch_lsum.resize(ntot);
+  batch_vrad.resize(npairs * nchannel);
+
+  RealType* restrict zz        = batch_zz.data();
+  RealType* restrict lpol_prev = batch_lpol_prev.data();
+  RealType* restrict lpol_cur  = batch_lpol.data();
+  RealType* restrict lsum      = batch_lsum.data();
+  RealType* restrict vr        = batch_vrad.data();
+
+  // radial potentials multiplied by (2l+1) and cos(theta) of all the quadrature points
+  for (size_t ip = 0; ip < npairs; ip++)
+  {
+    const NLPPJob<RealType>& job = joblist[ip];
+    for (int ic = 0; ic < nchannel; ic++)
+      vr[ip * nchannel + ic] = nlpp_m[ic]->splint(job.ion_elec_dist) * wgt_angpp_m[ic];
+    const RealType rinv = RealType(1) / job.ion_elec_dist;
+    for (int j = 0; j < nknot; j++)
+      zz[ip * nknot + j] = dot(job.ion_elec_displ, rrotsgrid_m[j]) * rinv;
+  }
+
+  // Legendre polynomials by recursion, the channels of each l are added as soon as P_l is available
+  for (size_t i = 0; i < ntot; i++)
+  {
+    lpol_prev[i] = RealType(0);
+    lpol_cur[i]  = RealType(1);
+    lsum[i]      = RealType(0);
+  }
+  for (int l = 0; l <= lmax; l++)
+  {
+    if (l > 0)
+    {
+      const RealType f1 = Lfactor1[l - 1];
+      const RealType f2 = Lfactor2[l - 1];
+      const RealType lm = static_cast<RealType>(l - 1);
+#pragma omp simd
+      for (size_t i = 0; i < ntot; i++)
+      {
+        const RealType lpol_next = (f1 * zz[i] * lpol_cur[i] - lm * lpol_prev[i]) * f2;
+        lpol_prev[i]             = lpol_cur[i];
+        lpol_cur[i]              = lpol_next;
+      }
+    }
+    for (int ic = 0; ic < nchannel; ic++)
+      if (angpp_m[ic] == l)
+        for (size_t ip = 0; ip < npairs; ip++)
+        {
+          const RealType v = vr[ip * nchannel + ic];
+#pragma omp simd
+          for (int j = 0; j < nknot; j++)
+            lsum[ip * nknot + j] += v * lpol_cur[ip * nknot + j];
+        }
+  }
+
+  for (size_t ip = 0; ip < npairs; ip++)
+  {
+    const std::vector<ValueType>& ratios = ratios_list[ip];
+    std::vector<RealType>& knot_pots     = knot_pots_list[ip];
+    knot_pots.resize(nknot);
+    RealType pairpot = RealType(0);
+    for (int j = 0; j < nknot; j++)
+    {
+      knot_pots[j] = std::real(lsum[ip * nknot + j] * sgridweight_m[j] * ratios[j]);
+      pairpot += knot_pots[j];
+    }
+    pairpots[ip] = pairpot;
+  }
+}
+
 NonLocalECPComponent::RealType NonLocalECPComponent::evaluateOneWithForces(ParticleSet& W,
                                                                            int iat,
                                                                            TrialWaveFunction& psi,
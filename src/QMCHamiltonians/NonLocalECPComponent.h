@@ -94,6 +94,9 @@ private:
   Matrix<ValueType> dratio;
   std::vector<ValueType> dlogpsi_vp;
 
+  /// scratch spaces used by calculateProjectors, one entry per (pair, knot) or (pair, channel)
+  aligned_vector<RealType> batch_zz, batch_lpol_prev, batch_lpol, batch_lsum, batch_vrad;
+
   // For Pulay correction to the force
   std::vector<RealType> WarpNorm;
   ParticleSet::ParticleGradient_t dG;
@@ -186,6 +189,28 @@ public:
                                std::vector<RealType>& pairpots,
                                bool use_DLA);
 
+  /** @brief vectorized calculateProjector for a set of ion-electron pairs using this component
+   *
+   * @param joblist a list of ion-electron pairs
+   * @param ratios_list wavefunction ratios at the quadrature points of each pair
+   * @param knot_pots_list contribution per quadrature point of each pair, used by T-moves
+   * @param pairpots contribution to $\frac{V\Psi_T}{\Psi_T}$ of each pair
+   *
+   * The Legendre recursion and the angular sum run over all the (pair, knot) entries at once.
+   * The quadrature grid of this component must not be randomized between the ratio evaluation and this call.
+   */
+  void calculateProjectors(const RefVector<const NLPPJob<RealType>>& joblist,
+                           const RefVector<const std::vector<ValueType>>& ratios_list,
+                           const RefVector<std::vector<RealType>>& knot_pots_list,
+                           RealType* pairpots);
+
+  /// build QP position deltas of a pair from the reference electron, nknot entries
+  void buildQuadraturePointDeltas(RealType r, const PosType& dr, std::vector<PosType>& deltas) const
+  {
+    deltas.resize(nknot);
+    buildQuadraturePointDeltaPositions(r, dr, deltas);
+  }
+
   /** @brief Evaluate the nonlocal pp contribution via randomized quadrature grid
    * to total energy from ion "iat" and electron "iel".
    *
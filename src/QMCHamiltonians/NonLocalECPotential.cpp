@@ -18,6 +18,7 @@
 #include "NonLocalECPotential.h"
 #include "QMCHamiltonians/NonLocalECPComponent.h"
 #include "QMCHamiltonians/NLPPJob.h"
+#include "Particle/VirtualParticleSet.h"
 #include "Utilities/IteratorUtility.h"
 
 namespace qmcplusplus
@@ -44,7 +45,8 @@ NonLocalECPotential::NonLocalECPotential(ParticleSet& ions,
       UseTMove(TMOVE_OFF),
       nonLocalOps(els.getTotalNum()),
       ComputeForces(computeForces),
-      use_DLA(enable_DLA)
+      use_DLA(enable_DLA),
+      use_pair_batching(false)
 {
   set_energy_domain(potential);
   two_body_quantum_domain(ions, els);
@@ -281,6 +283,12 @@ void NonLocalECPotential::mw_evaluateImpl(const RefVector<OperatorBase>& O_list,
     O.Value = 0.0;
   }
 
+  if (use_pair_batching)
+  {
+    mw_evaluatePairs(O_list, P_list, Tmove);
+    return;
+  }
+
   RefVector<NonLocalECPotential> ecp_potential_list;
   RefVector<NonLocalECPComponent> ecp_component_list;
   RefVector<ParticleSet> p_list;
@@ -339,6 +347,152 @@ void NonLocalECPotential::mw_evaluateImpl(const RefVector<OperatorBase>& O_list,
     }
 }
 
+void NonLocalECPotential::mw_evaluatePairs(const RefVector<OperatorBase>& O_list,
+                                           const RefVector<ParticleSet>& P_list,
+                                           bool Tmove)
+{
+  const size_t nw = O_list.size();
+
+  RefVector<TrialWaveFunction> psi_list;
+  RefVector<VirtualParticleSet> vp_list;
+  RefVector<const VirtualParticleSet> const_vp_list;
+  RefVector<const std::vector<PosType>> deltaV_list;
+  RefVector<std::vector<ValueType>> ratios_list;
+  RefVector<const NLPPJob<RealType>> batch_list;
+
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    NonLocalECPotential& O(static_cast<NonLocalECPotential&>(O_list[iw].get()));
+    size_t num_jobs = 0;
+    for (const auto& joblist : O.nlpp_jobs)
+      num_jobs += joblist.size();
+    O.pair_deltaV.resize(num_jobs);
+    O.pair_ratios.resize(num_jobs);
+    O.pair_knot_pots.resize(num_jobs);
+  }
+
+  // one batched call per electron group, SlaterDet picks the determinant from the group of vp_list[0].refPtcl
+  std::map<int, size_t> vp_count;
+  for (size_t ig = 0; ig < nlpp_jobs.size(); ig++)
+  {
+    psi_list.clear();
+    vp_list.clear();
+    const_vp_list.clear();
+    deltaV_list.clear();
+    ratios_list.clear();
+    batch_list.clear();
+
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      NonLocalECPotential& O(static_cast<NonLocalECPotential&>(O_list[iw].get()));
+      // the pairs are stored in group order
+      size_t ijob = 0;
+      for (size_t jg = 0; jg < ig; jg++)
+        ijob += O.nlpp_jobs[jg].size();
+
+      // the virtual particle sets of a walker are reused by every group
+      vp_count.clear();
+      for (const auto& job : O.nlpp_jobs[ig])
+      {
+        const NonLocalECPComponent& component(*O.PP[job.ion_id]);
+        const int nknot = component.getNknot();
+        component.buildQuadraturePointDeltas(job.ion_elec_dist, job.ion_elec_displ, O.pair_deltaV[ijob]);
+        O.pair_ratios[ijob].resize(nknot);
+        VirtualParticleSet& vp(O.getPairVP(nknot, vp_count[nknot]++));
+
+        psi_list.push_back(O.Psi);
+        vp_list.push_back(vp);
+        const_vp_list.push_back(vp);
+        deltaV_list.push_back(O.pair_deltaV[ijob]);
+        ratios_list.push_back(O.pair_ratios[ijob]);
+        batch_list.push_back(job);
+        ijob++;
+      }
+    }
+
+    if (psi_list.empty())
+      continue;
+
+    // a walker appears once per pair in psi_list
+    VirtualParticleSet::flex_makeMoves(vp_list, deltaV_list, batch_list, true);
+    if (use_DLA)
+      Psi.flex_evaluateRatios(psi_list, const_vp_list, ratios_list, TrialWaveFunction::ComputeType::FERMIONIC);
+    else
+      Psi.flex_evaluateRatios(psi_list, const_vp_list, ratios_list);
+  }
+
+#pragma omp parallel for
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    NonLocalECPotential& O(static_cast<NonLocalECPotential&>(O_list[iw].get()));
+    const size_t num_jobs = O.pair_ratios.size();
+    std::vector<RealType> pairpots(num_jobs);
+    std::vector<RealType> component_pots;
+    std::vector<size_t> job_ids;
+    RefVector<const NLPPJob<RealType>> component_jobs;
+    RefVector<const std::vector<ValueType>> component_ratios;
+    RefVector<std::vector<RealType>> component_knot_pots;
+
+    // contract the pairs sharing the same component at once
+    for (NonLocalECPComponent* component : O.PPset)
+    {
+      if (component == nullptr)
+        continue;
+      job_ids.clear();
+      component_jobs.clear();
+      component_ratios.clear();
+      component_knot_pots.clear();
+      size_t ijob = 0;
+      for (const auto& joblist : O.nlpp_jobs)
+        for (const auto& job : joblist)
+        {
+          if (O.PP[job.ion_id] == component)
+          {
+            job_ids.push_back(ijob);
+            component_jobs.push_back(job);
+            component_ratios.push_back(O.pair_ratios[ijob]);
+            component_knot_pots.push_back(O.pair_knot_pots[ijob]);
+          }
+          ijob++;
+        }
+      if (job_ids.empty())
+        continue;
+      component_pots.resize(job_ids.size());
+      component->calculateProjectors(component_jobs, component_ratios, component_knot_pots, component_pots.data());
+      for (size_t i = 0; i < job_ids.size(); i++)
+        pairpots[job_ids[i]] = component_pots[i];
+    }
+
+    size_t ijob = 0;
+    for (const auto& joblist : O.nlpp_jobs)
+      for (const auto& job : joblist)
+      {
+        O.Value += pairpots[ijob];
+        if (Tmove)
+        {
+          const auto& knot_pots = O.pair_knot_pots[ijob];
+          const auto& deltaV    = O.pair_deltaV[ijob];
+          for (size_t j = 0; j < knot_pots.size(); j++)
+            O.nonLocalOps.Txy.push_back(NonLocalData(job.electron_id, knot_pots[j], deltaV[j]));
+        }
+        ijob++;
+      }
+  }
+}
+
+VirtualParticleSet& NonLocalECPotential::getPairVP(int nknot, size_t ivp)
+{
+  auto& vps = pair_vps[nknot];
+  if (ivp >= vps.size())
+  {
+    outputManager.pause();
+    while (vps.size() <= ivp)
+      vps.push_back(std::make_unique<VirtualParticleSet>(Peln, nknot));
+    outputManager.resume();
+  }
+  return *vps[ivp];
+}
+
 NonLocalECPotential::Return_t NonLocalECPotential::evaluateWithIonDerivs(ParticleSet& P,
                                                                          ParticleSet& ions,
                                                                          TrialWaveFunction& psi,
@@ -540,6 +694,7 @@ void NonLocalECPotential::addComponent(int groupID, NonLocalECPComponent* ppot)
 OperatorBase* NonLocalECPotential::makeClone(ParticleSet& qp, TrialWaveFunction& psi)
 {
   NonLocalECPotential* myclone = new NonLocalECPotential(IonConfig, qp, psi, ComputeForces, use_DLA);
+  myclone->use_pair_batching   = use_pair_batching;
   for (int ig = 0; ig < PPset.size(); ++ig)
   {
     if (PPset[ig])
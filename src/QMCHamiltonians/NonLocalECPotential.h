@@ -19,10 +19,18 @@
 #include "QMCHamiltonians/NonLocalTOperator.h"
 #include "QMCHamiltonians/ForceBase.h"
 #include "Particle/NeighborLists.h"
+#include <map>
+#include <memory>
 
 namespace qmcplusplus
 {
+namespace testing
+{
+class TestNonLocalECPotential;
+}
+
 class NonLocalECPComponent;
+class VirtualParticleSet;
 template<typename T>
 struct NLPPJob;
 
@@ -94,6 +102,15 @@ public:
 
   void addComponent(int groupID, NonLocalECPComponent* pp);
 
+  /** evaluate all the ion-electron pairs of a walker batch together in mw_evaluate
+   *
+   * The quadrature points of all the pairs of all the walkers are moved and their ratios are computed
+   * by a single TrialWaveFunction::flex_evaluateRatios call instead of one call per pair index.
+   * Each walker keeps one VirtualParticleSet per pair in pair_vps, the pool grows to the largest number
+   * of ion-electron pairs seen and is not released.
+   */
+  void enablePairBatching() { use_pair_batching = true; }
+
   /** set the internal RNG pointer as the given pointer
    * @param rng input RNG pointer
    */
@@ -140,6 +157,16 @@ private:
   bool ComputeForces;
   ///true, determinant localization approximation(DLA) is enabled
   bool use_DLA;
+  ///true, mw_evaluate computes the ratios of all the pairs in a walker batch at once
+  bool use_pair_batching;
+  ///virtual particle sets for the pairs of this walker, grouped by the number of quadrature points
+  std::map<int, std::vector<std::unique_ptr<VirtualParticleSet>>> pair_vps;
+  ///quadrature point displacements of each pair of this walker
+  std::vector<std::vector<PosType>> pair_deltaV;
+  ///wavefunction ratios at the quadrature points of each pair of this walker
+  std::vector<std::vector<ValueType>> pair_ratios;
+  ///contribution of each quadrature point of each pair of this walker, used by T-moves
+  std::vector<std::vector<RealType>> pair_knot_pots;
   ///Pulay force vector
   ParticleSet::ParticlePos_t PulayTerm;
 #if !defined(REMOVE_TRACEMANAGER)
@@ -163,6 +190,18 @@ private:
    */
   void mw_evaluateImpl(const RefVector<OperatorBase>& O_list, const RefVector<ParticleSet>& P_list, bool Tmove);
 
+  /** evaluate the ion-electron pairs listed in nlpp_jobs of all the walkers together, used by mw_evaluateImpl
+   * @param O_list the list of NonLocalECPotential in a walker batch
+   * @param P_list the list of ParticleSet in a walker batch
+   * @param Tmove whether Txy for Tmove is updated
+   */
+  void mw_evaluatePairs(const RefVector<OperatorBase>& O_list, const RefVector<ParticleSet>& P_list, bool Tmove);
+
+  /// return the ivp-th virtual particle set with nknot particles, created if not available yet
+  VirtualParticleSet& getPairVP(int nknot, size_t ivp);
+
+  friend class testing::TestNonLocalECPotential;
+
   /** compute the T move transition probability for a given electron
    * member variable nonLocalOps.Txy is updated
    * @param P particle set
@@ -14,6 +14,7 @@
 #include "SpaceGrid.h"
 #include "OhmmsData/AttributeSet.h"
 #include "Utilities/string_utils.h"
+#include <algorithm>
 #include <cmath>
 #include "OhmmsPETE/OhmmsArray.h"
 
@@ -821,251 +822,125 @@ void SpaceGrid::registerCollectables(std::vector<observable_helper*>& h5desc, hi
 #define SPACEGRID_CHECK
 
 
+void SpaceGrid::locate_particles(const ParticlePos_t& R, int nparticles, const DistanceTableData& dtab)
+{
+  const RealType o2pi = 1.0 / (2.0 * M_PI);
+  auto inside         = [this](const Point& u) {
+    return u[0] > umin[0] && u[0] < umax[0] && u[1] > umin[1] && u[1] < umax[1] && u[2] > umin[2] && u[2] < umax[2];
+  };
+  auto domain = [this](const Point& u) {
+    int nd = 0;
+    for (int d = 0; d < DIM; ++d)
+      nd += dm[d] * gmap[d][floor((u[d] - umin[d]) * odu[d])];
+    return nd;
+  };
+  particle_domain.resize(nparticles);
+  switch (coordinate)
+  {
+  case cartesian:
+    for (int p = 0; p < nparticles; p++)
+    {
+      u                  = dot(axinv, (R[p] - origin));
+      particle_domain[p] = ((periodic && !chempot) || inside(u)) ? domain(u) : -1;
+    }
+    break;
+  case cylindrical:
+    for (int p = 0; p < nparticles; p++)
+    {
+      ub                 = dot(axinv, (R[p] - origin));
+      u[0]               = sqrt(ub[0] * ub[0] + ub[1] * ub[1]);
+      u[1]               = atan2(ub[1], ub[0]) * o2pi + .5;
+      u[2]               = ub[2];
+      particle_domain[p] = inside(u) ? domain(u) : -1;
+    }
+    break;
+  case spherical:
+    for (int p = 0; p < nparticles; p++)
+    {
+      ub                 = dot(axinv, (R[p] - origin));
+      u[0]               = sqrt(ub[0] * ub[0] + ub[1] * ub[1] + ub[2] * ub[2]);
+      u[1]               = atan2(ub[1], ub[0]) * o2pi + .5;
+      u[2]               = acos(ub[2] / u[0]) * o2pi * 2.0;
+      particle_domain[p] = inside(u) ? domain(u) : -1;
+    }
+    break;
+  case voronoi:
+    if (chempot)
+      APP_ABORT("SoA transformation needed for Voronoi grids");
+    //find cell center nearest to each dynamic particle
+    for (int p = 0; p < ndparticles; p++)
+    {
+      const auto& dist = dtab.getDistRow(p);
+      for (int nd = 0; nd < ndomains; nd++)
+        if (dist[nd] < nearcell[p].r)
+        {
+          nearcell[p].r = dist[nd];
+          nearcell[p].i = nd;
+        }
+      particle_domain[p] = nearcell[p].i;
+      nearcell[p].r      = std::numeric_limits<RealType>::max();
+    }
+    //static particles are the cell centers
+    for (int p = ndparticles; p < nparticles; p++)
+      particle_domain[p] = p - ndparticles;
+    break;
+  default:
+    app_log() << "  coordinate type must be cartesian, cylindrical, spherical, or voronoi" << std::endl;
+    APP_ABORT("SpaceGrid::evaluate");
+  }
+}
+
+
 void SpaceGrid::evaluate(const ParticlePos_t& R,
                          const Matrix<RealType>& values,
                          BufferType& buf,
                          std::vector<bool>& particles_outside,
                          const DistanceTableData& dtab)
 {
-  int p, v;
-  int nparticles = values.size1();
-  int nvalues    = values.size2();
-  int iu[DIM];
-  int buf_index;
-  const RealType o2pi = 1.0 / (2.0 * M_PI);
+  const int nparticles = values.size1();
+  const int nvalues    = values.size2();
+  locate_particles(R, nparticles, dtab);
   if (!chempot)
   {
-    switch (coordinate)
+    for (int p = 0; p < nparticles; p++)
     {
-    case cartesian:
-      if (periodic)
-      {
-        for (p = 0; p < nparticles; p++)
-        {
-          particles_outside[p] = false;
-          u = dot(axinv, (R[p] - origin));
-          for (int d=0; d<DIM; ++d)
-            iu[d] = gmap[d][floor((u[d] - umin[d]) * odu[d])];
-          buf_index = buffer_offset;
-          for (int d=0; d<DIM; ++d)
-            buf_index += nvalues*dm[d]*iu[d];
-          for (v = 0; v < nvalues; v++, buf_index++)
-            buf[buf_index] += values(p, v);
-        }
-      }
-      else
-      {
-        for (p = 0; p < nparticles; p++)
-        {
-          u = dot(axinv, (R[p] - origin));
-          if (u[0] > umin[0] && u[0] < umax[0] && u[1] > umin[1] && u[1] < umax[1] && u[2] > umin[2] && u[2] < umax[2])
-          {
-            particles_outside[p] = false;
-            iu[0]                = gmap[0][floor((u[0] - umin[0]) * odu[0])];
-            iu[1]                = gmap[1][floor((u[1] - umin[1]) * odu[1])];
-            iu[2]                = gmap[2][floor((u[2] - umin[2]) * odu[2])];
-            buf_index            = buffer_offset + nvalues * (dm[0] * iu[0] + dm[1] * iu[1] + dm[2] * iu[2]);
-            for (v = 0; v < nvalues; v++, buf_index++)
-              buf[buf_index] += values(p, v);
-          }
-        }
-      }
-      break;
-    case cylindrical:
-      for (p = 0; p < nparticles; p++)
-      {
-        ub   = dot(axinv, (R[p] - origin));
-        u[0] = sqrt(ub[0] * ub[0] + ub[1] * ub[1]);
-        u[1] = atan2(ub[1], ub[0]) * o2pi + .5;
-        u[2] = ub[2];
-        if (u[0] > umin[0] && u[0] < umax[0] && u[1] > umin[1] && u[1] < umax[1] && u[2] > umin[2] && u[2] < umax[2])
-        {
-          particles_outside[p] = false;
-          iu[0]                = gmap[0][floor((u[0] - umin[0]) * odu[0])];
-          iu[1]                = gmap[1][floor((u[1] - umin[1]) * odu[1])];
-          iu[2]                = gmap[2][floor((u[2] - umin[2]) * odu[2])];
-          buf_index            = buffer_offset + nvalues * (dm[0] * iu[0] + dm[1] * iu[1] + dm[2] * iu[2]);
-          for (v = 0; v < nvalues; v++, buf_index++)
-            buf[buf_index] += values(p, v);
-        }
-      }
-      break;
-    case spherical:
-      for (p = 0; p < nparticles; p++)
-      {
-        ub   = dot(axinv, (R[p] - origin));
-        u[0] = sqrt(ub[0] * ub[0] + ub[1] * ub[1] + ub[2] * ub[2]);
-        u[1] = atan2(ub[1], ub[0]) * o2pi + .5;
-        u[2] = acos(ub[2] / u[0]) * o2pi * 2.0;
-        if (u[0] > umin[0] && u[0] < umax[0] && u[1] > umin[1] && u[1] < umax[1] && u[2] > umin[2] && u[2] < umax[2])
-        {
-          particles_outside[p] = false;
-          iu[0]                = gmap[0][floor((u[0] - umin[0]) * odu[0])];
-          iu[1]                = gmap[1][floor((u[1] - umin[1]) * odu[1])];
-          iu[2]                = gmap[2][floor((u[2] - umin[2]) * odu[2])];
-          buf_index            = buffer_offset + nvalues * (dm[0] * iu[0] + dm[1] * iu[1] + dm[2] * iu[2]);
-          for (v = 0; v < nvalues; v++, buf_index++)
-            buf[buf_index] += values(p, v);
-        }
-      }
-      break;
-    case voronoi:
-      //find cell center nearest to each dynamic particle
-      int nd, nn;
-      RealType dist;
-      for (p = 0; p < ndparticles; p++)
-      {
-        const auto& dist = dtab.getDistRow(p);
-        for (nd = 0; nd < ndomains; nd++)
-              if (dist[nd] < nearcell[p].r)
-              {
-                nearcell[p].r = dist[nd];
-                nearcell[p].i = nd;
-              }
-      }
-      //accumulate values for each dynamic particle
-      for (p = 0; p < ndparticles; p++)
-      {
-        buf_index = buffer_offset + nvalues * nearcell[p].i;
-        for (v = 0; v < nvalues; v++, buf_index++)
-          buf[buf_index] += values(p, v);
-      }
-      //accumulate values for static particles (static particles == cell centers)
-      buf_index = buffer_offset;
-      for (p = ndparticles; p < nparticles; p++)
-        for (v = 0; v < nvalues; v++, buf_index++)
-          buf[buf_index] += values(p, v);
-      //each particle belongs to some voronoi cell
-      for (p = 0; p < nparticles; p++)
-        particles_outside[p] = false;
-      //reset distances
-      for (p = 0; p < ndparticles; p++)
-        nearcell[p].r = std::numeric_limits<RealType>::max();
-      break;
-    default:
-      app_log() << "  coordinate type must be cartesian, cylindrical, spherical, or voronoi" << std::endl;
-      APP_ABORT("SpaceGrid::evaluate");
+      const int nd = particle_domain[p];
+      if (nd < 0)
+        continue;
+      particles_outside[p] = false;
+      int buf_index        = buffer_offset + nd * nvalues;
+      for (int v = 0; v < nvalues; v++, buf_index++)
+        buf[buf_index] += values(p, v);
     }
   }
   else
   //chempot: sort values by particle count in volumes
   {
-    int cell_index;
-    int nd;
-    std::fill(cellsamples.begin(), cellsamples.end(), 0.0);
-    switch (coordinate)
+    //only the domains holding particles are accumulated and cleared,
+    //the empty domains have no values to add to the buffer
+    touched_domains.clear();
+    for (int p = 0; p < nparticles; p++)
     {
-    case cartesian:
-      for (p = 0; p < nparticles; p++)
-      {
-        u = dot(axinv, (R[p] - origin));
-        if (u[0] > umin[0] && u[0] < umax[0] && u[1] > umin[1] && u[1] < umax[1] && u[2] > umin[2] && u[2] < umax[2])
-        {
-          particles_outside[p] = false;
-          iu[0]                = gmap[0][floor((u[0] - umin[0]) * odu[0])];
-          iu[1]                = gmap[1][floor((u[1] - umin[1]) * odu[1])];
-          iu[2]                = gmap[2][floor((u[2] - umin[2]) * odu[2])];
-          cell_index           = dm[0] * iu[0] + dm[1] * iu[1] + dm[2] * iu[2];
-          for (v = 0; v < nvalues; v++)
-            cellsamples(cell_index, v) += values(p, v);
-          cellsamples(cell_index, nvalues) += 1.0;
-        }
-      }
-      break;
-    case cylindrical:
-      for (p = 0; p < nparticles; p++)
-      {
-        ub   = dot(axinv, (R[p] - origin));
-        u[0] = sqrt(ub[0] * ub[0] + ub[1] * ub[1]);
-        u[1] = atan2(ub[1], ub[0]) * o2pi + .5;
-        u[2] = ub[2];
-        if (u[0] > umin[0] && u[0] < umax[0] && u[1] > umin[1] && u[1] < umax[1] && u[2] > umin[2] && u[2] < umax[2])
-        {
-          particles_outside[p] = false;
-          iu[0]                = gmap[0][floor((u[0] - umin[0]) * odu[0])];
-          iu[1]                = gmap[1][floor((u[1] - umin[1]) * odu[1])];
-          iu[2]                = gmap[2][floor((u[2] - umin[2]) * odu[2])];
-          cell_index           = dm[0] * iu[0] + dm[1] * iu[1] + dm[2] * iu[2];
-          for (v = 0; v < nvalues; v++)
-            cellsamples(cell_index, v) += values(p, v);
-          cellsamples(cell_index, nvalues) += 1.0;
-        }
-      }
-      break;
-    case spherical:
-      for (p = 0; p < nparticles; p++)
-      {
-        ub   = dot(axinv, (R[p] - origin));
-        u[0] = sqrt(ub[0] * ub[0] + ub[1] * ub[1] + ub[2] * ub[2]);
-        u[1] = atan2(ub[1], ub[0]) * o2pi + .5;
-        u[2] = acos(ub[2] / u[0]) * o2pi * 2.0;
-        if (u[0] > umin[0] && u[0] < umax[0] && u[1] > umin[1] && u[1] < umax[1] && u[2] > umin[2] && u[2] < umax[2])
-        {
-          particles_outside[p] = false;
-          iu[0]                = gmap[0][floor((u[0] - umin[0]) * odu[0])];
-          iu[1]                = gmap[1][floor((u[1] - umin[1]) * odu[1])];
-          iu[2]                = gmap[2][floor((u[2] - umin[2]) * odu[2])];
-          cell_index           = dm[0] * iu[0] + dm[1] * iu[1] + dm[2] * iu[2];
-          for (v = 0; v < nvalues; v++)
-            cellsamples(cell_index, v) += values(p, v);
-          cellsamples(cell_index, nvalues) += 1.0;
-        }
-      }
-      break;
-    case voronoi:
-      //find cell center nearest to each dynamic particle
-      int nn;
-      RealType dist;
-      APP_ABORT("SoA transformation needed for Voronoi grids")
-      //for (nd = 0; nd < ndomains; nd++)
-      //  for (nn = dtab.M[nd], p = 0; nn < dtab.M[nd + 1]; ++nn, ++p)
-      //  {
-      //    dist = dtab.r(nn);
-      //    if (dist < nearcell[p].r)
-      //    {
-      //      nearcell[p].r = dist;
-      //      nearcell[p].i = nd;
-      //    }
-      //  }
-      //accumulate values for each dynamic particle
-      for (p = 0; p < ndparticles; p++)
-      {
-        cell_index = nearcell[p].i;
-        for (v = 0; v < nvalues; v++)
-          cellsamples(cell_index, v) += values(p, v);
-        cellsamples(cell_index, nvalues) += 1.0;
-      }
-      //accumulate values for static particles (static particles == cell centers)
-      for (p = ndparticles, cell_index = 0; p < nparticles; p++, cell_index++)
-      {
-        for (v = 0; v < nvalues; v++)
-          cellsamples(cell_index, v) += values(p, v);
-        cellsamples(cell_index, nvalues) += 1.0;
-      }
-      //each particle belongs to some voronoi cell
-      for (p = 0; p < nparticles; p++)
-        particles_outside[p] = false;
-      //reset distances
-      for (p = 0; p < ndparticles; p++)
-        nearcell[p].r = std::numeric_limits<RealType>::max();
-      break;
-    default:
-      app_log() << "  coordinate type must be cartesian, cylindrical, spherical, or voronoi" << std::endl;
-      APP_ABORT("SpaceGrid::evaluate");
+      const int nd = particle_domain[p];
+      if (nd < 0)
+        continue;
+      particles_outside[p] = false;
+      if (cellsamples(nd, nvalues) == 0.0)
+        touched_domains.push_back(nd);
+      for (int v = 0; v < nvalues; v++)
+        cellsamples(nd, v) += values(p, v);
+      cellsamples(nd, nvalues) += 1.0;
     }
-    //now place samples in the buffer according to how
-    // many particles are in each cell
-    int nincell;
-    buf_index = buffer_offset;
-    for (nd = 0; nd < ndomains; nd++)
+    for (const int nd : touched_domains)
     {
-      nincell = cellsamples(nd, nvalues) - reference_count[nd];
+      const int nincell = cellsamples(nd, nvalues) - reference_count[nd];
       if (nincell >= npmin && nincell <= npmax)
       {
-        buf_index = buffer_offset + (nd * npvalues + nincell - npmin) * nvalues;
-        for (v = 0; v < nvalues; v++, buf_index++)
+        int buf_index = buffer_offset + (nd * npvalues + nincell - npmin) * nvalues;
+        for (int v = 0; v < nvalues; v++, buf_index++)
           buf[buf_index] += cellsamples(nd, v);
       }
+      std::fill(cellsamples[nd], cellsamples[nd] + nvalues + 1, 0.0);
     }
   }
 }
@@ -50,6 +50,13 @@ public:
   void write_description(std::ostream& os, std::string& indent);
   int allocate_buffer_space(BufferType& buf);
   void registerCollectables(std::vector<observable_helper*>& h5desc, hid_t gid, int grid_index) const;
+  ///set particle_domain to the domain of each particle, -1 for the particles outside of the grid
+  void locate_particles(const ParticlePos_t& R, int nparticles, const DistanceTableData& dtab);
+  /** add the values of the particles inside the grid to their domains in buf
+   *
+   * The values go straight into the Collectables buffer. The drivers reset and normalize it every step,
+   * by the ensemble weight in DMC, so the samples cannot be held back and reduced at the end of the block.
+   */
   void evaluate(const ParticlePos_t& R,
                 const Matrix<RealType>& values,
                 BufferType& buf,
@@ -122,6 +129,9 @@ public:
 
   //used only in evaluate
   Point u, ub;
+  std::vector<int> particle_domain;
+  ///chempot: domains with particles in the current sample, their rows of cellsamples are cleared after use
+  std::vector<int> touched_domains;
 };
 
 
@@ -0,0 +1,255 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "OhmmsData/Libxml2Doc.h"
+#include "Particle/ParticleSet.h"
+#include "QMCHamiltonians/SpaceGrid.h"
+
+#include <cmath>
+#include <string>
+
+namespace qmcplusplus
+{
+using RealType      = SpaceGrid::RealType;
+using Point         = SpaceGrid::Point;
+using ParticlePos_t = SpaceGrid::ParticlePos_t;
+
+/** the particle-by-particle scatter of SpaceGrid::evaluate before it was split in locate_particles
+ *
+ * It accumulates into buf from index 0 and counts the particles of each domain over the whole grid in chempot mode.
+ */
+void referenceScatter(const SpaceGrid& sg,
+                      const ParticlePos_t& R,
+                      const Matrix<RealType>& values,
+                      std::vector<RealType>& buf,
+                      std::vector<bool>& particles_outside,
+                      const DistanceTableData& dtab)
+{
+  const int nparticles = values.size1();
+  const int nvalues    = values.size2();
+  const RealType o2pi  = 1.0 / (2.0 * M_PI);
+  Matrix<RealType> cellsamples(sg.ndomains, nvalues + 1);
+  cellsamples = 0.0;
+  for (int p = 0; p < nparticles; p++)
+  {
+    int cell = -1;
+    if (sg.coordinate == SpaceGrid::voronoi)
+    {
+      if (p < sg.ndparticles)
+      {
+        const auto& dist = dtab.getDistRow(p);
+        RealType rmin    = std::numeric_limits<RealType>::max();
+        for (int nd = 0; nd < sg.ndomains; nd++)
+          if (dist[nd] < rmin)
+          {
+            rmin = dist[nd];
+            cell = nd;
+          }
+      }
+      else
+        cell = p - sg.ndparticles;
+    }
+    else
+    {
+      Point u, ub = dot(sg.axinv, (R[p] - sg.origin));
+      if (sg.coordinate == SpaceGrid::cartesian)
+        u = ub;
+      else if (sg.coordinate == SpaceGrid::cylindrical)
+      {
+        u[0] = std::sqrt(ub[0] * ub[0] + ub[1] * ub[1]);
+        u[1] = std::atan2(ub[1], ub[0]) * o2pi + .5;
+        u[2] = ub[2];
+      }
+      else
+      {
+        u[0] = std::sqrt(ub[0] * ub[0] + ub[1] * ub[1] + ub[2] * ub[2]);
+        u[1] = std::atan2(ub[1], ub[0]) * o2pi + .5;
+        u[2] = std::acos(ub[2] / u[0]) * o2pi * 2.0;
+      }
+      const bool always_inside = sg.coordinate == SpaceGrid::cartesian && sg.periodic && !sg.chempot;
+      if (always_inside ||
+          (u[0] > sg.umin[0] && u[0] < sg.umax[0] && u[1] > sg.umin[1] && u[1] < sg.umax[1] && u[2] > sg.umin[2] &&
+           u[2] < sg.umax[2]))
+      {
+        cell = 0;
+        for (int d = 0; d < OHMMS_DIM; d++)
+          cell += sg.dm[d] * sg.gmap[d][std::floor((u[d] - sg.umin[d]) * sg.odu[d])];
+      }
+    }
+    if (cell < 0)
+      continue;
+    particles_outside[p] = false;
+    for (int v = 0; v < nvalues; v++)
+      cellsamples(cell, v) += values(p, v);
+    cellsamples(cell, nvalues) += 1.0;
+  }
+
+  for (int nd = 0; nd < sg.ndomains; nd++)
+  {
+    int buf_index = nd * nvalues;
+    if (sg.chempot)
+    {
+      const int nincell = cellsamples(nd, nvalues) - sg.reference_count[nd];
+      if (nincell < sg.npmin || nincell > sg.npmax)
+        continue;
+      buf_index = (nd * sg.npvalues + nincell - sg.npmin) * nvalues;
+    }
+    for (int v = 0; v < nvalues; v++)
+      buf[buf_index + v] += cellsamples(nd, v);
+  }
+}
+
+/** bin two samples with SpaceGrid::evaluate and with referenceScatter and compare the buffers
+ * @param grid_xml spacegrid element
+ * @param periodic periodic attribute of the energy density estimator
+ */
+void checkSpaceGrid(const std::string& grid_xml, bool periodic)
+{
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(grid_xml);
+  REQUIRE(okay);
+
+  ParticleSet ions;
+  ions.setName("ion");
+  ions.create(2);
+  ions.R[0] = {-1.0, 0.5, 0.0};
+  ions.R[1] = {1.5, -0.5, 0.5};
+  ParticleSet elec;
+  elec.setName("e");
+  const int nelec = 40;
+  elec.create(nelec);
+  const int itab = elec.addTable(ions);
+
+  // the electrons are followed by the ions as in EnergyDensityEstimator
+  const int nparticles = nelec + ions.getTotalNum();
+  const int nvalues    = 3;
+  std::vector<RealType> Z(ions.getTotalNum(), 1.0);
+  std::map<std::string, Point> points;
+  points["zero"] = {0.0, 0.0, 0.0};
+  points["a1"]   = {4.0, 0.0, 0.0};
+  points["a2"]   = {0.0, 4.0, 0.0};
+  points["a3"]   = {1.0, 0.0, 4.0};
+
+  int nv = nvalues;
+  SpaceGrid sg(nv);
+  REQUIRE(sg.put(doc.getRoot(), points, ions.R, Z, nelec, periodic, false));
+
+  SpaceGrid::BufferType buf;
+  RealType dummy = 0.5;
+  buf.add(dummy);
+  sg.allocate_buffer_space(buf);
+  std::vector<RealType> buf_ref(buf.size() - sg.buffer_offset, 0.0);
+
+  ParticlePos_t R(nparticles);
+  Matrix<RealType> values(nparticles, nvalues);
+  for (int sample = 0; sample < 2; sample++)
+  {
+    // spread the electrons over the grid and outside of it, periodic cartesian grids need them inside the cell
+    const bool in_cell  = sg.coordinate == SpaceGrid::cartesian && sg.periodic && !sg.chempot;
+    const RealType span = in_cell ? 1.4 : 3.0;
+    for (int p = 0; p < nelec; p++)
+    {
+      const RealType t = 0.37 * p + 1.1 * sample;
+      elec.R[p]        = {span * std::sin(1.3 * t), span * std::cos(0.7 * t + 0.2), span * std::sin(0.5 * t + 1.0)};
+      R[p]             = elec.R[p];
+    }
+    for (int p = nelec; p < nparticles; p++)
+      R[p] = ions.R[p - nelec];
+    for (int p = 0; p < nparticles; p++)
+      for (int v = 0; v < nvalues; v++)
+        values(p, v) = 0.1 * (p + 1) + v + sample;
+    elec.update();
+    const auto& dtab = elec.getDistTable(itab);
+
+    std::vector<bool> outside(nparticles, true), outside_ref(nparticles, true);
+    sg.evaluate(R, values, buf, outside, dtab);
+    referenceScatter(sg, R, values, buf_ref, outside_ref, dtab);
+
+    CHECK(outside == outside_ref);
+    CHECK(buf[0] == dummy);
+    RealType total = 0.0;
+    for (int i = 0; i < buf_ref.size(); i++)
+    {
+      CHECK(buf[sg.buffer_offset + i] == Approx(buf_ref[i]));
+      total += buf_ref[i];
+    }
+    // the grid is not empty
+    CHECK(total > 0.0);
+  }
+}
+
+TEST_CASE("SpaceGrid cartesian", "[hamiltonian]")
+{
+  const char* grid = "<spacegrid coord=\"cartesian\"> \
+  <origin p1=\"zero\"/> \
+  <axis p1=\"a1\" scale=\".5\" label=\"x\" grid=\"-1 (.5) 0 (.25) 1\"/> \
+  <axis p1=\"a2\" scale=\".5\" label=\"y\" grid=\"-1 (.25) 1\"/> \
+  <axis p1=\"a3\" scale=\".5\" label=\"z\" grid=\"-1 (4) 1\"/> \
+</spacegrid>";
+  checkSpaceGrid(grid, false);
+  checkSpaceGrid(grid, true);
+}
+
+TEST_CASE("SpaceGrid cylindrical", "[hamiltonian]")
+{
+  checkSpaceGrid("<spacegrid coord=\"cylindrical\"> \
+  <origin p1=\"zero\"/> \
+  <axis p1=\"a1\" scale=\".6\" label=\"r\" grid=\"0 (.25) 1\"/> \
+  <axis p1=\"a2\" scale=\".6\" label=\"phi\" grid=\"0 (.125) 1\"/> \
+  <axis p1=\"a3\" scale=\".6\" label=\"z\" grid=\"-1 (.5) 1\"/> \
+</spacegrid>",
+                 false);
+}
+
+TEST_CASE("SpaceGrid spherical", "[hamiltonian]")
+{
+  checkSpaceGrid("<spacegrid coord=\"spherical\"> \
+  <origin p1=\"zero\"/> \
+  <axis p1=\"a1\" scale=\".6\" label=\"r\" grid=\"0 (.25) 1\"/> \
+  <axis p1=\"a2\" scale=\".6\" label=\"phi\" grid=\"0 (.25) 1\"/> \
+  <axis p1=\"a3\" scale=\".6\" label=\"theta\" grid=\"0 (.5) 1\"/> \
+</spacegrid>",
+                 false);
+}
+
+TEST_CASE("SpaceGrid voronoi", "[hamiltonian]") { checkSpaceGrid("<spacegrid coord=\"voronoi\"/>", false); }
+
+TEST_CASE("SpaceGrid chempot", "[hamiltonian]")
+{
+  // the particle count sorting skips the particles outside of periodic cartesian grids
+  const char* cartesian = "<spacegrid coord=\"cartesian\" min_part=\"0\" max_part=\"3\"> \
+  <origin p1=\"zero\"/> \
+  <axis p1=\"a1\" scale=\".5\" label=\"x\" grid=\"-1 (.5) 1\"/> \
+  <axis p1=\"a2\" scale=\".5\" label=\"y\" grid=\"-1 (.5) 1\"/> \
+  <axis p1=\"a3\" scale=\".5\" label=\"z\" grid=\"-1 (1) 1\"/> \
+</spacegrid>";
+  checkSpaceGrid(cartesian, false);
+  checkSpaceGrid(cartesian, true);
+  checkSpaceGrid("<spacegrid coord=\"cylindrical\" min_part=\"1\" max_part=\"4\"> \
+  <origin p1=\"zero\"/> \
+  <axis p1=\"a1\" scale=\".6\" label=\"r\" grid=\"0 (.5) 1\"/> \
+  <axis p1=\"a2\" scale=\".6\" label=\"phi\" grid=\"0 (.25) 1\"/> \
+  <axis p1=\"a3\" scale=\".6\" label=\"z\" grid=\"-1 (1) 1\"/> \
+</spacegrid>",
+                 false);
+  checkSpaceGrid("<spacegrid coord=\"spherical\" min_part=\"0\" max_part=\"5\"> \
+  <origin p1=\"zero\"/> \
+  <axis p1=\"a1\" scale=\".6\" label=\"r\" grid=\"0 (.5) 1\"/> \
+  <axis p1=\"a2\" scale=\".6\" label=\"phi\" grid=\"0 (.5) 1\"/> \
+  <axis p1=\"a3\" scale=\".6\" label=\"theta\" grid=\"0 (.5) 1\"/> \
+</spacegrid>",
+                 false);
+}
+
+} // namespace qmcplusplus
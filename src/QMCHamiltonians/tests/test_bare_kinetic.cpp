@@ -22,6 +22,7 @@
 #include "QMCWaveFunctions/Jastrow/RadialJastrowBuilder.h"
 
 
+#include <memory>
 #include <stdio.h>
 #include <string>
 
@@ -98,6 +99,69 @@ TEST_CASE("Bare Kinetic Energy", "[hamiltonian]")
   REQUIRE(v == -0.5);
 }
 
+TEST_CASE("Bare Kinetic Energy batched", "[hamiltonian]")
+{
+  // the mass differs between the species, so the per-species sum is used
+  auto make_elec = [](double pmass) {
+    auto elec = std::make_unique<ParticleSet>();
+    elec->setName("elec");
+    elec->create({2, 1});
+    SpeciesSet& tspecies     = elec->getSpeciesSet();
+    int upIdx                = tspecies.addSpecies("u");
+    int pIdx                 = tspecies.addSpecies("p");
+    int massIdx              = tspecies.addAttribute("mass");
+    tspecies(massIdx, upIdx) = 1.0;
+    tspecies(massIdx, pIdx)  = pmass;
+    return elec;
+  };
+
+  for (double pmass : {1.0, 5.0})
+  {
+    const int nw = 3;
+    std::vector<std::unique_ptr<ParticleSet>> elecs;
+    std::vector<std::unique_ptr<BareKineticEnergy<double>>> kes;
+    std::vector<double> ke_ref(nw, 0.0);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      elecs.push_back(make_elec(pmass));
+      ParticleSet& elec = *elecs.back();
+      for (int i = 0; i < elec.getTotalNum(); i++)
+      {
+        double g2 = 0.0;
+        for (int d = 0; d < 3; d++)
+        {
+          const double g = 0.1 * (iw + 1) * (d + 1) - 0.3 * i;
+          elec.G[i][d]   = g;
+          g2 += g * g;
+        }
+        const double l = -1.0 + 0.5 * iw - 0.2 * i;
+        elec.L[i]      = l;
+        ke_ref[iw] -= (g2 + l) / (2.0 * (i < 2 ? 1.0 : pmass));
+      }
+      kes.push_back(std::make_unique<BareKineticEnergy<double>>(elec));
+    }
+
+    RefVector<OperatorBase> ke_list;
+    RefVector<ParticleSet> elec_list;
+    for (int iw = 0; iw < nw; iw++)
+    {
+      ke_list.push_back(*kes[iw]);
+      elec_list.push_back(*elecs[iw]);
+    }
+    kes[0]->mw_evaluate(ke_list, elec_list);
+
+    BareKineticEnergy<double> ke_single(*elecs[0]);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      const double v = ke_single.evaluate(*elecs[iw]);
+      CHECK(v == Approx(ke_ref[iw]));
+      CHECK(kes[iw]->Value == Approx(v));
+    }
+    // the walkers differ
+    CHECK(kes[0]->Value != Approx(kes[1]->Value));
+  }
+}
+
 TEST_CASE("Bare KE Pulay PBC", "[hamiltonian]")
 {
   typedef QMCTraits::RealType RealType;
@@ -185,6 +185,28 @@ TEST_CASE("Coulomb PBC A-B BCC H", "[hamiltonian]")
   double sum            = val_ee + val_ii + val_ei;
   REQUIRE(sum == Approx(-3.143491064)); // Can be validated via Ewald summation elsewhere
                                         // -3.14349127313640
+
+  // a walker batch
+  ParticleSet elec_clone(elec);
+  elec_clone.R[0][0] = 1.2;
+  elec_clone.R[0][2] = 0.7;
+  elec_clone.R[1][1] = 2.3;
+  elec_clone.update();
+  CoulombPBCAB cab_clone(ions, elec_clone);
+  CoulombPBCAA caa_clone(elec_clone, false);
+  const double val_ei_clone = cab_clone.evaluate(elec_clone);
+  const double val_ee_clone = caa_clone.evaluate(elec_clone);
+
+  RefVector<ParticleSet> p_list{elec, elec_clone};
+  RefVector<OperatorBase> cab_list{cab, cab_clone};
+  cab.mw_evaluate(cab_list, p_list);
+  REQUIRE(cab.Value == Approx(val_ei));
+  REQUIRE(cab_clone.Value == Approx(val_ei_clone));
+
+  RefVector<OperatorBase> caa_list{caa_elec, caa_clone};
+  caa_elec.mw_evaluate(caa_list, p_list);
+  REQUIRE(caa_elec.Value == Approx(val_ee));
+  REQUIRE(caa_clone.Value == Approx(val_ee_clone));
 }
 
 } // namespace qmcplusplus
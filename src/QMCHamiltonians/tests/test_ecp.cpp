@@ -17,7 +17,10 @@
 #include "Numerics/Quadrature.h"
 #include "QMCHamiltonians/ECPComponentBuilder.h"
 #include "QMCHamiltonians/NonLocalECPComponent.h"
+#include "QMCHamiltonians/NonLocalECPotential.h"
 #include "QMCHamiltonians/SOECPComponent.h"
+#include "QMCHamiltonians/NLPPJob.h"
+#include "Particle/VirtualParticleSet.h"
 
 //for wavefunction
 #include "OhmmsData/Libxml2Doc.h"
@@ -26,6 +29,7 @@
 #include "QMCWaveFunctions/Jastrow/BsplineFunctor.h"
 #include "QMCWaveFunctions/Jastrow/RadialJastrowBuilder.h"
 #include "QMCWaveFunctions/Fermion/DiracDeterminant.h"
+#include "QMCWaveFunctions/Fermion/SlaterDet.h"
 #include "QMCWaveFunctions/SpinorSet.h"
 //for nonlocal moves
 #include "QMCHamiltonians/NonLocalTOperator.h"
@@ -38,6 +42,8 @@
 
 #ifdef QMC_COMPLEX //This is for the spinor test.
 #include "QMCWaveFunctions/ElectronGas/ElectronGasComplexOrbitalBuilder.h"
+#else
+#include "QMCWaveFunctions/ElectronGas/ElectronGasOrbitalBuilder.h"
 #endif
 
 namespace qmcplusplus
@@ -316,6 +322,49 @@ TEST_CASE("Evaluate_ecp", "[hamiltonian]")
   //These numbers are validated against an alternate code path via wavefunction tester.
   REQUIRE(Value1 == Approx(6.9015710211e-02));
 
+  {
+    // vectorized projector over all the pairs
+    std::vector<NLPPJob<RealType>> jobs;
+    for (int jel = 0; jel < elec.getTotalNum(); jel++)
+    {
+      const auto& dist  = myTable.getDistRow(jel);
+      const auto& displ = myTable.getDisplRow(jel);
+      for (int iat = 0; iat < ions.getTotalNum(); iat++)
+        if (dist[iat] < nlpp->getRmax())
+          jobs.emplace_back(iat, jel, elec.R[jel], dist[iat], -displ[iat]);
+    }
+    REQUIRE(jobs.size() > 0);
+
+    const int nknot = nlpp->getNknot();
+    VirtualParticleSet vp(elec, nknot);
+    std::vector<std::vector<PosType>> deltaV(jobs.size());
+    std::vector<std::vector<ValueType>> ratios(jobs.size(), std::vector<ValueType>(nknot));
+    std::vector<std::vector<RealType>> knot_pots(jobs.size());
+    RefVector<const NLPPJob<RealType>> job_list;
+    RefVector<const std::vector<ValueType>> ratios_list;
+    RefVector<std::vector<RealType>> knot_pots_list;
+    for (int i = 0; i < jobs.size(); i++)
+    {
+      const auto& job = jobs[i];
+      nlpp->buildQuadraturePointDeltas(job.ion_elec_dist, job.ion_elec_displ, deltaV[i]);
+      vp.makeMoves(job.electron_id, job.elec_pos, deltaV[i], true, job.ion_id);
+      psi.evaluateRatios(vp, ratios[i]);
+      job_list.push_back(job);
+      ratios_list.push_back(ratios[i]);
+      knot_pots_list.push_back(knot_pots[i]);
+    }
+
+    std::vector<RealType> pairpots(jobs.size());
+    nlpp->calculateProjectors(job_list, ratios_list, knot_pots_list, pairpots.data());
+    RealType Value_batched(0);
+    for (int i = 0; i < jobs.size(); i++)
+    {
+      REQUIRE(knot_pots[i].size() == nknot);
+      Value_batched += pairpots[i];
+    }
+    REQUIRE(Value_batched == Approx(Value1));
+  }
+
   opt_variables_type optvars;
   std::vector<ValueType> dlogpsi;
   std::vector<ValueType> dhpsioverpsi;
@@ -427,6 +476,182 @@ TEST_CASE("Evaluate_ecp", "[hamiltonian]")
   //HFTerm[1][2]+PulayTerm[1][2] =  0.0
 }
 
+namespace testing
+{
+class TestNonLocalECPotential
+{
+public:
+  static const std::vector<NonLocalData>& getTxy(const NonLocalECPotential& ecp) { return ecp.nonLocalOps.Txy; }
+};
+} // namespace testing
+
+/** compare the potential and the Txy of the pair batching with the walker batching
+ * @param nelec_per_group number of electrons in each of the two spin groups
+ * @param use_slater add a SlaterDet with one determinant per group to the one-body Jastrow
+ */
+void checkPairBatching(int nelec_per_group, bool use_slater)
+{
+  using RealType = QMCTraits::RealType;
+  using PosType  = QMCTraits::PosType;
+#ifdef QMC_COMPLEX
+  using EGSPOSet = EGOSet;
+#else
+  using EGSPOSet = RealEGOSet;
+#endif
+
+  Communicate* c = OHMMS::Controller;
+
+  CrystalLattice<OHMMS_PRECISION, OHMMS_DIM> Lattice;
+  Lattice.BoxBConds     = true; // periodic
+  Lattice.R.diagonal(20);
+  Lattice.LR_dim_cutoff = 15;
+  Lattice.reset();
+
+  ParticleSet ions;
+  ParticleSet elec;
+
+  ions.setName("ion0");
+  ions.create(2);
+  ions.R[0] = {0.0, 0.0, 0.0};
+  ions.R[1] = {6.0, 0.0, 0.0};
+  SpeciesSet& ion_species       = ions.getSpeciesSet();
+  int pIdx                      = ion_species.addSpecies("Na");
+  int pChargeIdx                = ion_species.addAttribute("charge");
+  int iatnumber                 = ion_species.addAttribute("atomic_number");
+  ion_species(pChargeIdx, pIdx) = 1;
+  ion_species(iatnumber, pIdx)  = 11;
+  ions.Lattice                  = Lattice;
+  ions.createSK();
+
+  elec.Lattice = Lattice;
+  elec.setName("e");
+  std::vector<int> agroup(2, nelec_per_group);
+  elec.create(agroup);
+  SpeciesSet& tspecies         = elec.getSpeciesSet();
+  int upIdx                    = tspecies.addSpecies("u");
+  int downIdx                  = tspecies.addSpecies("d");
+  int chargeIdx                = tspecies.addAttribute("charge");
+  int massIdx                  = tspecies.addAttribute("mass");
+  tspecies(chargeIdx, upIdx)   = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+  tspecies(massIdx, upIdx)     = 1.0;
+  tspecies(massIdx, downIdx)   = 1.0;
+  elec.createSK();
+
+  ions.resetGroups();
+  elec.resetGroups();
+
+  TrialWaveFunction psi;
+  const char* particles = "<tmp> \
+  <jastrow name=\"J1\" type=\"One-Body\" function=\"Bspline\" source=\"ion0\" print=\"yes\"> \
+        <correlation elementType=\"Na\" rcut=\"10\" size=\"10\" cusp=\"0\"> \
+          <coefficients id=\"eNa\" type=\"Array\"> 1.244201343 -1.188935609 -1.840397253 -1.803849126 -1.612058635 -1.35993202 -1.083353212 -0.8066295188 -0.5319252448 -0.3158819772</coefficients> \
+        </correlation> \
+      </jastrow> \
+  </tmp> \
+  ";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(particles);
+  REQUIRE(okay);
+  xmlNodePtr jas1 = xmlFirstElementChild(doc.getRoot());
+  RadialJastrowBuilder jastrow1bdy(c, elec, ions);
+  psi.addComponent(jastrow1bdy.buildComponent(jas1));
+
+  if (use_slater)
+  {
+    // plane waves with different k in each group, SlaterDet picks the determinant of the moved electron
+    const int ngroups = agroup.size();
+    auto* slater_det  = new SlaterDet(elec);
+    for (int ig = 0; ig < ngroups; ig++)
+    {
+      std::vector<PosType> kpts{{0.4 + 0.2 * ig, 0.3, -0.1 * ig}, {-0.2, 0.5 - 0.1 * ig, 0.3}, {0.1, -0.3, 0.4}};
+#ifdef QMC_COMPLEX
+      kpts.resize(nelec_per_group);
+#else
+      // a constant orbital followed by the cosine and the sine of each k
+      kpts.resize(nelec_per_group / 2);
+#endif
+      std::vector<RealType> mk2;
+      for (const auto& k : kpts)
+        mk2.push_back(-dot(k, k));
+      auto* spo = new EGSPOSet(kpts, mk2);
+      REQUIRE(spo->getOrbitalSetSize() == nelec_per_group);
+      auto* det = new DiracDeterminant<>(spo);
+      det->set(elec.first(ig), nelec_per_group);
+      slater_det->add(det, ig);
+    }
+    psi.addComponent(slater_det);
+  }
+
+  ECPComponentBuilder ecp_builder("test_read_ecp", c);
+  bool okay2 = ecp_builder.read_pp_file("Na.BFD.xml");
+  REQUIRE(okay2);
+
+  // owns the component read from the file
+  NonLocalECPotential ecp(ions, elec, psi, false, false);
+  ecp.addComponent(pIdx, ecp_builder.pp_nonloc);
+
+  // walkers with different configurations, each with its own wavefunction and two copies of the potential
+  const int nw = 3;
+  // identically seeded generators draw the same quadrature rotations in both paths
+  std::vector<RandomGenerator_t> rngs_batched(nw), rngs_pairs(nw);
+  std::vector<std::unique_ptr<ParticleSet>> elecs;
+  std::vector<std::unique_ptr<TrialWaveFunction>> psis;
+  std::vector<std::unique_ptr<OperatorBase>> ecps_batched, ecps_pairs;
+  RefVector<ParticleSet> p_list;
+  RefVector<OperatorBase> batched_list, pairs_list;
+  for (int iw = 0; iw < nw; iw++)
+  {
+    elecs.push_back(std::make_unique<ParticleSet>(elec));
+    ParticleSet& P(*elecs.back());
+    for (int iel = 0; iel < P.getTotalNum(); iel++)
+      P.R[iel] = {2.0 + iel + (iel % 2 ? -0.4 : 0.3) * iw, (iel % 2 ? 0.1 : 0.2 * iw) + 0.15 * (iel / 2),
+                  0.3 * iw * (iel % 2)};
+    P.update();
+    psis.emplace_back(psi.makeClone(P));
+    psis.back()->evaluateLog(P);
+    ecps_batched.emplace_back(ecp.makeClone(P, *psis.back()));
+    ecps_pairs.emplace_back(ecp.makeClone(P, *psis.back()));
+    static_cast<NonLocalECPotential&>(*ecps_batched.back()).setRandomGenerator(&rngs_batched[iw]);
+    static_cast<NonLocalECPotential&>(*ecps_pairs.back()).setRandomGenerator(&rngs_pairs[iw]);
+    for (auto* ecps : {&ecps_batched, &ecps_pairs})
+      static_cast<NonLocalECPotential&>(*ecps->back()).setNonLocalMoves("v0", 0.01, 0.0, 0.0);
+    static_cast<NonLocalECPotential&>(*ecps_pairs.back()).enablePairBatching();
+    p_list.push_back(P);
+    batched_list.push_back(*ecps_batched.back());
+    pairs_list.push_back(*ecps_pairs.back());
+  }
+
+  batched_list[0].get().mw_evaluateWithToperator(batched_list, p_list);
+  pairs_list[0].get().mw_evaluateWithToperator(pairs_list, p_list);
+
+  for (int iw = 0; iw < nw; iw++)
+  {
+    const auto& O_batched = static_cast<const NonLocalECPotential&>(batched_list[iw].get());
+    const auto& O_pairs   = static_cast<const NonLocalECPotential&>(pairs_list[iw].get());
+    CHECK(O_batched.Value != Approx(0.0));
+    CHECK(O_pairs.Value == Approx(O_batched.Value));
+
+    const auto& txy_batched = testing::TestNonLocalECPotential::getTxy(O_batched);
+    const auto& txy_pairs   = testing::TestNonLocalECPotential::getTxy(O_pairs);
+    REQUIRE(txy_batched.size() > 0);
+    REQUIRE(txy_pairs.size() == txy_batched.size());
+    for (size_t i = 0; i < txy_batched.size(); i++)
+    {
+      CHECK(txy_pairs[i].PID == txy_batched[i].PID);
+      CHECK(txy_pairs[i].Weight == Approx(txy_batched[i].Weight));
+      for (int d = 0; d < OHMMS_DIM; d++)
+        CHECK(txy_pairs[i].Delta[d] == Approx(txy_batched[i].Delta[d]));
+    }
+  }
+}
+
+TEST_CASE("Evaluate_ecp batched pairs", "[hamiltonian]")
+{
+  checkPairBatching(1, false);
+  checkPairBatching(3, true);
+}
+
 #ifdef QMC_COMPLEX
 TEST_CASE("Evaluate_soecp", "[hamiltonian]")
 {
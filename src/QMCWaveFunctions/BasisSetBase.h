@@ -23,6 +23,8 @@
 
 #include "Particle/ParticleSet.h"
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "type_traits/template_types.hpp"
 
 namespace qmcplusplus
 {
@@ -151,6 +153,16 @@ struct SoaBasisSetBase
 
   //Evaluates value, gradient, and laplacian for electron "iat".  Parks them into a temporary data structure "vgl".
   virtual void evaluateVGL(const ParticleSet& P, int iat, vgl_type& vgl) = 0;
+  //Evaluates value, gradient, and laplacian for electron "iat" of multiple walkers.
+  //    Parks them into "vgl_mw", Matrix(5*nw,BasisSetSize) with rows 5*iw to 5*iw+4 holding walker iw.
+  virtual void mw_evaluateVGL(const RefVector<ParticleSet>& P_list, int iat, Matrix<T>& vgl_mw)
+  {
+    for (int iw = 0; iw < P_list.size(); iw++)
+    {
+      vgl_type vgl(vgl_mw[iw * (OHMMS_DIM + 2)], BasisSetSize, vgl_mw.cols());
+      evaluateVGL(P_list[iw], iat, vgl);
+    }
+  }
   //Evaluates value, gradient, and Hessian for electron "iat".  Parks them into a temporary data structure "vgh".
   virtual void evaluateVGH(const ParticleSet& P, int iat, vgh_type& vgh) = 0;
   //Evaluates value, gradient, and Hessian, and Gradient Hessian for electron "iat".  Parks them into a temporary data structure "vghgh".
@@ -167,6 +179,25 @@ struct SoaBasisSetBase
   virtual void evaluateV(const ParticleSet& P, int iat, value_type* restrict vals) = 0;
   virtual bool is_S_orbital(int mo_idx, int ao_idx) { return false; }
 
+  /** ranges [first,last) of basis functions */
+  using BlockList = std::vector<std::pair<int, int>>;
+  //Enables screening the centers by distance, basis functions below "tol" are treated as zero.
+  //    Returns false if the basis set does not support screening.
+  virtual bool setScreening(QMCTraits::RealType tol) { return false; }
+  //Evaluates VGL like evaluateVGL, only for the centers within their screening radii.
+  //    The evaluated ranges are returned in "blocks", the other basis functions in "vgl" are not touched.
+  virtual void evaluateVGLScreened(const ParticleSet& P, int iat, vgl_type& vgl, BlockList& blocks)
+  {
+    evaluateVGL(P, iat, vgl);
+    blocks.assign(1, {0, BasisSetSize});
+  }
+  //Evaluates values like evaluateV, only for the centers within their screening radii.
+  virtual void evaluateVScreened(const ParticleSet& P, int iat, value_type* restrict vals, BlockList& blocks)
+  {
+    evaluateV(P, iat, vals);
+    blocks.assign(1, {0, BasisSetSize});
+  }
+
   /// Determine which orbitals are S-type.  Used for cusp correction.
   virtual void queryOrbitalsForSType(const std::vector<bool>& corrCenter, std::vector<bool>& is_s_orbital) const {}
 };
@@ -25,7 +25,13 @@
 namespace qmcplusplus
 {
 BsplineReaderBase::BsplineReaderBase(EinsplineSetBuilder* e)
-    : mybuilder(e), MeshSize(0), checkNorm(true), saveSplineCoefs(false)
+    : mybuilder(e),
+      MeshSize(0),
+      checkNorm(true),
+      saveSplineCoefs(false),
+      nodeSharedCoefs(false),
+      mappedSplineCoefs(false),
+      concurrentBands(1)
 {
   myComm = mybuilder->getCommunicator();
 }
@@ -85,9 +91,14 @@ void BsplineReaderBase::setCommon(xmlNodePtr cur)
   // check orbital normalization by default
   std::string checkOrbNorm("yes");
   std::string saveCoefs("no");
+  std::string sharedCoefs("no");
+  std::string mappedCoefs("no");
   OhmmsAttributeSet a;
   a.add(checkOrbNorm, "check_orb_norm");
   a.add(saveCoefs, "save_coefs");
+  a.add(sharedCoefs, "shared_coefs");
+  a.add(mappedCoefs, "mapped_coefs");
+  a.add(concurrentBands, "concurrent_bands");
   a.put(cur);
 
   // allow user to turn off norm check with a warning
@@ -97,6 +108,8 @@ void BsplineReaderBase::setCommon(xmlNodePtr cur)
     checkNorm = false;
   }
   saveSplineCoefs = saveCoefs == "yes";
+  nodeSharedCoefs   = sharedCoefs == "yes";
+  mappedSplineCoefs = mappedCoefs == "yes";
 }
 
 SPOSet* BsplineReaderBase::create_spline_set(int spin, xmlNodePtr cur)
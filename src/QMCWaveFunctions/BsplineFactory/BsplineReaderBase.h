@@ -44,6 +44,12 @@ struct BsplineReaderBase
   bool checkNorm;
   ///save spline coefficients to storage
   bool saveSplineCoefs;
+  ///place spline coefficients in node-shared memory
+  bool nodeSharedCoefs;
+  ///map spline coefficients read-only from a cache file, written if missing
+  bool mappedSplineCoefs;
+  ///number of bands transformed concurrently, 1 by default and 0 for one band per thread
+  int concurrentBands;
   ///map from spo index to band index
   std::vector<std::vector<int>> spo2band;
 
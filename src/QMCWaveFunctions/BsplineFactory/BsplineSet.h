@@ -21,9 +21,12 @@
 #ifndef QMCPLUSPLUS_BSPLINESET_H
 #define QMCPLUSPLUS_BSPLINESET_H
 
+#include <memory>
 #include "QMCWaveFunctions/SPOSet.h"
 #include "spline/einspline_engine.hpp"
 #include "spline/einspline_util.hpp"
+#include "Message/SharedMemoryWindow.h"
+#include "QMCWaveFunctions/BsplineFactory/MappedSplineCoefs.h"
 
 namespace qmcplusplus
 {
@@ -55,13 +58,69 @@ protected:
   std::vector<int> offset;
   ///keyword used to match hdf5
   std::string KeyWord;
+  ///node communicator, if set the derived class may place the coefficient table in node-shared memory
+  std::shared_ptr<Communicate> NodeComm;
+  ///node-shared memory holding the coefficient table, shared by all the clones
+  std::shared_ptr<SharedMemoryWindow> SharedCoefs;
+
+  ///allocate n elements of T in the node-shared memory of NodeComm
+  template<typename T>
+  T* allocateSharedCoefs(size_t n)
+  {
+    SharedCoefs = std::make_shared<SharedMemoryWindow>(*NodeComm, n * sizeof(T));
+    return SharedCoefs->data<T>();
+  }
+
+  ///read-only mapping of a coefficient cache file offered to create_spline, shared by all the clones
+  std::shared_ptr<MappedSplineCoefs> MappedCoefs;
+  ///true if the coefficient table is the mapping of MappedCoefs
+  bool coefs_mapped;
+
+  ///use the n elements of T of MappedCoefs as the coefficient table
+  template<typename T>
+  T* useMappedCoefs(size_t n)
+  {
+    T* coefs     = MappedCoefs->data<T>(n);
+    coefs_mapped = true;
+    return coefs;
+  }
 
 public:
   BsplineSet(bool use_OMP_offload = false, bool ion_deriv = false, bool optimizable = false)
-      : SPOSet(use_OMP_offload, ion_deriv, optimizable), is_complex(false), MyIndex(0), first_spo(0), last_spo(0) {}
+      : SPOSet(use_OMP_offload, ion_deriv, optimizable), is_complex(false), MyIndex(0), first_spo(0), last_spo(0), coefs_mapped(false)
+  {}
 
   auto& getHalfG() const { return HalfG; }
 
+  /** request the coefficient table in node-shared memory, must be called before create_spline
+   *
+   * Classes not supporting node-shared tables ignore the request. Check isNodeShared after create_spline.
+   */
+  void setNodeComm(const std::shared_ptr<Communicate>& node_comm) { NodeComm = node_comm; }
+
+  ///return true if the coefficient table is in node-shared memory and only written by the node leader
+  bool isNodeShared() const { return SharedCoefs != nullptr; }
+
+  /** offer a mapped coefficient cache file as the coefficient table, must be called before create_spline
+   *
+   * Classes not supporting mapped tables ignore the offer. Check isMapped after create_spline.
+   * A mapped table is read-only and is neither filled nor broadcast.
+   */
+  void setMappedCoefs(const std::shared_ptr<MappedSplineCoefs>& mapped) { MappedCoefs = mapped; }
+
+  ///return true if the coefficient table is a read-only mapping of a cache file
+  bool isMapped() const { return coefs_mapped; }
+
+  ///return true if create_spline uses a mapped table offered by setMappedCoefs
+  virtual bool canMapCoefs() const { return false; }
+
+  ///make the table written by the node leader visible to all the ranks on the node, collective over the node
+  void fenceSharedCoefs()
+  {
+    if (SharedCoefs)
+      SharedCoefs->fence();
+  }
+
   inline void init_base(int n)
   {
     kPoints.resize(n);
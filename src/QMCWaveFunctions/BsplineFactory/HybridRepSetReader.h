@@ -153,6 +153,18 @@ struct HybridRepSetReader : public SplineSetReader<SA>
   /** initialize basic parameters of atomic orbitals */
   void initialize_hybridrep_atomic_centers() override
   {
+    if (BaseReader::nodeSharedCoefs)
+    {
+      app_warning() << "Hybrid orbital representation does not support shared_coefs. "
+                    << "Each rank keeps a private copy of the spline coefficients." << std::endl;
+      BaseReader::nodeSharedCoefs = false;
+    }
+    if (BaseReader::mappedSplineCoefs)
+    {
+      app_warning() << "Hybrid orbital representation does not support mapped_coefs. "
+                    << "The spline coefficients are not mapped from a cache file." << std::endl;
+      BaseReader::mappedSplineCoefs = false;
+    }
     OhmmsAttributeSet a;
     std::string scheme_name("Consistent");
     std::string s_function_name("LEKS2018");
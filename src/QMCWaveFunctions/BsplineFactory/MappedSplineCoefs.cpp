@@ -0,0 +1,149 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "MappedSplineCoefs.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace qmcplusplus
+{
+///identifies a spline coefficient cache file
+static const char cache_magic[8] = {'Q', 'M', 'C', 'S', 'P', 'L', 'C', 'F'};
+
+///read exactly bytes from fd at offset
+static bool readAt(int fd, void* buf, size_t bytes, off_t offset)
+{
+  return pread(fd, buf, bytes, offset) == static_cast<ssize_t>(bytes);
+}
+
+bool MappedSplineCoefs::open(const std::string& fname,
+                             size_t value_size,
+                             const std::string& layout,
+                             std::string& reason)
+{
+  release();
+  const int fd = ::open(fname.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    reason = "cannot open " + fname + " : " + std::strerror(errno);
+    return false;
+  }
+
+  struct stat st;
+  Header h;
+  std::vector<char> file_layout;
+  reason.clear();
+  if (fstat(fd, &st) != 0 || !readAt(fd, &h, sizeof(Header), 0))
+    reason = "cannot read the header of " + fname;
+  else if (std::memcmp(h.magic, cache_magic, sizeof(cache_magic)) != 0)
+    reason = fname + " is not a spline coefficient cache file";
+  else if (h.version != Version)
+    reason = fname + " has format version " + std::to_string(h.version) + " instead of " + std::to_string(Version);
+  else if (h.value_size != value_size)
+    reason = fname + " holds coefficients of " + std::to_string(h.value_size) + " bytes instead of " +
+        std::to_string(value_size);
+  else if (h.layout_size != layout.size() || h.coefs_offset % CoefsAlignment != 0 ||
+           h.coefs_offset < sizeof(Header) + h.layout_size ||
+           static_cast<uint64_t>(st.st_size) != h.coefs_offset + h.coefs_size * h.value_size)
+    reason = fname + " does not match the grid, twists or orbitals of this spline set";
+  else
+  {
+    file_layout.resize(h.layout_size);
+    if (!readAt(fd, file_layout.data(), file_layout.size(), sizeof(Header)))
+      reason = "cannot read the layout of " + fname;
+    else if (!std::equal(file_layout.begin(), file_layout.end(), layout.begin()))
+      reason = fname + " does not match the grid, twists or orbitals of this spline set";
+  }
+
+  if (reason.empty())
+  {
+    void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED)
+      reason = "cannot map " + fname + " : " + std::strerror(errno);
+    else
+    {
+      base_       = static_cast<char*>(ptr);
+      bytes_      = st.st_size;
+      offset_     = h.coefs_offset;
+      value_size_ = h.value_size;
+      size_       = h.coefs_size;
+    }
+  }
+  close(fd);
+  return reason.empty();
+}
+
+void MappedSplineCoefs::release()
+{
+  if (base_ != nullptr)
+    munmap(base_, bytes_);
+  base_       = nullptr;
+  bytes_      = 0;
+  offset_     = 0;
+  value_size_ = 0;
+  size_       = 0;
+}
+
+std::string MappedSplineCoefs::sourceStamp(const std::string& fname)
+{
+  struct stat st;
+  if (stat(fname.c_str(), &st) != 0)
+    return "source " + fname + " missing";
+  return "source " + fname + " size " + std::to_string(st.st_size) + " mtime " + std::to_string(st.st_mtime);
+}
+
+bool MappedSplineCoefs::write(const std::string& fname,
+                              const void* coefs,
+                              size_t value_size,
+                              size_t n,
+                              const std::string& layout)
+{
+  Header h;
+  std::memcpy(h.magic, cache_magic, sizeof(cache_magic));
+  h.version      = Version;
+  h.value_size   = value_size;
+  h.layout_size  = layout.size();
+  h.coefs_offset = (sizeof(Header) + layout.size() + CoefsAlignment - 1) / CoefsAlignment * CoefsAlignment;
+  h.coefs_size   = n;
+
+  const std::string tmpname = fname + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream fout(tmpname, std::ios::binary | std::ios::trunc);
+    fout.write(reinterpret_cast<const char*>(&h), sizeof(Header));
+    fout.write(layout.data(), layout.size());
+    const std::vector<char> padding(h.coefs_offset - sizeof(Header) - layout.size(), 0);
+    fout.write(padding.data(), padding.size());
+    fout.write(static_cast<const char*>(coefs), n * value_size);
+    fout.close();
+    if (fout.fail())
+    {
+      std::remove(tmpname.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmpname.c_str(), fname.c_str()) != 0)
+  {
+    std::remove(tmpname.c_str());
+    return false;
+  }
+  return true;
+}
+
+} // namespace qmcplusplus
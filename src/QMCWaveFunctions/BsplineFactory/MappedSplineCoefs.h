@@ -0,0 +1,130 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file MappedSplineCoefs.h
+ * @brief declaration of MappedSplineCoefs
+ */
+#ifndef QMCPLUSPLUS_MAPPED_SPLINE_COEFS_H
+#define QMCPLUSPLUS_MAPPED_SPLINE_COEFS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace qmcplusplus
+{
+/** read-only memory mapping of a spline coefficient cache file
+ *
+ * A cache file holds a MultiBspline coefficient table exactly as it is laid out in memory,
+ * so that the mapping can be used as the storage of the table without reading or copying it.
+ * The file consists of
+ * - Header: magic string, format version, size of a coefficient, size of the layout and position of the table
+ * - layout: text recording the source h5 file, grid, boundary conditions, precision, twists and orbital ordering
+ *   of the table
+ * - table: coefficients starting at an offset aligned to CoefsAlignment
+ *
+ * A file is mapped only if its format version, precision and layout match the requested ones.
+ * The kernel loads the pages on first access and all the processes mapping the file on a node share them.
+ */
+class MappedSplineCoefs
+{
+public:
+  struct Header
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t value_size;
+    uint64_t layout_size;
+    uint64_t coefs_offset;
+    uint64_t coefs_size;
+  };
+
+  ///format version, increase when the file layout or the meaning of the layout text changes
+  static constexpr uint32_t Version = 2;
+  ///alignment of the table in the file
+  static constexpr size_t CoefsAlignment = 4096;
+
+  MappedSplineCoefs() : base_(nullptr), bytes_(0), offset_(0), value_size_(0), size_(0) {}
+  ~MappedSplineCoefs() { release(); }
+
+  MappedSplineCoefs(const MappedSplineCoefs&) = delete;
+  MappedSplineCoefs& operator=(const MappedSplineCoefs&) = delete;
+
+  /** map the table of a cache file read-only, any previous mapping is released
+   * @param fname name of the cache file
+   * @param value_size size of a coefficient in bytes
+   * @param layout expected layout of the table
+   * @param reason set to the reason if the file is not mapped
+   * @return true if the file is mapped
+   */
+  bool open(const std::string& fname, size_t value_size, const std::string& layout, std::string& reason);
+
+  ///unmap the file
+  void release();
+
+  /** return the mapped table as the storage of n coefficients of type T
+   *
+   * The table is mapped read-only and must not be written.
+   */
+  template<typename T>
+  T* data(size_t n) const
+  {
+    if (sizeof(T) != value_size_ || n != size_)
+      throw std::runtime_error("MappedSplineCoefs holds " + std::to_string(size_) + " coefficients of " +
+                               std::to_string(value_size_) + " bytes but " + std::to_string(n) + " of " +
+                               std::to_string(sizeof(T)) + " bytes are requested. Remove the cache file.");
+    return reinterpret_cast<T*>(base_ + offset_);
+  }
+
+  ///return the number of coefficients in the mapped table
+  inline size_t size() const { return size_; }
+
+  /** write a coefficient table to a cache file
+   * @param fname name of the cache file
+   * @param coefs the table
+   * @param value_size size of a coefficient in bytes
+   * @param n number of coefficients
+   * @param layout layout of the table
+   * @return true if the file is written
+   *
+   * The file is written under a temporary name and renamed at the end,
+   * so that concurrent jobs never map a partially written file.
+   */
+  static bool write(const std::string& fname,
+                    const void* coefs,
+                    size_t value_size,
+                    size_t n,
+                    const std::string& layout);
+
+  /** return a line of layout identifying the version of a source file
+   * @param fname name of the file the table is computed from
+   *
+   * It records the name, size and modification time, so a cache file is not mapped after its source was rewritten.
+   */
+  static std::string sourceStamp(const std::string& fname);
+
+private:
+  ///address of the mapping
+  char* base_;
+  ///size of the mapping in bytes
+  size_t bytes_;
+  ///offset of the table in the mapping
+  size_t offset_;
+  ///size of a coefficient in bytes
+  size_t value_size_;
+  ///number of coefficients
+  size_t size_;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -96,6 +96,8 @@ public:
 
   void bcast_tables(Communicate* comm) { chunked_bcast(comm, SplineInst->getSplinePtr()); }
 
+  bool canMapCoefs() const override { return true; }
+
   void gather_tables(Communicate* comm)
   {
     if (comm->size() == 1)
@@ -112,9 +114,16 @@ public:
   {
     GGt        = dot(transpose(PrimLattice.G), PrimLattice.G);
     SplineInst = std::make_shared<MultiBspline<ST>>();
-    SplineInst->create(xyz_g, xyz_bc, myV.size());
-
-    app_log() << "MEMORY " << SplineInst->sizeInByte() / (1 << 20) << " MB allocated "
+    if (MappedCoefs)
+      SplineInst->create(xyz_g, xyz_bc, myV.size(), [this](size_t n) { return useMappedCoefs<ST>(n); });
+    else if (NodeComm)
+      SplineInst->create(xyz_g, xyz_bc, myV.size(), [this](size_t n) { return allocateSharedCoefs<ST>(n); });
+    else
+      SplineInst->create(xyz_g, xyz_bc, myV.size());
+
+    app_log() << "MEMORY " << SplineInst->sizeInByte() / (1 << 20) << " MB "
+              << (isMapped() ? "mapped from a cache file "
+                             : (isNodeShared() ? "allocated in node-shared memory " : "allocated "))
               << "for the coefficients in 3D spline orbital representation" << std::endl;
   }
 
@@ -25,8 +25,11 @@
  */
 #ifndef QMCPLUSPLUS_SPLINESET_READER_H
 #define QMCPLUSPLUS_SPLINESET_READER_H
+#include <memory>
+#include <thread>
 #include "mpi/collectives.h"
 #include "mpi/point2point.h"
+#include "Message/OpenMP.h"
 #include "Utilities/FairDivide.h"
 
 namespace qmcplusplus
@@ -40,16 +43,37 @@ struct SplineSetReader : public BsplineReaderBase
   typedef typename splineset_t::DataType DataType;
   typedef typename splineset_t::SplineType SplineType;
 
-  Array<std::complex<double>, 3> FFTbox;
+  /// scratch space to transform one band, each band transformed concurrently owns one
+  struct BandWorkspace
+  {
+    Array<std::complex<double>, 3> FFTbox;
+    Array<double, 3> splineData_r, splineData_i;
+    UBspline_3d_d* spline_r = nullptr;
+    UBspline_3d_d* spline_i = nullptr;
+    fftw_plan FFTplan       = nullptr;
+  };
+
+  /// accumulated time of each stage of the band transformation
+  struct BandStageTimes
+  {
+    double fft   = 0.0;
+    double phase = 0.0;
+    double solve = 0.0;
+    double copy  = 0.0;
+  };
+
   Array<double, 3> splineData_r, splineData_i;
   double rotate_phase_r, rotate_phase_i;
   UBspline_3d_d* spline_r;
   UBspline_3d_d* spline_i;
   splineset_t* bspline;
-  fftw_plan FFTplan;
+  ///communicator of the ranks on the same node, used with node-shared coefficients
+  std::shared_ptr<Communicate> nodeComm;
+  ///communicator of the node leaders, used with node-shared coefficients
+  std::unique_ptr<Communicate> nodeLeaderComm;
 
   SplineSetReader(EinsplineSetBuilder* e)
-      : BsplineReaderBase(e), spline_r(NULL), spline_i(NULL), bspline(0), FFTplan(NULL)
+      : BsplineReaderBase(e), spline_r(NULL), spline_i(NULL), bspline(0)
   {}
 
   ~SplineSetReader() { clear(); }
@@ -58,9 +82,36 @@ struct SplineSetReader : public BsplineReaderBase
   {
     einspline::destroy(spline_r);
     einspline::destroy(spline_i);
-    if (FFTplan != NULL)
-      fftw_destroy_plan(FFTplan);
-    FFTplan = NULL;
+  }
+
+  /// allocate the FFT box, its plan and the single splines of a band workspace
+  void create_workspace(BandWorkspace& ws)
+  {
+    const int nx = MeshSize[0];
+    const int ny = MeshSize[1];
+    const int nz = MeshSize[2];
+    ws.FFTbox.resize(nx, ny, nz);
+    // planning is not thread-safe, each workspace gets its own plan before the threads start
+    ws.FFTplan = fftw_plan_dft_3d(nx, ny, nz, reinterpret_cast<fftw_complex*>(ws.FFTbox.data()),
+                                  reinterpret_cast<fftw_complex*>(ws.FFTbox.data()), +1, FFTW_ESTIMATE);
+    ws.splineData_r.resize(nx, ny, nz);
+    if (bspline->is_complex)
+      ws.splineData_i.resize(nx, ny, nz);
+
+    TinyVector<double, 3> start(0.0);
+    TinyVector<double, 3> end(1.0);
+    ws.spline_r = einspline::create(ws.spline_r, start, end, MeshSize, bspline->HalfG);
+    if (bspline->is_complex)
+      ws.spline_i = einspline::create(ws.spline_i, start, end, MeshSize, bspline->HalfG);
+  }
+
+  void destroy_workspace(BandWorkspace& ws)
+  {
+    einspline::destroy(ws.spline_r);
+    einspline::destroy(ws.spline_i);
+    if (ws.FFTplan != nullptr)
+      fftw_destroy_plan(ws.FFTplan);
+    ws.FFTplan = nullptr;
   }
 
   // set info for Hybrid
@@ -157,12 +208,43 @@ struct SplineSetReader : public BsplineReaderBase
     {
       APP_ABORT("SplineSetReader needs psi_g. Set precision=\"double\".");
     }
-    bspline->create_spline(xyz_grid, xyz_bc);
-    //    int TwistNum = mybuilder->TwistNum;
     std::ostringstream oo;
-    oo << bandgroup.myName << ".g" << MeshSize[0] << "x" << MeshSize[1] << "x" << MeshSize[2] << ".h5";
-    std::string splinefile = oo.str(); //bandgroup.myName+".h5";
-    //=make_spline_filename(mybuilder->H5FileName,mybuilder->TileMatrix,spin,TwistNum,bandgroup.GroupID,MeshSize);
+    oo << bandgroup.myName << ".g" << MeshSize[0] << "x" << MeshSize[1] << "x" << MeshSize[2];
+    const std::string splinefile = oo.str() + ".h5";
+    const std::string cachefile  = oo.str() + ".coefs";
+    if (mappedSplineCoefs && !bspline->canMapCoefs())
+    {
+      app_warning() << bspline->getClassName() << " does not support mapped_coefs. "
+                    << "Each rank keeps a private copy of the spline coefficients." << std::endl;
+      mappedSplineCoefs = false;
+    }
+    // the layout is taken before create_spline reorders the bands
+    const std::string layout = mappedSplineCoefs ? coefs_layout(bandgroup, xyz_grid, xyz_bc) : std::string();
+    bool mapped              = mappedSplineCoefs && map_coefs(cachefile, layout);
+    if (nodeSharedCoefs && !mapped)
+    {
+      nodeComm = std::make_shared<Communicate>();
+      nodeComm->initializeAsNodeComm(*myComm);
+      bspline->setNodeComm(nodeComm);
+    }
+    bspline->create_spline(xyz_grid, xyz_bc);
+    if (mapped)
+    {
+      clear();
+      return bspline;
+    }
+    // with node-shared coefficients, only the node leaders fill the table
+    const bool node_shared = bspline->isNodeShared();
+    if (node_shared)
+    {
+      nodeLeaderComm = std::make_unique<Communicate>();
+      nodeLeaderComm->initializeAsSplitComm(*myComm, nodeComm->rank() == 0 ? 0 : 1);
+      app_log() << "  Sharing spline coefficients among " << nodeComm->size() << " ranks per node" << std::endl;
+    }
+    else if (nodeSharedCoefs)
+      app_warning() << bspline->getClassName() << " does not support shared_coefs. "
+                    << "Each rank keeps a private copy of the spline coefficients." << std::endl;
+    const bool fill_table = !node_shared || nodeComm->rank() == 0;
     bool root       = (myComm->rank() == 0);
     int foundspline = 0;
     Timer now;
@@ -196,38 +278,26 @@ struct SplineSetReader : public BsplineReaderBase
     if (foundspline)
     {
       now.restart();
-      bspline->bcast_tables(myComm);
+      bcast_tables();
       app_log() << "  SplineSetReader bcast the full table " << now.elapsed() << " sec." << std::endl;
       app_log().flush();
     }
     else
     {
-      bspline->flush_zero();
+      if (fill_table)
+        bspline->flush_zero();
 
-      int nx = MeshSize[0];
-      int ny = MeshSize[1];
-      int nz = MeshSize[2];
       if (havePsig) //perform FFT using FFTW
       {
-        FFTbox.resize(nx, ny, nz);
-        FFTplan = fftw_plan_dft_3d(nx, ny, nz, reinterpret_cast<fftw_complex*>(FFTbox.data()),
-                                   reinterpret_cast<fftw_complex*>(FFTbox.data()), +1, FFTW_ESTIMATE);
-        splineData_r.resize(nx, ny, nz);
-        if (bspline->is_complex)
-          splineData_i.resize(nx, ny, nz);
-
-        TinyVector<double, 3> start(0.0);
-        TinyVector<double, 3> end(1.0);
-        spline_r = einspline::create(spline_r, start, end, MeshSize, bspline->HalfG);
-        if (bspline->is_complex)
-          spline_i = einspline::create(spline_i, start, end, MeshSize, bspline->HalfG);
-
+        if (fill_table)
+        {
+          now.restart();
+          initialize_spline_pio_gather(spin, bandgroup, node_shared ? nodeLeaderComm.get() : myComm);
+          app_log() << "  SplineSetReader initialize_spline_pio " << now.elapsed() << " sec" << std::endl;
+        }
         now.restart();
-        initialize_spline_pio_gather(spin, bandgroup);
-        app_log() << "  SplineSetReader initialize_spline_pio " << now.elapsed() << " sec" << std::endl;
-
-        fftw_destroy_plan(FFTplan);
-        FFTplan = NULL;
+        bcast_tables();
+        app_log() << "  Time to bcast the table = " << now.elapsed() << std::endl;
       }
       else //why, don't know
         initialize_spline_psi_r(spin, bandgroup);
@@ -247,91 +317,272 @@ struct SplineSetReader : public BsplineReaderBase
       }
     }
 
+    if (mappedSplineCoefs && root)
+    {
+      now.restart();
+      auto* spline = bspline->SplineInst->getSplinePtr();
+      if (MappedSplineCoefs::write(cachefile, spline->coefs, sizeof(DataType), spline->coefs_size, layout))
+        app_log() << "  Stored spline coefficients in " << cachefile
+                  << " for mapping in later runs. The writing time is " << now.elapsed() << " sec." << std::endl;
+      else
+        app_warning() << "Failed to write the spline coefficient cache " << cachefile << std::endl;
+    }
+
     clear();
     return bspline;
   }
 
-  /** fft and spline cG
+  /** return the layout of the coefficient table recorded in a cache file
+   *
+   * The layout covers all the inputs determining the table: the size and modification time of the h5 file,
+   * class, precision, grid, boundary conditions, twists and the ordering of the bands.
+   */
+  template<typename GT, typename BCT>
+  std::string coefs_layout(const BandInfoGroup& bandgroup, const GT* xyz_grid, const BCT* xyz_bc) const
+  {
+    std::ostringstream o;
+    o.setf(std::ios::scientific);
+    o.precision(17);
+    o << MappedSplineCoefs::sourceStamp(mybuilder->H5FileName) << "\n";
+    o << "class " << bspline->getClassName() << "\n";
+    o << "sizeof " << sizeof(DataType) << " alignment " << QMC_CLINE << "\n";
+    for (int j = 0; j < 3; j++)
+      o << "grid " << xyz_grid[j].start << " " << xyz_grid[j].end << " " << xyz_grid[j].num << " bc "
+        << xyz_bc[j].lCode << " " << xyz_bc[j].rCode << "\n";
+    o << "halfg " << bspline->HalfG << "\n";
+    o << "spos " << bandgroup.getFirstSPO() << " " << bandgroup.getLastSPO() << "\n";
+    const std::vector<BandInfo>& cur_bands = bandgroup.myBands;
+    for (int iorb = 0; iorb < cur_bands.size(); iorb++)
+      o << "band " << cur_bands[iorb].TwistIndex << " " << cur_bands[iorb].BandIndex << " "
+        << bspline->MakeTwoCopies[iorb] << " " << bspline->kPoints[iorb] << "\n";
+    return o.str();
+  }
+
+  /** map the coefficient table read-only from a cache file on all the ranks
+   * @param cachefile name of the cache file
+   * @param layout expected layout of the table
+   * @return true if all the ranks mapped the file and offered it to bspline
+   */
+  bool map_coefs(const std::string& cachefile, const std::string& layout)
+  {
+    Timer now;
+    auto mapped = std::make_shared<MappedSplineCoefs>();
+    std::string reason;
+    int found = mapped->open(cachefile, sizeof(DataType), layout, reason) ? 1 : 0;
+    if (!found)
+      app_log() << "  Spline coefficient cache is not used, " << reason << std::endl;
+    myComm->allreduce(found);
+    if (found < myComm->size())
+    {
+      if (found > 0)
+        app_warning() << "Spline coefficient cache " << cachefile << " is not usable on all the ranks." << std::endl;
+      return false;
+    }
+    bspline->setMappedCoefs(mapped);
+    app_log() << "  Mapped spline coefficients from " << cachefile << ". The mapping time is " << now.elapsed()
+              << " sec." << std::endl;
+    return true;
+  }
+
+  /** fft and spline cG, then copy the splines to the table
    * @param cG psi_g to be processed
    * @param ti twist index
    * @param iorb orbital index
+   * @param ws scratch space owned by the calling thread
+   * @param phase_r real part of the phase used to rotate the orbital
+   * @param phase_i imaginary part of the phase used to rotate the orbital
+   * @param times accumulated time of each stage
    *
-   * Perform FFT and spline to spline_r and spline_i
+   * Different bands can be processed concurrently with different workspaces.
    */
-  inline void fft_spline(Vector<std::complex<double>>& cG, int ti)
+  inline void fft_spline(const Vector<std::complex<double>>& cG,
+                         int ti,
+                         int iorb,
+                         BandWorkspace& ws,
+                         double& phase_r,
+                         double& phase_i,
+                         BandStageTimes& times)
   {
-    unpack4fftw(cG, mybuilder->Gvecs[0], MeshSize, FFTbox);
-    fftw_execute(FFTplan);
+    Timer clock;
+    unpack4fftw(cG, mybuilder->Gvecs[0], MeshSize, ws.FFTbox);
+    fftw_execute(ws.FFTplan);
+    times.fft += clock.elapsed();
+    clock.restart();
     if (bspline->is_complex)
-    {
-      fix_phase_rotate_c2c(FFTbox, splineData_r, splineData_i, mybuilder->TwistAngles[ti], rotate_phase_r,
-                           rotate_phase_i);
-      einspline::set(spline_r, splineData_r.data());
-      einspline::set(spline_i, splineData_i.data());
-    }
+      fix_phase_rotate_c2c(ws.FFTbox, ws.splineData_r, ws.splineData_i, mybuilder->TwistAngles[ti], phase_r, phase_i);
     else
+      fix_phase_rotate_c2r(ws.FFTbox, ws.splineData_r, mybuilder->TwistAngles[ti], phase_r, phase_i);
+    times.phase += clock.elapsed();
+    clock.restart();
+    einspline::set(ws.spline_r, ws.splineData_r.data());
+    if (bspline->is_complex)
+      einspline::set(ws.spline_i, ws.splineData_i.data());
+    times.solve += clock.elapsed();
+    clock.restart();
+    // each band fills its own columns of the table
+    bspline->set_spline(ws.spline_r, ws.spline_i, ti, iorb, 0);
+    times.copy += clock.elapsed();
+  }
+
+
+  /** bcast the full table from the rank 0 of myComm
+   *
+   * A node-shared table is only sent to the node leaders and becomes visible to the other ranks after the fence.
+   */
+  void bcast_tables()
+  {
+    if (bspline->isNodeShared())
     {
-      fix_phase_rotate_c2r(FFTbox, splineData_r, mybuilder->TwistAngles[ti], rotate_phase_r, rotate_phase_i);
-      einspline::set(spline_r, splineData_r.data());
+      if (nodeComm->rank() == 0)
+        bspline->bcast_tables(nodeLeaderComm.get());
+      bspline->fenceSharedCoefs();
     }
+    else
+      bspline->bcast_tables(myComm);
   }
 
-
   /** initialize the splines
+   * @param comm ranks sharing the work, the full table is gathered on its rank 0
+   *
+   * The bands of a band group are processed in batches. While the threads transform a batch,
+   * one band per thread with FFT, phase rotation and spline solve, another thread reads the next batch.
    */
-  void initialize_spline_pio_gather(int spin, const BandInfoGroup& bandgroup)
+  void initialize_spline_pio_gather(int spin, const BandInfoGroup& bandgroup, Communicate* comm)
   {
     //distribute bands over processor groups
     int Nbands            = bandgroup.getNumDistinctOrbitals();
-    const int Nprocs      = myComm->size();
+    const int Nprocs      = comm->size();
     const int Nbandgroups = std::min(Nbands, Nprocs);
-    Communicate band_group_comm(*myComm, Nbandgroups);
+    Communicate band_group_comm(*comm, Nbandgroups);
     std::vector<int> band_groups(Nbandgroups + 1, 0);
     FairDivideLow(Nbands, Nbandgroups, band_groups);
-    int iorb_first = band_groups[band_group_comm.getGroupID()];
-    int iorb_last  = band_groups[band_group_comm.getGroupID() + 1];
+    int iorb_first    = band_groups[band_group_comm.getGroupID()];
+    int iorb_last     = band_groups[band_group_comm.getGroupID() + 1];
+    const bool leader = band_group_comm.isGroupLeader();
+
+    // number of bands transformed concurrently, each needs its own workspace
+    const int batch_size =
+        std::max(1, std::min(concurrentBands > 0 ? concurrentBands : omp_get_max_threads(), iorb_last - iorb_first));
+    app_log() << "Start transforming plane waves to 3D B-Splines, " << batch_size << " band(s) at a time."
+              << std::endl;
 
-    app_log() << "Start transforming plane waves to 3D B-Splines." << std::endl;
     hdf_archive h5f(&band_group_comm, false);
-    Vector<std::complex<double>> cG(mybuilder->Gvecs[0].size());
     const std::vector<BandInfo>& cur_bands = bandgroup.myBands;
-    if (band_group_comm.isGroupLeader())
+    if (leader)
       h5f.open(mybuilder->H5FileName, H5F_ACC_RDONLY);
-    for (int iorb = iorb_first; iorb < iorb_last; iorb++)
+
+    // the batch being transformed and the batch being read
+    std::vector<Vector<std::complex<double>>> cG_work(batch_size), cG_read(batch_size);
+    for (int ib = 0; ib < batch_size; ib++)
     {
-      if (band_group_comm.isGroupLeader())
+      cG_work[ib].resize(mybuilder->Gvecs[0].size());
+      cG_read[ib].resize(mybuilder->Gvecs[0].size());
+    }
+    std::vector<BandWorkspace> workspaces(leader ? batch_size : 0);
+    for (auto& ws : workspaces)
+      create_workspace(ws);
+    std::vector<double> phases_r(batch_size), phases_i(batch_size), norms(batch_size);
+    std::vector<BandStageTimes> stage_times(batch_size);
+    double t_read = 0.0, t_centers = 0.0;
+
+    auto read_bands = [&](int first, int last, std::vector<Vector<std::complex<double>>>& cGs) {
+      for (int iorb = first; iorb < last; iorb++)
       {
         int iorb_h5   = bspline->BandIndexMap[iorb];
-        int ti        = cur_bands[iorb_h5].TwistIndex;
-        std::string s = psi_g_path(ti, spin, cur_bands[iorb_h5].BandIndex);
-        if (!h5f.readEntry(cG, s))
-          APP_ABORT("SplineSetReader Failed to read band(s) from h5!\n");
-        double total_norm = compute_norm(cG);
-        if ((checkNorm) && (std::abs(total_norm - 1.0) > PW_COEFF_NORM_TOLERANCE))
+        std::string s = psi_g_path(cur_bands[iorb_h5].TwistIndex, spin, cur_bands[iorb_h5].BandIndex);
+        if (!h5f.readEntry(cGs[iorb - first], s))
+          return false;
+      }
+      return true;
+    };
+
+    Timer clock;
+    bool read_ok = true;
+    if (leader)
+      read_ok = read_bands(iorb_first, std::min(iorb_first + batch_size, iorb_last), cG_read);
+    t_read += clock.elapsed();
+    for (int first = iorb_first; first < iorb_last; first += batch_size)
+    {
+      const int last = std::min(first + batch_size, iorb_last);
+      std::swap(cG_work, cG_read);
+      if (!read_ok)
+        APP_ABORT("SplineSetReader Failed to read band(s) from h5!\n");
+
+      // only the HDF5 reads happen on the reader thread
+      std::thread reader;
+      if (leader && last < iorb_last)
+        reader = std::thread([&, last] {
+          Timer read_clock;
+          read_ok = read_bands(last, std::min(last + batch_size, iorb_last), cG_read);
+          t_read += read_clock.elapsed();
+        });
+
+      if (leader)
+      {
+        const int nb = last - first;
+#pragma omp parallel for num_threads(nb) if (nb > 1)
+        for (int ib = 0; ib < nb; ib++)
         {
-          std::cerr << "The orbital " << iorb_h5 << " has a wrong norm " << total_norm
-                    << ", computed from plane wave coefficients!" << std::endl
-                    << "This may indicate a problem with the HDF5 library versions used "
-                    << "during wavefunction conversion or read." << std::endl;
-          APP_ABORT("SplineSetReader Wrong orbital norm!");
+          const int iorb_h5 = bspline->BandIndexMap[first + ib];
+          norms[ib]         = compute_norm(cG_work[ib]);
+          fft_spline(cG_work[ib], cur_bands[iorb_h5].TwistIndex, first + ib, workspaces[ib], phases_r[ib],
+                     phases_i[ib], stage_times[ib]);
         }
-        fft_spline(cG, ti);
-        bspline->set_spline(spline_r, spline_i, cur_bands[iorb_h5].TwistIndex, iorb, 0);
+        for (int ib = 0; ib < nb; ib++)
+          if ((checkNorm) && (std::abs(norms[ib] - 1.0) > PW_COEFF_NORM_TOLERANCE))
+          {
+            std::cerr << "The orbital " << bspline->BandIndexMap[first + ib] << " has a wrong norm " << norms[ib]
+                      << ", computed from plane wave coefficients!" << std::endl
+                      << "This may indicate a problem with the HDF5 library versions used "
+                      << "during wavefunction conversion or read." << std::endl;
+            APP_ABORT("SplineSetReader Wrong orbital norm!");
+          }
+      }
+      if (reader.joinable())
+        reader.join();
+
+      // atomic centers use collectives over band_group_comm and take the bands in order
+      clock.restart();
+      for (int iorb = first; iorb < last; iorb++)
+      {
+        rotate_phase_r = phases_r[iorb - first];
+        rotate_phase_i = phases_i[iorb - first];
+        this->create_atomic_centers_Gspace(cG_work[iorb - first], band_group_comm, iorb);
+      }
+      t_centers += clock.elapsed();
+    }
+    for (auto& ws : workspaces)
+      destroy_workspace(ws);
+
+    if (leader)
+    {
+      BandStageTimes total;
+      for (const auto& t : stage_times)
+      {
+        total.fft += t.fft;
+        total.phase += t.phase;
+        total.solve += t.solve;
+        total.copy += t.copy;
       }
-      this->create_atomic_centers_Gspace(cG, band_group_comm, iorb);
+      app_log() << "  Band transformation stages, read time overlaps the other stages and thread times are summed "
+                   "over threads"
+                << std::endl
+                << "    read HDF5     = " << t_read << " sec" << std::endl
+                << "    FFT           = " << total.fft << " sec" << std::endl
+                << "    phase         = " << total.phase << " sec" << std::endl
+                << "    spline solve  = " << total.solve << " sec" << std::endl
+                << "    copy to table = " << total.copy << " sec" << std::endl
+                << "    atomic orbs   = " << t_centers << " sec" << std::endl;
     }
 
-    myComm->barrier();
+    comm->barrier();
     Timer now;
-    if (band_group_comm.isGroupLeader())
+    if (leader)
     {
       now.restart();
       bspline->gather_tables(band_group_comm.GroupLeaderComm);
       app_log() << "  Time to gather the table = " << now.elapsed() << std::endl;
     }
-    now.restart();
-    bspline->bcast_tables(myComm);
-    app_log() << "  Time to bcast the table = " << now.elapsed() << std::endl;
   }
 
   void initialize_spline_psi_r(int spin, const BandInfoGroup& bandgroup)
@@ -32,6 +32,28 @@ DiffWaveFunctionComponentPtr DiffWaveFunctionComponent::makeClone(ParticleSet& t
   return 0;
 }
 
+void DiffWaveFunctionComponent::mw_evaluateDerivatives(const RefVector<DiffWaveFunctionComponent>& dpsi_list,
+                                                       const RefVector<ParticleSet>& P_list,
+                                                       const opt_variables_type& optvars,
+                                                       RecordArray<ValueType>& dlogpsi,
+                                                       RecordArray<ValueType>& dhpsioverpsi)
+{
+  const int nparam = dlogpsi.nparam();
+  std::vector<ValueType> tmp_dlogpsi(nparam);
+  std::vector<ValueType> tmp_dhpsioverpsi(nparam);
+  for (int iw = 0; iw < dpsi_list.size(); iw++)
+  {
+    std::fill(tmp_dlogpsi.begin(), tmp_dlogpsi.end(), ValueType(0));
+    std::fill(tmp_dhpsioverpsi.begin(), tmp_dhpsioverpsi.end(), ValueType(0));
+    dpsi_list[iw].get().evaluateDerivatives(P_list[iw], optvars, tmp_dlogpsi, tmp_dhpsioverpsi);
+    for (int i = 0; i < nparam; i++)
+    {
+      dlogpsi.setValue(i, iw, dlogpsi.getValue(i, iw) + tmp_dlogpsi[i]);
+      dhpsioverpsi.setValue(i, iw, dhpsioverpsi.getValue(i, iw) + tmp_dhpsioverpsi[i]);
+    }
+  }
+}
+
 void DiffWaveFunctionComponent::evaluateDerivRatios(ParticleSet& VP,
                                                     const opt_variables_type& optvars,
                                                     Matrix<ValueType>& dratios)
@@ -80,6 +80,19 @@ struct DiffWaveFunctionComponent
                                    std::vector<ValueType>& dlogpsi,
                                    std::vector<ValueType>& dhpsioverpsi) = 0;
 
+  /** evaluate derivatives for a batch of walkers
+   * @param dpsi_list the list of DiffWaveFunctionComponent of the same component in a walker batch
+   * @param P_list the list of ParticleSet in a walker batch
+   * @param optvars optimizable variables
+   * @param dlogpsi derivatives of the log of the wavefunction, added to the entry of each walker
+   * @param dhpsioverpsi derivatives of the local kinetic energy, added to the entry of each walker
+   */
+  virtual void mw_evaluateDerivatives(const RefVector<DiffWaveFunctionComponent>& dpsi_list,
+                                      const RefVector<ParticleSet>& P_list,
+                                      const opt_variables_type& optvars,
+                                      RecordArray<ValueType>& dlogpsi,
+                                      RecordArray<ValueType>& dhpsioverpsi);
+
   /** evaluate derivatives at \f$\{R\}\f$
    * @param P current configuration
    * @param optvars optimizable variables
@@ -341,7 +341,8 @@ typename DiracDeterminant<DU_TYPE>::LogValueType DiracDeterminant<DU_TYPE>::upda
                                                                                          WFBufferType& buf,
                                                                                          bool fromscratch)
 {
-  if (fromscratch)
+  // recompute in full precision when the accumulated updates have degraded the inverse
+  if (fromscratch || (residual_tolerance > 0 && sampledInverseResidual(P, psiM) > residual_tolerance))
   {
     LogValue = evaluateLog(P, P.G, P.L);
   }
@@ -464,6 +465,25 @@ void DiracDeterminant<DU_TYPE>::evaluateRatiosAlltoOne(ParticleSet& P, std::vect
   MatrixOperators::product(psiM, psiV.data(), &ratios[FirstIndex]);
 }
 
+template<typename DU_TYPE>
+void DiracDeterminant<DU_TYPE>::evaluateRatiosAlltoMany(ParticleSet& P,
+                                                        const std::vector<PosType>& positions,
+                                                        Matrix<ValueType>& ratios)
+{
+  const int nk = positions.size();
+  psiV_many.resize(nk, NumOrbitals);
+  SPOVTimer.start();
+  for (int k = 0; k < nk; ++k)
+  {
+    P.makeVirtualMoves(positions[k]);
+    ValueVector_t psiV_k(psiV_many[k], NumOrbitals);
+    Phi->evaluateValue(P, -1, psiV_k);
+  }
+  SPOVTimer.stop();
+  // ratios(k,FirstIndex+i) = sum_j psiM(i,j) psiV_many(k,j)
+  BLAS::gemm('T', 'N', NumPtcls, nk, NumOrbitals, ValueType(1), psiM.data(), psiM.cols(), psiV_many.data(),
+             NumOrbitals, ValueType(0), ratios.data() + FirstIndex, ratios.cols());
+}
 
 template<typename DU_TYPE>
 void DiracDeterminant<DU_TYPE>::resizeScratchObjectsForIonDerivs()
@@ -688,11 +708,26 @@ void DiracDeterminant<DU_TYPE>::evaluateDerivatives(ParticleSet& P,
   Phi->evaluateDerivatives(P, active, dlogpsi, dhpsioverpsi, FirstIndex, LastIndex);
 }
 
+template<typename DU_TYPE>
+void DiracDeterminant<DU_TYPE>::mw_evaluateParameterDerivatives(const RefVector<WaveFunctionComponent>& WFC_list,
+                                                                const RefVector<ParticleSet>& P_list,
+                                                                const opt_variables_type& optvars,
+                                                                RecordArray<ValueType>& dlogpsi,
+                                                                RecordArray<ValueType>& dhpsioverpsi)
+{
+  RefVector<SPOSet> spo_list;
+  spo_list.reserve(WFC_list.size());
+  for (WaveFunctionComponent& wfc : WFC_list)
+    spo_list.push_back(*static_cast<DiracDeterminant<DU_TYPE>&>(wfc).Phi);
+  Phi->mw_evaluateDerivatives(spo_list, P_list, optvars, dlogpsi, dhpsioverpsi, FirstIndex, LastIndex);
+}
+
 template<typename DU_TYPE>
 DiracDeterminant<DU_TYPE>* DiracDeterminant<DU_TYPE>::makeCopy(SPOSetPtr spo) const
 {
   DiracDeterminant<DU_TYPE>* dclone = new DiracDeterminant<DU_TYPE>(spo);
   dclone->set(FirstIndex, LastIndex - FirstIndex, ndelay);
+  dclone->setResidualCheck(residual_tolerance, residual_rows);
   return dclone;
 }
 
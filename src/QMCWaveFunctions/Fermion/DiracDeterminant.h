@@ -69,6 +69,12 @@ public:
                            std::vector<ValueType>& dlogpsi,
                            std::vector<ValueType>& dhpsioverpsi) override;
 
+  void mw_evaluateParameterDerivatives(const RefVector<WaveFunctionComponent>& WFC_list,
+                                       const RefVector<ParticleSet>& P_list,
+                                       const opt_variables_type& optvars,
+                                       RecordArray<ValueType>& dlogpsi,
+                                       RecordArray<ValueType>& dhpsioverpsi) override;
+
   ///reset the size: with the number of particles and number of orbtials
   void resize(int nel, int morb);
 
@@ -177,6 +183,14 @@ public:
 
   void evaluateRatiosAlltoOne(ParticleSet& P, std::vector<ValueType>& ratios) override;
 
+  /** fills the columns [FirstIndex, LastIndex) of ratios
+   *
+   * The orbitals are evaluated at all the positions and contracted with the inverse by a single GEMM.
+   */
+  void evaluateRatiosAlltoMany(ParticleSet& P,
+                               const std::vector<PosType>& positions,
+                               Matrix<ValueType>& ratios) override;
+
 #ifndef NDEBUG
   /// return  for testing
   ValueMatrix_t& getPsiMinv() override { return psiM; }
@@ -209,6 +223,8 @@ public:
 
   /// value of single-particle orbital for particle-by-particle update
   ValueVector_t psiV;
+  /// orbital values at the positions of evaluateRatiosAlltoMany
+  ValueMatrix_t psiV_many;
   ValueVector_t dspin_psiV;
   GradVector_t dpsiV;
   ValueVector_t d2psiV;
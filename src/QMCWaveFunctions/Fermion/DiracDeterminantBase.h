@@ -42,7 +42,10 @@ public:
         FirstIndex(first),
         LastIndex(first + spos->size()),
         NumOrbitals(spos->size()),
-        NumPtcls(spos->size())
+        NumPtcls(spos->size()),
+        residual_tolerance(0),
+        residual_rows(1),
+        residual_offset(0)
   {
     Optimizable  = Phi->isOptimizable();
     is_fermionic = true;
@@ -73,6 +76,50 @@ public:
    */
   virtual void set(int first, int nel, int delay = 1){};
 
+  /** check the inverse matrix on a few sampled rows when the walker buffer is updated
+   *@param tolerance the inverse is recomputed when the residual exceeds tolerance, 0 disables the check
+   *@param num_rows number of rows sampled by each check
+   */
+  void setResidualCheck(RealType tolerance, int num_rows)
+  {
+    residual_tolerance = tolerance;
+    residual_rows      = num_rows;
+  }
+
+  /** residual of the inverse matrix on the sampled rows
+   *@param P current configuration
+   *@param invMat inverse matrix, sum_j invMat(i,j) phi_j(r_k) = delta_ik
+   *@return max |sum_j invMat(i,j) phi_j(r_k) - delta_ik| over all i and the sampled particles k
+   *
+   * The sampled particles are spread over the determinant and shifted by one at each call
+   * so that repeated checks cover all the rows. The sums are accumulated in full precision.
+   */
+  template<typename MT>
+  RealType sampledInverseResidual(ParticleSet& P, const MT& invMat)
+  {
+    using mValueType = QMCTraits::QTFull::ValueType;
+    const int nrows  = std::max(1, std::min(residual_rows, NumPtcls));
+    const int stride = NumPtcls / nrows;
+    residual_psiV.resize(NumOrbitals);
+    RealType residual = 0;
+    for (int s = 0; s < nrows; s++)
+    {
+      const int k = (residual_offset + s * stride) % NumPtcls;
+      SPOVTimer.start();
+      Phi->evaluateValue(P, FirstIndex + k, residual_psiV);
+      SPOVTimer.stop();
+      for (int i = 0; i < NumPtcls; i++)
+      {
+        mValueType sum(i == k ? -1 : 0);
+        for (int j = 0; j < NumOrbitals; j++)
+          sum += static_cast<mValueType>(invMat(i, j)) * static_cast<mValueType>(residual_psiV[j]);
+        residual = std::max(residual, static_cast<RealType>(std::abs(sum)));
+      }
+    }
+    residual_offset = (residual_offset + 1) % NumPtcls;
+    return residual;
+  }
+
   ///set BF pointers
   virtual void setBF(BackflowTransformation* BFTrans) {}
 
@@ -182,6 +229,15 @@ protected:
   ///number of particles which belong to this Dirac determinant
   int NumPtcls;
 
+  ///recompute the inverse when the sampled residual exceeds this value, 0 disables the check
+  RealType residual_tolerance;
+  ///number of rows sampled by each residual check
+  int residual_rows;
+  ///first row sampled by the next residual check
+  int residual_offset;
+  ///orbital values of a sampled particle
+  SPOSet::ValueVector_t residual_psiV;
+
 #ifndef NDEBUG
   ValueMatrix_t dummy_vmt;
 #endif
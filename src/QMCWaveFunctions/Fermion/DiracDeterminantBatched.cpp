@@ -347,7 +347,8 @@ typename DiracDeterminantBatched<DET_ENGINE_TYPE>::LogValueType DiracDeterminant
     WFBufferType& buf,
     bool fromscratch)
 {
-  if (fromscratch)
+  // recompute in full precision when the accumulated updates have degraded the inverse
+  if (fromscratch || (residual_tolerance > 0 && sampledInverseResidual(P, psiMinv) > residual_tolerance))
   {
     LogValue = evaluateLog(P, P.G, P.L);
   }
@@ -500,6 +501,25 @@ void DiracDeterminantBatched<DET_ENGINE_TYPE>::evaluateRatiosAlltoOne(ParticleSe
   MatrixOperators::product(psiMinv_host_view, psiV.data(), &ratios[FirstIndex]);
 }
 
+template<typename DET_ENGINE_TYPE>
+void DiracDeterminantBatched<DET_ENGINE_TYPE>::evaluateRatiosAlltoMany(ParticleSet& P,
+                                                                       const std::vector<PosType>& positions,
+                                                                       Matrix<ValueType>& ratios)
+{
+  const int nk = positions.size();
+  psiV_many.resize(nk, NumOrbitals);
+  SPOVTimer.start();
+  for (int k = 0; k < nk; ++k)
+  {
+    P.makeVirtualMoves(positions[k]);
+    ValueVector_t psiV_k(psiV_many[k], NumOrbitals);
+    Phi->evaluateValue(P, -1, psiV_k);
+  }
+  SPOVTimer.stop();
+  // ratios(k,FirstIndex+i) = sum_j psiMinv(i,j) psiV_many(k,j)
+  BLAS::gemm('T', 'N', NumPtcls, nk, NumOrbitals, ValueType(1), psiMinv.data(), psiMinv.cols(), psiV_many.data(),
+             NumOrbitals, ValueType(0), ratios.data() + FirstIndex, ratios.cols());
+}
 
 template<typename DET_ENGINE_TYPE>
 void DiracDeterminantBatched<DET_ENGINE_TYPE>::resizeScratchObjectsForIonDerivs()
@@ -743,11 +763,27 @@ void DiracDeterminantBatched<DET_ENGINE_TYPE>::evaluateDerivatives(ParticleSet&
   Phi->evaluateDerivatives(P, active, dlogpsi, dhpsioverpsi, FirstIndex, LastIndex);
 }
 
+template<typename DET_ENGINE_TYPE>
+void DiracDeterminantBatched<DET_ENGINE_TYPE>::mw_evaluateParameterDerivatives(
+    const RefVector<WaveFunctionComponent>& WFC_list,
+    const RefVector<ParticleSet>& P_list,
+    const opt_variables_type& optvars,
+    RecordArray<ValueType>& dlogpsi,
+    RecordArray<ValueType>& dhpsioverpsi)
+{
+  RefVector<SPOSet> spo_list;
+  spo_list.reserve(WFC_list.size());
+  for (WaveFunctionComponent& wfc : WFC_list)
+    spo_list.push_back(*static_cast<DiracDeterminantBatched<DET_ENGINE_TYPE>&>(wfc).Phi);
+  Phi->mw_evaluateDerivatives(spo_list, P_list, optvars, dlogpsi, dhpsioverpsi, FirstIndex, LastIndex);
+}
+
 template<typename DET_ENGINE_TYPE>
 DiracDeterminantBatched<DET_ENGINE_TYPE>* DiracDeterminantBatched<DET_ENGINE_TYPE>::makeCopy(SPOSetPtr spo) const
 {
   DiracDeterminantBatched<DET_ENGINE_TYPE>* dclone = new DiracDeterminantBatched<DET_ENGINE_TYPE>(spo);
   dclone->set(FirstIndex, LastIndex - FirstIndex, ndelay);
+  dclone->setResidualCheck(residual_tolerance, residual_rows);
   return dclone;
 }
 
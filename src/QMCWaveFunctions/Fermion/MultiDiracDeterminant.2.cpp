@@ -19,6 +19,7 @@
  */
 #include "QMCWaveFunctions/Fermion/MultiDiracDeterminant.h"
 #include "Numerics/MatrixOperators.h"
+#include "CPU/BLAS.hpp"
 
 namespace qmcplusplus
 {
@@ -189,6 +190,282 @@ void MultiDiracDeterminant::BuildDotProductsAndCalculateRatios(int ref,
 #endif
 }
 
+void MultiDiracDeterminant::calculateExcitationLevelRatios(const ExcitationLevel& table,
+                                                           int level,
+                                                           const ValueType* restrict dots,
+                                                           ValueType det0,
+                                                           ValueType* restrict ratios,
+                                                           size_t stride)
+{
+  const size_t ndets             = table.dets.size();
+  const int* restrict dets       = table.dets.data();
+  const int* restrict rows       = table.rows.data();
+  const int* restrict cols       = table.cols.data();
+  const RealType* restrict signs = table.signs.data();
+  switch (level)
+  {
+  case 0:
+    for (size_t n = 0; n < ndets; ++n)
+      ratios[dets[n] * stride] = signs[n] * det0;
+    break;
+  case 1:
+    for (size_t n = 0; n < ndets; ++n)
+      ratios[dets[n] * stride] = signs[n] * det0 * dots[rows[n] + cols[n]];
+    break;
+  case 2:
+    for (size_t n = 0; n < ndets; ++n)
+    {
+      const int* restrict r = rows + 2 * n;
+      const int* restrict c = cols + 2 * n;
+      ratios[dets[n] * stride] =
+          signs[n] * det0 * (dots[r[0] + c[0]] * dots[r[1] + c[1]] - dots[r[0] + c[1]] * dots[r[1] + c[0]]);
+    }
+    break;
+  case 3:
+    for (size_t n = 0; n < ndets; ++n)
+    {
+      const int* restrict r = rows + 3 * n;
+      const int* restrict c = cols + 3 * n;
+      ratios[dets[n] * stride] = signs[n] * det0 *
+          DetCalculator.evaluate(dots[r[0] + c[0]], dots[r[0] + c[1]], dots[r[0] + c[2]], dots[r[1] + c[0]],
+                                 dots[r[1] + c[1]], dots[r[1] + c[2]], dots[r[2] + c[0]], dots[r[2] + c[1]],
+                                 dots[r[2] + c[2]]);
+    }
+    break;
+  default:
+    for (size_t n = 0; n < ndets; ++n)
+    {
+      const int* restrict r = rows + level * n;
+      const int* restrict c = cols + level * n;
+      ValueType* restrict m = DetCalculator.M.data();
+      for (int i = 0; i < level; ++i)
+        for (int j = 0; j < level; ++j)
+          m[i * level + j] = dots[r[i] + c[j]];
+      ratios[dets[n] * stride] = signs[n] * det0 * Determinant(m, level, level, DetCalculator.Pivot.data());
+    }
+  }
+}
+
+void MultiDiracDeterminant::mw_BuildDotProductsAndCalculateRatios(const RefVector<MultiDiracDeterminant>& det_list,
+                                                                  const std::vector<ValueType>& det0_list,
+                                                                  const std::vector<const ValueType*>& psiinv_list,
+                                                                  const std::vector<ValueType*>& ratios_list,
+                                                                  size_t stride)
+{
+  const int nw = det_list.size();
+  buildTableTimer.start();
+  // dotProducts(i,a) = psiinv[i] . TpsiM[a] for all the rows and the referenced orbitals, one small GEMM per walker
+  std::vector<ValueType*> dots_list(nw);
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    MultiDiracDeterminant& det = det_list[iw].get();
+    dots_list[iw]              = det.dotProducts.data();
+    if (NumExcitedOrbitals > 0)
+      BLAS::gemm('t', 'n', NumExcitedOrbitals, NumPtcls, NumPtcls, ValueType(1), det.TpsiM.data(), NumPtcls,
+                 psiinv_list[iw], NumPtcls, ValueType(0), dots_list[iw], NumOrbitals);
+  }
+  buildTableTimer.stop();
+  readMatTimer.start();
+  const auto& levels = *excitationLevels;
+  for (int level = 0; level < levels.size(); ++level)
+    for (int iw = 0; iw < nw; ++iw)
+      calculateExcitationLevelRatios(levels[level], level, dots_list[iw], det0_list[iw], ratios_list[iw], stride);
+  for (int iw = 0; iw < nw; ++iw)
+    ratios_list[iw][ReferenceDeterminant * stride] = det0_list[iw];
+  readMatTimer.stop();
+}
+
+void MultiDiracDeterminant::mw_evaluateDetsForPtclMove(const RefVector<MultiDiracDeterminant>& det_list,
+                                                       const RefVector<ParticleSet>& P_list,
+                                                       int iat)
+{
+  const int nw = det_list.size();
+  if (NumPtcls == 1)
+  {
+    for (int iw = 0; iw < nw; ++iw)
+      det_list[iw].get().evaluateDetsForPtclMove(P_list[iw], iat);
+    return;
+  }
+
+  RatioTimer.start();
+  std::vector<ValueType> det0_list(nw);
+  std::vector<const ValueType*> psiinv_list(nw);
+  std::vector<ValueType*> ratios_list(nw);
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    MultiDiracDeterminant& det = det_list[iw].get();
+    det.UpdateMode             = ORB_PBYP_RATIO;
+    evalOrbTimer.start();
+    det.Phi->evaluateValue(P_list[iw], iat, det.psiV);
+    evalOrbTimer.stop();
+    ExtraStuffTimer.start();
+    det.WorkingIndex = iat - FirstIndex;
+    // see the comment in evaluateDetsForPtclMove
+    det.psiMinv_temp = det.psiMinv;
+    auto it(det.ciConfigList->at(ReferenceDeterminant).occup.begin());
+    for (size_t i = 0; i < NumPtcls; i++)
+      det.psiV_temp[i] = det.psiV[*(it++)];
+    ValueType ratioRef                      = DetRatioByColumn(det.psiMinv_temp, det.psiV_temp, det.WorkingIndex);
+    det.new_detValues[ReferenceDeterminant] = ratioRef * det.detValues[ReferenceDeterminant];
+    InverseUpdateByColumn(det.psiMinv_temp, det.psiV_temp, det.workV1, det.workV2, det.WorkingIndex, ratioRef);
+    for (size_t i = 0; i < NumOrbitals; i++)
+      det.TpsiM(i, det.WorkingIndex) = det.psiV[i];
+    ExtraStuffTimer.stop();
+    det0_list[iw]   = det.new_detValues[ReferenceDeterminant];
+    psiinv_list[iw] = det.psiMinv_temp.data();
+    ratios_list[iw] = det.new_detValues.data();
+  }
+
+  mw_BuildDotProductsAndCalculateRatios(det_list, det0_list, psiinv_list, ratios_list, 1);
+
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    MultiDiracDeterminant& det = det_list[iw].get();
+    for (size_t i = 0; i < NumOrbitals; i++)
+      det.TpsiM(i, det.WorkingIndex) = det.psiM(det.WorkingIndex, i);
+  }
+  RatioTimer.stop();
+}
+
+void MultiDiracDeterminant::mw_evaluateDetsAndGradsForPtclMove(const RefVector<MultiDiracDeterminant>& det_list,
+                                                               const RefVector<ParticleSet>& P_list,
+                                                               int iat)
+{
+  const int nw = det_list.size();
+  if (NumPtcls == 1)
+  {
+    for (int iw = 0; iw < nw; ++iw)
+      det_list[iw].get().evaluateDetsAndGradsForPtclMove(P_list[iw], iat);
+    return;
+  }
+
+  RefVector<SPOSet> spo_list;
+  RefVector<ValueVector_t> psi_v_list, d2psi_v_list;
+  RefVector<GradVector_t> dpsi_v_list;
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    MultiDiracDeterminant& det = det_list[iw].get();
+    spo_list.push_back(*det.Phi);
+    psi_v_list.push_back(det.psiV);
+    dpsi_v_list.push_back(det.dpsiV);
+    d2psi_v_list.push_back(det.d2psiV);
+  }
+  evalOrb1Timer.start();
+  Phi->mw_evaluateVGL(spo_list, P_list, iat, psi_v_list, dpsi_v_list, d2psi_v_list);
+  evalOrb1Timer.stop();
+
+  std::vector<ValueType> det0_list(nw);
+  std::vector<const ValueType*> psiinv_list(nw);
+  std::vector<ValueType*> ratios_list(nw);
+  std::vector<GradType> ratioGradRef_list(nw);
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    MultiDiracDeterminant& det = det_list[iw].get();
+    det.UpdateMode             = ORB_PBYP_PARTIAL;
+    ExtraStuffTimer.start();
+    det.WorkingIndex = iat - FirstIndex;
+    det.psiMinv_temp = det.psiMinv;
+    auto it(det.ciConfigList->at(ReferenceDeterminant).occup.begin());
+    GradType ratioGradRef;
+    for (size_t i = 0; i < NumPtcls; i++)
+    {
+      det.psiV_temp[i] = det.psiV[*it];
+      ratioGradRef += det.psiMinv_temp(i, det.WorkingIndex) * det.dpsiV[*it];
+      it++;
+    }
+    ValueType ratioRef = DetRatioByColumn(det.psiMinv_temp, det.psiV_temp, det.WorkingIndex);
+    det.new_grads(ReferenceDeterminant, det.WorkingIndex) = ratioGradRef * det.detValues[ReferenceDeterminant];
+    det.new_detValues[ReferenceDeterminant]               = ratioRef * det.detValues[ReferenceDeterminant];
+    InverseUpdateByColumn(det.psiMinv_temp, det.psiV_temp, det.workV1, det.workV2, det.WorkingIndex, ratioRef);
+    for (size_t i = 0; i < NumOrbitals; i++)
+      det.TpsiM(i, det.WorkingIndex) = det.psiV[i];
+    ExtraStuffTimer.stop();
+    ratioGradRef_list[iw] = ratioGradRef;
+    det0_list[iw]         = det.new_detValues[ReferenceDeterminant];
+    psiinv_list[iw]       = det.psiMinv_temp.data();
+    ratios_list[iw]       = det.new_detValues.data();
+  }
+  mw_BuildDotProductsAndCalculateRatios(det_list, det0_list, psiinv_list, ratios_list, 1);
+
+  for (size_t idim = 0; idim < OHMMS_DIM; idim++)
+  {
+    for (int iw = 0; iw < nw; ++iw)
+    {
+      MultiDiracDeterminant& det = det_list[iw].get();
+      ExtraStuffTimer.start();
+      det.dpsiMinv = det.psiMinv;
+      auto it(det.ciConfigList->at(ReferenceDeterminant).occup.begin());
+      for (size_t i = 0; i < NumPtcls; i++)
+        det.psiV_temp[i] = det.dpsiV[*(it++)][idim];
+      InverseUpdateByColumn(det.dpsiMinv, det.psiV_temp, det.workV1, det.workV2, det.WorkingIndex,
+                            ratioGradRef_list[iw][idim]);
+      for (size_t i = 0; i < NumOrbitals; i++)
+        det.TpsiM(i, det.WorkingIndex) = det.dpsiV[i][idim];
+      ExtraStuffTimer.stop();
+      det0_list[iw]   = det.new_grads(ReferenceDeterminant, det.WorkingIndex)[idim];
+      psiinv_list[iw] = det.dpsiMinv.data();
+      ratios_list[iw] = &det.new_grads(0, det.WorkingIndex)[idim];
+    }
+    mw_BuildDotProductsAndCalculateRatios(det_list, det0_list, psiinv_list, ratios_list, OHMMS_DIM * NumPtcls);
+  }
+
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    MultiDiracDeterminant& det = det_list[iw].get();
+    for (size_t i = 0; i < NumOrbitals; i++)
+      det.TpsiM(i, det.WorkingIndex) = det.psiM(det.WorkingIndex, i);
+  }
+}
+
+void MultiDiracDeterminant::mw_evaluateGrads(const RefVector<MultiDiracDeterminant>& det_list,
+                                             const RefVector<ParticleSet>& P_list,
+                                             int iat)
+{
+  const int nw = det_list.size();
+  if (NumPtcls == 1)
+  {
+    for (int iw = 0; iw < nw; ++iw)
+      det_list[iw].get().evaluateGrads(P_list[iw], iat);
+    return;
+  }
+
+  std::vector<ValueType> det0_list(nw);
+  std::vector<const ValueType*> psiinv_list(nw);
+  std::vector<ValueType*> ratios_list(nw);
+  for (size_t idim = 0; idim < OHMMS_DIM; idim++)
+  {
+    for (int iw = 0; iw < nw; ++iw)
+    {
+      MultiDiracDeterminant& det = det_list[iw].get();
+      det.WorkingIndex           = iat - FirstIndex;
+      det.dpsiMinv               = det.psiMinv;
+      auto it(det.ciConfigList->at(ReferenceDeterminant).occup.begin());
+      ValueType ratioG = 0.0;
+      for (size_t i = 0; i < NumPtcls; i++)
+      {
+        det.psiV_temp[i] = det.dpsiM(det.WorkingIndex, *it)[idim];
+        ratioG += det.psiMinv(i, det.WorkingIndex) * det.dpsiM(det.WorkingIndex, *it)[idim];
+        it++;
+      }
+      det.grads(ReferenceDeterminant, det.WorkingIndex)[idim] = ratioG * det.detValues[ReferenceDeterminant];
+      InverseUpdateByColumn(det.dpsiMinv, det.psiV_temp, det.workV1, det.workV2, det.WorkingIndex, ratioG);
+      for (size_t i = 0; i < NumOrbitals; i++)
+        det.TpsiM(i, det.WorkingIndex) = det.dpsiM(det.WorkingIndex, i)[idim];
+      det0_list[iw]   = det.grads(ReferenceDeterminant, det.WorkingIndex)[idim];
+      psiinv_list[iw] = det.dpsiMinv.data();
+      ratios_list[iw] = &det.grads(0, det.WorkingIndex)[idim];
+    }
+    mw_BuildDotProductsAndCalculateRatios(det_list, det0_list, psiinv_list, ratios_list, OHMMS_DIM * NumPtcls);
+  }
+
+  for (int iw = 0; iw < nw; ++iw)
+  {
+    MultiDiracDeterminant& det = det_list[iw].get();
+    for (size_t i = 0; i < NumOrbitals; i++)
+      det.TpsiM(i, det.WorkingIndex) = det.psiM(det.WorkingIndex, i);
+  }
+}
+
 void MultiDiracDeterminant::evaluateDetsForPtclMove(ParticleSet& P, int iat)
 {
   UpdateMode = ORB_PBYP_RATIO;
@@ -326,6 +326,7 @@ MultiDiracDeterminant::MultiDiracDeterminant(const MultiDiracDeterminant& s)
   detData              = s.detData;
   uniquePairs          = s.uniquePairs;
   DetSigns             = s.DetSigns;
+  excitationLevels     = s.excitationLevels;
   Optimizable          = s.Optimizable;
 
   registerTimers();
@@ -373,6 +374,7 @@ MultiDiracDeterminant::MultiDiracDeterminant(SPOSetPtr const& spos, int first)
   detData      = new std::vector<int>;
   uniquePairs  = new std::vector<std::pair<int, int>>;
   DetSigns     = new std::vector<RealType>;
+  excitationLevels = new std::vector<ExcitationLevel>;
 
   registerTimers();
 }
@@ -396,6 +398,8 @@ MultiDiracDeterminant& MultiDiracDeterminant::operator=(const MultiDiracDetermin
   FirstIndex  = s.FirstIndex;
   DetSigns    = s.DetSigns;
 
+  excitationLevels = s.excitationLevels;
+
   resize(s.NumPtcls, s.NumOrbitals);
   this->DetCalculator.resize(s.NumPtcls);
 
@@ -481,7 +485,38 @@ void MultiDiracDeterminant::resize(int nel, int morb)
   //  APP_ABORT("ciConfigList was not properly initialized.\n");
   //}
   if (!IsCloned)
+  {
     createDetData((*ciConfigList)[ReferenceDeterminant], *detData, *uniquePairs, *DetSigns);
+    buildExcitationLevels();
+  }
+
+  NumExcitedOrbitals = 0;
+  for (const auto& p : *uniquePairs)
+    NumExcitedOrbitals = std::max(NumExcitedOrbitals, p.second + 1);
+}
+
+void MultiDiracDeterminant::buildExcitationLevels()
+{
+  auto& levels = *excitationLevels;
+  levels.clear();
+  auto it = detData->begin();
+  for (int count = 0; count < NumDets; ++count)
+  {
+    const int n = *it;
+    if (count != ReferenceDeterminant)
+    {
+      if (levels.size() <= n)
+        levels.resize(n + 1);
+      ExcitationLevel& table = levels[n];
+      table.dets.push_back(count);
+      table.signs.push_back((*DetSigns)[count]);
+      for (int k = 0; k < n; ++k)
+        table.rows.push_back(*(it + 1 + k) * NumOrbitals);
+      for (int k = 0; k < n; ++k)
+        table.cols.push_back(*(it + 1 + n + k));
+    }
+    it += 3 * n + 1;
+  }
 }
 
 void MultiDiracDeterminant::registerTimers()
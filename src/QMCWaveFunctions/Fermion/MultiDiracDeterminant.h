@@ -386,6 +386,37 @@ public:
   void evaluateDetsForPtclMove(ParticleSet& P, int iat);
   void evaluateDetsAndGradsForPtclMove(ParticleSet& P, int iat);
   void evaluateGrads(ParticleSet& P, int iat);
+
+  /** batched version of evaluateDetsForPtclMove
+   * @param det_list the list of MultiDiracDeterminant of the same spin in a walker batch, *this is the batch leader
+   * @param P_list the list of ParticleSet in a walker batch
+   * @param iat active particle
+   */
+  void mw_evaluateDetsForPtclMove(const RefVector<MultiDiracDeterminant>& det_list,
+                                  const RefVector<ParticleSet>& P_list,
+                                  int iat);
+  /// batched version of evaluateDetsAndGradsForPtclMove
+  void mw_evaluateDetsAndGradsForPtclMove(const RefVector<MultiDiracDeterminant>& det_list,
+                                          const RefVector<ParticleSet>& P_list,
+                                          int iat);
+  /// batched version of evaluateGrads
+  void mw_evaluateGrads(const RefVector<MultiDiracDeterminant>& det_list, const RefVector<ParticleSet>& P_list, int iat);
+
+  /** batched version of BuildDotProductsAndCalculateRatios
+   * @param det_list the list of MultiDiracDeterminant in a walker batch, TpsiM and dotProducts of each walker are used
+   * @param det0_list the reference determinant value of each walker
+   * @param psiinv_list the inverse matrix of each walker
+   * @param ratios_list the address of the ratio of the first determinant of each walker
+   * @param stride distance between the ratios of consecutive determinants
+   *
+   * The dotProducts of each walker are computed by a GEMM restricted to the orbitals referenced by uniquePairs.
+   * The ratios are then evaluated excitation level by excitation level using the ExcitationLevel tables.
+   */
+  void mw_BuildDotProductsAndCalculateRatios(const RefVector<MultiDiracDeterminant>& det_list,
+                                             const std::vector<ValueType>& det0_list,
+                                             const std::vector<const ValueType*>& psiinv_list,
+                                             const std::vector<ValueType*>& ratios_list,
+                                             size_t stride);
   void evaluateAllForPtclMove(ParticleSet& P, int iat);
   // full evaluation of all the structures from scratch, used in evaluateLog for example
   void evaluateForWalkerMove(ParticleSet& P, bool fromScratch = true);
@@ -459,6 +490,42 @@ public:
   std::vector<std::pair<int, int>>* uniquePairs;
   std::vector<RealType>* DetSigns;
   MultiDiracDeterminantCalculator<ValueType> DetCalculator;
+
+  /** determinants of the same excitation level, built from detData
+   *
+   * For the n-th determinant of the level, rows[n*level+k] is the offset of the k-th replaced row
+   * in dotProducts and cols[n*level+k] is the k-th excited orbital.
+   */
+  struct ExcitationLevel
+  {
+    std::vector<int> dets;
+    std::vector<int> rows;
+    std::vector<int> cols;
+    std::vector<RealType> signs;
+  };
+  /// excitation tables indexed by the excitation level, the reference determinant is not included
+  std::vector<ExcitationLevel>* excitationLevels;
+  /// number of dotProducts columns referenced by uniquePairs
+  int NumExcitedOrbitals;
+
+private:
+  /// fill excitationLevels from detData and DetSigns
+  void buildExcitationLevels();
+
+  /** evaluate the ratios of all the determinants of one excitation level
+   * @param table excitation table
+   * @param level excitation level
+   * @param dots dotProducts of a walker
+   * @param det0 reference determinant value
+   * @param ratios the address of the ratio of the first determinant
+   * @param stride distance between the ratios of consecutive determinants
+   */
+  void calculateExcitationLevelRatios(const ExcitationLevel& table,
+                                      int level,
+                                      const ValueType* restrict dots,
+                                      ValueType det0,
+                                      ValueType* restrict ratios,
+                                      size_t stride);
 };
 
 
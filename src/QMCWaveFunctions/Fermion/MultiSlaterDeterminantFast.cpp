@@ -280,6 +280,18 @@ WaveFunctionComponent::PsiValueType MultiSlaterDeterminantFast::evalGrad_impl(Pa
   else
     Dets[spin0]->evaluateGrads(P, iat);
 
+  return evalGrad_impl_no_precompute(P, iat, newpos, g_at);
+}
+
+WaveFunctionComponent::PsiValueType MultiSlaterDeterminantFast::evalGrad_impl_no_precompute(ParticleSet& P,
+                                                                                            int iat,
+                                                                                            bool newpos,
+                                                                                            GradType& g_at)
+{
+  const bool upspin = (iat < FirstIndex_dn);
+  const int spin0   = (upspin) ? 0 : 1;
+  const int spin1   = (upspin) ? 1 : 0;
+
   const GradMatrix_t& grads            = (newpos) ? Dets[spin0]->new_grads : Dets[spin0]->grads;
   const ValueType* restrict detValues0 = (newpos) ? Dets[spin0]->new_detValues.data() : Dets[spin0]->detValues.data();
   const ValueType* restrict detValues1 = Dets[spin1]->detValues.data();
@@ -337,6 +349,15 @@ WaveFunctionComponent::PsiValueType MultiSlaterDeterminantFast::ratio_impl(Parti
 
   Dets[spin0]->evaluateDetsForPtclMove(P, iat);
 
+  return ratio_impl_no_precompute(P, iat);
+}
+
+WaveFunctionComponent::PsiValueType MultiSlaterDeterminantFast::ratio_impl_no_precompute(ParticleSet& P, int iat)
+{
+  const bool upspin = (iat < FirstIndex_dn);
+  const int spin0   = (upspin) ? 0 : 1;
+  const int spin1   = (upspin) ? 1 : 0;
+
   const ValueType* restrict detValues0 = Dets[spin0]->new_detValues.data(); //always new
   const ValueType* restrict detValues1 = Dets[spin1]->detValues.data();
   const size_t* restrict det0          = (upspin) ? C2node_up->data() : C2node_dn->data();
@@ -363,6 +384,90 @@ WaveFunctionComponent::PsiValueType MultiSlaterDeterminantFast::ratio(ParticleSe
   return curRatio;
 }
 
+void MultiSlaterDeterminantFast::mw_calcRatio(const RefVector<WaveFunctionComponent>& WFC_list,
+                                              const RefVector<ParticleSet>& P_list,
+                                              int iat,
+                                              std::vector<PsiValueType>& ratios)
+{
+  if (usingBF)
+  {
+    APP_ABORT("Fast MSD+BF: ratio not implemented. \n");
+  }
+  ScopedTimer local_timer(&RatioTimer);
+  const int spin0 = (iat < FirstIndex_dn) ? 0 : 1;
+  const auto det_list(extractDetRefList(WFC_list, spin0));
+  Dets[spin0]->mw_evaluateDetsForPtclMove(det_list, P_list, iat);
+
+  for (int iw = 0; iw < WFC_list.size(); iw++)
+  {
+    auto& msd           = static_cast<MultiSlaterDeterminantFast&>(WFC_list[iw].get());
+    msd.UpdateMode      = ORB_PBYP_RATIO;
+    PsiValueType psiNew = msd.ratio_impl_no_precompute(P_list[iw], iat);
+    msd.curRatio        = psiNew / msd.psiCurrent;
+    ratios[iw]          = msd.curRatio;
+  }
+}
+
+void MultiSlaterDeterminantFast::mw_evalGrad(const RefVector<WaveFunctionComponent>& WFC_list,
+                                             const RefVector<ParticleSet>& P_list,
+                                             int iat,
+                                             std::vector<GradType>& grad_now)
+{
+  if (usingBF)
+  {
+    APP_ABORT("Fast MSD+BF: evalGrad not implemented. \n");
+  }
+  const int spin0 = (iat < FirstIndex_dn) ? 0 : 1;
+  const auto det_list(extractDetRefList(WFC_list, spin0));
+  Dets[spin0]->mw_evaluateGrads(det_list, P_list, iat);
+
+  for (int iw = 0; iw < WFC_list.size(); iw++)
+  {
+    auto& msd = static_cast<MultiSlaterDeterminantFast&>(WFC_list[iw].get());
+    GradType grad_iat;
+    PsiValueType psi = msd.evalGrad_impl_no_precompute(P_list[iw], iat, false, grad_iat);
+    grad_now[iw]     = grad_iat * (PsiValueType(1.0) / psi);
+  }
+}
+
+void MultiSlaterDeterminantFast::mw_ratioGrad(const RefVector<WaveFunctionComponent>& WFC_list,
+                                              const RefVector<ParticleSet>& P_list,
+                                              int iat,
+                                              std::vector<PsiValueType>& ratios,
+                                              std::vector<GradType>& grad_new)
+{
+  if (usingBF)
+  {
+    APP_ABORT("Fast MSD+BF: ratioGrad not implemented. \n");
+  }
+  ScopedTimer local_timer(&RatioGradTimer);
+  const int spin0 = (iat < FirstIndex_dn) ? 0 : 1;
+  const auto det_list(extractDetRefList(WFC_list, spin0));
+  Dets[spin0]->mw_evaluateDetsAndGradsForPtclMove(det_list, P_list, iat);
+
+  for (int iw = 0; iw < WFC_list.size(); iw++)
+  {
+    auto& msd      = static_cast<MultiSlaterDeterminantFast&>(WFC_list[iw].get());
+    msd.UpdateMode = ORB_PBYP_PARTIAL;
+    GradType dummy;
+    PsiValueType psiNew = msd.evalGrad_impl_no_precompute(P_list[iw], iat, true, dummy);
+    grad_new[iw] += static_cast<ValueType>(PsiValueType(1.0) / psiNew) * dummy;
+    msd.curRatio = psiNew / msd.psiCurrent;
+    ratios[iw]   = msd.curRatio;
+  }
+}
+
+RefVector<MultiDiracDeterminant> MultiSlaterDeterminantFast::extractDetRefList(
+    const RefVector<WaveFunctionComponent>& WFC_list,
+    int spin)
+{
+  RefVector<MultiDiracDeterminant> det_list;
+  det_list.reserve(WFC_list.size());
+  for (WaveFunctionComponent& wfc : WFC_list)
+    det_list.push_back(*static_cast<MultiSlaterDeterminantFast&>(wfc).Dets[spin]);
+  return det_list;
+}
+
 void MultiSlaterDeterminantFast::acceptMove(ParticleSet& P, int iat, bool safe_to_delay)
 {
   // this should depend on the type of update, ratio / ratioGrad
@@ -106,9 +106,29 @@ public:
   GradType evalGrad(ParticleSet& P, int iat) override;
   PsiValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat) override;
   PsiValueType evalGrad_impl(ParticleSet& P, int iat, bool newpos, GradType& g_at);
+  /// contract the determinant gradients with the CI coefficients, the determinants must be up to date
+  PsiValueType evalGrad_impl_no_precompute(ParticleSet& P, int iat, bool newpos, GradType& g_at);
 
   PsiValueType ratio(ParticleSet& P, int iat) override;
   PsiValueType ratio_impl(ParticleSet& P, int iat);
+  /// contract the determinant values with the CI coefficients, the determinants must be up to date
+  PsiValueType ratio_impl_no_precompute(ParticleSet& P, int iat);
+
+  void mw_evalGrad(const RefVector<WaveFunctionComponent>& WFC_list,
+                   const RefVector<ParticleSet>& P_list,
+                   int iat,
+                   std::vector<GradType>& grad_now) override;
+
+  void mw_ratioGrad(const RefVector<WaveFunctionComponent>& WFC_list,
+                    const RefVector<ParticleSet>& P_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new) override;
+
+  void mw_calcRatio(const RefVector<WaveFunctionComponent>& WFC_list,
+                    const RefVector<ParticleSet>& P_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios) override;
   void evaluateRatiosAlltoOne(ParticleSet& P, std::vector<ValueType>& ratios) override
   {
     // the base class routine may probably work, just never tested.
@@ -183,6 +203,11 @@ public:
   Matrix<RealType> dpsia_dn, dLa_dn;
   Array<GradType, OHMMS_DIM> dGa_up, dGa_dn;
 
+private:
+  /// collect the MultiDiracDeterminant of a spin from a walker batch
+  static RefVector<MultiDiracDeterminant> extractDetRefList(const RefVector<WaveFunctionComponent>& WFC_list,
+                                                            int spin);
+
   // debug, erase later
   //      MultiSlaterDeterminant *msd;
 };
@@ -126,6 +126,14 @@ void SlaterDet::evaluateRatiosAlltoOne(ParticleSet& P, std::vector<ValueType>& r
     Dets[i]->evaluateRatiosAlltoOne(P, ratios);
 }
 
+void SlaterDet::evaluateRatiosAlltoMany(ParticleSet& P,
+                                        const std::vector<PosType>& positions,
+                                        Matrix<ValueType>& ratios)
+{
+  for (int i = 0; i < Dets.size(); ++i)
+    Dets[i]->evaluateRatiosAlltoMany(P, positions, ratios);
+}
+
 SlaterDet::LogValueType SlaterDet::evaluateLog(ParticleSet& P,
                                                ParticleSet::ParticleGradient_t& G,
                                                ParticleSet::ParticleLaplacian_t& L)
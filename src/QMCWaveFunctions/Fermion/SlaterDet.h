@@ -219,6 +219,10 @@ public:
 
   virtual void evaluateRatiosAlltoOne(ParticleSet& P, std::vector<ValueType>& ratios) override;
 
+  virtual void evaluateRatiosAlltoMany(ParticleSet& P,
+                                       const std::vector<PosType>& positions,
+                                       Matrix<ValueType>& ratios) override;
+
   void evaluateDerivatives(ParticleSet& P,
                            const opt_variables_type& active,
                            std::vector<ValueType>& dlogpsi,
@@ -238,6 +242,17 @@ public:
       Dets[i]->evaluateDerivatives(P, active, dlogpsi, dhpsioverpsi);
   }
 
+  void mw_evaluateParameterDerivatives(const RefVector<WaveFunctionComponent>& wfc_list,
+                                       const RefVector<ParticleSet>& P_list,
+                                       const opt_variables_type& optvars,
+                                       RecordArray<ValueType>& dlogpsi,
+                                       RecordArray<ValueType>& dhpsioverpsi) override
+  {
+    for (int i = 0; i < Dets.size(); i++)
+      Dets[i]->mw_evaluateParameterDerivatives(extract_DetRef_list(wfc_list, i), P_list, optvars, dlogpsi,
+                                               dhpsioverpsi);
+  }
+
   void evaluateGradDerivatives(const ParticleSet::ParticleGradient_t& G_in,
                                std::vector<ValueType>& dgradlogpsi) override
   {
@@ -368,8 +368,12 @@ bool SlaterDetBuilder::putDeterminant(xmlNodePtr cur, int spin_group)
   std::string useGPU("no");
 #endif
   int delay_rank(0);
+  RealType recompute_tolerance(0);
+  int residual_rows(4);
   OhmmsAttributeSet sdAttrib;
   sdAttrib.add(delay_rank, "delay_rank");
+  sdAttrib.add(recompute_tolerance, "recompute_tolerance");
+  sdAttrib.add(residual_rows, "residual_rows");
   sdAttrib.add(optimize, "optimize");
   sdAttrib.add(use_batch, "batch");
   sdAttrib.add(useGPU, "gpu");
@@ -439,6 +443,12 @@ bool SlaterDetBuilder::putDeterminant(xmlNodePtr cur, int spin_group)
   else
     app_summary() << "      Using rank-1 Sherman-Morrison Fahy update (SM1)" << std::endl;
 
+  if (recompute_tolerance < 0 || residual_rows < 1)
+    APP_ABORT("SlaterDetBuilder::putDeterminant recompute_tolerance must be non-negative and residual_rows positive!");
+  if (recompute_tolerance > 0)
+    app_summary() << "      Recomputing the inverse when the residual on " << residual_rows << " sampled rows exceeds "
+                  << recompute_tolerance << std::endl;
+
   DiracDeterminantBase* adet = 0;
 
   //TODO: the switch logic should be improved as we refine the input tags.
@@ -491,6 +501,7 @@ bool SlaterDetBuilder::putDeterminant(xmlNodePtr cur, int spin_group)
 #endif
 
   adet->set(firstIndex, lastIndex - firstIndex, delay_rank);
+  adet->setResidualCheck(recompute_tolerance, residual_rows);
 #ifdef QMC_CUDA
   targetPsi.setndelay(delay_rank);
 #endif
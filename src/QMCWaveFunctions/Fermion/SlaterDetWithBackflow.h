@@ -154,6 +154,16 @@ public:
                            std::vector<ValueType>& dlogpsi,
                            std::vector<ValueType>& dhpsioverpsi);
 
+  ///the backflow parameters are not batched, use the walker by walker evaluation
+  void mw_evaluateParameterDerivatives(const RefVector<WaveFunctionComponent>& wfc_list,
+                                       const RefVector<ParticleSet>& P_list,
+                                       const opt_variables_type& optvars,
+                                       RecordArray<ValueType>& dlogpsi,
+                                       RecordArray<ValueType>& dhpsioverpsi) override
+  {
+    WaveFunctionComponent::mw_evaluateParameterDerivatives(wfc_list, P_list, optvars, dlogpsi, dhpsioverpsi);
+  }
+
   void testDerivGL(ParticleSet& P);
 
   //private:
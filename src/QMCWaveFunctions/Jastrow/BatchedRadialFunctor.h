@@ -0,0 +1,110 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+/**@file BatchedRadialFunctor.h
+ * @brief multi-walker evaluation of radial Jastrow functors
+ */
+#ifndef QMCPLUSPLUS_BATCHED_RADIAL_FUNCTOR_H
+#define QMCPLUSPLUS_BATCHED_RADIAL_FUNCTOR_H
+
+#include "QMCWaveFunctions/Jastrow/BsplineFunctor.h"
+
+namespace qmcplusplus
+{
+/** helper class to evaluate a radial functor over the distance rows of a walker batch
+ *
+ * Distance rows and the outputs are stored walker-major with a common stride.
+ * The generic version evaluates the functor row by row. Functors providing
+ * a native multi-walker kernel specialize this class.
+ */
+template<class FT>
+struct BatchedRadialFunctor
+{
+  using T = typename FT::real_type;
+
+  static void mw_evaluateV(const FT& func,
+                           const int num_walkers,
+                           const int iat,
+                           const int iStart,
+                           const int iEnd,
+                           const T* mw_distArray,
+                           const int dist_stride,
+                           T* mw_vals,
+                           T* mw_distArrayCompressed,
+                           int* mw_distIndices)
+  {
+    for (int iw = 0; iw < num_walkers; iw++)
+      mw_vals[iw] += func.evaluateV(iat, iStart, iEnd, mw_distArray + iw * dist_stride, mw_distArrayCompressed);
+  }
+
+  static void mw_evaluateVGL(const FT& func,
+                             const int num_walkers,
+                             const int iat,
+                             const int iStart,
+                             const int iEnd,
+                             const T* mw_distArray,
+                             const int dist_stride,
+                             T* mw_valArray,
+                             T* mw_gradArray,
+                             T* mw_laplArray,
+                             T* mw_distArrayCompressed,
+                             int* mw_distIndices)
+  {
+    for (int iw = 0; iw < num_walkers; iw++)
+    {
+      const int offset = iw * dist_stride;
+      func.evaluateVGL(iat, iStart, iEnd, mw_distArray + offset, mw_valArray + offset, mw_gradArray + offset,
+                       mw_laplArray + offset, mw_distArrayCompressed, mw_distIndices);
+    }
+  }
+};
+
+/** BsplineFunctor evaluates all the pairs of all the walkers in a single sweep
+ */
+template<typename T>
+struct BatchedRadialFunctor<BsplineFunctor<T>>
+{
+  static void mw_evaluateV(const BsplineFunctor<T>& func,
+                           const int num_walkers,
+                           const int iat,
+                           const int iStart,
+                           const int iEnd,
+                           const T* mw_distArray,
+                           const int dist_stride,
+                           T* mw_vals,
+                           T* mw_distArrayCompressed,
+                           int* mw_distIndices)
+  {
+    func.mw_evaluateV(num_walkers, iat, iStart, iEnd, mw_distArray, dist_stride, mw_vals, mw_distArrayCompressed,
+                      mw_distIndices);
+  }
+
+  static void mw_evaluateVGL(const BsplineFunctor<T>& func,
+                             const int num_walkers,
+                             const int iat,
+                             const int iStart,
+                             const int iEnd,
+                             const T* mw_distArray,
+                             const int dist_stride,
+                             T* mw_valArray,
+                             T* mw_gradArray,
+                             T* mw_laplArray,
+                             T* mw_distArrayCompressed,
+                             int* mw_distIndices)
+  {
+    func.mw_evaluateVGL(num_walkers, iat, iStart, iEnd, mw_distArray, dist_stride, mw_valArray, mw_gradArray,
+                        mw_laplArray, mw_distArrayCompressed, mw_distIndices);
+  }
+};
+
+} // namespace qmcplusplus
+#endif
@@ -45,6 +45,9 @@ struct BsplineFunctor : public OptimizableFunctorBase
   // Stores the derivatives w.r.t. SplineCoefs
   // of the u, du/dr, and d2u/dr2
   std::vector<TinyVector<real_type, 3>> SplineDerivs;
+  // Stores the sums of the derivatives w.r.t. SplineCoefs
+  // of u and of the kinetic term, used by evaluateDerivativesSum
+  aligned_vector<real_type> SplineDerivsSum;
   std::vector<real_type> Parameters;
   std::vector<std::string> ParameterNames;
   std::string elementType, pairType;
@@ -100,6 +103,7 @@ struct BsplineFunctor : public OptimizableFunctorBase
     Parameters.resize(n);
     SplineCoefs.resize(numCoefs);
     SplineDerivs.resize(numCoefs);
+    SplineDerivsSum.resize(2 * numCoefs);
   }
 
   void reset()
@@ -153,6 +157,56 @@ struct BsplineFunctor : public OptimizableFunctorBase
               const T* restrict _distArray,
               T* restrict distArrayCompressed) const;
 
+  /** evaluate sum of the pair potentials for [iStart,iEnd) of multiple walkers
+   * @param num_walkers number of walkers
+   * @param iat the reference particle excluded from the sum
+   * @param iStart starting particle index
+   * @param iEnd ending particle index
+   * @param mw_distArray distance rows of all the walkers, walker-major with stride dist_stride
+   * @param dist_stride stride between the distance rows of two walkers
+   * @param mw_vals \f$\sum u(r_j)\f$ of each walker is added to mw_vals[iw]
+   * @param mw_distArrayCompressed temp storage of size num_walkers*(iEnd-iStart)
+   * @param mw_walkerIndices temp storage of size num_walkers*(iEnd-iStart)
+   *
+   * All the pairs within the cutoff_radius from all the walkers are evaluated in a single simd loop.
+   */
+  void mw_evaluateV(const int num_walkers,
+                    const int iat,
+                    const int iStart,
+                    const int iEnd,
+                    const T* restrict mw_distArray,
+                    const int dist_stride,
+                    T* restrict mw_vals,
+                    T* restrict mw_distArrayCompressed,
+                    int* restrict mw_walkerIndices) const;
+
+  /** compute value, first and second derivatives for [iStart,iEnd) of multiple walkers
+   * @param num_walkers number of walkers
+   * @param iat the reference particle excluded from the evaluation
+   * @param iStart starting particle index
+   * @param iEnd ending particle index
+   * @param mw_distArray distance rows of all the walkers, walker-major with stride dist_stride
+   * @param dist_stride stride between the rows of two walkers, shared by all the input and output arrays
+   * @param mw_valArray  u(r_j) for j=[iStart,iEnd) of all the walkers
+   * @param mw_gradArray  du(r_j)/dr /r_j for j=[iStart,iEnd) of all the walkers
+   * @param mw_laplArray  d2u(r_j)/dr2 for j=[iStart,iEnd) of all the walkers
+   * @param mw_distArrayCompressed temp storage of size num_walkers*(iEnd-iStart)
+   * @param mw_distIndices temp storage of size num_walkers*(iEnd-iStart)
+   *
+   * Entries beyond the cutoff_radius are not touched and should be zeroed by the caller.
+   */
+  void mw_evaluateVGL(const int num_walkers,
+                      const int iat,
+                      const int iStart,
+                      const int iEnd,
+                      const T* mw_distArray,
+                      const int dist_stride,
+                      T* restrict mw_valArray,
+                      T* restrict mw_gradArray,
+                      T* restrict mw_laplArray,
+                      T* restrict mw_distArrayCompressed,
+                      int* restrict mw_distIndices) const;
+
   inline real_type evaluate(real_type r)
   {
     if (r >= cutoff_radius)
@@ -337,6 +391,64 @@ struct BsplineFunctor : public OptimizableFunctorBase
     return true;
   }
 
+  /** accumulate the parameter derivatives of a sum of u(r) and of a kinetic term over a list of distances
+   *
+   * Each distance contributes to four spline coefficients. The contributions are computed for a chunk
+   * of distances at a time, summed per coefficient and mapped to the parameters at the end.
+   */
+  void evaluateDerivativesSum(int n,
+                              const real_type* restrict dist,
+                              const real_type* restrict cfac,
+                              real_type* restrict dlog,
+                              real_type* restrict dh) override
+  {
+    const int numCoefs        = NumParams + 4;
+    real_type* restrict c_log = SplineDerivsSum.data();
+    real_type* restrict c_h   = SplineDerivsSum.data() + numCoefs;
+    std::fill(SplineDerivsSum.begin(), SplineDerivsSum.end(), real_type(0));
+
+    constexpr int chunk = 64;
+    int cell[chunk];
+    real_type w_log[4][chunk], w_h[4][chunk];
+    const real_type dr2inv = DeltaRInv * DeltaRInv;
+    for (int k0 = 0; k0 < n; k0 += chunk)
+    {
+      const int m = std::min(chunk, n - k0);
+#pragma omp simd
+      for (int k = 0; k < m; ++k)
+      {
+        const real_type r  = dist[k0 + k] * DeltaRInv;
+        const real_type ip = std::floor(r);
+        const real_type t  = r - ip;
+        const real_type t2 = t * t;
+        const real_type t3 = t2 * t;
+        const real_type c  = cfac[k0 + k];
+        cell[k]            = static_cast<int>(ip);
+        for (int a = 0; a < 4; ++a)
+        {
+          w_log[a][k] = A[4 * a] * t3 + A[4 * a + 1] * t2 + A[4 * a + 2] * t + A[4 * a + 3];
+          w_h[a][k]   = dr2inv * (d2A[4 * a + 2] * t + d2A[4 * a + 3]) +
+              c * DeltaRInv * (dA[4 * a + 1] * t2 + dA[4 * a + 2] * t + dA[4 * a + 3]);
+        }
+      }
+      for (int k = 0; k < m; ++k)
+        for (int a = 0; a < 4; ++a)
+        {
+          c_log[cell[k] + a] += w_log[a][k];
+          c_h[cell[k] + a] += w_h[a][k];
+        }
+    }
+
+    // coefficient i+1 is parameter i, coefficient 0 follows parameter 1 through the cusp condition
+    for (int p = 0; p < NumParams; ++p)
+    {
+      dlog[p] -= c_log[p + 1];
+      dh[p] += c_h[p + 1];
+    }
+    dlog[1] -= c_log[0];
+    dh[1] += c_h[0];
+  }
+
   inline bool evaluateDerivatives(real_type r, std::vector<real_type>& derivs)
   {
     if (r >= cutoff_radius)
@@ -732,5 +844,129 @@ inline void BsplineFunctor<T>::evaluateVGL(const int iat,
                           sCoef3 * (A[12] * tp0 + A[13] * tp1 + A[14] * tp2 + A[15]));
   }
 }
+
+template<typename T>
+inline void BsplineFunctor<T>::mw_evaluateV(const int num_walkers,
+                                            const int iat,
+                                            const int iStart,
+                                            const int iEnd,
+                                            const T* restrict mw_distArray,
+                                            const int dist_stride,
+                                            T* restrict mw_vals,
+                                            T* restrict mw_distArrayCompressed,
+                                            int* restrict mw_walkerIndices) const
+{
+  const int iLimit = iEnd - iStart;
+  int iCount       = 0;
+
+  // gather the pairs within the cutoff from all the walkers
+  for (int iw = 0; iw < num_walkers; iw++)
+  {
+    const real_type* restrict distArray = mw_distArray + iw * dist_stride + iStart;
+#pragma vector always
+    for (int jat = 0; jat < iLimit; jat++)
+    {
+      real_type r = distArray[jat];
+      if (r < cutoff_radius && iStart + jat != iat)
+      {
+        mw_walkerIndices[iCount]       = iw;
+        mw_distArrayCompressed[iCount] = r;
+        iCount++;
+      }
+    }
+  }
+
+  // values overwrite the compressed distances
+#pragma omp simd
+  for (int j = 0; j < iCount; j++)
+  {
+    real_type r = mw_distArrayCompressed[j];
+    r *= DeltaRInv;
+    int i         = (int)r;
+    real_type t   = r - real_type(i);
+    real_type tp0 = t * t * t;
+    real_type tp1 = t * t;
+    real_type tp2 = t;
+
+    real_type d1 = SplineCoefs[i + 0] * (A[0] * tp0 + A[1] * tp1 + A[2] * tp2 + A[3]);
+    real_type d2 = SplineCoefs[i + 1] * (A[4] * tp0 + A[5] * tp1 + A[6] * tp2 + A[7]);
+    real_type d3 = SplineCoefs[i + 2] * (A[8] * tp0 + A[9] * tp1 + A[10] * tp2 + A[11]);
+    real_type d4 = SplineCoefs[i + 3] * (A[12] * tp0 + A[13] * tp1 + A[14] * tp2 + A[15]);
+    mw_distArrayCompressed[j] = d1 + d2 + d3 + d4;
+  }
+
+  for (int j = 0; j < iCount; j++)
+    mw_vals[mw_walkerIndices[j]] += mw_distArrayCompressed[j];
+}
+
+template<typename T>
+inline void BsplineFunctor<T>::mw_evaluateVGL(const int num_walkers,
+                                              const int iat,
+                                              const int iStart,
+                                              const int iEnd,
+                                              const T* mw_distArray,
+                                              const int dist_stride,
+                                              T* restrict mw_valArray,
+                                              T* restrict mw_gradArray,
+                                              T* restrict mw_laplArray,
+                                              T* restrict mw_distArrayCompressed,
+                                              int* restrict mw_distIndices) const
+{
+  real_type dSquareDeltaRinv = DeltaRInv * DeltaRInv;
+  constexpr real_type cOne(1);
+
+  const int iLimit = iEnd - iStart;
+  int iCount       = 0;
+
+  // gather the pairs within the cutoff from all the walkers, indices are in the walker-major layout
+  for (int iw = 0; iw < num_walkers; iw++)
+  {
+    const int offset           = iw * dist_stride + iStart;
+    const real_type* distArray = mw_distArray + offset;
+#pragma vector always
+    for (int jat = 0; jat < iLimit; jat++)
+    {
+      real_type r = distArray[jat];
+      if (r < cutoff_radius && iStart + jat != iat)
+      {
+        mw_distIndices[iCount]         = offset + jat;
+        mw_distArrayCompressed[iCount] = r;
+        iCount++;
+      }
+    }
+  }
+
+#pragma omp simd
+  for (int j = 0; j < iCount; j++)
+  {
+    real_type r    = mw_distArrayCompressed[j];
+    int iScatter   = mw_distIndices[j];
+    real_type rinv = cOne / r;
+    r *= DeltaRInv;
+    int iGather   = (int)r;
+    real_type t   = r - real_type(iGather);
+    real_type tp0 = t * t * t;
+    real_type tp1 = t * t;
+    real_type tp2 = t;
+
+    real_type sCoef0 = SplineCoefs[iGather + 0];
+    real_type sCoef1 = SplineCoefs[iGather + 1];
+    real_type sCoef2 = SplineCoefs[iGather + 2];
+    real_type sCoef3 = SplineCoefs[iGather + 3];
+
+    mw_laplArray[iScatter] = dSquareDeltaRinv *
+        (sCoef0 * (d2A[2] * tp2 + d2A[3]) + sCoef1 * (d2A[6] * tp2 + d2A[7]) + sCoef2 * (d2A[10] * tp2 + d2A[11]) +
+         sCoef3 * (d2A[14] * tp2 + d2A[15]));
+
+    mw_gradArray[iScatter] = DeltaRInv * rinv *
+        (sCoef0 * (dA[1] * tp1 + dA[2] * tp2 + dA[3]) + sCoef1 * (dA[5] * tp1 + dA[6] * tp2 + dA[7]) +
+         sCoef2 * (dA[9] * tp1 + dA[10] * tp2 + dA[11]) + sCoef3 * (dA[13] * tp1 + dA[14] * tp2 + dA[15]));
+
+    mw_valArray[iScatter] = (sCoef0 * (A[0] * tp0 + A[1] * tp1 + A[2] * tp2 + A[3]) +
+                             sCoef1 * (A[4] * tp0 + A[5] * tp1 + A[6] * tp2 + A[7]) +
+                             sCoef2 * (A[8] * tp0 + A[9] * tp1 + A[10] * tp2 + A[11]) +
+                             sCoef3 * (A[12] * tp0 + A[13] * tp1 + A[14] * tp2 + A[15]));
+  }
+}
 } // namespace qmcplusplus
 #endif
@@ -19,6 +19,7 @@
 #include "Particle/DistanceTableData.h"
 #include "ParticleBase/ParticleAttribOps.h"
 #include "Utilities/IteratorUtility.h"
+#include "CPU/SIMD/aligned_allocator.hpp"
 
 
 namespace qmcplusplus
@@ -47,6 +48,14 @@ class DiffOneBodyJastrowOrbital : public DiffWaveFunctionComponent
   Vector<RealType> dLogPsi;
   std::vector<GradVectorType*> gradLogPsi;
   std::vector<ValueVectorType*> lapLogPsi;
+  ///scratch of mw_evaluateDerivatives: neighbors of a center
+  aligned_vector<int> nb_id_;
+  aligned_vector<RealType> nb_dist_;
+  std::vector<PosType> nb_displ_;
+  ///scratch of mw_evaluateDerivatives: distances and factors of du/dr in the kinetic term
+  aligned_vector<typename FT::real_type> pair_dist_, pair_cfac_;
+  ///scratch of mw_evaluateDerivatives: sums over the pairs
+  std::vector<typename FT::real_type> dlog_sum_, dh_sum_;
 
 public:
   ///constructor
@@ -156,6 +165,89 @@ public:
     }
   }
 
+#if !defined(QMC_COMPLEX)
+  /** evaluate derivatives for a batch of walkers
+   *
+   * The gradients and Laplacians of the parameter derivatives are only needed through
+   * \f$-\frac{1}{2}\nabla^2 - \nabla\log\Psi\cdot\nabla\f$, which reduces for each electron-center pair to
+   * \f$\frac{1}{2}\left[\partial_p u''(r) + \partial_p u'(r)\,(D-1+2\mathbf{G}_j\cdot\mathbf{r}_{Ij})/r\right]\f$.
+   * The neighbors of each center are summed by the functor, so no per-particle arrays are touched.
+   */
+  void mw_evaluateDerivatives(const RefVector<DiffWaveFunctionComponent>& dpsi_list,
+                              const RefVector<ParticleSet>& P_list,
+                              const opt_variables_type& active,
+                              RecordArray<ValueType>& dlogpsi,
+                              RecordArray<ValueType>& dhpsioverpsi) override
+  {
+    bool recalculate(false);
+    std::vector<bool> rcsingles(myVars.size(), false);
+    for (int k = 0; k < myVars.size(); ++k)
+    {
+      int kk = myVars.where(k);
+      if (kk < 0)
+        continue;
+      if (active.recompute(kk))
+        recalculate = true;
+      rcsingles[k] = true;
+    }
+    if (!recalculate)
+      return;
+
+    using real_type = typename FT::real_type;
+    constexpr RealType cone(1);
+    constexpr RealType lapfac(OHMMS_DIM - cone);
+    nb_id_.resize(NumPtcls);
+    nb_dist_.resize(NumPtcls);
+    nb_displ_.resize(NumPtcls);
+    pair_dist_.resize(NumPtcls);
+    pair_cfac_.resize(NumPtcls);
+    dlog_sum_.resize(NumVars);
+    dh_sum_.resize(NumVars);
+    for (int iw = 0; iw < dpsi_list.size(); iw++)
+    {
+      auto& dj             = static_cast<DiffOneBodyJastrowOrbital<FT>&>(dpsi_list[iw].get());
+      const ParticleSet& P = P_list[iw];
+      const auto& d_table  = P.getDistTable(dj.myTableIndex);
+      std::fill(dlog_sum_.begin(), dlog_sum_.end(), real_type(0));
+      std::fill(dh_sum_.begin(), dh_sum_.end(), real_type(0));
+      for (int i = 0; i < dj.Fs.size(); ++i)
+      {
+        FT* func = dj.Fs[i];
+        if (func == nullptr)
+          continue;
+        const int first(dj.OffSet[i].first);
+        const int last(dj.OffSet[i].second);
+        bool recalcFunc(false);
+        for (int rcs = first; rcs < last; rcs++)
+          if (rcsingles[rcs])
+            recalcFunc = true;
+        if (!recalcFunc)
+          continue;
+        const size_t nn =
+            d_table.get_neighbors(i, func->cutoff_radius, nb_id_.data(), nb_dist_.data(), nb_displ_.data());
+        for (size_t nj = 0; nj < nn; ++nj)
+        {
+          RealType gdr(0);
+          for (int idim = 0; idim < OHMMS_DIM; ++idim)
+            gdr += P.G[nb_id_[nj]][idim] * nb_displ_[nj][idim];
+          pair_dist_[nj] = nb_dist_[nj];
+          pair_cfac_[nj] = (lapfac + 2 * gdr) / nb_dist_[nj];
+        }
+        func->evaluateDerivativesSum(nn, pair_dist_.data(), pair_cfac_.data(), dlog_sum_.data() + first,
+                                     dh_sum_.data() + first);
+      }
+      for (int k = 0; k < myVars.size(); ++k)
+      {
+        int kk = myVars.where(k);
+        if (kk < 0)
+          continue;
+        dlogpsi.setValue(kk, iw, dlogpsi.getValue(kk, iw) + ValueType(dlog_sum_[k]));
+        dhpsioverpsi.setValue(kk, iw, dhpsioverpsi.getValue(kk, iw) + ValueType(0.5 * dh_sum_[k]));
+      }
+    }
+  }
+#endif
+
   void evaluateDerivativesWF(ParticleSet& P, const opt_variables_type& active, std::vector<ValueType>& dlogpsi)
   {
     bool recalculate(false);
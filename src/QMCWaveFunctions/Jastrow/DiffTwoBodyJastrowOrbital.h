@@ -21,6 +21,7 @@
 #include "Particle/DistanceTableData.h"
 #include "ParticleBase/ParticleAttribOps.h"
 #include "Utilities/IteratorUtility.h"
+#include "CPU/SIMD/aligned_allocator.hpp"
 
 namespace qmcplusplus
 {
@@ -48,6 +49,12 @@ class DiffTwoBodyJastrowOrbital : public DiffWaveFunctionComponent
   std::vector<GradVectorType*> gradLogPsi;
   std::vector<ValueVectorType*> lapLogPsi;
   std::map<std::string, FT*> J2Unique;
+  ///scratch of mw_evaluateDerivatives: distances of the pairs within the cutoff
+  aligned_vector<typename FT::real_type> pair_dist_;
+  ///scratch of mw_evaluateDerivatives: factors of du/dr in the kinetic term of the pairs
+  aligned_vector<typename FT::real_type> pair_cfac_;
+  ///scratch of mw_evaluateDerivatives: sums over the pairs
+  std::vector<typename FT::real_type> dlog_sum_, dh_sum_;
 
 public:
   ///constructor
@@ -189,6 +196,98 @@ public:
     }
   }
 
+#if !defined(QMC_COMPLEX)
+  /** evaluate derivatives for a batch of walkers
+   *
+   * The gradients and Laplacians of the parameter derivatives are only needed through
+   * \f$-\frac{1}{2}\nabla^2 - \nabla\log\Psi\cdot\nabla\f$, which reduces for each pair to
+   * \f$\partial_p u''(r) + \partial_p u'(r)\,(D-1-(\mathbf{G}_i-\mathbf{G}_j)\cdot\mathbf{r}_{ij})/r\f$.
+   * The pairs of each pair type are collected into contiguous arrays and summed by the functor,
+   * so no per-particle arrays are touched.
+   */
+  void mw_evaluateDerivatives(const RefVector<DiffWaveFunctionComponent>& dpsi_list,
+                              const RefVector<ParticleSet>& P_list,
+                              const opt_variables_type& active,
+                              RecordArray<ValueType>& dlogpsi,
+                              RecordArray<ValueType>& dhpsioverpsi) override
+  {
+    if (myVars.size() == 0)
+      return;
+    bool recalculate(false);
+    std::vector<bool> rcsingles(myVars.size(), false);
+    for (int k = 0; k < myVars.size(); ++k)
+    {
+      int kk = myVars.where(k);
+      if (kk < 0)
+        continue;
+      if (active.recompute(kk))
+        recalculate = true;
+      rcsingles[k] = true;
+    }
+    if (!recalculate)
+      return;
+
+    std::vector<bool> RecalcSwitch(F.size(), false);
+    for (int i = 0; i < F.size(); ++i)
+      for (int rcs = OffSet[i].first; rcs >= 0 && rcs < OffSet[i].second; rcs++)
+        if (rcsingles[rcs])
+          RecalcSwitch[i] = true;
+
+    using real_type = typename FT::real_type;
+    constexpr RealType cone(1);
+    constexpr RealType lapfac(OHMMS_DIM - cone);
+    pair_dist_.resize(NumPtcls * (NumPtcls - 1) / 2);
+    pair_cfac_.resize(NumPtcls * (NumPtcls - 1) / 2);
+    dlog_sum_.resize(NumVars);
+    dh_sum_.resize(NumVars);
+    for (int iw = 0; iw < dpsi_list.size(); iw++)
+    {
+      auto& dj             = static_cast<DiffTwoBodyJastrowOrbital<FT>&>(dpsi_list[iw].get());
+      const ParticleSet& P = P_list[iw];
+      const auto& d_table  = P.getDistTable(dj.my_table_ID_);
+      std::fill(dlog_sum_.begin(), dlog_sum_.end(), real_type(0));
+      std::fill(dh_sum_.begin(), dh_sum_.end(), real_type(0));
+      for (int ig = 0; ig < NumGroups; ++ig)
+        for (int jg = 0; jg <= ig; ++jg)
+        {
+          const int ptype = ig * NumGroups + jg;
+          if (!RecalcSwitch[ptype])
+            continue;
+          FT& func            = *dj.F[ptype];
+          const RealType rcut = func.cutoff_radius;
+          int npairs          = 0;
+          for (int i = P.first(ig); i < P.last(ig); ++i)
+          {
+            const auto& dist  = d_table.getDistRow(i);
+            const auto& displ = d_table.getDisplRow(i);
+            const int jlast   = ig == jg ? i : P.last(jg);
+            for (int j = P.first(jg); j < jlast; ++j)
+              if (dist[j] < rcut)
+              {
+                RealType gdr(0);
+                for (int idim = 0; idim < OHMMS_DIM; ++idim)
+                  gdr += (P.G[i][idim] - P.G[j][idim]) * displ.data(idim)[j];
+                pair_dist_[npairs] = dist[j];
+                pair_cfac_[npairs] = (lapfac - gdr) / dist[j];
+                npairs++;
+              }
+          }
+          const int first = dj.OffSet[ptype].first;
+          func.evaluateDerivativesSum(npairs, pair_dist_.data(), pair_cfac_.data(), dlog_sum_.data() + first,
+                                      dh_sum_.data() + first);
+        }
+      for (int k = 0; k < myVars.size(); ++k)
+      {
+        int kk = myVars.where(k);
+        if (kk < 0)
+          continue;
+        dlogpsi.setValue(kk, iw, dlogpsi.getValue(kk, iw) + ValueType(dlog_sum_[k]));
+        dhpsioverpsi.setValue(kk, iw, dhpsioverpsi.getValue(kk, iw) + ValueType(dh_sum_[k]));
+      }
+    }
+  }
+#endif
+
   void evaluateDerivativesWF(ParticleSet& P, const opt_variables_type& active, std::vector<ValueType>& dlogpsi)
   {
     if (myVars.size() == 0)
@@ -14,6 +14,7 @@
 #include "Configuration.h"
 #include "QMCWaveFunctions/WaveFunctionComponent.h"
 #include "QMCWaveFunctions/Jastrow/DiffOneBodyJastrowOrbital.h"
+#include "QMCWaveFunctions/Jastrow/BatchedRadialFunctor.h"
 #include "Utilities/qmc_common.h"
 #include "CPU/SIMD/aligned_allocator.hpp"
 #include "CPU/SIMD/algorithm.hpp"
@@ -61,6 +62,13 @@ struct J1OrbitalSoA : public WaveFunctionComponent
   Vector<valT> Lap;
   ///Container for \f$F[ig*NumGroups+jg]\f$
   std::vector<FT*> F;
+  ///number of ions + padded
+  size_t Nions_padded;
+  /**@{ multi-walker scratch used by the crowd leader, walker-major with stride Nions_padded */
+  aligned_vector<valT> mw_dist, mw_U, mw_dU, mw_d2U;
+  aligned_vector<valT> mw_vals, mw_DistCompressed;
+  aligned_vector<int> mw_DistIndice;
+  /**@} */
 
   J1OrbitalSoA(const std::string& obj_name, const ParticleSet& ions, ParticleSet& els)
       : WaveFunctionComponent("J1OrbitalSoA", obj_name), myTableID(els.addTable(ions)), Ions(ions)
@@ -100,6 +108,7 @@ struct J1OrbitalSoA : public WaveFunctionComponent
     d3U.resize(Nions);
     DistCompressed.resize(Nions);
     DistIndice.resize(Nions);
+    Nions_padded = getAlignedSize<valT>(Nions);
   }
 
   void addFunc(int source_type, FT* afunc, int target_type = -1)
@@ -162,6 +171,51 @@ struct J1OrbitalSoA : public WaveFunctionComponent
     return std::exp(static_cast<PsiValueType>(Vat[iat] - curAt));
   }
 
+  void mw_calcRatio(const RefVector<WaveFunctionComponent>& WFC_list,
+                    const RefVector<ParticleSet>& P_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios)
+  {
+    const int nw = WFC_list.size();
+    resizeMultiWalkerScratch(nw);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      const auto& dist = P_list[iw].get().getDistTable(myTableID).getTempDists();
+      std::copy_n(dist.data(), Nions, mw_dist.data() + iw * Nions_padded);
+    }
+
+    std::fill_n(mw_vals.data(), nw, valT(0));
+    if (NumGroups > 0)
+    {
+      for (int jg = 0; jg < NumGroups; ++jg)
+        if (F[jg] != nullptr)
+          BatchedRadialFunctor<FT>::mw_evaluateV(*F[jg], nw, -1, Ions.first(jg), Ions.last(jg), mw_dist.data(),
+                                                 Nions_padded, mw_vals.data(), mw_DistCompressed.data(),
+                                                 mw_DistIndice.data());
+    }
+    else
+    {
+      for (int iw = 0; iw < nw; iw++)
+      {
+        const valT* restrict dist = mw_dist.data() + iw * Nions_padded;
+        for (int c = 0; c < Nions; ++c)
+        {
+          int gid = Ions.GroupID[c];
+          if (F[gid] != nullptr)
+            mw_vals[iw] += F[gid]->evaluate(dist[c]);
+        }
+      }
+    }
+
+    for (int iw = 0; iw < nw; iw++)
+    {
+      auto& j1      = static_cast<J1OrbitalSoA<FT>&>(WFC_list[iw].get());
+      j1.UpdateMode = ORB_PBYP_RATIO;
+      j1.curAt      = mw_vals[iw];
+      ratios[iw]    = std::exp(static_cast<PsiValueType>(j1.Vat[iat] - j1.curAt));
+    }
+  }
+
   inline void evaluateRatios(const VirtualParticleSet& VP, std::vector<ValueType>& ratios)
   {
     for (int k = 0; k < ratios.size(); ++k)
@@ -290,6 +344,62 @@ struct J1OrbitalSoA : public WaveFunctionComponent
     }
   }
 
+  /** resize multi-walker scratch spaces for a batch of nw walkers */
+  inline void resizeMultiWalkerScratch(int nw)
+  {
+    const size_t total_size = nw * Nions_padded;
+    if (mw_dist.size() < total_size)
+    {
+      mw_dist.resize(total_size);
+      mw_U.resize(total_size);
+      mw_dU.resize(total_size);
+      mw_d2U.resize(total_size);
+      mw_DistCompressed.resize(total_size);
+      mw_DistIndice.resize(total_size);
+    }
+    if (mw_vals.size() < nw)
+      mw_vals.resize(nw);
+  }
+
+  /** compute U, dU and d2U for the first nw rows of mw_dist in a single batch
+   * results are stored in mw_U, mw_dU and mw_d2U
+   */
+  inline void mw_computeU3(int nw)
+  {
+    constexpr valT czero(0);
+    std::fill_n(mw_U.data(), nw * Nions_padded, czero);
+    std::fill_n(mw_dU.data(), nw * Nions_padded, czero);
+    std::fill_n(mw_d2U.data(), nw * Nions_padded, czero);
+
+    if (NumGroups > 0)
+    { //ions are grouped
+      for (int jg = 0; jg < NumGroups; ++jg)
+      {
+        if (F[jg] == nullptr)
+          continue;
+        BatchedRadialFunctor<FT>::mw_evaluateVGL(*F[jg], nw, -1, Ions.first(jg), Ions.last(jg), mw_dist.data(),
+                                                 Nions_padded, mw_U.data(), mw_dU.data(), mw_d2U.data(),
+                                                 mw_DistCompressed.data(), mw_DistIndice.data());
+      }
+    }
+    else
+    {
+      for (int iw = 0; iw < nw; iw++)
+      {
+        const size_t offset = iw * Nions_padded;
+        for (int c = 0; c < Nions; ++c)
+        {
+          int gid = Ions.GroupID[c];
+          if (F[gid] != nullptr)
+          {
+            mw_U[offset + c] = F[gid]->evaluate(mw_dist[offset + c], mw_dU[offset + c], mw_d2U[offset + c]);
+            mw_dU[offset + c] /= mw_dist[offset + c];
+          }
+        }
+      }
+    }
+  }
+
   /** compute the gradient during particle-by-particle update
    * @param P quantum particleset
    * @param iat particle index
@@ -313,6 +423,35 @@ struct J1OrbitalSoA : public WaveFunctionComponent
     return std::exp(static_cast<PsiValueType>(Vat[iat] - curAt));
   }
 
+  void mw_ratioGrad(const RefVector<WaveFunctionComponent>& WFC_list,
+                    const RefVector<ParticleSet>& P_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new)
+  {
+    const int nw = WFC_list.size();
+    resizeMultiWalkerScratch(nw);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      const auto& dist = P_list[iw].get().getDistTable(myTableID).getTempDists();
+      std::copy_n(dist.data(), Nions, mw_dist.data() + iw * Nions_padded);
+    }
+
+    mw_computeU3(nw);
+
+    for (int iw = 0; iw < nw; iw++)
+    {
+      auto& j1            = static_cast<J1OrbitalSoA<FT>&>(WFC_list[iw].get());
+      const size_t offset = iw * Nions_padded;
+      j1.UpdateMode       = ORB_PBYP_PARTIAL;
+      j1.curLap           = accumulateGL(mw_dU.data() + offset, mw_d2U.data() + offset,
+                               P_list[iw].get().getDistTable(myTableID).getTempDispls(), j1.curGrad);
+      j1.curAt            = simd::accumulate_n(mw_U.data() + offset, Nions, valT());
+      grad_new[iw] += j1.curGrad;
+      ratios[iw] = std::exp(static_cast<PsiValueType>(j1.Vat[iat] - j1.curAt));
+    }
+  }
+
   /** Rejected move. Nothing to do */
   inline void restore(int iat) {}
 
@@ -332,6 +471,51 @@ struct J1OrbitalSoA : public WaveFunctionComponent
   }
 
 
+  void mw_accept_rejectMove(const RefVector<WaveFunctionComponent>& WFC_list,
+                            const RefVector<ParticleSet>& P_list,
+                            int iat,
+                            const std::vector<bool>& isAccepted,
+                            bool safe_to_delay = false)
+  {
+    const int nw = WFC_list.size();
+    resizeMultiWalkerScratch(nw);
+
+    // the accepted walkers which only computed ratios need the new gradients and laplacians
+    std::vector<int> ratio_only_list;
+    for (int iw = 0; iw < nw; iw++)
+      if (isAccepted[iw] && WFC_list[iw].get().UpdateMode == ORB_PBYP_RATIO)
+        ratio_only_list.push_back(iw);
+
+    const int n_ratio_only = ratio_only_list.size();
+    if (n_ratio_only > 0)
+    {
+      for (int i = 0; i < n_ratio_only; i++)
+      {
+        const auto& dist = P_list[ratio_only_list[i]].get().getDistTable(myTableID).getTempDists();
+        std::copy_n(dist.data(), Nions, mw_dist.data() + i * Nions_padded);
+      }
+      mw_computeU3(n_ratio_only);
+      for (int i = 0; i < n_ratio_only; i++)
+      {
+        const int iw        = ratio_only_list[i];
+        auto& j1            = static_cast<J1OrbitalSoA<FT>&>(WFC_list[iw].get());
+        const size_t offset = i * Nions_padded;
+        j1.curLap           = accumulateGL(mw_dU.data() + offset, mw_d2U.data() + offset,
+                                 P_list[iw].get().getDistTable(myTableID).getTempDispls(), j1.curGrad);
+      }
+    }
+
+    for (int iw = 0; iw < nw; iw++)
+      if (isAccepted[iw])
+      {
+        auto& j1 = static_cast<J1OrbitalSoA<FT>&>(WFC_list[iw].get());
+        j1.LogValue += j1.Vat[iat] - j1.curAt;
+        j1.Vat[iat]  = j1.curAt;
+        j1.Grad[iat] = j1.curGrad;
+        j1.Lap[iat]  = j1.curLap;
+      }
+  }
+
   inline void registerData(ParticleSet& P, WFBufferType& buf)
   {
     if (Bytes_in_WFBuffer == 0)
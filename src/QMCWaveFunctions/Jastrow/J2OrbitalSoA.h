@@ -21,6 +21,7 @@
 #include "QMCWaveFunctions/WaveFunctionComponent.h"
 #include "QMCWaveFunctions/Jastrow/DiffTwoBodyJastrowOrbital.h"
 #endif
+#include "QMCWaveFunctions/Jastrow/BatchedRadialFunctor.h"
 #include "Particle/DistanceTableData.h"
 #include "LongRange/StructFact.h"
 #include "CPU/SIMD/aligned_allocator.hpp"
@@ -153,6 +154,11 @@ protected:
   std::map<std::string, FT*> J2Unique;
   /// e-e table ID
   const int my_table_ID_;
+  /**@{ multi-walker scratch used by the crowd leader, walker-major with stride N_padded */
+  aligned_vector<valT> mw_dist_, mw_u_, mw_du_, mw_d2u_;
+  aligned_vector<valT> mw_vals_, mw_dist_compressed_;
+  aligned_vector<int> mw_dist_indices_;
+  /**@} */
   // helper for compute J2 Chiesa KE correction
   J2KECorrection<RealType, FT> j2_ke_corr_helper;
 
@@ -243,6 +249,10 @@ public:
   void recompute(ParticleSet& P);
 
   PsiValueType ratio(ParticleSet& P, int iat);
+  void mw_calcRatio(const RefVector<WaveFunctionComponent>& WFC_list,
+                    const RefVector<ParticleSet>& P_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios);
   void evaluateRatios(const VirtualParticleSet& VP, std::vector<ValueType>& ratios)
   {
     for (int k = 0; k < ratios.size(); ++k)
@@ -254,8 +264,18 @@ public:
   GradType evalGrad(ParticleSet& P, int iat);
 
   PsiValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat);
+  void mw_ratioGrad(const RefVector<WaveFunctionComponent>& WFC_list,
+                    const RefVector<ParticleSet>& P_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new);
 
   void acceptMove(ParticleSet& P, int iat, bool safe_to_delay = false);
+  void mw_accept_rejectMove(const RefVector<WaveFunctionComponent>& WFC_list,
+                            const RefVector<ParticleSet>& P_list,
+                            int iat,
+                            const std::vector<bool>& isAccepted,
+                            bool safe_to_delay = false);
   inline void restore(int iat) {}
 
   /** compute G and L after the sweep
@@ -322,6 +342,22 @@ public:
                         RealType* restrict d2u,
                         bool triangle = false);
 
+  /** update Uat, dUat and d2Uat with cur_u, cur_du, cur_d2u and the old values of the iat-th particle
+   */
+  inline void acceptU3(ParticleSet& P,
+                       int iat,
+                       const valT* restrict old_u_pt,
+                       const valT* restrict old_du_pt,
+                       const valT* restrict old_d2u_pt);
+
+  /** resize multi-walker scratch spaces for a batch of nw walkers */
+  inline void resizeMultiWalkerScratch(int nw);
+
+  /** compute u, du, d2u of the iat-th particle for the first nw rows of mw_dist_ in a single batch
+   * results are stored in mw_u_, mw_du_ and mw_d2u_
+   */
+  inline void mw_computeU3(const ParticleSet& P, int iat, int nw);
+
   /** compute gradient
    */
   inline posT accumulateG(const valT* restrict du, const DisplRow& displ) const
@@ -554,7 +590,17 @@ void J2OrbitalSoA<FT>::acceptMove(ParticleSet& P, int iat, bool safe_to_delay)
     const auto& dist = d_table.getTempDists();
     computeU3(P, iat, dist, cur_u.data(), cur_du.data(), cur_d2u.data());
   }
+  acceptU3(P, iat, old_u.data(), old_du.data(), old_d2u.data());
+}
 
+template<typename FT>
+inline void J2OrbitalSoA<FT>::acceptU3(ParticleSet& P,
+                                       int iat,
+                                       const valT* restrict old_u_pt,
+                                       const valT* restrict old_du_pt,
+                                       const valT* restrict old_d2u_pt)
+{
+  const auto& d_table = P.getDistTable(my_table_ID_);
   valT cur_d2Uat(0);
   const auto& new_dr    = d_table.getTempDispls();
   const auto& old_dr    = d_table.getOldDispls();
@@ -562,9 +608,9 @@ void J2OrbitalSoA<FT>::acceptMove(ParticleSet& P, int iat, bool safe_to_delay)
 #pragma omp simd reduction(+ : cur_d2Uat)
   for (int jat = 0; jat < N; jat++)
   {
-    const valT du   = cur_u[jat] - old_u[jat];
+    const valT du   = cur_u[jat] - old_u_pt[jat];
     const valT newl = cur_d2u[jat] + lapfac * cur_du[jat];
-    const valT dl   = old_d2u[jat] + lapfac * old_du[jat] - newl;
+    const valT dl   = old_d2u_pt[jat] + lapfac * old_du_pt[jat] - newl;
     Uat[jat] += du;
     d2Uat[jat] += dl;
     cur_d2Uat -= newl;
@@ -575,10 +621,9 @@ void J2OrbitalSoA<FT>::acceptMove(ParticleSet& P, int iat, bool safe_to_delay)
     const valT* restrict new_dX    = new_dr.data(idim);
     const valT* restrict old_dX    = old_dr.data(idim);
     const valT* restrict cur_du_pt = cur_du.data();
-    const valT* restrict old_du_pt = old_du.data();
     valT* restrict save_g          = dUat.data(idim);
     valT cur_g                     = cur_dUat[idim];
-#pragma omp simd reduction(+ : cur_g) aligned(old_dX, new_dX, save_g, cur_du_pt, old_du_pt)
+#pragma omp simd reduction(+ : cur_g) aligned(old_dX, new_dX, save_g, cur_du_pt)
     for (int jat = 0; jat < N; jat++)
     {
       const valT newg = cur_du_pt[jat] * new_dX[jat];
@@ -594,6 +639,161 @@ void J2OrbitalSoA<FT>::acceptMove(ParticleSet& P, int iat, bool safe_to_delay)
   d2Uat[iat] = cur_d2Uat;
 }
 
+template<typename FT>
+inline void J2OrbitalSoA<FT>::resizeMultiWalkerScratch(int nw)
+{
+  const size_t total_size = nw * N_padded;
+  if (mw_dist_.size() < total_size)
+  {
+    mw_dist_.resize(total_size);
+    mw_u_.resize(total_size);
+    mw_du_.resize(total_size);
+    mw_d2u_.resize(total_size);
+    mw_dist_compressed_.resize(total_size);
+    mw_dist_indices_.resize(total_size);
+  }
+  if (mw_vals_.size() < nw)
+    mw_vals_.resize(nw);
+}
+
+template<typename FT>
+inline void J2OrbitalSoA<FT>::mw_computeU3(const ParticleSet& P, int iat, int nw)
+{
+  constexpr valT czero(0);
+  std::fill_n(mw_u_.data(), nw * N_padded, czero);
+  std::fill_n(mw_du_.data(), nw * N_padded, czero);
+  std::fill_n(mw_d2u_.data(), nw * N_padded, czero);
+
+  const int igt = P.GroupID[iat] * NumGroups;
+  for (int jg = 0; jg < NumGroups; ++jg)
+    BatchedRadialFunctor<FT>::mw_evaluateVGL(*F[igt + jg], nw, iat, P.first(jg), P.last(jg), mw_dist_.data(),
+                                             N_padded, mw_u_.data(), mw_du_.data(), mw_d2u_.data(),
+                                             mw_dist_compressed_.data(), mw_dist_indices_.data());
+}
+
+template<typename FT>
+void J2OrbitalSoA<FT>::mw_calcRatio(const RefVector<WaveFunctionComponent>& WFC_list,
+                                    const RefVector<ParticleSet>& P_list,
+                                    int iat,
+                                    std::vector<PsiValueType>& ratios)
+{
+  const int nw = WFC_list.size();
+  resizeMultiWalkerScratch(nw);
+  for (int iw = 0; iw < nw; iw++)
+  {
+    const auto& dist = P_list[iw].get().getDistTable(my_table_ID_).getTempDists();
+    std::copy_n(dist.data(), N, mw_dist_.data() + iw * N_padded);
+  }
+
+  std::fill_n(mw_vals_.data(), nw, valT(0));
+  const ParticleSet& P(P_list[0]);
+  const int igt = P.GroupID[iat] * NumGroups;
+  for (int jg = 0; jg < NumGroups; ++jg)
+    BatchedRadialFunctor<FT>::mw_evaluateV(*F[igt + jg], nw, iat, P.first(jg), P.last(jg), mw_dist_.data(), N_padded,
+                                           mw_vals_.data(), mw_dist_compressed_.data(), mw_dist_indices_.data());
+
+  for (int iw = 0; iw < nw; iw++)
+  {
+    auto& j2      = static_cast<J2OrbitalSoA<FT>&>(WFC_list[iw].get());
+    j2.UpdateMode = ORB_PBYP_RATIO;
+    j2.cur_Uat    = mw_vals_[iw];
+    ratios[iw]    = std::exp(static_cast<PsiValueType>(j2.Uat[iat] - j2.cur_Uat));
+  }
+}
+
+template<typename FT>
+void J2OrbitalSoA<FT>::mw_ratioGrad(const RefVector<WaveFunctionComponent>& WFC_list,
+                                    const RefVector<ParticleSet>& P_list,
+                                    int iat,
+                                    std::vector<PsiValueType>& ratios,
+                                    std::vector<GradType>& grad_new)
+{
+  const int nw = WFC_list.size();
+  resizeMultiWalkerScratch(nw);
+  for (int iw = 0; iw < nw; iw++)
+  {
+    const auto& dist = P_list[iw].get().getDistTable(my_table_ID_).getTempDists();
+    std::copy_n(dist.data(), N, mw_dist_.data() + iw * N_padded);
+  }
+
+  mw_computeU3(P_list[0], iat, nw);
+
+  for (int iw = 0; iw < nw; iw++)
+  {
+    auto& j2      = static_cast<J2OrbitalSoA<FT>&>(WFC_list[iw].get());
+    j2.UpdateMode = ORB_PBYP_PARTIAL;
+    // keep the new values in the walker for the acceptance
+    std::copy_n(mw_u_.data() + iw * N_padded, N, j2.cur_u.data());
+    std::copy_n(mw_du_.data() + iw * N_padded, N, j2.cur_du.data());
+    std::copy_n(mw_d2u_.data() + iw * N_padded, N, j2.cur_d2u.data());
+    j2.cur_Uat = simd::accumulate_n(j2.cur_u.data(), N, valT());
+    j2.DiffVal = j2.Uat[iat] - j2.cur_Uat;
+    grad_new[iw] += j2.accumulateG(j2.cur_du.data(), P_list[iw].get().getDistTable(my_table_ID_).getTempDispls());
+    ratios[iw] = std::exp(static_cast<PsiValueType>(j2.DiffVal));
+  }
+}
+
+template<typename FT>
+void J2OrbitalSoA<FT>::mw_accept_rejectMove(const RefVector<WaveFunctionComponent>& WFC_list,
+                                            const RefVector<ParticleSet>& P_list,
+                                            int iat,
+                                            const std::vector<bool>& isAccepted,
+                                            bool safe_to_delay)
+{
+  const int nw = WFC_list.size();
+  resizeMultiWalkerScratch(nw);
+
+  // the accepted walkers which only computed ratios need the new derivatives
+  std::vector<int> accepted_list;
+  std::vector<int> ratio_only_list;
+  accepted_list.reserve(nw);
+  for (int iw = 0; iw < nw; iw++)
+    if (isAccepted[iw])
+    {
+      accepted_list.push_back(iw);
+      if (WFC_list[iw].get().UpdateMode == ORB_PBYP_RATIO)
+        ratio_only_list.push_back(iw);
+    }
+
+  if (ratio_only_list.size() > 0)
+  {
+    const int n_ratio_only = ratio_only_list.size();
+    for (int i = 0; i < n_ratio_only; i++)
+    {
+      const auto& dist = P_list[ratio_only_list[i]].get().getDistTable(my_table_ID_).getTempDists();
+      std::copy_n(dist.data(), N, mw_dist_.data() + i * N_padded);
+    }
+    mw_computeU3(P_list[0], iat, n_ratio_only);
+    for (int i = 0; i < n_ratio_only; i++)
+    {
+      auto& j2 = static_cast<J2OrbitalSoA<FT>&>(WFC_list[ratio_only_list[i]].get());
+      std::copy_n(mw_u_.data() + i * N_padded, N, j2.cur_u.data());
+      std::copy_n(mw_du_.data() + i * N_padded, N, j2.cur_du.data());
+      std::copy_n(mw_d2u_.data() + i * N_padded, N, j2.cur_d2u.data());
+    }
+  }
+
+  const int n_accepted = accepted_list.size();
+  if (n_accepted == 0)
+    return;
+
+  // old u, du, d2u of all the accepted walkers in one batch
+  for (int i = 0; i < n_accepted; i++)
+  {
+    const auto& dist = P_list[accepted_list[i]].get().getDistTable(my_table_ID_).getOldDists();
+    std::copy_n(dist.data(), N, mw_dist_.data() + i * N_padded);
+  }
+  mw_computeU3(P_list[0], iat, n_accepted);
+
+  for (int i = 0; i < n_accepted; i++)
+  {
+    const int iw = accepted_list[i];
+    auto& j2     = static_cast<J2OrbitalSoA<FT>&>(WFC_list[iw].get());
+    j2.acceptU3(P_list[iw], iat, mw_u_.data() + i * N_padded, mw_du_.data() + i * N_padded,
+                mw_d2u_.data() + i * N_padded);
+  }
+}
+
 template<typename FT>
 void J2OrbitalSoA<FT>::recompute(ParticleSet& P)
 {
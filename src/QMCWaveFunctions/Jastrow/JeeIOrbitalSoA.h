@@ -92,6 +92,21 @@ class JeeIOrbitalSoA : public WaveFunctionComponent
   /// work result buffer
   VectorSoaContainer<valT, 9> mVGL;
 
+  /**@{ multi-walker scratch used by the crowd leader, the triples of all the walkers are stacked */
+  size_t mw_Nbuffer_ = 0;
+  aligned_vector<valT> mw_Distjk_, mw_DistjI_, mw_DistkI_;
+  gContainer_type mw_Disp_jk_, mw_Disp_jI_, mw_Disp_kI_;
+  VectorSoaContainer<valT, 9> mw_VGL_;
+  /// the walker and the electron k of each triple
+  std::vector<int> mw_walker_, mw_kel_;
+  /// U, dU, d2U of the moved electron of each walker
+  std::vector<valT> mw_Uj_, mw_d2Uj_;
+  std::vector<posT> mw_dUj_;
+  /// U, dU, d2U of the other electrons of each walker
+  std::vector<valT*> mw_Uk_, mw_d2Uk_;
+  std::vector<gContainer_type*> mw_dUk_;
+  /**@} */
+
   // Used for evaluating derivatives with respect to the parameters
   int NumVars;
   Array<std::pair<int, int>, 3> VarOffset;
@@ -423,6 +438,23 @@ public:
     return std::exp(static_cast<PsiValueType>(DiffVal));
   }
 
+  void mw_calcRatio(const RefVector<WaveFunctionComponent>& WFC_list,
+                    const RefVector<ParticleSet>& P_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios)
+  {
+    const RefVector<JeeIOrbitalSoA<FT>> j3_list(extractJ3RefList(WFC_list));
+    mw_computeU(j3_list, P_list, iat);
+    for (int iw = 0; iw < j3_list.size(); iw++)
+    {
+      auto& j3      = j3_list[iw].get();
+      j3.UpdateMode = ORB_PBYP_RATIO;
+      j3.cur_Uat    = mw_Uj_[iw];
+      j3.DiffVal    = j3.Uat[iat] - j3.cur_Uat;
+      ratios[iw]    = std::exp(static_cast<PsiValueType>(j3.DiffVal));
+    }
+  }
+
   void evaluateRatios(const VirtualParticleSet& VP, std::vector<ValueType>& ratios)
   {
     for (int k = 0; k < ratios.size(); ++k)
@@ -476,6 +508,24 @@ public:
     return std::exp(static_cast<PsiValueType>(DiffVal));
   }
 
+  void mw_ratioGrad(const RefVector<WaveFunctionComponent>& WFC_list,
+                    const RefVector<ParticleSet>& P_list,
+                    int iat,
+                    std::vector<PsiValueType>& ratios,
+                    std::vector<GradType>& grad_new)
+  {
+    const RefVector<JeeIOrbitalSoA<FT>> j3_list(extractJ3RefList(WFC_list));
+    mw_computeU3(j3_list, P_list, iat, false);
+    for (int iw = 0; iw < j3_list.size(); iw++)
+    {
+      auto& j3      = j3_list[iw].get();
+      j3.UpdateMode = ORB_PBYP_PARTIAL;
+      j3.DiffVal    = j3.Uat[iat] - j3.cur_Uat;
+      grad_new[iw] += j3.cur_dUat;
+      ratios[iw] = std::exp(static_cast<PsiValueType>(j3.DiffVal));
+    }
+  }
+
   inline void restore(int iat) {}
 
   void acceptMove(ParticleSet& P, int iat, bool safe_to_delay = false)
@@ -490,6 +540,45 @@ public:
       computeU3(P, iat, eI_table.getTempDists(), eI_table.getTempDispls(), ee_table.getTempDists(),
                 ee_table.getTempDispls(), cur_Uat, cur_dUat, cur_d2Uat, newUk, newdUk, newd2Uk, ions_nearby_new);
     }
+    acceptU3(P, iat);
+  }
+
+  void mw_accept_rejectMove(const RefVector<WaveFunctionComponent>& WFC_list,
+                            const RefVector<ParticleSet>& P_list,
+                            int iat,
+                            const std::vector<bool>& isAccepted,
+                            bool safe_to_delay = false)
+  {
+    RefVector<JeeIOrbitalSoA<FT>> j3_accepted, j3_ratio_only;
+    RefVector<ParticleSet> p_accepted, p_ratio_only;
+    for (int iw = 0; iw < WFC_list.size(); iw++)
+      if (isAccepted[iw])
+      {
+        auto& j3 = static_cast<JeeIOrbitalSoA<FT>&>(WFC_list[iw].get());
+        j3_accepted.push_back(j3);
+        p_accepted.push_back(P_list[iw]);
+        // ratio-only during the move; need to compute derivatives
+        if (j3.UpdateMode == ORB_PBYP_RATIO)
+        {
+          j3_ratio_only.push_back(j3);
+          p_ratio_only.push_back(P_list[iw]);
+        }
+      }
+
+    if (j3_ratio_only.size() > 0)
+      mw_computeU3(j3_ratio_only, p_ratio_only, iat, false);
+    if (j3_accepted.size() == 0)
+      return;
+    mw_computeU3(j3_accepted, p_accepted, iat, true);
+    for (int i = 0; i < j3_accepted.size(); i++)
+      j3_accepted[i].get().acceptU3(p_accepted[i], iat);
+  }
+
+  /** update the sums and the compact lists with the old and new U, dU, d2U of the accepted move of iat
+   */
+  void acceptU3(ParticleSet& P, int iat)
+  {
+    const DistanceTableData& eI_table = P.getDistTable(ei_Table_ID_);
 
 #pragma omp simd
     for (int jel = 0; jel < Nelec; jel++)
@@ -599,6 +688,296 @@ public:
     }
   }
 
+  /// collect the ions within the cutoff radius of an electron
+  inline void findIonsNearby(const DistRow& distjI, std::vector<int>& ions_nearby) const
+  {
+    ions_nearby.clear();
+    for (int iat = 0; iat < Nion; ++iat)
+      if (distjI[iat] < Ion_cutoff[iat])
+        ions_nearby.push_back(iat);
+  }
+
+  /// cast the components of a crowd to JeeIOrbitalSoA
+  static RefVector<JeeIOrbitalSoA<FT>> extractJ3RefList(const RefVector<WaveFunctionComponent>& WFC_list)
+  {
+    RefVector<JeeIOrbitalSoA<FT>> j3_list;
+    j3_list.reserve(WFC_list.size());
+    for (WaveFunctionComponent& wfc : WFC_list)
+      j3_list.push_back(static_cast<JeeIOrbitalSoA<FT>&>(wfc));
+    return j3_list;
+  }
+
+  /// resize the multi-walker scratch for nw walkers
+  void resizeMultiWalkerScratch(int nw)
+  {
+    const size_t total_size = nw * Nbuffer;
+    if (mw_Nbuffer_ < total_size)
+    {
+      mw_Nbuffer_ = total_size;
+      mw_VGL_.resize(mw_Nbuffer_);
+      mw_Distjk_.resize(mw_Nbuffer_);
+      mw_DistjI_.resize(mw_Nbuffer_);
+      mw_DistkI_.resize(mw_Nbuffer_);
+      mw_Disp_jk_.resize(mw_Nbuffer_);
+      mw_Disp_jI_.resize(mw_Nbuffer_);
+      mw_Disp_kI_.resize(mw_Nbuffer_);
+      mw_walker_.resize(mw_Nbuffer_);
+      mw_kel_.resize(mw_Nbuffer_);
+    }
+    if (mw_Uj_.size() < nw)
+    {
+      mw_Uj_.resize(nw);
+      mw_dUj_.resize(nw);
+      mw_d2Uj_.resize(nw);
+      mw_Uk_.resize(nw);
+      mw_dUk_.resize(nw);
+      mw_d2Uk_.resize(nw);
+    }
+  }
+
+  /** compute U of electron jel at its proposed position for all the walkers of a crowd
+   *
+   * The triples (ion, jel, kel) of all the walkers sharing a functor are evaluated in a single batch
+   * using the compact lists of each walker. The results are stored in mw_Uj_ and ions_nearby_new of each walker.
+   */
+  void mw_computeU(const RefVector<JeeIOrbitalSoA<FT>>& j3_list, const RefVector<ParticleSet>& P_list, int jel)
+  {
+    const int nw = j3_list.size();
+    resizeMultiWalkerScratch(nw);
+    std::fill_n(mw_Uj_.begin(), nw, valT(0));
+    for (int iw = 0; iw < nw; iw++)
+    {
+      auto& j3 = j3_list[iw].get();
+      findIonsNearby(P_list[iw].get().getDistTable(ei_Table_ID_).getTempDists(), j3.ions_nearby_new);
+    }
+
+    valT* restrict val = mw_VGL_.data(0);
+    const int jg       = P_list[0].get().GroupID[jel];
+    for (int ig = 0; ig < iGroups; ++ig)
+      for (int kg = 0; kg < eGroups; ++kg)
+      {
+        if (F(ig, jg, kg) == nullptr)
+          continue;
+        const FT& feeI(*F(ig, jg, kg));
+        int counter = 0;
+        for (int iw = 0; iw < nw; iw++)
+        {
+          const auto& j3     = j3_list[iw].get();
+          const auto& distjI = P_list[iw].get().getDistTable(ei_Table_ID_).getTempDists();
+          const auto& distjk = P_list[iw].get().getDistTable(ee_Table_ID_).getTempDists();
+          for (const int iat : j3.ions_nearby_new)
+          {
+            if (Ions.GroupID[iat] != ig)
+              continue;
+            const valT r_jI = distjI[iat];
+            for (int kind = 0; kind < j3.elecs_inside(kg, iat).size(); kind++)
+            {
+              const int kel = j3.elecs_inside(kg, iat)[kind];
+              if (kel != jel)
+              {
+                mw_DistkI_[counter] = j3.elecs_inside_dist(kg, iat)[kind];
+                mw_DistjI_[counter] = r_jI;
+                mw_Distjk_[counter] = distjk[kel];
+                mw_walker_[counter] = iw;
+                if (++counter == mw_Nbuffer_)
+                {
+                  feeI.evaluateV(counter, mw_Distjk_.data(), mw_DistjI_.data(), mw_DistkI_.data(), val);
+                  for (int i = 0; i < counter; i++)
+                    mw_Uj_[mw_walker_[i]] += val[i];
+                  counter = 0;
+                }
+              }
+            }
+          }
+        }
+        if (counter > 0)
+        {
+          feeI.evaluateV(counter, mw_Distjk_.data(), mw_DistjI_.data(), mw_DistkI_.data(), val);
+          for (int i = 0; i < counter; i++)
+            mw_Uj_[mw_walker_[i]] += val[i];
+        }
+      }
+  }
+
+  /** compute U, dU, d2U of electron jel for all the walkers of a crowd
+   * @param old_position if true, use the current position of jel and store the results as acceptMove does
+   *        for the old position, otherwise use the proposed position and store them as ratioGrad does
+   *
+   * The triples (ion, jel, kel) of all the walkers sharing a functor are evaluated in a single batch
+   * using the compact lists of each walker.
+   */
+  void mw_computeU3(const RefVector<JeeIOrbitalSoA<FT>>& j3_list,
+                    const RefVector<ParticleSet>& P_list,
+                    int jel,
+                    bool old_position)
+  {
+    constexpr valT czero(0);
+    const int nw = j3_list.size();
+    resizeMultiWalkerScratch(nw);
+    for (int iw = 0; iw < nw; iw++)
+    {
+      auto& j3                 = j3_list[iw].get();
+      Vector<valT>& Uk         = old_position ? j3.oldUk : j3.newUk;
+      gContainer_type& dUk     = old_position ? j3.olddUk : j3.newdUk;
+      Vector<valT>& d2Uk       = old_position ? j3.oldd2Uk : j3.newd2Uk;
+      std::vector<int>& nearby = old_position ? j3.ions_nearby_old : j3.ions_nearby_new;
+      std::fill_n(Uk.data(), Nelec, czero);
+      std::fill_n(d2Uk.data(), Nelec, czero);
+      for (int idim = 0; idim < OHMMS_DIM; ++idim)
+        std::fill_n(dUk.data(idim), Nelec, czero);
+      mw_Uk_[iw]   = Uk.data();
+      mw_dUk_[iw]  = &dUk;
+      mw_d2Uk_[iw] = d2Uk.data();
+      mw_Uj_[iw]   = czero;
+      mw_dUj_[iw]  = posT();
+      mw_d2Uj_[iw] = czero;
+      const DistanceTableData& eI_table = P_list[iw].get().getDistTable(ei_Table_ID_);
+      findIonsNearby(old_position ? eI_table.getDistRow(jel) : eI_table.getTempDists(), nearby);
+    }
+
+    const int jg = P_list[0].get().GroupID[jel];
+    for (int ig = 0; ig < iGroups; ++ig)
+      for (int kg = 0; kg < eGroups; ++kg)
+      {
+        if (F(ig, jg, kg) == nullptr)
+          continue;
+        const FT& feeI(*F(ig, jg, kg));
+        int counter = 0;
+        for (int iw = 0; iw < nw; iw++)
+        {
+          const auto& j3                    = j3_list[iw].get();
+          const DistanceTableData& eI_table = P_list[iw].get().getDistTable(ei_Table_ID_);
+          const DistanceTableData& ee_table = P_list[iw].get().getDistTable(ee_Table_ID_);
+          const DistRow& distjI             = old_position ? eI_table.getDistRow(jel) : eI_table.getTempDists();
+          const DisplRow& displjI           = old_position ? eI_table.getDisplRow(jel) : eI_table.getTempDispls();
+          const DistRow& distjk             = old_position ? ee_table.getOldDists() : ee_table.getTempDists();
+          const DisplRow& displjk           = old_position ? ee_table.getOldDispls() : ee_table.getTempDispls();
+          for (const int iat : old_position ? j3.ions_nearby_old : j3.ions_nearby_new)
+          {
+            if (Ions.GroupID[iat] != ig)
+              continue;
+            const valT r_jI    = distjI[iat];
+            const posT disp_Ij = displjI[iat];
+            for (int kind = 0; kind < j3.elecs_inside(kg, iat).size(); kind++)
+            {
+              const int kel = j3.elecs_inside(kg, iat)[kind];
+              if (kel != jel)
+              {
+                mw_DistkI_[counter]  = j3.elecs_inside_dist(kg, iat)[kind];
+                mw_DistjI_[counter]  = r_jI;
+                mw_Distjk_[counter]  = distjk[kel];
+                mw_Disp_kI_(counter) = j3.elecs_inside_displ(kg, iat)[kind];
+                mw_Disp_jI_(counter) = disp_Ij;
+                mw_Disp_jk_(counter) = displjk[kel];
+                mw_walker_[counter]  = iw;
+                mw_kel_[counter]     = kel;
+                if (++counter == mw_Nbuffer_)
+                {
+                  mw_computeU3_engine(feeI, counter);
+                  counter = 0;
+                }
+              }
+            }
+          }
+        }
+        if (counter > 0)
+          mw_computeU3_engine(feeI, counter);
+      }
+
+    for (int iw = 0; iw < nw; iw++)
+    {
+      auto& j3 = j3_list[iw].get();
+      if (old_position)
+      {
+        j3.Uat[jel]   = mw_Uj_[iw];
+        j3.dUat_temp  = mw_dUj_[iw];
+        j3.d2Uat[jel] = mw_d2Uj_[iw];
+      }
+      else
+      {
+        j3.cur_Uat   = mw_Uj_[iw];
+        j3.cur_dUat  = mw_dUj_[iw];
+        j3.cur_d2Uat = mw_d2Uj_[iw];
+      }
+    }
+  }
+
+  /** evaluate the first counter triples stacked by mw_computeU3 and accumulate them to their walkers
+   */
+  inline void mw_computeU3_engine(const FT& feeI, int counter)
+  {
+    constexpr valT cone(1);
+    constexpr valT ctwo(2);
+    constexpr valT lapfac = OHMMS_DIM - cone;
+
+    valT* restrict val     = mw_VGL_.data(0);
+    valT* restrict gradF0  = mw_VGL_.data(1);
+    valT* restrict gradF1  = mw_VGL_.data(2);
+    valT* restrict gradF2  = mw_VGL_.data(3);
+    valT* restrict hessF00 = mw_VGL_.data(4);
+    valT* restrict hessF11 = mw_VGL_.data(5);
+    valT* restrict hessF22 = mw_VGL_.data(6);
+    valT* restrict hessF01 = mw_VGL_.data(7);
+    valT* restrict hessF02 = mw_VGL_.data(8);
+
+    feeI.evaluateVGL(counter, mw_Distjk_.data(), mw_DistjI_.data(), mw_DistkI_.data(), val, gradF0, gradF1, gradF2,
+                     hessF00, hessF11, hessF22, hessF01, hessF02);
+
+    // d2U of jel and kel overwrite hessF11 and hessF22
+    const valT* restrict jk[OHMMS_DIM];
+    const valT* restrict jI[OHMMS_DIM];
+    const valT* restrict kI[OHMMS_DIM];
+    for (int idim = 0; idim < OHMMS_DIM; ++idim)
+    {
+      jk[idim] = mw_Disp_jk_.data(idim);
+      jI[idim] = mw_Disp_jI_.data(idim);
+      kI[idim] = mw_Disp_kI_.data(idim);
+    }
+#pragma omp simd aligned(gradF0, gradF1, gradF2, hessF00, hessF11, hessF22, hessF01, hessF02)
+    for (int i = 0; i < counter; i++)
+    {
+      valT jk_dot_jI(0), jk_dot_kI(0);
+      for (int idim = 0; idim < OHMMS_DIM; ++idim)
+      {
+        jk_dot_jI += jk[idim][i] * jI[idim][i];
+        jk_dot_kI += jk[idim][i] * kI[idim][i];
+      }
+      const valT d2j = hessF00[i] + hessF11[i] + lapfac * (gradF0[i] + gradF1[i]) + ctwo * hessF01[i] * jk_dot_jI;
+      const valT d2k = hessF00[i] + hessF22[i] + lapfac * (gradF0[i] + gradF2[i]) - ctwo * hessF02[i] * jk_dot_kI;
+      hessF11[i]     = d2j;
+      hessF22[i]     = d2k;
+    }
+
+    for (int i = 0; i < counter; i++)
+    {
+      const int iw = mw_walker_[i];
+      mw_Uj_[iw] += val[i];
+      mw_d2Uj_[iw] -= hessF11[i];
+      mw_Uk_[iw][mw_kel_[i]] += val[i];
+      mw_d2Uk_[iw][mw_kel_[i]] -= hessF22[i];
+    }
+
+    // dU of jel and kel overwrite the jI and kI displacements
+    for (int idim = 0; idim < OHMMS_DIM; ++idim)
+    {
+      const valT* restrict jk_x = mw_Disp_jk_.data(idim);
+      valT* restrict jI_x       = mw_Disp_jI_.data(idim);
+      valT* restrict kI_x       = mw_Disp_kI_.data(idim);
+#pragma omp simd aligned(gradF0, gradF1, gradF2, jk_x, jI_x, kI_x)
+      for (int i = 0; i < counter; i++)
+      {
+        jI_x[i] = gradF1[i] * jI_x[i] + gradF0[i] * jk_x[i];
+        kI_x[i] = gradF2[i] * kI_x[i] - gradF0[i] * jk_x[i];
+      }
+      for (int i = 0; i < counter; i++)
+      {
+        const int iw = mw_walker_[i];
+        mw_dUj_[iw][idim] += jI_x[i];
+        mw_dUk_[iw]->data(idim)[mw_kel_[i]] += kI_x[i];
+      }
+    }
+  }
+
   inline valT computeU(const ParticleSet& P,
                        int jel,
                        int jg,
@@ -606,10 +985,7 @@ public:
                        const DistRow& distjk,
                        std::vector<int>& ions_nearby)
   {
-    ions_nearby.clear();
-    for (int iat = 0; iat < Nion; ++iat)
-      if (distjI[iat] < Ion_cutoff[iat])
-        ions_nearby.push_back(iat);
+    findIonsNearby(distjI, ions_nearby);
 
     valT Uj = valT(0);
     for (int kg = 0; kg < eGroups; ++kg)
@@ -767,10 +1143,7 @@ public:
     for (int idim = 0; idim < OHMMS_DIM; ++idim)
       std::fill_n(dUk.data(idim), kelmax, czero);
 
-    ions_nearby.clear();
-    for (int iat = 0; iat < Nion; ++iat)
-      if (distjI[iat] < Ion_cutoff[iat])
-        ions_nearby.push_back(iat);
+    findIonsNearby(distjI, ions_nearby);
 
     for (int kg = 0; kg < eGroups; ++kg)
     {
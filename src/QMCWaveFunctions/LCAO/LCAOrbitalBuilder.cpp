@@ -112,7 +112,8 @@ LCAOrbitalBuilder::LCAOrbitalBuilder(ParticleSet& els, ParticleSet& ions, Commun
       sourcePtcl(ions),
       h5_path(""),
       SuperTwist(0.0),
-      doCuspCorrection(false)
+      doCuspCorrection(false),
+      screening_tol_(0.0)
 {
   ClassName = "LCAOrbitalBuilder";
   ReportEngine PRE(ClassName, "createBasisSet");
@@ -123,6 +124,7 @@ LCAOrbitalBuilder::LCAOrbitalBuilder(ParticleSet& els, ParticleSet& ions, Commun
   aAttrib.add(h5_path, "href");
   aAttrib.add(PBCImages, "PBCimages");
   aAttrib.add(SuperTwist, "twist");
+  aAttrib.add(screening_tol_, "screening");
   aAttrib.put(cur);
 
   if (cuspC == "yes")
@@ -491,6 +493,12 @@ SPOSet* LCAOrbitalBuilder::createSPOSetFromXML(xmlNodePtr cur)
 #endif
   loadMO(*lcos, cur);
 
+  if (screening_tol_ > 0)
+  {
+    app_summary() << "        Screening basis set centers with tolerance " << screening_tol_ << std::endl;
+    lcos->enableScreening(screening_tol_);
+  }
+
 #if !defined(QMC_COMPLEX)
   if (doCuspCorrection)
   {
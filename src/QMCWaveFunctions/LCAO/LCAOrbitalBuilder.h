@@ -65,6 +65,9 @@ protected:
   /// Enable cusp correction
   bool doCuspCorrection;
 
+  ///tolerance of the screening of the basis set centers, 0 to disable
+  RealType screening_tol_;
+
   /** create basis set
      *
      * Use ao_traits<T,I,J> to match (ROT)x(SH) combo
@@ -17,7 +17,7 @@
 namespace qmcplusplus
 {
 LCAOrbitalSet::LCAOrbitalSet(std::unique_ptr<basis_type>&& bs, bool optimize)
-    : SPOSet(false, true, optimize), BasisSetSize(bs ? bs->getBasisSetSize() : 0), Identity(true)
+    : SPOSet(false, true, optimize), BasisSetSize(bs ? bs->getBasisSetSize() : 0), Identity(true), Screening(false)
 {
   if (!bs)
     throw std::runtime_error("LCAOrbitalSet cannot take nullptr as its  basis set!");
@@ -30,7 +30,12 @@ LCAOrbitalSet::LCAOrbitalSet(std::unique_ptr<basis_type>&& bs, bool optimize)
 }
 
 LCAOrbitalSet::LCAOrbitalSet(const LCAOrbitalSet& in)
-    : SPOSet(in), myBasisSet(in.myBasisSet->makeClone()), C(in.C), BasisSetSize(in.BasisSetSize), Identity(in.Identity)
+    : SPOSet(in),
+      myBasisSet(in.myBasisSet->makeClone()),
+      C(in.C),
+      BasisSetSize(in.BasisSetSize),
+      Identity(in.Identity),
+      Screening(in.Screening)
 {
   Temp.resize(BasisSetSize);
   Temph.resize(BasisSetSize);
@@ -81,12 +86,29 @@ void LCAOrbitalSet::checkObject() const
 
 SPOSet* LCAOrbitalSet::makeClone() const { return new LCAOrbitalSet(*this); }
 
+void LCAOrbitalSet::enableScreening(RealType tol)
+{
+  Screening = myBasisSet->setScreening(tol);
+  if (!Screening)
+    app_warning() << "LCAOrbitalSet::enableScreening the basis set does not support screening" << std::endl;
+}
+
 void LCAOrbitalSet::evaluateValue(const ParticleSet& P, int iat, ValueVector_t& psi)
 {
   if (Identity)
   { //PAY ATTENTION TO COMPLEX
     myBasisSet->evaluateV(P, iat, psi.data());
   }
+  else if (Screening)
+  {
+    Vector<ValueType> vTemp(Temp.data(0), BasisSetSize);
+    myBasisSet->evaluateVScreened(P, iat, vTemp.data(), screened_blocks_);
+    assert(psi.size() <= OrbitalSetSize);
+    std::fill_n(psi.data(), psi.size(), ValueType(0));
+    for (const auto& block : screened_blocks_)
+      BLAS::gemv('T', block.second - block.first, psi.size(), ValueType(1), C->data() + block.first, BasisSetSize,
+                 vTemp.data() + block.first, 1, ValueType(1), psi.data(), 1);
+  }
   else
   {
     Vector<ValueType> vTemp(Temp.data(0), BasisSetSize);
@@ -315,6 +337,21 @@ void LCAOrbitalSet::evaluateVGL(const ParticleSet& P,
                                 ValueVector_t& d2psi)
 {
   //TAKE CARE OF IDENTITY
+  if (Screening && !Identity)
+  {
+    myBasisSet->evaluateVGLScreened(P, iat, Temp, screened_blocks_);
+    assert(psi.size() <= OrbitalSetSize);
+    const size_t output_size = psi.size();
+    for (int idim = 0; idim < OHMMS_DIM + 2; idim++)
+      std::fill_n(Tempv.data(idim), output_size, ValueType(0));
+    for (const auto& block : screened_blocks_)
+      BLAS::gemm('t', 'n', output_size, OHMMS_DIM + 2, block.second - block.first, ValueType(1),
+                 C->data() + block.first, BasisSetSize, Temp.data() + block.first, Temp.capacity(), ValueType(1),
+                 Tempv.data(), Tempv.capacity());
+    evaluate_vgl_impl(Tempv, psi, dpsi, d2psi);
+    return;
+  }
+
   myBasisSet->evaluateVGL(P, iat, Temp);
   if (Identity)
     evaluate_vgl_impl(Temp, psi, dpsi, d2psi);
@@ -339,8 +376,122 @@ void LCAOrbitalSet::evaluateDetRatios(const VirtualParticleSet& VP,
 
   for (size_t j = 0; j < VP.getTotalNum(); j++)
   {
-    myBasisSet->evaluateV(VP, j, vTemp.data());
-    ratios[j] = simd::dot(vTemp.data(), invTemp.data(), BasisSetSize);
+    if (Screening)
+    {
+      myBasisSet->evaluateVScreened(VP, j, vTemp.data(), screened_blocks_);
+      ValueType ratio(0);
+      for (const auto& block : screened_blocks_)
+        ratio += simd::dot(vTemp.data() + block.first, invTemp.data() + block.first, block.second - block.first);
+      ratios[j] = ratio;
+    }
+    else
+    {
+      myBasisSet->evaluateV(VP, j, vTemp.data());
+      ratios[j] = simd::dot(vTemp.data(), invTemp.data(), BasisSetSize);
+    }
+  }
+}
+
+void LCAOrbitalSet::mw_evaluateDetRatios(const RefVector<SPOSet>& spo_list,
+                                         const RefVector<const VirtualParticleSet>& vp_list,
+                                         const RefVector<ValueVector_t>& psi_list,
+                                         const std::vector<const ValueType*>& invRow_ptr_list,
+                                         std::vector<std::vector<ValueType>>& ratios_list)
+{
+  const size_t nw   = spo_list.size();
+  const size_t norb = psi_list[0].get().size();
+  assert(norb <= OrbitalSetSize);
+
+  if (Identity)
+  {
+    SPOSet::mw_evaluateDetRatios(spo_list, vp_list, psi_list, invRow_ptr_list, ratios_list);
+    return;
+  }
+
+  // C^T psiinv of all the walkers as a single GEMM
+  mw_invrow_.resize(nw, norb);
+  mw_invrow_basis_.resize(nw, BasisSetSize);
+  for (size_t iw = 0; iw < nw; iw++)
+    std::copy_n(invRow_ptr_list[iw], norb, mw_invrow_[iw]);
+  BLAS::gemm('n', 'n', BasisSetSize, nw, norb, ValueType(1), C->data(), BasisSetSize, mw_invrow_.data(), norb,
+             ValueType(0), mw_invrow_basis_.data(), BasisSetSize);
+
+  Vector<ValueType> vTemp(Temp.data(0), BasisSetSize);
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    const VirtualParticleSet& VP = vp_list[iw];
+    for (size_t j = 0; j < VP.getTotalNum(); j++)
+      if (Screening)
+      {
+        myBasisSet->evaluateVScreened(VP, j, vTemp.data(), screened_blocks_);
+        ValueType ratio(0);
+        for (const auto& block : screened_blocks_)
+          ratio += simd::dot(vTemp.data() + block.first, mw_invrow_basis_[iw] + block.first,
+                             block.second - block.first);
+        ratios_list[iw][j] = ratio;
+      }
+      else
+      {
+        myBasisSet->evaluateV(VP, j, vTemp.data());
+        ratios_list[iw][j] = simd::dot(vTemp.data(), mw_invrow_basis_[iw], BasisSetSize);
+      }
+  }
+}
+
+const LCAOrbitalSet::ValueMatrix_t& LCAOrbitalSet::mw_evaluateVGLImplGEMM(const RefVector<ParticleSet>& P_list,
+                                                                         int iat,
+                                                                         size_t norb)
+{
+  const size_t nw = P_list.size();
+  mw_basis_vgl_.resize(nw * (OHMMS_DIM + 2), BasisSetSize);
+  myBasisSet->mw_evaluateVGL(P_list, iat, mw_basis_vgl_);
+  if (Identity)
+    return mw_basis_vgl_;
+
+  assert(norb <= OrbitalSetSize);
+  mw_phi_vgl_.resize(nw * (OHMMS_DIM + 2), norb);
+  BLAS::gemm('t', 'n', norb, mw_basis_vgl_.rows(), BasisSetSize, ValueType(1), C->data(), BasisSetSize,
+             mw_basis_vgl_.data(), mw_basis_vgl_.cols(), ValueType(0), mw_phi_vgl_.data(), mw_phi_vgl_.cols());
+  return mw_phi_vgl_;
+}
+
+void LCAOrbitalSet::mw_evaluateVGL(const RefVector<SPOSet>& spo_list,
+                                   const RefVector<ParticleSet>& P_list,
+                                   int iat,
+                                   const RefVector<ValueVector_t>& psi_v_list,
+                                   const RefVector<GradVector_t>& dpsi_v_list,
+                                   const RefVector<ValueVector_t>& d2psi_v_list)
+{
+  const size_t norb       = psi_v_list[0].get().size();
+  const ValueMatrix_t& phi_vgl = mw_evaluateVGLImplGEMM(P_list, iat, norb);
+  for (size_t iw = 0; iw < spo_list.size(); iw++)
+  {
+    const vgl_type phi_vgl_iw(const_cast<ValueType*>(phi_vgl[iw * (OHMMS_DIM + 2)]), norb, phi_vgl.cols());
+    evaluate_vgl_impl(phi_vgl_iw, psi_v_list[iw], dpsi_v_list[iw], d2psi_v_list[iw]);
+  }
+}
+
+void LCAOrbitalSet::mw_evaluateVGLandDetRatioGrads(const RefVector<SPOSet>& spo_list,
+                                                   const RefVector<ParticleSet>& P_list,
+                                                   int iat,
+                                                   const std::vector<const ValueType*>& invRow_ptr_list,
+                                                   VGLVector_t& phi_vgl_v,
+                                                   std::vector<ValueType>& ratios,
+                                                   std::vector<GradType>& grads)
+{
+  const size_t nw              = spo_list.size();
+  const size_t norb            = phi_vgl_v.size() / nw;
+  const ValueMatrix_t& phi_vgl = mw_evaluateVGLImplGEMM(P_list, iat, norb);
+  for (size_t iw = 0; iw < nw; iw++)
+  {
+    const vgl_type phi_vgl_iw(const_cast<ValueType*>(phi_vgl[iw * (OHMMS_DIM + 2)]), norb, phi_vgl.cols());
+    ValueVector_t phi_v(phi_vgl_v.data() + norb * iw, norb);
+    GradVector_t dphi_v(reinterpret_cast<GradType*>(phi_vgl_v.data(1)) + norb * iw, norb);
+    ValueVector_t d2phi_v(phi_vgl_v.data(4) + norb * iw, norb);
+    evaluate_vgl_impl(phi_vgl_iw, phi_v, dphi_v, d2phi_v);
+
+    ratios[iw] = simd::dot(invRow_ptr_list[iw], phi_v.data(), norb);
+    grads[iw]  = simd::dot(invRow_ptr_list[iw], dphi_v.data(), norb) / ratios[iw];
   }
 }
 
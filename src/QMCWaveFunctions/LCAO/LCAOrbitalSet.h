@@ -79,6 +79,13 @@ public:
 
   bool isIdentity() const { return Identity; };
 
+  /** enable screening the basis set centers by the electron-ion distance
+   * @param tol threshold below which the basis functions are treated as zero
+   *
+   * Only the columns of C of the centers within their screening radii are contracted.
+   */
+  void enableScreening(RealType tol);
+
   /** check consistency between Identity and C
     *
     */
@@ -97,6 +104,27 @@ public:
                          const ValueVector_t& psiinv,
                          std::vector<ValueType>& ratios) override;
 
+  void mw_evaluateDetRatios(const RefVector<SPOSet>& spo_list,
+                            const RefVector<const VirtualParticleSet>& vp_list,
+                            const RefVector<ValueVector_t>& psi_list,
+                            const std::vector<const ValueType*>& invRow_ptr_list,
+                            std::vector<std::vector<ValueType>>& ratios_list) override;
+
+  void mw_evaluateVGL(const RefVector<SPOSet>& spo_list,
+                      const RefVector<ParticleSet>& P_list,
+                      int iat,
+                      const RefVector<ValueVector_t>& psi_v_list,
+                      const RefVector<GradVector_t>& dpsi_v_list,
+                      const RefVector<ValueVector_t>& d2psi_v_list) override;
+
+  void mw_evaluateVGLandDetRatioGrads(const RefVector<SPOSet>& spo_list,
+                                      const RefVector<ParticleSet>& P_list,
+                                      int iat,
+                                      const std::vector<const ValueType*>& invRow_ptr_list,
+                                      VGLVector_t& phi_vgl_v,
+                                      std::vector<ValueType>& ratios,
+                                      std::vector<GradType>& grads) override;
+
   void evaluateVGH(const ParticleSet& P,
                    int iat,
                    ValueVector_t& psi,
@@ -207,6 +235,10 @@ protected:
 
   ///true if C is an identity matrix
   bool Identity;
+  ///true if the basis set centers are screened by distance
+  bool Screening;
+  ///ranges of the basis functions evaluated with screening
+  basis_type::BlockList screened_blocks_;
   ///Temp(BasisSetSize) : Row index=V,Gx,Gy,Gz,L
   vgl_type Temp;
   ///Tempv(OrbitalSetSize) Tempv=C*Temp
@@ -226,7 +258,24 @@ protected:
   //Nbasis x [1(value)+3(gradient)+6(hessian)+10(grad_hessian)]
   vghgh_type Tempghv;
 
+  ///basis VGL of all the walkers in a batch, (5*nw, BasisSetSize)
+  ValueMatrix_t mw_basis_vgl_;
+  ///orbital VGL of all the walkers in a batch, (5*nw, number of requested orbitals)
+  ValueMatrix_t mw_phi_vgl_;
+  ///rows of the inverse matrix of all the walkers in a batch, (nw, number of requested orbitals)
+  ValueMatrix_t mw_invrow_;
+  ///C^T times the rows of the inverse matrix, (nw, BasisSetSize)
+  ValueMatrix_t mw_invrow_basis_;
+
 private:
+  /** evaluate the orbital VGL of multiple walkers
+   * @return (5*nw, norb) matrix with rows 5*iw to 5*iw+4 holding the orbital VGL of walker iw
+   *
+   * The basis functions of all the walkers are evaluated first and then
+   * multiplied by the MO coefficients as a single GEMM instead of a GEMM per walker.
+   */
+  const ValueMatrix_t& mw_evaluateVGLImplGEMM(const RefVector<ParticleSet>& P_list, int iat, size_t norb);
+
   //helper functions to handl Identity
   void evaluate_vgl_impl(const vgl_type& temp, ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi) const;
 
@@ -50,6 +50,31 @@ void LCAOrbitalSetWithCorrection::evaluateVGL(const ParticleSet& P,
   cusp.add_vector_vgl(P, iat, psi, dpsi, d2psi);
 }
 
+void LCAOrbitalSetWithCorrection::mw_evaluateVGL(const RefVector<SPOSet>& spo_list,
+                                                 const RefVector<ParticleSet>& P_list,
+                                                 int iat,
+                                                 const RefVector<ValueVector_t>& psi_v_list,
+                                                 const RefVector<GradVector_t>& dpsi_v_list,
+                                                 const RefVector<ValueVector_t>& d2psi_v_list)
+{
+  LCAOrbitalSet::mw_evaluateVGL(spo_list, P_list, iat, psi_v_list, dpsi_v_list, d2psi_v_list);
+  for (int iw = 0; iw < spo_list.size(); iw++)
+    static_cast<LCAOrbitalSetWithCorrection&>(spo_list[iw].get())
+        .cusp.add_vector_vgl(P_list[iw], iat, psi_v_list[iw], dpsi_v_list[iw], d2psi_v_list[iw]);
+}
+
+void LCAOrbitalSetWithCorrection::mw_evaluateVGLandDetRatioGrads(const RefVector<SPOSet>& spo_list,
+                                                                 const RefVector<ParticleSet>& P_list,
+                                                                 int iat,
+                                                                 const std::vector<const ValueType*>& invRow_ptr_list,
+                                                                 VGLVector_t& phi_vgl_v,
+                                                                 std::vector<ValueType>& ratios,
+                                                                 std::vector<GradType>& grads)
+{
+  // the ratios need the corrected orbitals, use the walker by walker evaluateVGL
+  SPOSet::mw_evaluateVGLandDetRatioGrads(spo_list, P_list, iat, invRow_ptr_list, phi_vgl_v, ratios, grads);
+}
+
 void LCAOrbitalSetWithCorrection::evaluateVGH(const ParticleSet& P,
                                               int iat,
                                               ValueVector_t& psi,
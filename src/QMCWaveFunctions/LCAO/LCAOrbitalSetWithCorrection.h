@@ -50,6 +50,21 @@ struct LCAOrbitalSetWithCorrection : public LCAOrbitalSet
                    GradVector_t& dpsi,
                    ValueVector_t& d2psi) override;
 
+  void mw_evaluateVGL(const RefVector<SPOSet>& spo_list,
+                      const RefVector<ParticleSet>& P_list,
+                      int iat,
+                      const RefVector<ValueVector_t>& psi_v_list,
+                      const RefVector<GradVector_t>& dpsi_v_list,
+                      const RefVector<ValueVector_t>& d2psi_v_list) override;
+
+  void mw_evaluateVGLandDetRatioGrads(const RefVector<SPOSet>& spo_list,
+                                      const RefVector<ParticleSet>& P_list,
+                                      int iat,
+                                      const std::vector<const ValueType*>& invRow_ptr_list,
+                                      VGLVector_t& phi_vgl_v,
+                                      std::vector<ValueType>& ratios,
+                                      std::vector<GradType>& grads) override;
+
   void evaluateVGH(const ParticleSet& P,
                    int iat,
                    ValueVector_t& psi,
@@ -14,6 +14,7 @@
 #ifndef QMCPLUSPLUS_SOA_SPHERICALORBITAL_BASISSET_H
 #define QMCPLUSPLUS_SOA_SPHERICALORBITAL_BASISSET_H
 
+#include <algorithm>
 #include "config/stdlib/math.hpp"
 
 namespace qmcplusplus
@@ -127,6 +128,31 @@ struct SoaAtomicBasisSet
     Rmax = (rmax > 0) ? rmax : MultiRnl->rmax();
   }
 
+  /** return the radius beyond which all the basis functions of this center are negligible
+   * @param tol threshold on the radial functions and their derivatives
+   *
+   * The radial functions are scanned inward from Rmax. Up to the radius r, the angular part
+   * may scale as r^l, so the radial functions are compared to tol/r^l.
+   */
+  RealType getScreeningRadius(RealType tol)
+  {
+    constexpr RealType dr(0.05);
+    RealType* restrict phi   = tempS.data(0);
+    RealType* restrict dphi  = tempS.data(1);
+    RealType* restrict d2phi = tempS.data(2);
+    for (RealType r = Rmax - dr; r > dr; r -= dr)
+    {
+      MultiRnl->evaluate(r, phi, dphi, d2phi);
+      for (size_t nl = 0; nl < RnlID.size(); ++nl)
+      {
+        const RealType rl = std::pow(std::max(r, RealType(1)), RnlID[nl][1]);
+        if (rl * std::max(std::abs(phi[nl]), std::max(std::abs(dphi[nl]), std::abs(d2phi[nl]))) > tol)
+          return std::min(r + dr, Rmax);
+      }
+    }
+    return dr;
+  }
+
   ///set the current offset
   inline void setCenter(int c, int offset) {}
 
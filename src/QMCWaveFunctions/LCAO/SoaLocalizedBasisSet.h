@@ -68,6 +68,12 @@ struct SoaLocalizedBasisSet : public SoaBasisSetBase<ORBT>
    */
   aligned_vector<COT*> LOBasisSet;
 
+  /** screening radius of each unique center, empty if screening is disabled
+   *
+   * size of ScreeningRadii = number of unique centers
+   */
+  std::vector<RealType> ScreeningRadii;
+
   /** constructor
    * @param ions ionic system
    * @param els electronic system
@@ -174,6 +180,119 @@ struct SoaLocalizedBasisSet : public SoaBasisSetBase<ORBT>
   }
 
 
+  /** enable the screening of the centers
+   * @param tol threshold below which the basis functions are treated as zero
+   */
+  bool setScreening(QMCTraits::RealType tol)
+  {
+    ScreeningRadii.resize(LOBasisSet.size());
+    for (int i = 0; i < LOBasisSet.size(); ++i)
+      ScreeningRadii[i] = LOBasisSet[i]->getScreeningRadius(tol);
+    return true;
+  }
+
+  /** compute VGL of the centers within their screening radii
+   * @param P quantum particleset
+   * @param iat active particle
+   * @param vgl Matrix(5,BasisSetSize), only the blocks of the centers within their screening radii are written
+   * @param blocks ranges of the basis functions written, contiguous centers are merged
+   */
+  inline void evaluateVGLScreened(const ParticleSet& P, int iat, vgl_type& vgl, typename BaseType::BlockList& blocks)
+  {
+    const auto& IonID(ions_.GroupID);
+    const auto& coordR  = P.activeR(iat);
+    const auto& d_table = P.getDistTable(myTableIndex);
+    const auto& dist    = (P.activePtcl == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
+    const auto& displ   = (P.activePtcl == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
+
+    blocks.clear();
+    PosType Tv;
+    for (int c = 0; c < NumCenters; c++)
+    {
+      if (!ScreeningRadii.empty() && dist[c] >= ScreeningRadii[IonID[c]])
+        continue;
+      Tv[0] = (ions_.R[c][0] - coordR[0]) - displ[c][0];
+      Tv[1] = (ions_.R[c][1] - coordR[1]) - displ[c][1];
+      Tv[2] = (ions_.R[c][2] - coordR[2]) - displ[c][2];
+      LOBasisSet[IonID[c]]->evaluateVGL(P.Lattice, dist[c], displ[c], BasisOffset[c], vgl, Tv);
+      addBlock(blocks, c);
+    }
+  }
+
+  /** compute values of the centers within their screening radii
+   * @param P quantum particleset
+   * @param iat active particle
+   * @param vals values, only the blocks of the centers within their screening radii are written
+   * @param blocks ranges of the basis functions written, contiguous centers are merged
+   */
+  inline void evaluateVScreened(const ParticleSet& P,
+                                int iat,
+                                ORBT* restrict vals,
+                                typename BaseType::BlockList& blocks)
+  {
+    const auto& IonID(ions_.GroupID);
+    const auto& coordR  = P.activeR(iat);
+    const auto& d_table = P.getDistTable(myTableIndex);
+    const auto& dist    = (P.activePtcl == iat) ? d_table.getTempDists() : d_table.getDistRow(iat);
+    const auto& displ   = (P.activePtcl == iat) ? d_table.getTempDispls() : d_table.getDisplRow(iat);
+
+    blocks.clear();
+    PosType Tv;
+    for (int c = 0; c < NumCenters; c++)
+    {
+      if (!ScreeningRadii.empty() && dist[c] >= ScreeningRadii[IonID[c]])
+        continue;
+      Tv[0] = (ions_.R[c][0] - coordR[0]) - displ[c][0];
+      Tv[1] = (ions_.R[c][1] - coordR[1]) - displ[c][1];
+      Tv[2] = (ions_.R[c][2] - coordR[2]) - displ[c][2];
+      LOBasisSet[IonID[c]]->evaluateV(P.Lattice, dist[c], displ[c], vals + BasisOffset[c], Tv);
+      addBlock(blocks, c);
+    }
+  }
+
+  /** compute VGL of multiple walkers
+   * @param P_list quantum particlesets of the walkers
+   * @param iat active particle
+   * @param vgl_mw Matrix(5*nw,BasisSetSize), rows 5*iw to 5*iw+4 hold the VGL of walker iw
+   *
+   * The loop over the centers is outside the loop over the walkers, so the radial spline table
+   * and the angular part of a center stay in cache while all the walkers are evaluated.
+   * The radial functions are still evaluated per walker.
+   */
+  inline void mw_evaluateVGL(const RefVector<ParticleSet>& P_list, int iat, Matrix<ORBT>& vgl_mw)
+  {
+    const auto& IonID(ions_.GroupID);
+    const size_t nw = P_list.size();
+    std::vector<const PosType*> coordR_list(nw);
+    std::vector<const DistanceTableData::DistRow*> dist_list(nw);
+    std::vector<const DistanceTableData::DisplRow*> displ_list(nw);
+    std::vector<vgl_type> vgl_list;
+    vgl_list.reserve(nw);
+    for (size_t iw = 0; iw < nw; iw++)
+    {
+      const ParticleSet& P = P_list[iw];
+      const auto& d_table  = P.getDistTable(myTableIndex);
+      coordR_list[iw]      = &P.activeR(iat);
+      dist_list[iw]        = (P.activePtcl == iat) ? &d_table.getTempDists() : &d_table.getDistRow(iat);
+      displ_list[iw]       = (P.activePtcl == iat) ? &d_table.getTempDispls() : &d_table.getDisplRow(iat);
+      vgl_list.emplace_back(vgl_mw[iw * (OHMMS_DIM + 2)], BasisSetSize, vgl_mw.cols());
+    }
+
+    PosType Tv;
+    for (int c = 0; c < NumCenters; c++)
+      for (size_t iw = 0; iw < nw; iw++)
+      {
+        const auto& coordR = *coordR_list[iw];
+        const auto& dist   = *dist_list[iw];
+        const auto& displ  = *displ_list[iw];
+        Tv[0]              = (ions_.R[c][0] - coordR[0]) - displ[c][0];
+        Tv[1]              = (ions_.R[c][1] - coordR[1]) - displ[c][1];
+        Tv[2]              = (ions_.R[c][2] - coordR[2]) - displ[c][2];
+        LOBasisSet[IonID[c]]->evaluateVGL(P_list[iw].get().Lattice, dist[c], displ[c], BasisOffset[c], vgl_list[iw],
+                                          Tv);
+      }
+  }
+
   /** compute VGH 
    * @param P quantum particleset
    * @param iat active particle
@@ -338,6 +457,16 @@ struct SoaLocalizedBasisSet : public SoaBasisSetBase<ORBT>
    * @param aos a set of Centered Atomic Orbitals
    */
   void add(int icenter, COT* aos) { LOBasisSet[icenter] = aos; }
+
+private:
+  ///append the basis functions of center c to blocks
+  inline void addBlock(typename BaseType::BlockList& blocks, int c) const
+  {
+    if (!blocks.empty() && blocks.back().second == BasisOffset[c])
+      blocks.back().second = BasisOffset[c + 1];
+    else
+      blocks.emplace_back(BasisOffset[c], BasisOffset[c + 1]);
+  }
 };
 } // namespace qmcplusplus
 #endif
@@ -64,6 +64,7 @@ void RotatedSPOs::buildOptVariables(const std::vector<std::pair<int, int>>& rota
 
   // create active rotations
   m_act_rot_inds = rotations;
+  setup_active_subspace();
 
   // This will add the orbital rotation parameters to myVars
   // and will also read in initial parameter values supplied in input file
@@ -120,28 +121,74 @@ void RotatedSPOs::buildOptVariables(const std::vector<std::pair<int, int>>& rota
 #endif
 }
 
+void RotatedSPOs::setup_active_subspace()
+{
+  const size_t nmo = Phi->getOrbitalSetSize();
+  std::vector<int> orb_used(nmo, 0);
+  std::vector<int> col_of_orb(nmo, -1);
+  act_cols_.clear();
+  act_col_of_rot_.resize(m_act_rot_inds.size());
+  for (int i = 0; i < m_act_rot_inds.size(); i++)
+  {
+    const int p = m_act_rot_inds[i].first;
+    const int q = m_act_rot_inds[i].second;
+    orb_used[p] = orb_used[q] = 1;
+    if (col_of_orb[q] < 0)
+    {
+      col_of_orb[q] = act_cols_.size();
+      act_cols_.push_back(q);
+    }
+    act_col_of_rot_[i] = col_of_orb[q];
+  }
+  act_orbs_.clear();
+  for (int i = 0; i < nmo; i++)
+    if (orb_used[i])
+      act_orbs_.push_back(i);
+  rot_params_.clear();
+}
+
 void RotatedSPOs::apply_rotation(const std::vector<RealType>& param, bool use_stored_copy)
 {
   assert(param.size() == m_act_rot_inds.size());
 
-  const size_t nmo = Phi->getOrbitalSetSize();
-  ValueMatrix_t rot_mat(nmo, nmo);
-  rot_mat = ValueType(0);
-
-  // read out the parameters that define the rotation into an antisymmetric matrix
-  for (int i = 0; i < m_act_rot_inds.size(); i++)
+  // the exponential only depends on the parameters, reuse it when the optimizer repeats them
+  if (rot_params_.empty() || param != rot_params_)
   {
-    const int p      = m_act_rot_inds[i].first;
-    const int q      = m_act_rot_inds[i].second;
-    const RealType x = param[i];
+    const size_t nmo  = Phi->getOrbitalSetSize();
+    const size_t nact = act_orbs_.size();
+    std::vector<int> act_index(nmo, -1);
+    for (int i = 0; i < nact; i++)
+      act_index[act_orbs_[i]] = i;
+
+    // read out the parameters that define the rotation into an antisymmetric matrix
+    // restricted to the orbitals touched by the active rotations
+    ValueMatrix_t act_mat(nact, nact);
+    act_mat = ValueType(0);
+    for (int i = 0; i < m_act_rot_inds.size(); i++)
+    {
+      const int p      = act_index[m_act_rot_inds[i].first];
+      const int q      = act_index[m_act_rot_inds[i].second];
+      const RealType x = param[i];
 
-    rot_mat[q][p] = x;
-    rot_mat[p][q] = -x;
-  }
+      act_mat[q][p] = x;
+      act_mat[p][q] = -x;
+    }
 
-  exponentiate_antisym_matrix(rot_mat);
+    if (nact > 0)
+      exponentiate_antisym_matrix(act_mat);
+
+    // the rotation is the identity on the other orbitals
+    rot_mat_.resize(nmo, nmo);
+    rot_mat_ = ValueType(0);
+    for (int i = 0; i < nmo; i++)
+      rot_mat_[i][i] = ValueType(1);
+    for (int i = 0; i < nact; i++)
+      for (int j = 0; j < nact; j++)
+        rot_mat_[act_orbs_[i]][act_orbs_[j]] = act_mat[i][j];
+    rot_params_ = param;
+  }
 
-  Phi->applyRotation(rot_mat, use_stored_copy);
+  Phi->applyRotation(rot_mat_, use_stored_copy);
 }
 
 
@@ -208,15 +255,11 @@ void RotatedSPOs::exponentiate_antisym_matrix(ValueMatrix_t& mat)
     }
 }
 
-void RotatedSPOs::evaluateDerivatives(ParticleSet& P,
-                                      const opt_variables_type& optvars,
-                                      std::vector<ValueType>& dlogpsi,
-                                      std::vector<ValueType>& dhpsioverpsi,
-                                      const int& FirstIndex,
-                                      const int& LastIndex)
+void RotatedSPOs::evaluateRotationTables(SPOSet& phi, const ParticleSet& P, int FirstIndex, int LastIndex)
 {
-  const size_t nel = LastIndex - FirstIndex;
-  const size_t nmo = Phi->getOrbitalSetSize();
+  const size_t nel   = LastIndex - FirstIndex;
+  const size_t nmo   = phi.getOrbitalSetSize();
+  const size_t ncols = act_cols_.size();
 
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~PART1
   myG_temp.resize(nel);
@@ -225,24 +268,14 @@ void RotatedSPOs::evaluateDerivatives(ParticleSet& P,
   myL_J.resize(nel);
 
   myG_temp = 0;
-  myG_J    = 0;
   myL_temp = 0;
-  myL_J    = 0;
 
-  Bbar.resize(nel, nmo);
   psiM_inv.resize(nel, nel);
   psiM_all.resize(nel, nmo);
   dpsiM_all.resize(nel, nmo);
   d2psiM_all.resize(nel, nmo);
 
-  Bbar       = 0;
-  psiM_inv   = 0;
-  psiM_all   = 0;
-  dpsiM_all  = 0;
-  d2psiM_all = 0;
-
-
-  Phi->evaluate_notranspose(P, FirstIndex, LastIndex, psiM_all, dpsiM_all, d2psiM_all);
+  phi.evaluate_notranspose(P, FirstIndex, LastIndex, psiM_all, dpsiM_all, d2psiM_all);
 
   for (int i = 0; i < nel; i++)
     for (int j = 0; j < nel; j++)
@@ -251,17 +284,12 @@ void RotatedSPOs::evaluateDerivatives(ParticleSet& P,
   Invert(psiM_inv.data(), nel, nel);
 
   //current value of Gradient and Laplacian
-  // gradient components
-  for (int a = 0; a < nel; a++)
-    for (int i = 0; i < nel; i++)
-      for (int k = 0; k < 3; k++)
-        myG_temp[a][k] += psiM_inv(i, a) * dpsiM_all(a, i)[k];
-  // laplacian components
   for (int a = 0; a < nel; a++)
-  {
     for (int i = 0; i < nel; i++)
+    {
+      myG_temp[a] += psiM_inv(i, a) * dpsiM_all(a, i);
       myL_temp[a] += psiM_inv(i, a) * d2psiM_all(a, i);
-  }
+    }
 
   // calculation of myG_J which will be used to represent \frac{\nabla\psi_{J}}{\psi_{J}}
   // calculation of myL_J will be used to represent \frac{\nabla^2\psi_{J}}{\psi_{J}}
@@ -271,43 +299,89 @@ void RotatedSPOs::evaluateDerivatives(ParticleSet& P,
     myG_J[a] = (P.G[iat] - myG_temp[a]);
     myL_J[a] = (P.L[iat] + dot(P.G[iat], P.G[iat]) - myL_temp[a]);
   }
-  //possibly replace wit BLAS calls
-  for (int i = 0; i < nel; i++)
-    for (int j = 0; j < nmo; j++)
-      Bbar(i, j) = d2psiM_all(i, j) + 2 * dot(myG_J[i], dpsiM_all(i, j)) + myL_J[i] * psiM_all(i, j);
 
+  // Bbar is only needed for the occupied orbitals and the columns of the active rotations
+  auto bbar = [&](int i, int j) {
+    return d2psiM_all(i, j) + 2 * dot(myG_J[i], dpsiM_all(i, j)) + myL_J[i] * psiM_all(i, j);
+  };
+  Bbar.resize(nel, nel);
+  AB_act_.resize(nel, 2 * ncols);
+  for (int i = 0; i < nel; i++)
+  {
+    for (int j = 0; j < nel; j++)
+      Bbar(i, j) = bbar(i, j);
+    for (int c = 0; c < ncols; c++)
+    {
+      AB_act_(i, c)         = psiM_all(i, act_cols_[c]);
+      AB_act_(i, ncols + c) = bbar(i, act_cols_[c]);
+    }
+  }
 
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~PART2
-  const ValueType* const A(psiM_all.data());
-  const ValueType* const Ainv(psiM_inv.data());
-  const ValueType* const B(Bbar.data());
-  SPOSet::ValueMatrix_t T;
-  SPOSet::ValueMatrix_t Y1;
-  SPOSet::ValueMatrix_t Y2;
-  SPOSet::ValueMatrix_t Y3;
-  SPOSet::ValueMatrix_t Y4;
-  T.resize(nel, nmo);
-  Y1.resize(nel, nel);
-  Y2.resize(nel, nmo);
-  Y3.resize(nel, nmo);
-  Y4.resize(nel, nmo);
-
-
-  BLAS::gemm('N', 'N', nmo, nel, nel, ValueType(1.0), A, nmo, Ainv, nel, ValueType(0.0), T.data(), nmo);
-  BLAS::gemm('N', 'N', nel, nel, nel, ValueType(1.0), B, nmo, Ainv, nel, ValueType(0.0), Y1.data(), nel);
-  BLAS::gemm('N', 'N', nmo, nel, nel, ValueType(1.0), T.data(), nmo, Y1.data(), nel, ValueType(0.0), Y2.data(), nmo);
-  BLAS::gemm('N', 'N', nmo, nel, nel, ValueType(1.0), B, nmo, Ainv, nel, ValueType(0.0), Y3.data(), nmo);
+  // row-major products with the column-major BLAS, C = A * B is computed as C^T = B^T * A^T
+  // [T | Y3] = psiM_inv * [A | B] for the active columns
+  T_act_.resize(nel, 2 * ncols);
+  Y1_.resize(nel, nel);
+  if (ncols > 0)
+    BLAS::gemm('N', 'N', 2 * ncols, nel, nel, ValueType(1.0), AB_act_.data(), 2 * ncols, psiM_inv.data(), nel,
+               ValueType(0.0), T_act_.data(), 2 * ncols);
+  // Y1 = psiM_inv * Bbar of the occupied orbitals
+  BLAS::gemm('N', 'N', nel, nel, nel, ValueType(1.0), Bbar.data(), nel, psiM_inv.data(), nel, ValueType(0.0),
+             Y1_.data(), nel);
+  // Y4 = Y3 - Y1 * T overwrites Y3
+  if (ncols > 0)
+    BLAS::gemm('N', 'N', ncols, nel, nel, ValueType(-1.0), T_act_.data(), 2 * ncols, Y1_.data(), nel, ValueType(1.0),
+               T_act_.data() + ncols, 2 * ncols);
+}
 
-  //possibly replace with BLAS call
-  Y4 = Y3 - Y2;
+void RotatedSPOs::evaluateDerivatives(ParticleSet& P,
+                                      const opt_variables_type& optvars,
+                                      std::vector<ValueType>& dlogpsi,
+                                      std::vector<ValueType>& dhpsioverpsi,
+                                      const int& FirstIndex,
+                                      const int& LastIndex)
+{
+  evaluateRotationTables(*Phi, P, FirstIndex, LastIndex);
 
+  const size_t nel   = LastIndex - FirstIndex;
+  const size_t ncols = act_cols_.size();
   for (int i = 0; i < m_act_rot_inds.size(); i++)
   {
-    int kk              = myVars.where(i);
-    const int p         = m_act_rot_inds.at(i).first;
-    const int q         = m_act_rot_inds.at(i).second;
-    dlogpsi.at(kk)      = T(p, q);
-    dhpsioverpsi.at(kk) = ValueType(-0.5) * Y4(p, q);
+    int kk      = myVars.where(i);
+    const int p = m_act_rot_inds[i].first;
+    const int c = act_col_of_rot_[i];
+    // rotations among unoccupied orbitals of this determinant do not change it
+    if (kk < 0 || p >= nel)
+      continue;
+    dlogpsi[kk] += T_act_(p, c);
+    dhpsioverpsi[kk] += ValueType(-0.5) * T_act_(p, ncols + c);
+  }
+}
+
+void RotatedSPOs::mw_evaluateDerivatives(const RefVector<SPOSet>& spo_list,
+                                         const RefVector<ParticleSet>& P_list,
+                                         const opt_variables_type& optvars,
+                                         RecordArray<ValueType>& dlogpsi,
+                                         RecordArray<ValueType>& dhpsioverpsi,
+                                         int FirstIndex,
+                                         int LastIndex)
+{
+  const size_t nel   = LastIndex - FirstIndex;
+  const size_t ncols = act_cols_.size();
+  for (int iw = 0; iw < spo_list.size(); iw++)
+  {
+    // the orbitals of each walker with the scratch of the leader
+    evaluateRotationTables(*static_cast<RotatedSPOs&>(spo_list[iw].get()).Phi, P_list[iw], FirstIndex, LastIndex);
+    for (int i = 0; i < m_act_rot_inds.size(); i++)
+    {
+      int kk      = myVars.where(i);
+      const int p = m_act_rot_inds[i].first;
+      const int c = act_col_of_rot_[i];
+      if (kk < 0 || p >= nel)
+        continue;
+      dlogpsi.setValue(kk, iw, dlogpsi.getValue(kk, iw) + T_act_(p, c));
+      dhpsioverpsi.setValue(kk, iw, dhpsioverpsi.getValue(kk, iw) + ValueType(-0.5) * T_act_(p, ncols + c));
+    }
   }
 }
 
@@ -1045,6 +1119,7 @@ SPOSet* RotatedSPOs::makeClone() const
   myclone->m_act_rot_inds  = this->m_act_rot_inds;
   myclone->myVars          = this->myVars;
   myclone->myName          = this->myName;
+  myclone->setup_active_subspace();
   return myclone;
 }
 
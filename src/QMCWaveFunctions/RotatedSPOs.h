@@ -35,6 +35,9 @@ public:
   //helper function to apply_rotation
   void exponentiate_antisym_matrix(ValueMatrix_t& mat);
 
+  ///set up the orbitals and the table columns touched by m_act_rot_inds
+  void setup_active_subspace();
+
   //A particular SPOSet used for Orbitals
   SPOSet* Phi;
 
@@ -62,6 +65,24 @@ public:
   GradMatrix_t dpsiM_all;
   ValueMatrix_t d2psiM_all;
 
+  ///orbitals touched by m_act_rot_inds, the rotation is the identity on all the others
+  std::vector<int> act_orbs_;
+  ///orbitals q of m_act_rot_inds, the columns of the derivative tables
+  std::vector<int> act_cols_;
+  ///column of each active rotation in the derivative tables
+  std::vector<int> act_col_of_rot_;
+  ///parameters of rot_mat_, empty if rot_mat_ is not computed
+  std::vector<RealType> rot_params_;
+  ///the last rotation matrix, exp of the antisymmetric matrix of rot_params_
+  ValueMatrix_t rot_mat_;
+
+  /// [psiM_all | Bbar] restricted to act_cols_
+  ValueMatrix_t AB_act_;
+  /// psiM_inv * AB_act_, the first half becomes dlogpsi and the second half dhpsioverpsi
+  ValueMatrix_t T_act_;
+  /// psiM_inv * Bbar restricted to the occupied orbitals
+  ValueMatrix_t Y1_;
+
 
   // Single Slater creation
   void buildOptVariables(const size_t nel) override;
@@ -76,6 +97,30 @@ public:
                            const int& FirstIndex,
                            const int& LastIndex) override;
 
+  /** evaluate the derivatives of a batch of walkers
+   *
+   * The derivative tables are computed walker by walker with the scratch of this object
+   * and only for the orbitals of the active rotations.
+   */
+  void mw_evaluateDerivatives(const RefVector<SPOSet>& spo_list,
+                              const RefVector<ParticleSet>& P_list,
+                              const opt_variables_type& optvars,
+                              RecordArray<ValueType>& dlogpsi,
+                              RecordArray<ValueType>& dhpsioverpsi,
+                              int FirstIndex,
+                              int LastIndex) override;
+
+  /** compute the derivative tables T_act_ of a determinant for the active rotations
+   * @param phi orbitals of the walker
+   * @param P particle set
+   * @param FirstIndex first particle of the determinant
+   * @param LastIndex last particle of the determinant
+   *
+   * For an active rotation (p,q) with p occupied, T_act_(p, c) is \f$\partial_{pq}\log\Psi\f$ and
+   * T_act_(p, ncols + c) is -2 times the derivative of \f$H\Psi/\Psi\f$, where c = act_col_of_rot_ of the rotation.
+   */
+  void evaluateRotationTables(SPOSet& phi, const ParticleSet& P, int FirstIndex, int LastIndex);
+
   void evaluateDerivatives(ParticleSet& P,
                            const opt_variables_type& optvars,
                            std::vector<ValueType>& dlogpsi,
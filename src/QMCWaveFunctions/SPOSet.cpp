@@ -60,12 +60,15 @@ void SPOSet::mw_evaluateDetRatios(const RefVector<SPOSet>& spo_list,
                                   const std::vector<const ValueType*>& invRow_ptr_list,
                                   std::vector<std::vector<ValueType>>& ratios_list)
 {
+  // the SPOSet of a walker may be listed once per virtual particle set, keep its entries on one thread
+  const auto groups = groupIndicesByObject(spo_list);
 #pragma omp parallel for
-  for (int iw = 0; iw < spo_list.size(); iw++)
-  {
-    Vector<ValueType> invRow(const_cast<ValueType*>(invRow_ptr_list[iw]), psi_list[iw].get().size());
-    spo_list[iw].get().evaluateDetRatios(vp_list[iw], psi_list[iw], invRow, ratios_list[iw]);
-  }
+  for (int ig = 0; ig < groups.size(); ig++)
+    for (int iw : groups[ig])
+    {
+      Vector<ValueType> invRow(const_cast<ValueType*>(invRow_ptr_list[iw]), psi_list[iw].get().size());
+      spo_list[iw].get().evaluateDetRatios(vp_list[iw], psi_list[iw], invRow, ratios_list[iw]);
+    }
 }
 
 void SPOSet::mw_evaluateVGL(const RefVector<SPOSet>& spo_list,
@@ -80,6 +83,30 @@ void SPOSet::mw_evaluateVGL(const RefVector<SPOSet>& spo_list,
     spo_list[iw].get().evaluateVGL(P_list[iw], iat, psi_v_list[iw], dpsi_v_list[iw], d2psi_v_list[iw]);
 }
 
+void SPOSet::mw_evaluateDerivatives(const RefVector<SPOSet>& spo_list,
+                                    const RefVector<ParticleSet>& P_list,
+                                    const opt_variables_type& optvars,
+                                    RecordArray<ValueType>& dlogpsi,
+                                    RecordArray<ValueType>& dhpsioverpsi,
+                                    int FirstIndex,
+                                    int LastIndex)
+{
+  const int nparam = dlogpsi.nparam();
+  std::vector<ValueType> tmp_dlogpsi(nparam);
+  std::vector<ValueType> tmp_dhpsioverpsi(nparam);
+  for (int iw = 0; iw < spo_list.size(); iw++)
+  {
+    std::fill(tmp_dlogpsi.begin(), tmp_dlogpsi.end(), ValueType(0));
+    std::fill(tmp_dhpsioverpsi.begin(), tmp_dhpsioverpsi.end(), ValueType(0));
+    spo_list[iw].get().evaluateDerivatives(P_list[iw], optvars, tmp_dlogpsi, tmp_dhpsioverpsi, FirstIndex, LastIndex);
+    for (int i = 0; i < nparam; i++)
+    {
+      dlogpsi.setValue(i, iw, dlogpsi.getValue(i, iw) + tmp_dlogpsi[i]);
+      dhpsioverpsi.setValue(i, iw, dhpsioverpsi.getValue(i, iw) + tmp_dhpsioverpsi[i]);
+    }
+  }
+}
+
 void SPOSet::mw_evaluateVGLandDetRatioGrads(const RefVector<SPOSet>& spo_list,
                                             const RefVector<ParticleSet>& P_list,
                                             int iat,
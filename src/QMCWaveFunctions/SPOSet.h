@@ -24,6 +24,7 @@
 #include "Particle/ParticleSet.h"
 #include "Particle/VirtualParticleSet.h"
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
+#include "Containers/MinimalContainers/RecordArray.hpp"
 #ifdef QMC_CUDA
 #include "type_traits/CUDATypes.h"
 #endif
@@ -128,6 +129,23 @@ public:
                                    const int& FirstIndex,
                                    const int& LastIndex)
   {}
+
+  /** evaluate the derivatives with respect to the parameters of a batch of walkers
+   * @param spo_list the list of SPOSet pointers in a walker batch
+   * @param P_list the list of ParticleSet pointers in a walker batch
+   * @param optvars optimizable parameters
+   * @param dlogpsi derivatives of the log of the wavefunction, added to the entry of each walker
+   * @param dhpsioverpsi derivatives of the local kinetic energy, added to the entry of each walker
+   * @param FirstIndex first particle of the determinant
+   * @param LastIndex last particle of the determinant
+   */
+  virtual void mw_evaluateDerivatives(const RefVector<SPOSet>& spo_list,
+                                      const RefVector<ParticleSet>& P_list,
+                                      const opt_variables_type& optvars,
+                                      RecordArray<ValueType>& dlogpsi,
+                                      RecordArray<ValueType>& dhpsioverpsi,
+                                      int FirstIndex,
+                                      int LastIndex);
   /** Evaluate the derivative of the optimized orbitals with respect to the parameters
    *  this is used only for MSD, to be refined for better serving both single and multi SD
    */
@@ -215,6 +233,8 @@ public:
    * @param psi_list a list of values of the SPO, used as a scratch space if needed
    * @param invRow_ptr_list a list of pointers to the rows of inverse slater matrix corresponding to the particles moved virtually
    * @param ratios_list a list of returning determinant ratios
+   *
+   * The same SPOSet and scratch space may appear more than once in spo_list and psi_list.
    */
   virtual void mw_evaluateDetRatios(const RefVector<SPOSet>& spo_list,
                                     const RefVector<const VirtualParticleSet>& vp_list,
@@ -1131,27 +1131,29 @@ void TrialWaveFunction::flex_evaluateParameterDerivatives(const RefVector<TrialW
                                                           RecordArray<ValueType>& dlogpsi,
                                                           RecordArray<ValueType>& dhpsioverpsi)
 {
-  int nparam = dlogpsi.nparam();
+  if (wf_list.size() == 0)
+    return;
+  const int nparam = dlogpsi.nparam();
   for (int iw = 0; iw < wf_list.size(); iw++)
-  {
-    std::vector<ValueType> tmp_dlogpsi(nparam);
-    std::vector<ValueType> tmp_dhpsioverpsi(nparam);
-    TrialWaveFunction& twf = wf_list[iw];
-    for (int i = 0; i < twf.Z.size(); i++)
+    for (int i = 0; i < nparam; i++)
     {
-      if (twf.Z[i]->dPsi)
-        (twf.Z[i]->dPsi)->evaluateDerivatives(p_list[iw], optvars, tmp_dlogpsi, tmp_dhpsioverpsi);
-      else
-        twf.Z[i]->evaluateDerivatives(p_list[iw], optvars, tmp_dlogpsi, tmp_dhpsioverpsi);
+      dlogpsi.setValue(i, iw, 0.0);
+      dhpsioverpsi.setValue(i, iw, 0.0);
     }
 
-    RealType OneOverM = twf.getReciprocalMass();
+  auto& wf_leader = wf_list[0].get();
+  for (int i = 0; i < wf_leader.Z.size(); i++)
+  {
+    const auto wfc_list(extractWFCRefList(wf_list, i));
+    wf_leader.Z[i]->mw_evaluateParameterDerivatives(wfc_list, p_list, optvars, dlogpsi, dhpsioverpsi);
+  }
+
+  for (int iw = 0; iw < wf_list.size(); iw++)
+  {
+    //orbitals do not know about mass of particle.
+    const RealType OneOverM = wf_list[iw].get().getReciprocalMass();
     for (int i = 0; i < nparam; i++)
-    {
-      dlogpsi.setValue(i, iw, tmp_dlogpsi[i]);
-      //orbitals do not know about mass of particle.
-      dhpsioverpsi.setValue(i, iw, tmp_dhpsioverpsi[i] * OneOverM);
-    }
+      dhpsioverpsi.setValue(i, iw, dhpsioverpsi.getValue(i, iw) * OneOverM);
   }
 }
 
@@ -1200,6 +1202,22 @@ void TrialWaveFunction::evaluateRatiosAlltoOne(ParticleSet& P, std::vector<Value
   }
 }
 
+void TrialWaveFunction::evaluateRatiosAlltoMany(ParticleSet& P,
+                                                const std::vector<PosType>& positions,
+                                                Matrix<ValueType>& ratios)
+{
+  ScopedTimer local_timer(TWF_timers_[V_TIMER]);
+  std::fill(ratios.begin(), ratios.end(), 1.0);
+  Matrix<ValueType> t(ratios.rows(), ratios.cols());
+  for (int i = 0, ii = V_TIMER; i < Z.size(); ++i, ii += TIMER_SKIP)
+  {
+    ScopedTimer local_timer(WFC_timers_[ii]);
+    Z[i]->evaluateRatiosAlltoMany(P, positions, t);
+    for (int j = 0; j < t.size(); ++j)
+      ratios(j) *= t(j);
+  }
+}
+
 RefVector<WaveFunctionComponent> TrialWaveFunction::extractWFCRefList(const RefVector<TrialWaveFunction>& wf_list,
                                                                       int id)
 {
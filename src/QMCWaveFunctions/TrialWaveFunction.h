@@ -428,6 +428,13 @@ public:
 
   void evaluateRatiosAlltoOne(ParticleSet& P, std::vector<ValueType>& ratios);
 
+  /** evaluate the ratios of moving each particle to each of the positions
+   * @param P reference particleset
+   * @param positions positions of the virtual moves
+   * @param ratios ratios(k,i) of moving particle i to positions[k], resized by the caller
+   */
+  void evaluateRatiosAlltoMany(ParticleSet& P, const std::vector<PosType>& positions, Matrix<ValueType>& ratios);
+
   void setTwist(std::vector<RealType> t) { myTwist = t; }
   const std::vector<RealType> twist() { return myTwist; }
 
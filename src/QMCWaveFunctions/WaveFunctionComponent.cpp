@@ -95,6 +95,38 @@ void WaveFunctionComponent::evaluateDerivatives(ParticleSet& P,
     dPsi->evaluateDerivatives(P, active, dlogpsi, dhpsioverpsi);
 }
 
+void WaveFunctionComponent::mw_evaluateParameterDerivatives(const RefVector<WaveFunctionComponent>& WFC_list,
+                                                            const RefVector<ParticleSet>& P_list,
+                                                            const opt_variables_type& optvars,
+                                                            RecordArray<ValueType>& dlogpsi,
+                                                            RecordArray<ValueType>& dhpsioverpsi)
+{
+  if (dPsi)
+  {
+    RefVector<DiffWaveFunctionComponent> dpsi_list;
+    dpsi_list.reserve(WFC_list.size());
+    for (WaveFunctionComponent& wfc : WFC_list)
+      dpsi_list.push_back(*wfc.dPsi);
+    dPsi->mw_evaluateDerivatives(dpsi_list, P_list, optvars, dlogpsi, dhpsioverpsi);
+    return;
+  }
+
+  const int nparam = dlogpsi.nparam();
+  std::vector<ValueType> tmp_dlogpsi(nparam);
+  std::vector<ValueType> tmp_dhpsioverpsi(nparam);
+  for (int iw = 0; iw < WFC_list.size(); iw++)
+  {
+    std::fill(tmp_dlogpsi.begin(), tmp_dlogpsi.end(), ValueType(0));
+    std::fill(tmp_dhpsioverpsi.begin(), tmp_dhpsioverpsi.end(), ValueType(0));
+    WFC_list[iw].get().evaluateDerivatives(P_list[iw], optvars, tmp_dlogpsi, tmp_dhpsioverpsi);
+    for (int i = 0; i < nparam; i++)
+    {
+      dlogpsi.setValue(i, iw, dlogpsi.getValue(i, iw) + tmp_dlogpsi[i]);
+      dhpsioverpsi.setValue(i, iw, dhpsioverpsi.getValue(i, iw) + tmp_dhpsioverpsi[i]);
+    }
+  }
+}
+
 void WaveFunctionComponent::evaluateDerivativesWF(ParticleSet& P,
                                                   const opt_variables_type& active,
                                                   std::vector<ValueType>& dlogpsi)
@@ -120,6 +152,23 @@ void WaveFunctionComponent::evaluateRatiosAlltoOne(ParticleSet& P, std::vector<V
     ratios[i] = ratio(P, i);
 }
 
+void WaveFunctionComponent::evaluateRatiosAlltoMany(ParticleSet& P,
+                                                    const std::vector<PosType>& positions,
+                                                    Matrix<ValueType>& ratios)
+{
+  assert(positions.size() == ratios.rows());
+  assert(P.getTotalNum() == ratios.cols());
+  std::vector<ValueType> t(ratios.cols());
+  for (int k = 0; k < positions.size(); ++k)
+  {
+    // keep the entries not touched by evaluateRatiosAlltoOne, e.g. the particles of other determinants
+    std::copy(ratios[k], ratios[k] + ratios.cols(), t.begin());
+    P.makeVirtualMoves(positions[k]);
+    evaluateRatiosAlltoOne(P, t);
+    std::copy(t.begin(), t.end(), ratios[k]);
+  }
+}
+
 void WaveFunctionComponent::evaluateRatios(const VirtualParticleSet& P, std::vector<ValueType>& ratios)
 {
   std::ostringstream o;
@@ -26,6 +26,7 @@
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
 #include "Particle/MCWalkerConfiguration.h"
 #include "type_traits/template_types.hpp"
+#include "Containers/MinimalContainers/RecordArray.hpp"
 #ifdef QMC_CUDA
 #include "type_traits/CUDATypes.h"
 #endif
@@ -509,6 +510,21 @@ struct WaveFunctionComponent : public QMCTraits
                                    std::vector<ValueType>& dlogpsi,
                                    std::vector<ValueType>& dhpsioverpsi);
 
+  /** Compute derivatives of the wavefunction with respect to the optimizable parameters for a batch of walkers
+   *  @param WFC_list the list of WaveFunctionComponent pointers of the same component in a walker batch
+   *  @param P_list the list of ParticleSet pointers in a walker batch
+   *  @param optvars optimizable parameters
+   *  @param dlogpsi derivatives of the log of the wavefunction, added to the entry of each walker
+   *  @param dhpsioverpsi derivatives of the Laplacian of the wavefunction divided by the wavefunction,
+   *         added to the entry of each walker
+   *  Components with a DiffWaveFunctionComponent hand the batch to it.
+   */
+  virtual void mw_evaluateParameterDerivatives(const RefVector<WaveFunctionComponent>& WFC_list,
+                                               const RefVector<ParticleSet>& P_list,
+                                               const opt_variables_type& optvars,
+                                               RecordArray<ValueType>& dlogpsi,
+                                               RecordArray<ValueType>& dhpsioverpsi);
+
   /** Compute derivatives of rhe wavefunction with respect to the optimizable 
    *  parameters
    *  @param P particle set
@@ -550,6 +566,18 @@ struct WaveFunctionComponent : public QMCTraits
    */
   virtual void evaluateRatiosAlltoOne(ParticleSet& P, std::vector<ValueType>& ratios);
 
+  /** evaluate the ratios of a list of virtual moves with respect to all the particles
+   * @param P reference particleset
+   * @param positions positions of the virtual moves
+   * @param ratios ratios(k,i) of moving particle i to positions[k], resized by the caller
+   *
+   * The default implementation calls P.makeVirtualMoves and evaluateRatiosAlltoOne position by position.
+   * Components with a cheaper path for many positions, e.g. determinants with one GEMM, should overwrite it.
+   */
+  virtual void evaluateRatiosAlltoMany(ParticleSet& P,
+                                       const std::vector<PosType>& positions,
+                                       Matrix<ValueType>& ratios);
+
   /** evaluate ratios to evaluate the non-local PP
    * @param VP VirtualParticleSet
    * @param ratios ratios with new positions VP.R[k] the VP.refPtcl
@@ -560,14 +588,19 @@ struct WaveFunctionComponent : public QMCTraits
    * @param wfc_list the list of WaveFunctionComponent references of the same component in a walker batch
    * @param vp_list the list of VirtualParticleSet references in a walker batch
    * @param ratios of all the virtual moves of all the walkers
+   *
+   * The same component may appear more than once in wfc_list, once per virtual particle set of its walker.
+   * The entries of one component are evaluated by the same thread.
    */
   virtual void mw_evaluateRatios(const RefVector<WaveFunctionComponent>& wfc_list,
                                  const RefVector<const VirtualParticleSet>& vp_list,
                                  std::vector<std::vector<ValueType>>& ratios)
   {
+    const auto groups = groupIndicesByObject(wfc_list);
 #pragma omp parallel for
-    for (int iw = 0; iw < wfc_list.size(); iw++)
-      wfc_list[iw].get().evaluateRatios(vp_list[iw], ratios[iw]);
+    for (int ig = 0; ig < groups.size(); ig++)
+      for (int iw : groups[ig])
+        wfc_list[iw].get().evaluateRatios(vp_list[iw], ratios[iw]);
   }
 
   /** evaluate ratios to evaluate the non-local PP
@@ -19,6 +19,7 @@
 #include "Numerics/GaussianBasisSet.h"
 #include "QMCWaveFunctions/LCAO/LCAOrbitalBuilder.h"
 #include "QMCWaveFunctions/SPOSetBuilderFactory.h"
+#include "Particle/VirtualParticleSet.h"
 
 namespace qmcplusplus
 {
@@ -661,6 +662,117 @@ void test_HCN(bool transform)
     REQUIRE(dionpsi[0][4][2] == Approx(-7.300043903e-05));
     REQUIRE(dionpsi[0][5][2] == Approx(2.910525987e-06));
     REQUIRE(dionpsi[0][6][2] == Approx(-1.56074936e-05));
+
+    //==========batched evaluation of two walkers==========
+    elec.rejectMove(0);
+    ParticleSet elec_2(elec);
+    elec_2.R[1] = ParticleSet::SingleParticlePos_t(0.1, -0.3, 0.2);
+    elec_2.update();
+    std::unique_ptr<SPOSet> sposet_2(sposet->makeClone());
+
+    ParticleSet::SingleParticlePos_t disp_1(0.2, 0.1, -0.4);
+    ParticleSet::SingleParticlePos_t disp_2(-0.3, 0.5, 0.1);
+    elec.makeMove(1, disp_1);
+    elec_2.makeMove(1, disp_2);
+
+    SPOSet::ValueVector_t values_ref_1(7), values_ref_2(7), d2psi_ref_1(7), d2psi_ref_2(7);
+    SPOSet::GradVector_t dpsi_ref_1(7), dpsi_ref_2(7);
+    sposet->evaluateVGL(elec, 1, values_ref_1, dpsi_ref_1, d2psi_ref_1);
+    sposet_2->evaluateVGL(elec_2, 1, values_ref_2, dpsi_ref_2, d2psi_ref_2);
+
+    RefVector<SPOSet> spo_list{*sposet, *sposet_2};
+    RefVector<ParticleSet> P_list{elec, elec_2};
+    SPOSet::ValueVector_t values_1(7), values_2(7), d2psi_1(7), d2psi_2(7);
+    SPOSet::GradVector_t dpsi_1(7), dpsi_2(7);
+    RefVector<SPOSet::ValueVector_t> values_list{values_1, values_2};
+    RefVector<SPOSet::GradVector_t> dpsi_list{dpsi_1, dpsi_2};
+    RefVector<SPOSet::ValueVector_t> d2psi_list{d2psi_1, d2psi_2};
+    sposet->mw_evaluateVGL(spo_list, P_list, 1, values_list, dpsi_list, d2psi_list);
+
+    for (int i = 0; i < 7; i++)
+    {
+      CHECK(values_1[i] == Approx(values_ref_1[i]));
+      CHECK(values_2[i] == Approx(values_ref_2[i]));
+      CHECK(d2psi_1[i] == Approx(d2psi_ref_1[i]));
+      CHECK(d2psi_2[i] == Approx(d2psi_ref_2[i]));
+      for (int idim = 0; idim < 3; idim++)
+      {
+        CHECK(dpsi_1[i][idim] == Approx(dpsi_ref_1[i][idim]));
+        CHECK(dpsi_2[i][idim] == Approx(dpsi_ref_2[i][idim]));
+      }
+    }
+
+    // arbitrary rows of the inverse matrix
+    std::vector<SPOSet::ValueType> invrow_1{0.1, -0.2, 0.3, 0.4, -0.5, 0.6, 0.7};
+    std::vector<SPOSet::ValueType> invrow_2{-0.7, 0.1, 0.2, -0.3, 0.5, 0.4, 0.2};
+    std::vector<const SPOSet::ValueType*> invrow_ptr_list{invrow_1.data(), invrow_2.data()};
+    SPOSet::VGLVector_t phi_vgl_v(14);
+    std::vector<SPOSet::ValueType> ratios(2);
+    std::vector<SPOSet::GradType> grads(2);
+    sposet->mw_evaluateVGLandDetRatioGrads(spo_list, P_list, 1, invrow_ptr_list, phi_vgl_v, ratios, grads);
+
+    SPOSet::ValueType ratio_ref_1(0), ratio_ref_2(0);
+    SPOSet::GradType grad_ref_1, grad_ref_2;
+    for (int i = 0; i < 7; i++)
+    {
+      ratio_ref_1 += invrow_1[i] * values_ref_1[i];
+      ratio_ref_2 += invrow_2[i] * values_ref_2[i];
+      grad_ref_1 += invrow_1[i] * dpsi_ref_1[i];
+      grad_ref_2 += invrow_2[i] * dpsi_ref_2[i];
+    }
+    CHECK(ratios[0] == Approx(ratio_ref_1));
+    CHECK(ratios[1] == Approx(ratio_ref_2));
+    for (int idim = 0; idim < 3; idim++)
+    {
+      CHECK(grads[0][idim] == Approx(grad_ref_1[idim] / ratio_ref_1));
+      CHECK(grads[1][idim] == Approx(grad_ref_2[idim] / ratio_ref_2));
+    }
+    CHECK(phi_vgl_v.data(0)[7 + 3] == Approx(values_ref_2[3]));
+    CHECK(phi_vgl_v.data(4)[7 + 3] == Approx(d2psi_ref_2[3]));
+
+    elec.rejectMove(1);
+    elec_2.rejectMove(1);
+
+    VirtualParticleSet VP_1(elec, 2), VP_2(elec_2, 2);
+    std::vector<ParticleSet::SingleParticlePos_t> deltaV_1{disp_1, disp_2};
+    std::vector<ParticleSet::SingleParticlePos_t> deltaV_2{disp_2, -disp_1};
+    VP_1.makeMoves(1, elec.R[1], deltaV_1);
+    VP_2.makeMoves(1, elec_2.R[1], deltaV_2);
+    SPOSet::ValueVector_t invrow_v_1(invrow_1.data(), 7), invrow_v_2(invrow_2.data(), 7);
+    std::vector<SPOSet::ValueType> ratios_ref_1(2), ratios_ref_2(2);
+    sposet->evaluateDetRatios(VP_1, values_1, invrow_v_1, ratios_ref_1);
+    sposet_2->evaluateDetRatios(VP_2, values_2, invrow_v_2, ratios_ref_2);
+
+    RefVector<const VirtualParticleSet> vp_list{VP_1, VP_2};
+    std::vector<std::vector<SPOSet::ValueType>> ratios_list(2, std::vector<SPOSet::ValueType>(2));
+    sposet->mw_evaluateDetRatios(spo_list, vp_list, values_list, invrow_ptr_list, ratios_list);
+    for (int j = 0; j < 2; j++)
+    {
+      CHECK(ratios_list[0][j] == Approx(ratios_ref_1[j]));
+      CHECK(ratios_list[1][j] == Approx(ratios_ref_2[j]));
+    }
+
+    //==========screening of the basis set centers==========
+    std::unique_ptr<LCAOrbitalSet> sposet_screened(dynamic_cast<LCAOrbitalSet*>(sposet->makeClone()));
+    REQUIRE(sposet_screened);
+    sposet_screened->enableScreening(1e-12);
+    std::vector<ParticleSet::SingleParticlePos_t> screening_pos{{0.1, 0.2, 0.3}, {6.0, 0.0, 1.0}, {0.0, 1.0, 11.0}};
+    for (const auto& pos : screening_pos)
+    {
+      elec.makeMove(0, pos - elec.R[0]);
+      sposet->evaluateVGL(elec, 0, values_ref_1, dpsi_ref_1, d2psi_ref_1);
+      sposet_screened->evaluateVGL(elec, 0, values_1, dpsi_1, d2psi_1);
+      sposet_screened->evaluateValue(elec, 0, values_2);
+      for (int i = 0; i < 7; i++)
+      {
+        CHECK(values_1[i] == Approx(values_ref_1[i]).margin(1e-9));
+        CHECK(values_2[i] == Approx(values_ref_1[i]).margin(1e-9));
+        CHECK(d2psi_1[i] == Approx(d2psi_ref_1[i]).margin(1e-9));
+        for (int idim = 0; idim < 3; idim++)
+          CHECK(dpsi_1[i][idim] == Approx(dpsi_ref_1[i][idim]).margin(1e-9));
+      }
+      elec.rejectMove(0);
+    }
   }
 }
 
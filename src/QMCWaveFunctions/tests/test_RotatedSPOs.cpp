@@ -0,0 +1,256 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "OhmmsPETE/OhmmsMatrix.h"
+#include "Particle/ParticleSet.h"
+#include "QMCWaveFunctions/RotatedSPOs.h"
+
+#include <cmath>
+#include <memory>
+
+namespace qmcplusplus
+{
+#if !defined(QMC_COMPLEX)
+using RealType  = QMCTraits::RealType;
+using ValueType = QMCTraits::ValueType;
+using PosType   = QMCTraits::PosType;
+
+/** orbitals made of linear combinations of gaussians, rotated like LCAOrbitalSet
+ */
+class GaussianSPO : public SPOSet
+{
+public:
+  GaussianSPO(const std::vector<PosType>& centers, const std::vector<RealType>& exponents)
+      : centers_(centers), exponents_(exponents)
+  {
+    className      = "GaussianSPO";
+    OrbitalSetSize = centers_.size();
+    C.resize(OrbitalSetSize, OrbitalSetSize);
+    C = ValueType(0);
+    for (int i = 0; i < OrbitalSetSize; i++)
+      C(i, i) = ValueType(1);
+  }
+
+  SPOSet* makeClone() const override { return new GaussianSPO(*this); }
+
+  void resetParameters(const opt_variables_type& optVariables) override {}
+  void setOrbitalSetSize(int norbs) override {}
+
+  void storeParamsBeforeRotation() override { C_copy = C; }
+
+  void applyRotation(const ValueMatrix_t& rot_mat, bool use_stored_copy) override
+  {
+    if (!use_stored_copy)
+      C_copy = C;
+    // orbital i becomes sum_k rot_mat(k, i) orbital k
+    const int nmo = OrbitalSetSize;
+    for (int i = 0; i < nmo; i++)
+      for (int b = 0; b < nmo; b++)
+      {
+        C(i, b) = ValueType(0);
+        for (int k = 0; k < nmo; k++)
+          C(i, b) += rot_mat(k, i) * C_copy(k, b);
+      }
+  }
+
+  void evaluateValue(const ParticleSet& P, int iat, ValueVector_t& psi) override
+  {
+    GradVector_t dpsi(OrbitalSetSize);
+    ValueVector_t d2psi(OrbitalSetSize);
+    evaluateVGL(P, iat, psi, dpsi, d2psi);
+  }
+
+  void evaluateVGL(const ParticleSet& P, int iat, ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi) override
+  {
+    const int nmo = OrbitalSetSize;
+    for (int i = 0; i < nmo; i++)
+    {
+      psi[i]   = ValueType(0);
+      dpsi[i]  = GradType(0);
+      d2psi[i] = ValueType(0);
+      for (int b = 0; b < nmo; b++)
+      {
+        const PosType dr   = P.R[iat] - centers_[b];
+        const RealType a   = exponents_[b];
+        const RealType r2  = dot(dr, dr);
+        const RealType val = std::exp(-a * r2);
+        psi[i] += C(i, b) * val;
+        dpsi[i] += C(i, b) * (-2 * a * val) * dr;
+        d2psi[i] += C(i, b) * (4 * a * a * r2 - 6 * a) * val;
+      }
+    }
+  }
+
+  void evaluate_notranspose(const ParticleSet& P,
+                            int first,
+                            int last,
+                            ValueMatrix_t& logdet,
+                            GradMatrix_t& dlogdet,
+                            ValueMatrix_t& d2logdet) override
+  {
+    for (int iat = first, i = 0; iat < last; iat++, i++)
+    {
+      ValueVector_t v(logdet[i], OrbitalSetSize);
+      GradVector_t g(dlogdet[i], OrbitalSetSize);
+      ValueVector_t l(d2logdet[i], OrbitalSetSize);
+      evaluateVGL(P, iat, v, g, l);
+    }
+  }
+
+private:
+  std::vector<PosType> centers_;
+  std::vector<RealType> exponents_;
+  ValueMatrix_t C, C_copy;
+};
+
+/** log of the 2x2 determinant, its kinetic energy and its G and L
+ */
+void evaluateDet2(ParticleSet& P, SPOSet& phi, RealType& logdet, RealType& kinetic)
+{
+  const int nmo = phi.getOrbitalSetSize();
+  SPOSet::ValueMatrix_t psi(2, nmo), d2psi(2, nmo);
+  SPOSet::GradMatrix_t dpsi(2, nmo);
+  phi.evaluate_notranspose(P, 0, 2, psi, dpsi, d2psi);
+  const RealType det = psi(0, 0) * psi(1, 1) - psi(0, 1) * psi(1, 0);
+  // inverse of the matrix with electrons as rows and orbitals as columns
+  RealType inv[2][2] = {{psi(1, 1) / det, -psi(0, 1) / det}, {-psi(1, 0) / det, psi(0, 0) / det}};
+  logdet  = std::log(std::abs(det));
+  kinetic = 0;
+  for (int i = 0; i < 2; i++)
+  {
+    PosType g;
+    RealType lap(0);
+    for (int j = 0; j < 2; j++)
+    {
+      g += inv[j][i] * dpsi(i, j);
+      lap += inv[j][i] * d2psi(i, j);
+    }
+    kinetic -= 0.5 * lap;
+    P.G[i] = g;
+    P.L[i] = lap - dot(g, g);
+  }
+}
+
+TEST_CASE("RotatedSPOs derivatives", "[wavefunction]")
+{
+  ParticleSet elec;
+  elec.setName("e");
+  elec.create(std::vector<int>{2});
+  elec.R[0] = PosType(0.1, -0.3, 0.2);
+  elec.R[1] = PosType(-0.4, 0.2, 0.5);
+
+  ParticleSet elec2(elec);
+  elec2.R[0] = PosType(0.3, 0.2, -0.1);
+  elec2.R[1] = PosType(0.5, -0.6, 0.1);
+
+  const std::vector<PosType> centers{PosType(0.0, 0.0, 0.0), PosType(0.5, 0.0, 0.0), PosType(0.0, 0.4, 0.3),
+                                     PosType(-0.2, -0.3, 0.6)};
+  const std::vector<RealType> exponents{1.0, 0.8, 1.3, 0.6};
+
+  RotatedSPOs rot(new GaussianSPO(centers, exponents));
+  // two occupied and two virtual orbitals
+  rot.buildOptVariables(2);
+  REQUIRE(rot.m_act_rot_inds.size() == 4);
+
+  opt_variables_type start;
+  rot.checkInVariables(start);
+  start.resetIndex();
+  rot.checkOutVariables(start);
+  const int nparam = start.size();
+
+  std::unique_ptr<SPOSet> rot2(rot.makeClone());
+  rot2->checkOutVariables(start);
+
+  // rotate the orbitals away from the initial ones, like a previous optimizer step
+  for (int i = 0; i < nparam; i++)
+    start[i] = 0.05 * (i + 1);
+  rot.resetParameters(start);
+  rot2->resetParameters(start);
+
+  // the derivatives are taken with respect to a rotation of the current orbitals
+  opt_variables_type active;
+  rot.checkInVariables(active);
+  active.resetIndex();
+  rot.checkOutVariables(active);
+  rot2->checkOutVariables(active);
+
+  RealType logdet, kinetic;
+  evaluateDet2(elec, rot, logdet, kinetic);
+  evaluateDet2(elec2, *rot2, logdet, kinetic);
+
+  std::vector<ValueType> dlogpsi(nparam), dhpsioverpsi(nparam);
+  rot.evaluateDerivatives(elec, active, dlogpsi, dhpsioverpsi, 0, 2);
+
+  // finite differences of log(det) and of the kinetic energy
+  const RealType h = 1e-4;
+  for (int ip = 0; ip < nparam; ip++)
+  {
+    RealType logdet_p, kinetic_p, logdet_m, kinetic_m;
+    const RealType x = active[ip];
+    active[ip]       = x + h;
+    rot.resetParameters(active);
+    evaluateDet2(elec, rot, logdet_p, kinetic_p);
+    active[ip] = x - h;
+    rot.resetParameters(active);
+    evaluateDet2(elec, rot, logdet_m, kinetic_m);
+    active[ip] = x;
+    rot.resetParameters(active);
+    CHECK(dlogpsi[ip] == Approx((logdet_p - logdet_m) / (2 * h)).epsilon(1e-5));
+    CHECK(dhpsioverpsi[ip] == Approx((kinetic_p - kinetic_m) / (2 * h)).epsilon(1e-5));
+  }
+  evaluateDet2(elec, rot, logdet, kinetic);
+
+  // the batched evaluation agrees with the walker by walker one
+  RefVector<SPOSet> spo_list{rot, *rot2};
+  RefVector<ParticleSet> p_list{elec, elec2};
+  RecordArray<ValueType> dlogpsi_mw(nparam, 2), dhpsioverpsi_mw(nparam, 2);
+  rot.mw_evaluateDerivatives(spo_list, p_list, active, dlogpsi_mw, dhpsioverpsi_mw, 0, 2);
+  for (int iw = 0; iw < 2; iw++)
+  {
+    std::vector<ValueType> dlogpsi_ref(nparam), dhpsioverpsi_ref(nparam);
+    spo_list[iw].get().evaluateDerivatives(p_list[iw], active, dlogpsi_ref, dhpsioverpsi_ref, 0, 2);
+    for (int ip = 0; ip < nparam; ip++)
+    {
+      CHECK(dlogpsi_mw.getValue(ip, iw) == Approx(dlogpsi_ref[ip]));
+      CHECK(dhpsioverpsi_mw.getValue(ip, iw) == Approx(dhpsioverpsi_ref[ip]));
+    }
+  }
+}
+
+TEST_CASE("RotatedSPOs active rotation subset", "[wavefunction]")
+{
+  const std::vector<PosType> centers(4, PosType(0.0, 0.0, 0.0));
+  const std::vector<RealType> exponents(4, 1.0);
+  GaussianSPO* phi = new GaussianSPO(centers, exponents);
+  RotatedSPOs rot(phi);
+  // a single rotation between orbitals 0 and 2
+  rot.buildOptVariables(std::vector<std::pair<int, int>>{{0, 2}});
+
+  const RealType x = 0.3;
+  rot.apply_rotation(std::vector<RealType>{x}, true);
+
+  // only the (0,2) block is rotated, orbitals 1 and 3 are left alone
+  SPOSet::ValueMatrix_t expected(4, 4);
+  expected       = ValueType(0);
+  expected(1, 1) = expected(3, 3) = ValueType(1);
+  expected(0, 0) = expected(2, 2) = std::cos(x);
+  expected(2, 0)                  = std::sin(x);
+  expected(0, 2)                  = -std::sin(x);
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++)
+      CHECK(rot.rot_mat_(i, j) == Approx(expected(i, j)).margin(1e-12));
+}
+#endif
+
+} // namespace qmcplusplus
@@ -199,6 +199,19 @@ TEST_CASE("TrialWaveFunction_diamondC_1x1x1", "[wavefunction]")
   REQUIRE(psi.getLogPsi() == Approx(-0.63650297977845492));
 #endif
 
+  // ratios of moving every electron to several positions agree with one position at a time
+  std::vector<PosType> sample_pos{{0.5, 0.1, 0.3}, {2.0, 1.5, 0.2}, {1.1, 2.9, 3.0}};
+  Matrix<ValueType> ratios_many(sample_pos.size(), elec_.getTotalNum());
+  psi.evaluateRatiosAlltoMany(elec_, sample_pos, ratios_many);
+  std::vector<ValueType> ratios_one(elec_.getTotalNum());
+  for (int k = 0; k < sample_pos.size(); k++)
+  {
+    elec_.makeVirtualMoves(sample_pos[k]);
+    psi.evaluateRatiosAlltoOne(elec_, ratios_one);
+    for (int i = 0; i < elec_.getTotalNum(); i++)
+      REQUIRE(ratios_many(k, i) == ValueApprox(ratios_one[i]));
+  }
+
   // testing batched interfaces
   std::vector<ParticleSet*> P_list(2, nullptr);
   P_list[0] = &elec_;
@@ -557,4 +557,290 @@ TEST_CASE("BSpline builder Jastrow J1", "[wavefunction]")
     REQUIRE(Vals2[i].ddu == Approx(ddv));
   }
 }
+
+TEST_CASE("BSpline builder Jastrow J2 and J1 multi-walker", "[wavefunction]")
+{
+  using PosType = QMCTraits::PosType;
+  Communicate* c;
+  c = OHMMS::Controller;
+
+  ParticleSet ions_;
+  ParticleSet elec_;
+
+  ions_.setName("ion");
+  ions_.create(1);
+  ions_.R[0][0]              = 2.0;
+  ions_.R[0][1]              = 0.0;
+  ions_.R[0][2]              = 0.0;
+  SpeciesSet& ispecies       = ions_.getSpeciesSet();
+  int CIdx                   = ispecies.addSpecies("C");
+  int ichargeIdx             = ispecies.addAttribute("charge");
+  ispecies(ichargeIdx, CIdx) = 4;
+  ions_.resetGroups();
+  ions_.update();
+
+  elec_.setName("elec");
+  std::vector<int> ud(2);
+  ud[0] = ud[1] = 2;
+  elec_.create(ud);
+  elec_.R[0] = PosType(1.00, 0.0, 0.0);
+  elec_.R[1] = PosType(0.0, 0.0, 0.0);
+  elec_.R[2] = PosType(0.2, 0.5, -0.3);
+  elec_.R[3] = PosType(-0.6, 0.1, 0.4);
+
+  SpeciesSet& tspecies         = elec_.getSpeciesSet();
+  int upIdx                    = tspecies.addSpecies("u");
+  int downIdx                  = tspecies.addSpecies("d");
+  int chargeIdx                = tspecies.addAttribute("charge");
+  tspecies(chargeIdx, upIdx)   = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+  elec_.resetGroups();
+
+  const char* particles = "<tmp> \
+<jastrow name=\"J2\" type=\"Two-Body\" function=\"Bspline\"> \
+   <correlation rcut=\"10\" size=\"10\" speciesA=\"u\" speciesB=\"u\"> \
+      <coefficients id=\"uu\" type=\"Array\"> 0.02904699284 -0.1004179 -0.1752703883 -0.2232576505 -0.2728029201 -0.3253286875 -0.3624525145 -0.3958223107 -0.4268582166 -0.4394531176</coefficients> \
+    </correlation> \
+   <correlation rcut=\"10\" size=\"10\" speciesA=\"u\" speciesB=\"d\"> \
+      <coefficients id=\"ud\" type=\"Array\"> 0.02904699284 -0.1004179 -0.1752703883 -0.2232576505 -0.2728029201 -0.3253286875 -0.3624525145 -0.3958223107 -0.4268582166 -0.4394531176</coefficients> \
+    </correlation> \
+</jastrow> \
+<jastrow type=\"One-Body\" name=\"J1\" function=\"bspline\" source=\"ion\"> \
+   <correlation elementType=\"C\" rcut=\"10\" size=\"8\" cusp=\"0.0\"> \
+      <coefficients id=\"eC\" type=\"Array\"> -0.2032153051 -0.1625595974 -0.143124599 -0.1216434956 -0.09919771951 -0.07111729038 -0.04445345869 -0.02135082917 </coefficients> \
+   </correlation> \
+</jastrow> \
+</tmp> \
+";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(particles);
+  REQUIRE(okay);
+
+  xmlNodePtr root = doc.getRoot();
+  xmlNodePtr jas2 = xmlFirstElementChild(root);
+  xmlNodePtr jas1 = xmlNextElementSibling(jas2);
+
+  RadialJastrowBuilder jastrow2(c, elec_);
+  std::unique_ptr<WaveFunctionComponent> j2(jastrow2.buildComponent(jas2));
+  REQUIRE(j2);
+  RadialJastrowBuilder jastrow1(c, elec_, ions_);
+  std::unique_ptr<WaveFunctionComponent> j1(jastrow1.buildComponent(jas1));
+  REQUIRE(j1);
+
+  ParticleSet elec_clone(elec_);
+  elec_clone.R[1] = PosType(0.3, -0.2, 0.1);
+  std::unique_ptr<WaveFunctionComponent> j2_clone(j2->makeClone(elec_clone));
+  std::unique_ptr<WaveFunctionComponent> j1_clone(j1->makeClone(elec_clone));
+
+  // single walker references
+  ParticleSet elec_ref(elec_);
+  ParticleSet elec_clone_ref(elec_clone);
+  std::unique_ptr<WaveFunctionComponent> j2_ref(j2->makeClone(elec_ref));
+  std::unique_ptr<WaveFunctionComponent> j2_clone_ref(j2->makeClone(elec_clone_ref));
+  std::unique_ptr<WaveFunctionComponent> j1_ref(j1->makeClone(elec_ref));
+  std::unique_ptr<WaveFunctionComponent> j1_clone_ref(j1->makeClone(elec_clone_ref));
+
+  RefVector<ParticleSet> p_list{elec_, elec_clone};
+  RefVector<ParticleSet> p_ref_list{elec_ref, elec_clone_ref};
+  std::vector<RefVector<WaveFunctionComponent>> wfc_lists{{*j2, *j2_clone}, {*j1, *j1_clone}};
+  std::vector<RefVector<WaveFunctionComponent>> wfc_ref_lists{{*j2_ref, *j2_clone_ref}, {*j1_ref, *j1_clone_ref}};
+
+  for (int iw = 0; iw < 2; iw++)
+  {
+    p_list[iw].get().update();
+    p_ref_list[iw].get().update();
+    for (int icomp = 0; icomp < 2; icomp++)
+    {
+      wfc_lists[icomp][iw].get().evaluateLog(p_list[iw], p_list[iw].get().G, p_list[iw].get().L);
+      wfc_ref_lists[icomp][iw].get().evaluateLog(p_ref_list[iw], p_ref_list[iw].get().G, p_ref_list[iw].get().L);
+    }
+  }
+
+  const std::vector<PosType> displs{PosType(0.1, 0.2, 0.3), PosType(-0.2, 0.1, 0.05)};
+  for (int iat = 0; iat < elec_.getTotalNum(); iat++)
+  {
+    ParticleSet::flex_makeMove(p_list, iat, displs);
+    for (int iw = 0; iw < 2; iw++)
+      p_ref_list[iw].get().makeMove(iat, displs[iw]);
+
+    // accept the move on the first walker and reject it on the second one
+    std::vector<bool> isAccepted{true, false};
+    for (int icomp = 0; icomp < 2; icomp++)
+    {
+      auto& wfc_list     = wfc_lists[icomp];
+      auto& wfc_ref_list = wfc_ref_lists[icomp];
+
+      std::vector<PsiValueType> ratios(2);
+      wfc_list[0].get().mw_calcRatio(wfc_list, p_list, iat, ratios);
+      for (int iw = 0; iw < 2; iw++)
+        REQUIRE(std::real(ratios[iw]) == Approx(std::real(wfc_ref_list[iw].get().ratio(p_ref_list[iw], iat))));
+
+      std::vector<QMCTraits::GradType> grads(2, QMCTraits::GradType(0.0));
+      wfc_list[0].get().mw_ratioGrad(wfc_list, p_list, iat, ratios, grads);
+      for (int iw = 0; iw < 2; iw++)
+      {
+        QMCTraits::GradType grad_ref(0.0);
+        PsiValueType ratio_ref = wfc_ref_list[iw].get().ratioGrad(p_ref_list[iw], iat, grad_ref);
+        REQUIRE(std::real(ratios[iw]) == Approx(std::real(ratio_ref)));
+        for (int idim = 0; idim < OHMMS_DIM; idim++)
+          REQUIRE(std::real(grads[iw][idim]) == Approx(std::real(grad_ref[idim])));
+      }
+
+      wfc_list[0].get().mw_accept_rejectMove(wfc_list, p_list, iat, isAccepted);
+      wfc_ref_list[0].get().acceptMove(p_ref_list[0], iat);
+      wfc_ref_list[1].get().restore(iat);
+    }
+    elec_.acceptMove(iat);
+    elec_clone.rejectMove(iat);
+    elec_ref.acceptMove(iat);
+    elec_clone_ref.rejectMove(iat);
+  }
+
+  // incrementally updated values agree with the ones from scratch
+  auto check_GL = [](auto& wfc, WaveFunctionComponent& wfc_ref, ParticleSet& pset) {
+    REQUIRE(std::real(wfc.LogValue) == Approx(std::real(wfc_ref.LogValue)));
+    pset.G = 0.0;
+    pset.L = 0.0;
+    wfc.evaluateGL(pset, pset.G, pset.L, false);
+    const auto G_updated = pset.G;
+    const auto L_updated = pset.L;
+    pset.G               = 0.0;
+    pset.L               = 0.0;
+    wfc.evaluateLog(pset, pset.G, pset.L);
+    REQUIRE(std::real(wfc.LogValue) == Approx(std::real(wfc_ref.LogValue)));
+    for (int iat = 0; iat < pset.getTotalNum(); iat++)
+    {
+      REQUIRE(std::real(L_updated[iat]) == Approx(std::real(pset.L[iat])));
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        REQUIRE(std::real(G_updated[iat][idim]) == Approx(std::real(pset.G[iat][idim])));
+    }
+  };
+
+  using J2Type = J2OrbitalSoA<BsplineFunctor<RealType>>;
+  using J1Type = J1OrbitalSoA<BsplineFunctor<RealType>>;
+  for (int iw = 0; iw < 2; iw++)
+  {
+    check_GL(static_cast<J2Type&>(wfc_lists[0][iw].get()), wfc_ref_lists[0][iw], p_list[iw]);
+    check_GL(static_cast<J1Type&>(wfc_lists[1][iw].get()), wfc_ref_lists[1][iw], p_list[iw]);
+  }
+}
+
+TEST_CASE("BSpline builder Jastrow J2 and J1 multi-walker parameter derivatives", "[wavefunction]")
+{
+  using PosType   = QMCTraits::PosType;
+  using ValueType = QMCTraits::ValueType;
+  Communicate* c;
+  c = OHMMS::Controller;
+
+  ParticleSet ions_;
+  ParticleSet elec_;
+
+  ions_.setName("ion");
+  ions_.create(1);
+  ions_.R[0][0]              = 2.0;
+  ions_.R[0][1]              = 0.0;
+  ions_.R[0][2]              = 0.0;
+  SpeciesSet& ispecies       = ions_.getSpeciesSet();
+  int CIdx                   = ispecies.addSpecies("C");
+  int ichargeIdx             = ispecies.addAttribute("charge");
+  ispecies(ichargeIdx, CIdx) = 4;
+  ions_.resetGroups();
+  ions_.update();
+
+  elec_.setName("elec");
+  std::vector<int> ud(2);
+  ud[0] = ud[1] = 2;
+  elec_.create(ud);
+  elec_.R[0] = PosType(1.00, 0.0, 0.0);
+  elec_.R[1] = PosType(0.0, 0.0, 0.0);
+  elec_.R[2] = PosType(0.2, 0.5, -0.3);
+  elec_.R[3] = PosType(-0.6, 0.1, 0.4);
+
+  SpeciesSet& tspecies         = elec_.getSpeciesSet();
+  int upIdx                    = tspecies.addSpecies("u");
+  int downIdx                  = tspecies.addSpecies("d");
+  int chargeIdx                = tspecies.addAttribute("charge");
+  tspecies(chargeIdx, upIdx)   = -1;
+  tspecies(chargeIdx, downIdx) = -1;
+  elec_.resetGroups();
+
+  // the u-u cutoff leaves some pairs out
+  const char* particles = "<tmp> \
+<jastrow name=\"J2\" type=\"Two-Body\" function=\"Bspline\"> \
+   <correlation rcut=\"1.2\" size=\"6\" speciesA=\"u\" speciesB=\"u\"> \
+      <coefficients id=\"uu\" type=\"Array\"> 0.1 0.05 -0.02 -0.04 -0.03 -0.01</coefficients> \
+    </correlation> \
+   <correlation rcut=\"10\" size=\"10\" speciesA=\"u\" speciesB=\"d\"> \
+      <coefficients id=\"ud\" type=\"Array\"> 0.02904699284 -0.1004179 -0.1752703883 -0.2232576505 -0.2728029201 -0.3253286875 -0.3624525145 -0.3958223107 -0.4268582166 -0.4394531176</coefficients> \
+    </correlation> \
+</jastrow> \
+<jastrow type=\"One-Body\" name=\"J1\" function=\"bspline\" source=\"ion\"> \
+   <correlation elementType=\"C\" rcut=\"3\" size=\"8\" cusp=\"0.0\"> \
+      <coefficients id=\"eC\" type=\"Array\"> -0.2032153051 -0.1625595974 -0.143124599 -0.1216434956 -0.09919771951 -0.07111729038 -0.04445345869 -0.02135082917 </coefficients> \
+   </correlation> \
+</jastrow> \
+</tmp> \
+";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(particles);
+  REQUIRE(okay);
+
+  xmlNodePtr root = doc.getRoot();
+  xmlNodePtr jas2 = xmlFirstElementChild(root);
+  xmlNodePtr jas1 = xmlNextElementSibling(jas2);
+
+  RadialJastrowBuilder jastrow2(c, elec_);
+  std::unique_ptr<WaveFunctionComponent> j2(jastrow2.buildComponent(jas2));
+  REQUIRE(j2);
+  RadialJastrowBuilder jastrow1(c, elec_, ions_);
+  std::unique_ptr<WaveFunctionComponent> j1(jastrow1.buildComponent(jas1));
+  REQUIRE(j1);
+
+  ParticleSet elec_clone(elec_);
+  elec_clone.R[1] = PosType(0.3, -0.2, 0.1);
+  elec_clone.R[3] = PosType(1.5, 0.7, -0.2);
+  std::unique_ptr<WaveFunctionComponent> j2_clone(j2->makeClone(elec_clone));
+  std::unique_ptr<WaveFunctionComponent> j1_clone(j1->makeClone(elec_clone));
+
+  opt_variables_type active;
+  j2->checkInVariables(active);
+  j1->checkInVariables(active);
+  active.resetIndex();
+  const int nparam = active.size();
+  REQUIRE(nparam == 6 + 10 + 8);
+
+  RefVector<ParticleSet> p_list{elec_, elec_clone};
+  std::vector<RefVector<WaveFunctionComponent>> wfc_lists{{*j2, *j2_clone}, {*j1, *j1_clone}};
+  for (int iw = 0; iw < 2; iw++)
+  {
+    ParticleSet& P = p_list[iw];
+    P.update();
+    P.G = 0.0;
+    P.L = 0.0;
+    for (int icomp = 0; icomp < 2; icomp++)
+    {
+      wfc_lists[icomp][iw].get().checkOutVariables(active);
+      wfc_lists[icomp][iw].get().evaluateLog(P, P.G, P.L);
+    }
+  }
+
+  RecordArray<ValueType> dlogpsi(nparam, 2);
+  RecordArray<ValueType> dhpsioverpsi(nparam, 2);
+  for (int icomp = 0; icomp < 2; icomp++)
+    wfc_lists[icomp][0].get().mw_evaluateParameterDerivatives(wfc_lists[icomp], p_list, active, dlogpsi,
+                                                              dhpsioverpsi);
+
+  for (int iw = 0; iw < 2; iw++)
+  {
+    std::vector<ValueType> dlogpsi_ref(nparam);
+    std::vector<ValueType> dhpsioverpsi_ref(nparam);
+    for (int icomp = 0; icomp < 2; icomp++)
+      wfc_lists[icomp][iw].get().evaluateDerivatives(p_list[iw], active, dlogpsi_ref, dhpsioverpsi_ref);
+    for (int ip = 0; ip < nparam; ip++)
+    {
+      REQUIRE(std::real(dlogpsi.getValue(ip, iw)) == Approx(std::real(dlogpsi_ref[ip])));
+      REQUIRE(std::real(dhpsioverpsi.getValue(ip, iw)) == Approx(std::real(dhpsioverpsi_ref[ip])));
+    }
+  }
+}
 } // namespace qmcplusplus
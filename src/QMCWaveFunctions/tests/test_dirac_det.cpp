@@ -113,6 +113,39 @@ TEST_CASE("DiracDeterminant_first", "[wavefunction][fermion]")
   check_matrix(ddb.psiM, b);
 }
 
+TEST_CASE("DiracDeterminant_residual_check", "[wavefunction][fermion]")
+{
+  FakeSPO* spo = new FakeSPO();
+  spo->setOrbitalSetSize(3);
+  DetType ddb(spo);
+
+  int norb = 3;
+  ddb.set(0, norb);
+  ddb.setResidualCheck(1e-3, norb);
+
+  ParticleSet elec;
+
+  elec.create(3);
+  ddb.recompute(elec);
+
+  // FakeSPO::evaluateValue returns the transpose of the rows used by recompute
+  Matrix<ValueType> inv(norb, norb);
+  for (int i = 0; i < norb; i++)
+    for (int j = 0; j < norb; j++)
+      inv(i, j) = ddb.psiM(j, i);
+  REQUIRE(ddb.sampledInverseResidual(elec, inv) < 1e-5);
+
+  // the error of row 1 is 0.01 * phi_2(r_k), largest for k = 2
+  inv(1, 2) += 0.01;
+  REQUIRE(ddb.sampledInverseResidual(elec, inv) == Approx(0.049).epsilon(1e-4));
+
+  // a single sampled row moves to the next particle at each check
+  ddb.setResidualCheck(1e-3, 1);
+  REQUIRE(ddb.sampledInverseResidual(elec, inv) == Approx(0.049).epsilon(1e-4));
+  REQUIRE(ddb.sampledInverseResidual(elec, inv) == Approx(0.026).epsilon(1e-4));
+  REQUIRE(ddb.sampledInverseResidual(elec, inv) == Approx(0.033).epsilon(1e-4));
+}
+
 //#define DUMP_INFO
 
 TEST_CASE("DiracDeterminant_second", "[wavefunction][fermion]")
@@ -19,8 +19,12 @@
 #include "QMCWaveFunctions/WaveFunctionComponent.h"
 #include "QMCWaveFunctions/EinsplineSetBuilder.h"
 #include "QMCWaveFunctions/EinsplineSpinorSetBuilder.h"
+#include "QMCWaveFunctions/BsplineFactory/BsplineSet.h"
+#include "QMCWaveFunctions/BsplineFactory/MappedSplineCoefs.h"
 
 #include <stdio.h>
+#include <cstdio>
+#include <fstream>
 #include <string>
 #include <limits>
 
@@ -463,4 +467,101 @@ TEST_CASE("EinsplineSetBuilder CheckLattice", "[wavefunction]")
   REQUIRE_FALSE(esb.CheckLattice());
 }
 
+TEST_CASE("Einspline SPO mapped coefficient cache", "[wavefunction]")
+{
+  Communicate* c = OHMMS::Controller;
+
+  ParticleSet ions_;
+  ParticleSet elec_;
+
+  ions_.setName("ion");
+  ions_.create(2);
+  ions_.R[0][0] = 0.0;
+  ions_.R[0][1] = 0.0;
+  ions_.R[0][2] = 0.0;
+  ions_.R[1][0] = 1.68658058;
+  ions_.R[1][1] = 1.68658058;
+  ions_.R[1][2] = 1.68658058;
+
+  elec_.setName("elec");
+  elec_.create(2);
+  elec_.R[0][0] = 0.0;
+  elec_.R[0][1] = 0.0;
+  elec_.R[0][2] = 0.0;
+  elec_.R[1][0] = 0.0;
+  elec_.R[1][1] = 1.0;
+  elec_.R[1][2] = 0.0;
+
+  // diamondC_1x1x1
+  elec_.Lattice.R(0, 0) = 3.37316115;
+  elec_.Lattice.R(0, 1) = 3.37316115;
+  elec_.Lattice.R(0, 2) = 0.0;
+  elec_.Lattice.R(1, 0) = 0.0;
+  elec_.Lattice.R(1, 1) = 3.37316115;
+  elec_.Lattice.R(1, 2) = 3.37316115;
+  elec_.Lattice.R(2, 0) = 3.37316115;
+  elec_.Lattice.R(2, 1) = 0.0;
+  elec_.Lattice.R(2, 2) = 3.37316115;
+
+  SpeciesSet& tspecies       = elec_.getSpeciesSet();
+  int upIdx                  = tspecies.addSpecies("u");
+  int chargeIdx              = tspecies.addAttribute("charge");
+  tspecies(chargeIdx, upIdx) = -1;
+
+  ParticleSetPool ptcl = ParticleSetPool(c);
+  ptcl.addParticleSet(&elec_);
+  ptcl.addParticleSet(&ions_);
+
+  const char* particles = "<tmp> \
+<determinantset type=\"einspline\" href=\"diamondC_1x1x1.pwscf.h5\" tilematrix=\"1 0 0 0 1 0 0 0 1\" twistnum=\"0\" source=\"ion\" meshfactor=\"1.0\" precision=\"float\" size=\"4\" mapped_coefs=\"yes\"/> \
+</tmp> \
+";
+
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(particles);
+  REQUIRE(okay);
+
+  xmlNodePtr ein1 = xmlFirstElementChild(doc.getRoot());
+
+  const std::string cachefile("einspline.tile_100010001.spin_0.tw_0.l0u4.g40x40x40.coefs");
+  std::remove(cachefile.c_str());
+
+  // the first build transforms the orbitals and writes the cache, the second one maps it
+  EinsplineSetBuilder einSet(elec_, ptcl.getPool(), c, ein1);
+  std::unique_ptr<SPOSet> spo(einSet.createSPOSetFromXML(ein1));
+  REQUIRE(spo);
+  EinsplineSetBuilder einSet_mapped(elec_, ptcl.getPool(), c, ein1);
+  std::unique_ptr<SPOSet> spo_mapped(einSet_mapped.createSPOSetFromXML(ein1));
+  REQUIRE(spo_mapped);
+
+  auto* bspline_mapped = dynamic_cast<BsplineSet*>(spo_mapped.get());
+  REQUIRE(bspline_mapped != nullptr);
+  REQUIRE(bspline_mapped->isMapped());
+  REQUIRE_FALSE(dynamic_cast<BsplineSet*>(spo.get())->isMapped());
+
+  elec_.update();
+  SPOSet::ValueVector_t psi(spo->getOrbitalSetSize());
+  SPOSet::ValueVector_t psi_mapped(spo->getOrbitalSetSize());
+  spo->evaluateValue(elec_, 1, psi);
+  spo_mapped->evaluateValue(elec_, 1, psi_mapped);
+  for (int i = 0; i < psi.size(); i++)
+    REQUIRE(psi_mapped[i] == psi[i]);
+
+  // a cache built for different orbitals is not mapped
+  MappedSplineCoefs mapped;
+  std::string reason;
+  REQUIRE(mapped.open(cachefile, sizeof(float), "class SplineR2R\n", reason) == false);
+  REQUIRE(mapped.open(cachefile, sizeof(double), "", reason) == false);
+
+  // nor a cache built from an h5 file that was rewritten since
+  const std::string source("mapped_coefs_source.h5");
+  std::ofstream(source) << "a";
+  const std::string stamp = MappedSplineCoefs::sourceStamp(source);
+  std::ofstream(source) << "ab";
+  REQUIRE(MappedSplineCoefs::sourceStamp(source) != stamp);
+  std::remove(source.c_str());
+
+  std::remove(cachefile.c_str());
+}
+
 } // namespace qmcplusplus
@@ -109,6 +109,48 @@ void test_LiH_msd(const std::string& spo_xml_string,
   ratio = twf.calcRatio(elec_, 1);
   std::cout << "twf.calcRatio ratio " << ratio << std::endl;
   REQUIRE(ratio == ValueApprox(1.374307585));
+
+  twf.rejectMove(1);
+  elec_.rejectMove(1);
+
+  // testing batched interfaces with two identical walkers
+  ParticleSet elec_clone(elec_);
+  std::unique_ptr<TrialWaveFunction> twf_clone(twf.makeClone(elec_clone));
+  RefVector<ParticleSet> p_ref_list{elec_, elec_clone};
+  RefVector<TrialWaveFunction> wf_ref_list{twf, *twf_clone};
+
+  ParticleSet::flex_update(p_ref_list);
+  TrialWaveFunction::flex_evaluateLog(wf_ref_list, p_ref_list);
+  for (int iw = 0; iw < 2; iw++)
+    REQUIRE(std::complex<double>(wf_ref_list[iw].get().getLogPsi(), wf_ref_list[iw].get().getPhase()) ==
+            LogComplexApprox(std::complex<double>(-7.646027846242066, 3.141592653589793)));
+
+  std::vector<ParticleSet::GradType> grad_old_list(2);
+  TrialWaveFunction::flex_evalGrad(wf_ref_list, p_ref_list, 1, grad_old_list);
+  for (int iw = 0; iw < 2; iw++)
+  {
+    REQUIRE(grad_old_list[iw][0] == ValueApprox(0.1204183219));
+    REQUIRE(grad_old_list[iw][1] == ValueApprox(0.120821033));
+    REQUIRE(grad_old_list[iw][2] == ValueApprox(2.05904174));
+  }
+
+  std::vector<ParticleSet::SingleParticlePos_t> displ(2, delta);
+  ParticleSet::flex_makeMove(p_ref_list, 1, displ);
+
+  std::vector<WaveFunctionComponent::PsiValueType> ratios(2);
+  std::vector<ParticleSet::GradType> grad_new_list(2);
+  TrialWaveFunction::flex_calcRatioGrad(wf_ref_list, p_ref_list, 1, ratios, grad_new_list);
+  for (int iw = 0; iw < 2; iw++)
+  {
+    REQUIRE(ratios[iw] == ValueApprox(1.374307585));
+    REQUIRE(grad_new_list[iw][0] == ValueApprox(0.05732804333));
+    REQUIRE(grad_new_list[iw][1] == ValueApprox(0.05747775029));
+    REQUIRE(grad_new_list[iw][2] == ValueApprox(1.126889742));
+  }
+
+  TrialWaveFunction::flex_calcRatio(wf_ref_list, p_ref_list, 1, ratios);
+  for (int iw = 0; iw < 2; iw++)
+    REQUIRE(ratios[iw] == ValueApprox(1.374307585));
 }
 
 TEST_CASE("LiH multi Slater dets", "[wavefunction]")
@@ -189,4 +189,155 @@ TEST_CASE("PolynomialFunctor3D Jastrow", "[wavefunction]")
   REQUIRE(std::real(ratios2[0]) == Approx(1.0357541137));
   REQUIRE(std::real(ratios2[1]) == Approx(1.0257141422));
 }
+
+TEST_CASE("PolynomialFunctor3D Jastrow multi-walker", "[wavefunction]")
+{
+  using PosType = QMCTraits::PosType;
+  Communicate* c;
+  c = OHMMS::Controller;
+
+  ParticleSet ions_;
+  ParticleSet elec_;
+
+  ions_.setName("ion");
+  ions_.create(2);
+  ions_.R[0] = PosType(2.0, 0.0, 0.0);
+  ions_.R[1] = PosType(-2.0, 0.0, 0.0);
+  SpeciesSet& source_species(ions_.getSpeciesSet());
+  source_species.addSpecies("O");
+  ions_.setCoordinates(ions_.R);
+
+  elec_.setName("elec");
+  std::vector<int> ud(2);
+  ud[0] = ud[1] = 2;
+  elec_.create(ud);
+  elec_.R[0] = PosType(1.00, 0.0, 0.0);
+  elec_.R[1] = PosType(0.0, 0.0, 0.0);
+  elec_.R[2] = PosType(-1.00, 0.0, 0.0);
+  elec_.R[3] = PosType(0.0, 0.0, 2.0);
+
+  SpeciesSet& target_species(elec_.getSpeciesSet());
+  int upIdx                          = target_species.addSpecies("u");
+  int downIdx                        = target_species.addSpecies("d");
+  int chargeIdx                      = target_species.addAttribute("charge");
+  target_species(chargeIdx, upIdx)   = -1;
+  target_species(chargeIdx, downIdx) = -1;
+
+  const char* particles = "<tmp> \
+    <jastrow name=\"J3\" type=\"eeI\" function=\"polynomial\" source=\"ion\" print=\"yes\"> \
+      <correlation ispecies=\"O\" especies=\"u\" isize=\"3\" esize=\"3\" rcut=\"10\"> \
+        <coefficients id=\"uuO\" type=\"Array\" optimize=\"yes\"> 8.227710241e-03 2.480817653e-03 -5.354068112e-03 -1.112644787e-02 -2.208006078e-03 5.213121933e-03 -1.537865869e-02 8.899030233e-03 6.257255156e-03 3.214580988e-03 -7.716743107e-03 -5.275682077e-03 -1.778457637e-03 7.926231121e-03 1.767406868e-03 5.451359059e-05 2.801423724e-03 4.577282736e-03 7.634608083e-03 -9.510673173e-04 -2.344131575e-03 -1.878777219e-03 3.937363358e-04 5.065353773e-04 5.086724869e-04 -1.358768154e-04</coefficients> \
+      </correlation> \
+      <correlation ispecies=\"O\" especies1=\"u\" especies2=\"d\" isize=\"3\" esize=\"3\" rcut=\"10\"> \
+        <coefficients id=\"udO\" type=\"Array\" optimize=\"yes\"> -6.939530224e-03 2.634169299e-02 4.046077477e-02 -8.002682388e-03 -5.396795988e-03 6.697370507e-03 5.433953051e-02 -6.336849668e-03 3.680471431e-02 -2.996059772e-02 1.99365828e-03 -3.222705626e-02 -8.091669063e-03 4.15738535e-03 4.843939112e-03 3.563650208e-04 3.786332474e-02 -1.418336941e-02 2.282691374e-02 1.29239286e-03 -4.93580873e-03 -3.052539228e-03 9.870288001e-05 1.844286407e-03 2.970561871e-04 -4.364303677e-05</coefficients> \
+      </correlation> \
+    </jastrow> \
+</tmp> \
+";
+  Libxml2Document doc;
+  bool okay = doc.parseFromString(particles);
+  REQUIRE(okay);
+
+  xmlNodePtr root    = doc.getRoot();
+  xmlNodePtr jas_eeI = xmlFirstElementChild(root);
+
+  eeI_JastrowBuilder jastrow(c, elec_, ions_);
+  std::unique_ptr<WaveFunctionComponent> j3(jastrow.buildComponent(jas_eeI));
+  REQUIRE(j3);
+
+  ParticleSet elec_clone(elec_);
+  elec_clone.R[1] = PosType(0.3, -0.2, 0.1);
+  elec_clone.R[3] = PosType(-0.5, 0.4, -0.2);
+  std::unique_ptr<WaveFunctionComponent> j3_clone(j3->makeClone(elec_clone));
+
+  // single walker references
+  ParticleSet elec_ref(elec_);
+  ParticleSet elec_clone_ref(elec_clone);
+  std::unique_ptr<WaveFunctionComponent> j3_ref(j3->makeClone(elec_ref));
+  std::unique_ptr<WaveFunctionComponent> j3_clone_ref(j3->makeClone(elec_clone_ref));
+
+  RefVector<ParticleSet> p_list{elec_, elec_clone};
+  RefVector<ParticleSet> p_ref_list{elec_ref, elec_clone_ref};
+  RefVector<WaveFunctionComponent> wfc_list{*j3, *j3_clone};
+  RefVector<WaveFunctionComponent> wfc_ref_list{*j3_ref, *j3_clone_ref};
+
+  for (int iw = 0; iw < 2; iw++)
+  {
+    p_list[iw].get().update();
+    p_ref_list[iw].get().update();
+    wfc_list[iw].get().evaluateLog(p_list[iw], p_list[iw].get().G, p_list[iw].get().L);
+    wfc_ref_list[iw].get().evaluateLog(p_ref_list[iw], p_ref_list[iw].get().G, p_ref_list[iw].get().L);
+  }
+
+  // the first walker moves electrons in and out of the cutoff radius of the ions
+  const std::vector<PosType> displs{PosType(3.5, 0.2, -0.1), PosType(-0.2, 0.1, 0.05)};
+  for (int sweep = 0; sweep < 2; sweep++)
+    for (int iat = 0; iat < elec_.getTotalNum(); iat++)
+    {
+      const std::vector<PosType> sweep_displs{(sweep == 0 ? 1 : -1) * displs[0], displs[1]};
+      ParticleSet::flex_makeMove(p_list, iat, sweep_displs);
+      for (int iw = 0; iw < 2; iw++)
+        p_ref_list[iw].get().makeMove(iat, sweep_displs[iw]);
+
+      std::vector<PsiValueType> ratios(2);
+      wfc_list[0].get().mw_calcRatio(wfc_list, p_list, iat, ratios);
+      for (int iw = 0; iw < 2; iw++)
+        REQUIRE(std::real(ratios[iw]) == Approx(std::real(wfc_ref_list[iw].get().ratio(p_ref_list[iw], iat))));
+
+      // leave the odd electrons with ratio-only updates to be completed at the acceptance
+      if (iat % 2 == 0)
+      {
+        std::vector<QMCTraits::GradType> grads(2, QMCTraits::GradType(0.0));
+        wfc_list[0].get().mw_ratioGrad(wfc_list, p_list, iat, ratios, grads);
+        for (int iw = 0; iw < 2; iw++)
+        {
+          QMCTraits::GradType grad_ref(0.0);
+          PsiValueType ratio_ref = wfc_ref_list[iw].get().ratioGrad(p_ref_list[iw], iat, grad_ref);
+          REQUIRE(std::real(ratios[iw]) == Approx(std::real(ratio_ref)));
+          for (int idim = 0; idim < OHMMS_DIM; idim++)
+            REQUIRE(std::real(grads[iw][idim]) == Approx(std::real(grad_ref[idim])));
+        }
+      }
+
+      std::vector<bool> isAccepted{true, iat != 1};
+      wfc_list[0].get().mw_accept_rejectMove(wfc_list, p_list, iat, isAccepted);
+      for (int iw = 0; iw < 2; iw++)
+        if (isAccepted[iw])
+        {
+          wfc_ref_list[iw].get().acceptMove(p_ref_list[iw], iat);
+          p_list[iw].get().acceptMove(iat);
+          p_ref_list[iw].get().acceptMove(iat);
+        }
+        else
+        {
+          wfc_ref_list[iw].get().restore(iat);
+          p_list[iw].get().rejectMove(iat);
+          p_ref_list[iw].get().rejectMove(iat);
+        }
+    }
+
+  // incrementally updated values agree with the ones from scratch
+  for (int iw = 0; iw < 2; iw++)
+  {
+    ParticleSet& pset(p_list[iw]);
+    WaveFunctionComponent& wfc(wfc_list[iw]);
+    REQUIRE(std::real(wfc.LogValue) == Approx(std::real(wfc_ref_list[iw].get().LogValue)));
+    pset.G = 0.0;
+    pset.L = 0.0;
+    static_cast<JeeIOrbitalSoA<PolynomialFunctor3D>&>(wfc).evaluateGL(pset, pset.G, pset.L, false);
+    const auto G_updated           = pset.G;
+    const auto L_updated           = pset.L;
+    const LogValueType log_updated = wfc.LogValue;
+    pset.G                         = 0.0;
+    pset.L                         = 0.0;
+    wfc.evaluateLog(pset, pset.G, pset.L);
+    REQUIRE(std::real(log_updated) == Approx(std::real(wfc.LogValue)));
+    for (int iat = 0; iat < pset.getTotalNum(); iat++)
+    {
+      REQUIRE(std::real(L_updated[iat]) == Approx(std::real(pset.L[iat])));
+      for (int idim = 0; idim < OHMMS_DIM; idim++)
+        REQUIRE(std::real(G_updated[iat][idim]) == Approx(std::real(pset.G[iat][idim])));
+    }
+  }
+}
 } // namespace qmcplusplus
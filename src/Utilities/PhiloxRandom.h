@@ -0,0 +1,294 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef OHMMS_PHILOXRANDOM_H
+#define OHMMS_PHILOXRANDOM_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/** Philox4x32-10 block function
+ *
+ * Counter-based random number generator of Salmon et al., SC11.
+ * Each call maps a 128-bit counter and a 64-bit key to 128 random bits without any internal state.
+ */
+struct Philox4x32
+{
+  using ctr_type = std::array<uint32_t, 4>;
+  using key_type = std::array<uint32_t, 2>;
+
+  static inline void round(uint32_t& c0, uint32_t& c1, uint32_t& c2, uint32_t& c3, uint32_t k0, uint32_t k1)
+  {
+    const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+    const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+    const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+    const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+    c1                = static_cast<uint32_t>(p1);
+    c3                = static_cast<uint32_t>(p0);
+    c0                = n0;
+    c2                = n2;
+  }
+
+  /** apply the 10 rounds in place
+   * written in scalar variables so that a loop over counters vectorizes
+   */
+  static inline void apply(uint32_t& c0, uint32_t& c1, uint32_t& c2, uint32_t& c3, uint32_t k0, uint32_t k1)
+  {
+    for (int r = 0; r < 10; ++r)
+    {
+      round(c0, c1, c2, c3, k0, k1);
+      k0 += 0x9E3779B9u;
+      k1 += 0xBB67AE85u;
+    }
+  }
+
+  static inline ctr_type generate(const ctr_type& ctr, const key_type& key)
+  {
+    ctr_type out(ctr);
+    apply(out[0], out[1], out[2], out[3], key[0], key[1]);
+    return out;
+  }
+};
+
+/** counter-based random number generator using Philox4x32-10
+ *
+ * Drop-in replacement of BoostRandom. The state is a key and a counter:
+ * - key = seed
+ * - counter = (block, step, stream id low, stream id high)
+ *
+ * A stream is selected by setStream, e.g. keyed by a walker ID and a step,
+ * so that the numbers drawn for a walker do not depend on which thread or rank moves it.
+ * Generating numbers only increments the block word of the counter.
+ * The bulk generate_uniform and generate_normal start from a new block and vectorize over blocks.
+ */
+template<typename T>
+class PhiloxRandom
+{
+public:
+  /// real result type
+  typedef T result_type;
+  /// unsigned integer type
+  typedef uint32_t uint_type;
+
+  std::string ClassName;
+  std::string EngineName;
+
+  ///default constructor
+  explicit PhiloxRandom(uint_type iseed = 911, const std::string& aname = "philox4x32")
+      : ClassName("philox"), EngineName(aname), myContext(0), nContexts(1), baseOffset(0)
+  {
+    seed(iseed);
+  }
+
+  /** initialize the generator
+   * @param i thread index
+   * @param nstr number of threads
+   * @param iseed_in input seed
+   *
+   * The seed is the key and the thread index selects the stream.
+   */
+  void init(int i, int nstr, int iseed_in, uint_type offset = 1)
+  {
+    uint_type baseSeed = iseed_in;
+    myContext          = i;
+    nContexts          = nstr;
+    if (iseed_in <= 0)
+      baseSeed = make_seed(i, nstr);
+    baseOffset = offset;
+    seed(baseSeed);
+    setStream(i, 0);
+  }
+
+  ///get baseOffset
+  inline int offset() const { return baseOffset; }
+  ///assign baseOffset
+  inline int& offset() { return baseOffset; }
+
+  ///assign seed, the stream is reset to zero
+  inline void seed(uint_type aseed)
+  {
+    key_[0] = aseed;
+    key_[1] = 0;
+    setStream(0, 0);
+  }
+
+  /** select the stream and rewind it
+   * @param stream_id stream identifier, e.g. walker ID
+   * @param step stream sub-identifier, e.g. MC step
+   */
+  inline void setStream(uint64_t stream_id, uint32_t step)
+  {
+    ctr_[0]     = 0;
+    ctr_[1]     = step;
+    ctr_[2]     = static_cast<uint32_t>(stream_id);
+    ctr_[3]     = static_cast<uint32_t>(stream_id >> 32);
+    buffer_pos_ = 4;
+  }
+
+  /** return a random number [0,1)
+   */
+  inline result_type rand() { return to_uniform(static_cast<T*>(nullptr)); }
+
+  /** return a random number [0,1)
+   */
+  inline result_type operator()() { return rand(); }
+
+  /** return a random integer
+   */
+  inline uint_type irand() { return next_word(); }
+
+  /** generate a series of random numbers [0,1) */
+  template<typename T1>
+  inline void generate_uniform(T1* restrict d, int n)
+  {
+    constexpr int per_block = sizeof(T1) == 4 ? 4 : 2;
+    const int nblocks       = n / per_block;
+    const uint32_t c0       = ctr_[0];
+    const uint32_t c1 = ctr_[1], c2 = ctr_[2], c3 = ctr_[3];
+    const uint32_t k0 = key_[0], k1 = key_[1];
+#pragma omp simd
+    for (int ib = 0; ib < nblocks; ++ib)
+    {
+      uint32_t x0 = c0 + ib, x1 = c1, x2 = c2, x3 = c3;
+      Philox4x32::apply(x0, x1, x2, x3, k0, k1);
+      store_uniform(d + ib * per_block, x0, x1, x2, x3);
+    }
+    ctr_[0] += nblocks;
+    buffer_pos_ = 4;
+    for (int i = nblocks * per_block; i < n; ++i)
+      d[i] = to_uniform(d);
+  }
+
+  /** generate a series of normal random numbers
+   *
+   * Uniform pairs are generated in bulk and then transformed by Box-Muller in a SIMD loop.
+   */
+  template<typename T1>
+  inline void generate_normal(T1* restrict d, int n)
+  {
+    generate_uniform(d, n);
+    constexpr T1 two_pi = 6.283185307179586;
+    const int npairs    = n / 2;
+#pragma omp simd
+    for (int i = 0; i < npairs; ++i)
+    {
+      const T1 r   = std::sqrt(T1(-2) * std::log(T1(1) - d[2 * i]));
+      const T1 phi = two_pi * d[2 * i + 1];
+      d[2 * i]     = r * std::cos(phi);
+      d[2 * i + 1] = r * std::sin(phi);
+    }
+    if (n % 2 == 1)
+      d[n - 1] = std::sqrt(T1(-2) * std::log(T1(1) - d[n - 1])) * std::cos(two_pi * to_uniform(d));
+  }
+
+  /** the state is the key, the counter and the position in the current block */
+  inline int state_size() const { return 7; }
+
+  inline void read(std::istream& rin)
+  {
+    std::vector<uint_type> state(state_size());
+    for (auto& s : state)
+      rin >> s;
+    load(state);
+  }
+
+  inline void write(std::ostream& rout) const
+  {
+    std::vector<uint_type> state;
+    save(state);
+    for (int i = 0; i < state.size(); ++i)
+      rout << state[i] << (i + 1 < state.size() ? " " : "");
+  }
+
+  inline void save(std::vector<uint_type>& curstate) const
+  {
+    curstate = {key_[0], key_[1], ctr_[0], ctr_[1], ctr_[2], ctr_[3], buffer_pos_};
+  }
+
+  inline void load(const std::vector<uint_type>& newstate)
+  {
+    key_[0]     = newstate[0];
+    key_[1]     = newstate[1];
+    ctr_[0]     = newstate[2];
+    ctr_[1]     = newstate[3];
+    ctr_[2]     = newstate[4];
+    ctr_[3]     = newstate[5];
+    buffer_pos_ = newstate[6];
+    // regenerate the current block, it was generated from the previous counter
+    if (buffer_pos_ < 4)
+    {
+      Philox4x32::ctr_type ctr(ctr_);
+      ctr[0]--;
+      buffer_ = Philox4x32::generate(ctr, key_);
+    }
+  }
+
+private:
+  ///context number
+  int myContext;
+  ///number of contexts
+  int nContexts;
+  ///offset of the random seed
+  int baseOffset;
+  ///key
+  Philox4x32::key_type key_;
+  ///counter of the next block
+  Philox4x32::ctr_type ctr_;
+  ///current block
+  Philox4x32::ctr_type buffer_;
+  ///position of the next word in buffer_, 4 if empty
+  uint_type buffer_pos_;
+
+  inline uint32_t next_word()
+  {
+    if (buffer_pos_ == 4)
+    {
+      buffer_ = Philox4x32::generate(ctr_, key_);
+      ctr_[0]++;
+      buffer_pos_ = 0;
+    }
+    return buffer_[buffer_pos_++];
+  }
+
+  ///24 random bits to [0,1) in single precision
+  inline float to_uniform(float*) { return (next_word() >> 8) * 5.9604644775390625e-8f; }
+
+  ///53 random bits to [0,1) in double precision
+  inline double to_uniform(double*)
+  {
+    const uint32_t a = next_word() >> 5;
+    const uint32_t b = next_word() >> 6;
+    return (a * 67108864.0 + b) * 1.1102230246251565e-16;
+  }
+
+  static inline void store_uniform(float* d, uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3)
+  {
+    d[0] = (x0 >> 8) * 5.9604644775390625e-8f;
+    d[1] = (x1 >> 8) * 5.9604644775390625e-8f;
+    d[2] = (x2 >> 8) * 5.9604644775390625e-8f;
+    d[3] = (x3 >> 8) * 5.9604644775390625e-8f;
+  }
+
+  static inline void store_uniform(double* d, uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3)
+  {
+    d[0] = ((x0 >> 5) * 67108864.0 + (x1 >> 6)) * 1.1102230246251565e-16;
+    d[1] = ((x2 >> 5) * 67108864.0 + (x3 >> 6)) * 1.1102230246251565e-16;
+  }
+};
+#endif
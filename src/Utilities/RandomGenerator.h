@@ -18,6 +18,7 @@
  *
  * Selected among
  * - boost::random
+ * - counter-based Philox4x32-10 if QMC_RNG_PHILOX is enabled
  * - sprng
  * - math::random
  * qmcplusplus::Random() returns a random number [0,1)
@@ -74,6 +75,8 @@ inline uint32_t make_seed(int i, int n) { return static_cast<uint32_t>(std::time
 
 // The definition of the fake RNG should always be available for unit testing
 #include "Utilities/FakeRandom.h"
+// The counter-based RNG is always available for keyed streams
+#include "Utilities/PhiloxRandom.h"
 #ifdef USE_FAKE_RNG
 namespace qmcplusplus
 {
@@ -82,7 +85,15 @@ typedef FakeRandom RandomGenerator_t;
 } // namespace qmcplusplus
 #else
 
-#ifdef HAVE_LIBBOOST
+#if defined(QMC_RNG_PHILOX)
+
+namespace qmcplusplus
+{
+template<class T>
+using RandomGenerator = PhiloxRandom<T>;
+typedef PhiloxRandom<OHMMS_PRECISION_FULL> RandomGenerator_t;
+} // namespace qmcplusplus
+#elif defined(HAVE_LIBBOOST)
 
 #include "Utilities/BoostRandom.h"
 namespace qmcplusplus
@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QMCPLUSPLUS_SCRATCH_FILE_ARRAY_H
+#define QMCPLUSPLUS_SCRATCH_FILE_ARRAY_H
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace qmcplusplus
+{
+/** array backed by a memory-mapped scratch file
+ *
+ * The file is created in a scratch directory and unlinked right away, so it is removed when the array is released
+ * or the process ends. The kernel writes the pages back to the file under memory pressure and reads them back on access,
+ * so the size of the array is limited by the disk instead of the node memory.
+ * Access is fastest when the array is traversed in order.
+ */
+template<typename T>
+class ScratchFileArray
+{
+  static_assert(std::is_trivially_copyable<T>::value, "ScratchFileArray requires a trivially copyable type");
+
+public:
+  ScratchFileArray() : data_(nullptr), size_(0) {}
+  ScratchFileArray(const ScratchFileArray&) = delete;
+  ScratchFileArray& operator=(const ScratchFileArray&) = delete;
+  ~ScratchFileArray() { free(); }
+
+  /** map n zero-initialized elements, any previous mapping is released
+   * @param directory directory of the scratch file
+   * @param n number of elements
+   * @return pointer to the first element
+   */
+  T* resize(const std::string& directory, size_t n)
+  {
+    free();
+    if (n == 0)
+      return nullptr;
+
+    const std::string pattern(directory + "/qmcpack_scratch_XXXXXX");
+    std::vector<char> fname(pattern.begin(), pattern.end());
+    fname.push_back('\0');
+    const int fd = mkstemp(fname.data());
+    if (fd < 0)
+      throw std::runtime_error("ScratchFileArray cannot create a scratch file in " + directory + " : " +
+                               std::strerror(errno));
+    unlink(fname.data());
+
+    const size_t bytes = n * sizeof(T);
+    if (ftruncate(fd, bytes) != 0)
+    {
+      const int err = errno;
+      close(fd);
+      throw std::runtime_error("ScratchFileArray cannot extend the scratch file in " + directory + " to " +
+                               std::to_string(bytes) + " bytes : " + std::strerror(err));
+    }
+    void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int err = errno;
+    close(fd);
+    if (ptr == MAP_FAILED)
+      throw std::runtime_error("ScratchFileArray cannot map the scratch file : " + std::string(std::strerror(err)));
+    madvise(ptr, bytes, MADV_SEQUENTIAL);
+
+    data_ = static_cast<T*>(ptr);
+    size_ = n;
+    return data_;
+  }
+
+  /// unmap the elements, the scratch file is removed
+  void free()
+  {
+    if (data_ != nullptr)
+      munmap(data_, size_ * sizeof(T));
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+  T* data_;
+  size_t size_;
+};
+
+} // namespace qmcplusplus
+#endif
@@ -16,6 +16,7 @@
 #include "Utilities/FakeRandom.h"
 #include <stdio.h>
 #include <string>
+#include <sstream>
 #include <vector>
 
 using std::string;
@@ -44,6 +45,111 @@ TEST_CASE("boost_mt19937_determinism", "[utilities]")
 
 #endif
 
+TEST_CASE("philox4x32 known answers", "[utilities]")
+{
+  // known answer tests of Random123
+  auto out = Philox4x32::generate({0, 0, 0, 0}, {0, 0});
+  REQUIRE(out[0] == 0x6627e8d5u);
+  REQUIRE(out[1] == 0xe169c58du);
+  REQUIRE(out[2] == 0xbc57ac4cu);
+  REQUIRE(out[3] == 0x9b00dbd8u);
+
+  out = Philox4x32::generate({0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}, {0xffffffffu, 0xffffffffu});
+  REQUIRE(out[0] == 0x408f276du);
+  REQUIRE(out[1] == 0x41c83b0eu);
+  REQUIRE(out[2] == 0xa20bc7c6u);
+  REQUIRE(out[3] == 0x6d5451fdu);
+
+  out = Philox4x32::generate({0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u}, {0xa4093822u, 0x299f31d0u});
+  REQUIRE(out[0] == 0xd16cfe09u);
+  REQUIRE(out[1] == 0x94fdccebu);
+  REQUIRE(out[2] == 0x5001e420u);
+  REQUIRE(out[3] == 0x24126ea1u);
+}
+
+TEST_CASE("philox streams", "[utilities]")
+{
+  PhiloxRandom<double> rng(13);
+  PhiloxRandom<double> rng_other(13);
+
+  // a stream only depends on the seed, the stream id and the step
+  rng.setStream(7, 3);
+  rng_other.setStream(5, 3);
+  rng_other.rand();
+  rng_other.setStream(7, 3);
+  for (int i = 0; i < 5; i++)
+    REQUIRE(rng() == rng_other());
+
+  // the bulk generation from the start of a stream matches the scalar one
+  const int n = 11;
+  std::vector<double> bulk(n);
+  rng.setStream(2, 1);
+  rng.generate_uniform(bulk.data(), n);
+  rng_other.setStream(2, 1);
+  for (int i = 0; i < n; i++)
+  {
+    REQUIRE(bulk[i] >= 0.0);
+    REQUIRE(bulk[i] < 1.0);
+    REQUIRE(bulk[i] == rng_other());
+  }
+
+  std::vector<float> bulk_float(n);
+  PhiloxRandom<float> rng_float(13);
+  rng_float.setStream(2, 1);
+  rng_float.generate_uniform(bulk_float.data(), n);
+  rng_float.setStream(2, 1);
+  for (int i = 0; i < n; i++)
+    REQUIRE(bulk_float[i] == rng_float());
+
+  // different steps give different streams
+  rng.setStream(2, 2);
+  REQUIRE(rng() != bulk[0]);
+}
+
+TEST_CASE("philox save and load", "[utilities]")
+{
+  PhiloxRandom<double> rng(29);
+  rng.init(3, 4, 29);
+  REQUIRE(rng.state_size() == 7);
+  rng();
+  rng.irand();
+
+  std::vector<PhiloxRandom<double>::uint_type> state;
+  rng.save(state);
+  REQUIRE(state.size() == rng.state_size());
+  std::vector<double> expected(6);
+  for (auto& v : expected)
+    v = rng();
+
+  PhiloxRandom<double> rng_restart;
+  rng_restart.load(state);
+  for (auto v : expected)
+    REQUIRE(rng_restart() == v);
+
+  std::stringstream ss;
+  rng.write(ss);
+  PhiloxRandom<double> rng_read;
+  rng_read.read(ss);
+  REQUIRE(rng_read() == rng());
+}
+
+TEST_CASE("philox normal", "[utilities]")
+{
+  PhiloxRandom<double> rng(11);
+  const int n = 100001;
+  std::vector<double> gauss(n);
+  rng.generate_normal(gauss.data(), n);
+  double mean = 0, var = 0;
+  for (auto g : gauss)
+    mean += g;
+  mean /= n;
+  for (auto g : gauss)
+    var += (g - mean) * (g - mean);
+  var /= n;
+  REQUIRE(std::abs(mean) < 0.01);
+  REQUIRE(var == Approx(1.0).epsilon(0.01));
+}
+
 TEST_CASE("make_seed", "[utilities]")
 {
   // not sure what to test here - mostly that it doesn't crash
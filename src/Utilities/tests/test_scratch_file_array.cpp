@@ -0,0 +1,49 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// This file is distributed under the University of Illinois/NCSA Open Source License.
+// See LICENSE file in top directory for details.
+//
+// Copyright (c) 2020 QMCPACK developers.
+//
+// File developed by: QMCPACK developers
+//
+// File created by: QMCPACK developers
+//////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "catch.hpp"
+
+#include "Utilities/ScratchFileArray.h"
+
+namespace qmcplusplus
+{
+TEST_CASE("ScratchFileArray", "[utilities]")
+{
+  ScratchFileArray<double> scratch;
+  REQUIRE(scratch.data() == nullptr);
+
+  const size_t n = 100000;
+  double* data   = scratch.resize(".", n);
+  REQUIRE(data != nullptr);
+  REQUIRE(scratch.size() == n);
+  REQUIRE(data[0] == 0.0);
+  REQUIRE(data[n - 1] == 0.0);
+  for (size_t i = 0; i < n; i++)
+    data[i] = 0.5 * i;
+  double sum = 0.0;
+  for (size_t i = 0; i < n; i++)
+    sum += data[i];
+  REQUIRE(sum == Approx(0.25 * n * (n - 1)));
+
+  // a new mapping starts from zero
+  data = scratch.resize(".", 10);
+  REQUIRE(scratch.size() == 10);
+  REQUIRE(data[9] == 0.0);
+
+  scratch.free();
+  REQUIRE(scratch.data() == nullptr);
+  REQUIRE(scratch.size() == 0);
+
+  CHECK_THROWS_AS(scratch.resize("./no_such_directory", 10), std::runtime_error);
+}
+
+} // namespace qmcplusplus
@@ -341,6 +341,11 @@ inline bool h5d_write(hid_t grp,
   return ret != -1;
 }
 
+/** append rows to an extendable dataset, the dataset is created by the first call
+ * @param chunk_size number of rows per chunk, the chunks span all the other dimensions
+ * @param create_plist if not H5P_DEFAULT, dataset creation property list with the chunk shape and filters,
+ *        chunk_size is ignored
+ */
 template<typename T>
 inline bool h5d_append(hid_t grp,
                        const std::string& aname,
@@ -349,7 +354,8 @@ inline bool h5d_append(hid_t grp,
                        const hsize_t* dims,
                        const T* first,
                        hsize_t chunk_size = 1,
-                       hid_t xfer_plist   = H5P_DEFAULT)
+                       hid_t xfer_plist   = H5P_DEFAULT,
+                       hid_t create_plist = H5P_DEFAULT)
 {
   //app_log()<<omp_get_thread_num()<<"  h5d_append  group = "<<grp<<"  name = "<<aname.c_str()<< std::endl;
   if (grp < 0)
@@ -375,11 +381,14 @@ inline bool h5d_append(hid_t grp,
     // create a dataspace sized to the current buffer
     dataspace = H5Screate_simple(ndims, dims, max_dims.data());
     // create dataset property list
-    hid_t p = H5Pcreate(H5P_DATASET_CREATE);
-    // set layout (chunked, contiguous)
-    hid_t sl = H5Pset_layout(p, H5D_CHUNKED);
-    // set chunk size
-    hid_t cs = H5Pset_chunk(p, ndims, chunk_dims.data());
+    hid_t p = (create_plist == H5P_DEFAULT) ? H5Pcreate(H5P_DATASET_CREATE) : H5Pcopy(create_plist);
+    if (create_plist == H5P_DEFAULT)
+    {
+      // set layout (chunked, contiguous)
+      hid_t sl = H5Pset_layout(p, H5D_CHUNKED);
+      // set chunk size
+      hid_t cs = H5Pset_chunk(p, ndims, chunk_dims.data());
+    }
     // create the dataset
     dataset = H5Dcreate2(grp, aname.c_str(), h5d_type_id, dataspace, H5P_DEFAULT, p, H5P_DEFAULT);
     // create memory dataspace, size of current buffer
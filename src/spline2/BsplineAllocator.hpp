@@ -69,7 +69,8 @@ public:
 
   void destroy(SplineType* spline)
   {
-    coefs_allocator.deallocate(spline->coefs, spline->coefs_size);
+    if (spline->coefs != nullptr)
+      coefs_allocator.deallocate(spline->coefs, spline->coefs_size);
     multi_spline_allocator.deallocate(spline, 1);
   }
 
@@ -79,14 +80,17 @@ public:
     single_spline_allocator.deallocate(spline, 1);
   }
 
-  ///allocate a multi-bspline structure
+  /** allocate a multi-bspline structure
+   * @param allocate_coefs if false, coefs is left nullptr and the caller provides the coefs_size storage
+   */
   SplineType* allocateMultiBspline(Ugrid x_grid,
                                    Ugrid y_grid,
                                    Ugrid z_grid,
                                    BCType xBC,
                                    BCType yBC,
                                    BCType zBC,
-                                   int num_splines);
+                                   int num_splines,
+                                   bool allocate_coefs = true);
 
   ///allocate a UBspline_3d_d, it can be made template to support UBspline_3d_s
   SingleSplineType* allocateUBspline(Ugrid x_grid,
@@ -116,7 +120,8 @@ BsplineAllocator<T, COEFS_ALLOC, MULTI_SPLINE_ALLOC, SINGLE_SPLINE_ALLOC>::alloc
                                                                                                 BCType xBC,
                                                                                                 BCType yBC,
                                                                                                 BCType zBC,
-                                                                                                int num_splines)
+                                                                                                int num_splines,
+                                                                                                bool allocate_coefs)
 {
   // Create new spline
   SplineType* spline = multi_spline_allocator.allocate(1);
@@ -165,7 +170,7 @@ BsplineAllocator<T, COEFS_ALLOC, MULTI_SPLINE_ALLOC, SINGLE_SPLINE_ALLOC>::alloc
   spline->z_stride = N;
 
   spline->coefs_size = (size_t)Nx * spline->x_stride;
-  spline->coefs      = coefs_allocator.allocate(spline->coefs_size);
+  spline->coefs      = allocate_coefs ? coefs_allocator.allocate(spline->coefs_size) : nullptr;
 
   return spline;
 }
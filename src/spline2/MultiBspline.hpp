@@ -45,31 +45,13 @@ private:
   using real_type = typename bspline_traits<T, 3>::real_type;
   ///actual einspline multi-bspline object
   SplineType* spline_m;
+  ///true if the coefficients are stored in an external buffer not owned by this object
+  bool external_coefs;
   ///use allocator
   BsplineAllocator<T, COEFS_ALLOC, MULTI_SPLINE_ALLOC, SINGLE_SPLINE_ALLOC> myAllocator;
 
-public:
-  MultiBspline() : spline_m(nullptr) {}
-  MultiBspline(const MultiBspline& in) = delete;
-  MultiBspline& operator=(const MultiBspline& in) = delete;
-
-  ~MultiBspline()
-  {
-    if (spline_m != nullptr)
-      myAllocator.destroy(spline_m);
-  }
-
-  SplineType* getSplinePtr() { return spline_m; }
-
-  /** create the einspline as used in the builder
-   * @tparam GT grid type
-   * @tparam BCT boundary type
-   * @param bc num_splines number of splines
-   *
-   * num_splines must be padded to the aligned size. The caller must be aware of padding and pad all result arrays.
-   */
   template<typename GT, typename BCT>
-  void create(GT& grid, BCT& bc, int num_splines)
+  void create_impl(GT& grid, BCT& bc, int num_splines, bool allocate_coefs)
   {
     static_assert(std::is_same<T, typename COEFS_ALLOC::value_type>::value, "MultiBspline and ALLOC data types must agree!");
     if (getAlignedSize<T, COEFS_ALLOC::alignment>(num_splines) != num_splines)
@@ -89,12 +71,56 @@ public:
       xBC.rVal  = static_cast<T>(bc[0].rVal);
       yBC.rVal  = static_cast<T>(bc[1].rVal);
       zBC.rVal  = static_cast<T>(bc[2].rVal);
-      spline_m  = myAllocator.allocateMultiBspline(grid[0], grid[1], grid[2], xBC, yBC, zBC, num_splines);
+      spline_m =
+          myAllocator.allocateMultiBspline(grid[0], grid[1], grid[2], xBC, yBC, zBC, num_splines, allocate_coefs);
     }
     else
       throw std::runtime_error("MultiBspline::spline_m cannot be created twice!\n");
   }
 
+public:
+  MultiBspline() : spline_m(nullptr), external_coefs(false) {}
+  MultiBspline(const MultiBspline& in) = delete;
+  MultiBspline& operator=(const MultiBspline& in) = delete;
+
+  ~MultiBspline()
+  {
+    if (spline_m != nullptr)
+    {
+      if (external_coefs)
+        spline_m->coefs = nullptr;
+      myAllocator.destroy(spline_m);
+    }
+  }
+
+  SplineType* getSplinePtr() { return spline_m; }
+
+  /** create the einspline as used in the builder
+   * @tparam GT grid type
+   * @tparam BCT boundary type
+   * @param bc num_splines number of splines
+   *
+   * num_splines must be padded to the aligned size. The caller must be aware of padding and pad all result arrays.
+   */
+  template<typename GT, typename BCT>
+  void create(GT& grid, BCT& bc, int num_splines)
+  {
+    create_impl(grid, bc, num_splines, true);
+  }
+
+  /** create the einspline with the coefficients stored in an external buffer
+   * @param get_coefs callable returning T* to a buffer of the requested size, aligned as COEFS_ALLOC
+   *
+   * The buffer, e.g. node-shared memory, is managed by the caller and not released by this object.
+   */
+  template<typename GT, typename BCT, typename GETCOEFS>
+  void create(GT& grid, BCT& bc, int num_splines, GETCOEFS&& get_coefs)
+  {
+    create_impl(grid, bc, num_splines, false);
+    spline_m->coefs = get_coefs(spline_m->coefs_size);
+    external_coefs  = true;
+  }
+
   void flush_zero() const
   {
     if (spline_m != nullptr)
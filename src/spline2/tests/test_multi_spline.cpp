@@ -372,4 +372,23 @@ TEST_CASE("MultiBspline periodic double large", "[.spline2]")
 
 TEST_CASE("MultiBspline periodic float", "[spline2]") { test_splines<float>().test(); }
 
+TEST_CASE("MultiBspline external coefs", "[spline2]")
+{
+  test_splines_base<double, 5, 1> base;
+  aligned_vector<double> buffer;
+  {
+    MultiBspline<double> bs;
+    bs.create(base.grid, base.bc, base.npad, [&buffer](size_t n) {
+      buffer.resize(n);
+      return buffer.data();
+    });
+    REQUIRE(bs.getSplinePtr()->coefs == buffer.data());
+    REQUIRE(bs.sizeInByte() == buffer.size() * sizeof(double));
+    bs.flush_zero();
+  }
+  // the buffer is not released by MultiBspline
+  REQUIRE(buffer.size() > 0);
+  REQUIRE(buffer[0] == 0.0);
+}
+
 } // namespace qmcplusplus
@@ -16,6 +16,7 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <unordered_map>
 
 namespace qmcplusplus
 {
@@ -122,5 +123,26 @@ static std::vector<T*> convertUPtrToPtrVector(const UPtrVector<T>& uptr_list)
   return ptr_list;
 }
 
+/** group the indices of a RefVector by the object they refer to
+ *
+ * Lists built per ion-electron pair refer to the same walker object several times.
+ * Threads working on different groups never share an object.
+ * @return groups ordered by the first appearance of their object
+ */
+template<class T>
+static std::vector<std::vector<int>> groupIndicesByObject(const RefVector<T>& ref_list)
+{
+  std::vector<std::vector<int>> groups;
+  std::unordered_map<const T*, int> group_index;
+  for (int i = 0; i < ref_list.size(); i++)
+  {
+    auto found = group_index.emplace(&ref_list[i].get(), groups.size());
+    if (found.second)
+      groups.emplace_back();
+    groups[found.first->second].push_back(i);
+  }
+  return groups;
+}
+
 } // namespace qmcplusplus
 #endif